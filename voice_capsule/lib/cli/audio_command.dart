@@ -1,4 +1,6 @@
+import 'dart:async';
 import 'dart:io';
+import '../services/audio_capture.dart';
 import '../services/audio_device_service.dart';
 import '../services/settings_service.dart';
 import '../services/language_service.dart';
@@ -11,7 +13,7 @@ import '../services/language_service.dart';
 /// - nextalk audio              交互模式
 /// - nextalk audio <序号>       直接设置设备
 /// - nextalk audio default      恢复默认设备
-/// - nextalk audio list         机器可读格式输出
+/// - nextalk audio list         机器可读格式输出 (含采集延迟协商结果)
 /// - nextalk audio help         显示帮助
 class AudioCommand {
   AudioCommand._();
@@ -40,7 +42,7 @@ class AudioCommand {
 
     // list / --list / -l (AC11)
     if (arg == 'list' || arg == '--list' || arg == '-l') {
-      return _listDevices();
+      return await _listDevices();
     }
 
     // default (AC12)
@@ -241,7 +243,7 @@ class AudioCommand {
   }
 
   /// 机器可读格式输出 (AC11)
-  static int _listDevices() {
+  static Future<int> _listDevices() async {
     // 先枚举设备（这会产生 ALSA/JACK 警告到 stderr）
     final devices = AudioDeviceService.instance.listInputDevices();
     final currentDevice = SettingsService.instance.audioInputDevice;
@@ -260,9 +262,50 @@ class AudioCommand {
     }
     print('# END');
 
+    await _printLatency(currentDevice);
+
     return 0;
   }
 
+  /// 短暂打开当前配置的设备，输出缓冲延迟协商结果
+  ///
+  /// 格式: <字段>\t<值>，未知值输出 "-"
+  static Future<void> _printLatency(String currentDevice) async {
+    CaptureLatencyReport? report;
+    // 采集服务的调试日志会打乱机器可读输出，探测期间屏蔽
+    await runZoned(
+      () async {
+        final capture = AudioCapture()
+          ..targetLatencyMs = SettingsService.instance.audioTargetLatencyMs
+          ..deviceNativeFormat = SettingsService.instance.audioDeviceNativeFormat;
+        try {
+          await capture.warmup(deviceName: currentDevice);
+          if (await capture.start(deviceName: currentDevice) ==
+              AudioCaptureError.none) {
+            // 等待服务器完成一次时序更新，实测延迟才有意义
+            await Future<void>.delayed(const Duration(milliseconds: 200));
+          }
+          report = capture.latencyReport;
+          await capture.stop();
+        } finally {
+          capture.dispose();
+        }
+      },
+      zoneSpecification: ZoneSpecification(
+        print: (self, parent, zone, line) {},
+      ),
+    );
+
+    String format(double? ms) => ms != null ? ms.toStringAsFixed(1) : '-';
+    print('# LATENCY');
+    print('backend\t${report?.backend ?? 'none'}');
+    print('target_ms\t${SettingsService.instance.audioTargetLatencyMs}');
+    print('granted_ms\t${format(report?.grantedMs)}');
+    print('measured_ms\t${format(report?.measuredMs)}');
+    print('device_rate\t${report?.deviceRate ?? '-'}');
+    print('# END');
+  }
+
   /// 打印帮助信息 (AC13)
   static void _printHelp(LanguageService lang) {
     if (lang.isZh) {
@@ -273,7 +316,7 @@ Nextalk 音频设备配置
   nextalk audio              进入交互模式
   nextalk audio <序号>       设置指定设备
   nextalk audio default      恢复默认设备
-  nextalk audio list         机器可读格式输出
+  nextalk audio list         机器可读格式输出 (含采集延迟)
   nextalk audio help         显示此帮助
 
 示例:
@@ -283,6 +326,8 @@ Nextalk 音频设备配置
 
 提示:
   抑制警告信息: nextalk audio list 2>/dev/null
+  采集延迟目标: ~/.config/nextalk/settings.yaml 中的 audio.target_latency_ms
+  device_rate 为设备侧实际采样率 (audio.device_native_format 开启时由 Nextalk 重采样)
 ''');
     } else {
       print('''
@@ -292,7 +337,7 @@ Usage:
   nextalk audio              Interactive mode
   nextalk audio <number>     Set specified device
   nextalk audio default      Reset to default device
-  nextalk audio list         Machine-readable output
+  nextalk audio list         Machine-readable output (incl. capture latency)
   nextalk audio help         Show this help
 
 Examples:
@@ -302,6 +347,8 @@ Examples:
 
 Tips:
   Suppress warnings: nextalk audio list 2>/dev/null
+  Capture latency target: audio.target_latency_ms in ~/.config/nextalk/settings.yaml
+  device_rate is the device-side sample rate (resampled by Nextalk when audio.device_native_format is on)
 ''');
     }
   }
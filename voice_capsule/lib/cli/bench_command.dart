@@ -0,0 +1,635 @@
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import '../constants/settings_constants.dart';
+import '../services/asr/asr_engine.dart';
+import '../services/asr/sensevoice_engine.dart';
+import '../services/asr/two_pass_engine.dart';
+import '../services/asr/zipformer_engine.dart';
+import '../services/chunk_scheduler.dart';
+import '../services/model_manager.dart';
+import '../services/ort_model_cache.dart';
+import '../services/settings_service.dart';
+import '../services/thread_calibrator.dart';
+import '../utils/process_cpu.dart';
+import '../utils/wav_reader.dart';
+
+// ignore_for_file: avoid_print
+
+/// CLI bench 子命令: 比较分块策略的首字延迟与 CPU 开销
+///
+/// 使用方法:
+/// - nextalk bench <16kHz 单声道 wav>             比较全部内置策略
+/// - nextalk bench <wav> <策略名>...              只比较指定策略
+/// - nextalk bench --segments <wav>... [线程数...] SenseVoice 语音段解码吞吐
+/// - nextalk bench --batch <wav>... [批大小...]    SenseVoice 合批解码 RTF
+/// - nextalk bench --alloc <wav>...                SenseVoice 每段堆分配次数
+/// - nextalk bench --two-pass <wav>... [参考.txt]  两遍识别与单引擎的延迟和错误率
+/// - nextalk bench --calibrate [引擎]              校准并保存推理线程数
+///
+/// 按实时到达模拟送入音频: 块在其末尾样本"录到"后才可处理，
+/// 处理耗时按实测计入模拟时钟。首字延迟为首个部分结果出现时的模拟时刻。
+class BenchCommand {
+  BenchCommand._();
+
+  /// 执行 bench 命令
+  /// 返回退出码: 0=成功, 1=错误
+  static Future<int> execute(List<String> args) async {
+    if (args.isEmpty || args[0] == 'help' || args[0] == '--help') {
+      _printHelp();
+      return args.isEmpty ? 1 : 0;
+    }
+    if (args[0] == '--calibrate') {
+      return _calibrate(args.skip(1).toList());
+    }
+    if (args[0] == '--two-pass') {
+      return _benchTwoPass(args.skip(1).toList());
+    }
+    if (args[0] == '--alloc') {
+      return _benchAllocations(args.skip(1).toList());
+    }
+    if (args[0] == '--segments' || args[0] == '--batch') {
+      return _benchSegments(args.skip(1).toList(),
+          byBatch: args[0] == '--batch');
+    }
+
+    final samples = readWav16kMono(args[0]);
+    if (samples == null) {
+      print('错误: 无法读取 ${args[0]} (需要 16kHz 单声道 16-bit PCM WAV)');
+      return 1;
+    }
+
+    final policies = <ChunkPolicy>[];
+    for (final name in args.skip(1)) {
+      final policy = ChunkPolicy.byName(name);
+      if (policy == null) {
+        print('错误: 未知策略 $name');
+        _printHelp();
+        return 1;
+      }
+      policies.add(policy);
+    }
+    if (policies.isEmpty) policies.addAll(ChunkPolicy.builtIn);
+
+    await SettingsService.instance.initialize();
+    final modelManager = ModelManager();
+    if (!modelManager.isModelReady) {
+      print('错误: Zipformer 模型未就绪，请先启动应用下载模型');
+      return 1;
+    }
+
+    // 同步解码，处理耗时才能计入模拟时钟
+    final engine = ZipformerEngine(useInferenceWorker: false);
+    final error = await engine.initialize(ZipformerConfig(
+      modelDir: modelManager.modelPath,
+      useInt8Model: SettingsService.instance.modelType == ModelType.int8,
+    ));
+    if (error != ASRError.none) {
+      print('错误: 引擎初始化失败: $error');
+      return 1;
+    }
+
+    final audioSec = samples.length / 16000;
+    print('音频: ${args[0]} (${audioSec.toStringAsFixed(2)}s)');
+
+    final buffer = calloc<Float>(ChunkPolicy.maxChunkMs * 16);
+    try {
+      // 预热一轮，避免首个策略承担 onnxruntime 初始化开销
+      _run(engine, ChunkPolicy.fixed, samples, buffer);
+
+      print('');
+      print('${'策略'.padRight(36)}首字延迟    CPU/音频秒  块数');
+      for (final policy in policies) {
+        final r = _run(engine, policy, samples, buffer);
+        final firstPartial = r.firstPartialMs == null
+            ? '-'.padLeft(7)
+            : '${r.firstPartialMs!.toString().padLeft(5)}ms';
+        final cpu = (r.cpuMs / audioSec).toStringAsFixed(0).padLeft(6);
+        print('${policy.toString().padRight(36)}$firstPartial   ${cpu}ms  '
+            '${r.chunks.toString().padLeft(5)}');
+      }
+    } finally {
+      calloc.free(buffer);
+      engine.dispose();
+    }
+    return 0;
+  }
+
+  /// 用模型自带的测试音频校准推理线程数，结果保存到设置 (下次启动生效)
+  ///
+  /// 默认校准当前引擎；model.<engine>.num_threads 大于 0 时配置值优先于校准值。
+  static Future<int> _calibrate(List<String> args) async {
+    await SettingsService.instance.initialize();
+    final settings = SettingsService.instance;
+    OrtModelCache.instance.enabled = settings.ortModelCache;
+
+    final EngineType engine;
+    if (args.isEmpty) {
+      engine = settings.engineType;
+    } else {
+      final match = EngineType.values.where((e) => e.name == args[0]);
+      if (match.isEmpty) {
+        print('错误: 未知引擎 ${args[0]} (zipformer | sensevoice)');
+        return 1;
+      }
+      engine = match.first;
+    }
+
+    final modelManager = ModelManager();
+    if (!modelManager.isEngineReady(engine)) {
+      print('错误: ${engine.name} 模型未就绪，请先启动应用下载模型');
+      return 1;
+    }
+    final clip = ThreadCalibrator.clipFor(modelManager, engine);
+    if (clip == null) {
+      print('错误: 模型目录中没有可用的测试音频 (test_wavs/*.wav)');
+      return 1;
+    }
+
+    print('引擎: ${engine.name}');
+    print('音频: $clip');
+    print('CPU 核数: ${Platform.numberOfProcessors}');
+    print('');
+
+    final result = await ThreadCalibrator.calibrate(
+      modelManager,
+      engine,
+      useInt8: settings.modelType == ModelType.int8,
+      provider: settings.provider,
+    );
+    if (result == null) {
+      print('错误: 引擎初始化失败');
+      return 1;
+    }
+    final (threads, timings) = result;
+    print('线程数     RTF    CPU/音频秒');
+    for (final t in timings) {
+      print('${t.threads.toString().padLeft(6)}  '
+          '${t.rtf.toStringAsFixed(3).padLeft(6)}  '
+          '${t.cpuLoad.toStringAsFixed(2).padLeft(10)}');
+    }
+    print('');
+
+    await settings.saveThreadCalibration(
+        settings.threadCalibration.withResult(engine, threads));
+    print('已保存: ${engine.name} 使用 $threads 个推理线程 (下次启动生效)');
+    if (settings.numThreadsConfigured(engine)) {
+      print('注意: 配置文件中 model.${engine.name}.num_threads 已固定为 '
+          '${settings.numThreadsFor(engine)}，改为 0 才会使用校准值');
+    }
+    return 0;
+  }
+
+  /// SenseVoice 语音段解码吞吐: 语料一次性送入，按线程数或合批段数比较
+  ///
+  /// [byBatch] 为 false 时参数为线程数 (默认 1, 2, 4... 直到 CPU 核数)；
+  /// 为 true 时单线程解码，参数为每批段数 (默认 1, 2, 4, 8)。
+  static Future<int> _benchSegments(List<String> args,
+      {required bool byBatch}) async {
+    final paths = args.where((a) => a.endsWith('.wav')).toList();
+    if (paths.isEmpty) {
+      _printHelp();
+      return 1;
+    }
+    final samples = _readCorpus(paths);
+    if (samples == null) return 1;
+
+    final cores = Platform.numberOfProcessors;
+    final values = <int>[];
+    for (final arg in args.where((a) => !a.endsWith('.wav'))) {
+      final n = int.tryParse(arg);
+      if (n == null || n < 1) {
+        print('错误: 无效${byBatch ? '批大小' : '线程数'} $arg');
+        return 1;
+      }
+      values.add(n);
+    }
+    if (values.isEmpty) {
+      final limit = byBatch ? 8 : cores;
+      for (var n = 1; n <= limit; n *= 2) {
+        values.add(n);
+      }
+    }
+
+    await SettingsService.instance.initialize();
+    final modelManager = ModelManager();
+    if (!modelManager.isSenseVoiceReady) {
+      print('错误: SenseVoice 模型未就绪，请先启动应用下载模型');
+      return 1;
+    }
+
+    final audioSec = samples.length / 16000;
+    print('语料: ${paths.length} 个文件 (${audioSec.toStringAsFixed(2)}s)');
+    print('CPU 核数: $cores');
+    print('');
+    print(byBatch
+        ? '批大小  语音段  平均批   耗时(ms)   段/秒     RTF'
+        : '线程数  语音段   耗时(ms)   段/秒     RTF');
+
+    // 按 100ms 分块送入，不等待实时到达，测量全部语音段解码完成的耗时
+    const chunk = 1600;
+    final buffer = calloc<Float>(chunk);
+    try {
+      for (final value in values) {
+        final engine = SenseVoiceEngine();
+        final error = await engine.initialize(SenseVoiceConfig(
+          modelDir: modelManager.getModelPathForEngine(EngineType.sensevoice),
+          vadModelPath: modelManager.vadModelFilePath,
+          partialIntervalMs: 0,
+          segmentThreads: byBatch ? 1 : value,
+          segmentBatchSize: byBatch ? value : 1,
+          // 音频送入远快于实时，给工作线程时间攒满一批
+          segmentBatchWaitMs: byBatch ? 200 : 0,
+        ));
+        if (error != ASRError.none) {
+          print('错误: 引擎初始化失败: $error');
+          return 1;
+        }
+
+        try {
+          final watch = Stopwatch()..start();
+          for (var offset = 0; offset < samples.length; offset += chunk) {
+            final n = math.min(chunk, samples.length - offset);
+            buffer.asTypedList(n).setAll(0, samples.sublist(offset, offset + n));
+            engine.acceptWaveform(16000, buffer, n);
+          }
+          engine.inputFinished();
+          watch.stop();
+
+          final ms = watch.elapsedMilliseconds;
+          final segments = engine.decodedSegments;
+          final perSec = ms > 0 ? segments * 1000 / ms : 0.0;
+          final label = engine.segmentThreads == 0 ? '同步' : '$value';
+          final batch = byBatch
+              ? '  ${engine.meanSegmentBatch.toStringAsFixed(2).padLeft(6)}'
+              : '';
+          print('${label.padLeft(6)}  ${segments.toString().padLeft(6)}$batch  '
+              '${ms.toString().padLeft(9)}  ${perSec.toStringAsFixed(2).padLeft(7)}  '
+              '${(ms / 1000 / audioSec).toStringAsFixed(3).padLeft(6)}');
+        } finally {
+          engine.dispose();
+        }
+      }
+    } finally {
+      calloc.free(buffer);
+    }
+    return 0;
+  }
+
+  /// SenseVoice 每段的原生堆分配次数: 同一引擎连续解码语料两轮
+  ///
+  /// 首轮缓冲尚未回收，每段都要新分配 (与不复用缓冲时相同)；
+  /// 次轮为稳态，复用首轮回收的结果缓冲、音频缓冲与 map 节点。
+  static Future<int> _benchAllocations(List<String> paths) async {
+    if (paths.isEmpty) {
+      _printHelp();
+      return 1;
+    }
+    final samples = _readCorpus(paths);
+    if (samples == null) return 1;
+
+    await SettingsService.instance.initialize();
+    final modelManager = ModelManager();
+    if (!modelManager.isSenseVoiceReady) {
+      print('错误: SenseVoice 模型未就绪，请先启动应用下载模型');
+      return 1;
+    }
+
+    final engine = SenseVoiceEngine();
+    final error = await engine.initialize(SenseVoiceConfig(
+      modelDir: modelManager.getModelPathForEngine(EngineType.sensevoice),
+      vadModelPath: modelManager.vadModelFilePath,
+      partialIntervalMs: 0,
+      segmentThreads: 1,
+      segmentBatchSize: 1,
+    ));
+    if (error != ASRError.none) {
+      print('错误: 引擎初始化失败: $error');
+      return 1;
+    }
+    if (engine.segmentThreads == 0) {
+      engine.dispose();
+      print('错误: 原生后台解码不可用');
+      return 1;
+    }
+
+    print('语料: ${paths.length} 个文件 '
+        '(${(samples.length / 16000).toStringAsFixed(2)}s)');
+    print('');
+    print('轮次  语音段  分配/段  无分配段');
+
+    const chunk = 1600;
+    final buffer = calloc<Float>(chunk);
+    try {
+      for (final round in ['冷', '热']) {
+        engine.reset();
+        for (var offset = 0; offset < samples.length; offset += chunk) {
+          final n = math.min(chunk, samples.length - offset);
+          buffer.asTypedList(n).setAll(0, samples.sublist(offset, offset + n));
+          engine.acceptWaveform(16000, buffer, n);
+        }
+        engine.inputFinished();
+
+        final allocs = engine.segmentAllocations;
+        final total = allocs.fold<int>(0, (sum, a) => sum + a);
+        final perSegment = allocs.isEmpty ? 0.0 : total / allocs.length;
+        final clean = allocs.where((a) => a == 0).length;
+        print('${round.padLeft(4)}  ${allocs.length.toString().padLeft(6)}  '
+            '${perSegment.toStringAsFixed(2).padLeft(7)}  '
+            '${clean.toString().padLeft(8)}');
+      }
+    } finally {
+      calloc.free(buffer);
+      engine.dispose();
+    }
+    print('');
+    print('不含 sherpa 内部的离线流与结果 (每段各一次，无重置接口)');
+    return 0;
+  }
+
+  /// 两遍识别与两个单引擎对比: 按实时节奏送入语料 (PTT 累积，端点处不重置)
+  ///
+  /// 首字为首个非空结果出现的时刻，停止后为 inputFinished 到最终结果的耗时；
+  /// 给出参考文本时计算错误率 (含中日韩文字按字，否则按词)。
+  static Future<int> _benchTwoPass(List<String> args) async {
+    final paths = args.where((a) => a.endsWith('.wav')).toList();
+    final refPath = args.where((a) => a.endsWith('.txt')).firstOrNull;
+    if (paths.isEmpty) {
+      _printHelp();
+      return 1;
+    }
+    final samples = _readCorpus(paths);
+    if (samples == null) return 1;
+    String? reference;
+    if (refPath != null) {
+      final file = File(refPath);
+      if (!file.existsSync()) {
+        print('错误: 参考文本 $refPath 不存在');
+        return 1;
+      }
+      reference = file.readAsStringSync();
+    }
+
+    await SettingsService.instance.initialize();
+    final settings = SettingsService.instance;
+    final modelManager = ModelManager();
+    if (!modelManager.isModelReady || !modelManager.isSenseVoiceReady) {
+      print('错误: 需要 Zipformer 与 SenseVoice 模型，请先启动应用下载模型');
+      return 1;
+    }
+
+    final zipformerConfig = ZipformerConfig(
+      modelDir: modelManager.modelPath,
+      useInt8Model: settings.modelType == ModelType.int8,
+    );
+    final senseVoiceDir =
+        modelManager.getModelPathForEngine(EngineType.sensevoice);
+    final candidates = <String, (ASREngine, ASRConfig)>{
+      'Zipformer': (ZipformerEngine(), zipformerConfig),
+      'SenseVoice': (
+        SenseVoiceEngine(),
+        SenseVoiceConfig(
+          modelDir: senseVoiceDir,
+          vadModelPath: modelManager.vadModelFilePath,
+          partialIntervalMs: settings.senseVoicePartialIntervalMs,
+          partialMaxLoad: settings.senseVoicePartialMaxLoad,
+        ),
+      ),
+      '两遍': (
+        TwoPassEngine(
+          secondPass: SenseVoiceConfig(
+            modelDir: senseVoiceDir,
+            vadModelPath: modelManager.vadModelFilePath,
+            numThreads: settings.twoPassNumThreads,
+            partialIntervalMs: 0,
+            segmentThreads: 1,
+            segmentBatchSize: 1,
+          ),
+          maxSegmentSec: settings.twoPassMaxSegmentSec,
+          maxWait: Duration(milliseconds: settings.twoPassMaxWaitMs),
+        ),
+        zipformerConfig,
+      ),
+    };
+
+    final audioSec = samples.length / 16000;
+    print('语料: ${paths.length} 个文件 (${audioSec.toStringAsFixed(2)}s)，'
+        '按实时节奏送入，共需约 ${(audioSec * candidates.length).round()}s');
+    print('');
+
+    const chunk = 1600;
+    final buffer = calloc<Float>(chunk);
+    final texts = <String, String>{};
+    try {
+      print('引擎          首字(ms)  停止后(ms)  CPU/音频秒  '
+          '${reference == null ? '' : '错误率'}');
+      for (final MapEntry(key: name, value: (engine, config))
+          in candidates.entries) {
+        final error = await engine.initialize(config);
+        if (error != ASRError.none) {
+          print('错误: $name 初始化失败: $error');
+          engine.dispose();
+          return 1;
+        }
+        try {
+          final cpuStart = processCpuMs();
+          final watch = Stopwatch()..start();
+          int? firstTextMs;
+          for (var offset = 0; offset < samples.length; offset += chunk) {
+            final n = math.min(chunk, samples.length - offset);
+            final arrivalUs = (offset + n) * 1000000 ~/ 16000;
+            final waitUs = arrivalUs - watch.elapsedMicroseconds;
+            if (waitUs > 0) sleep(Duration(microseconds: waitUs));
+
+            buffer.asTypedList(n).setAll(0, samples.sublist(offset, offset + n));
+            engine.acceptWaveform(16000, buffer, n);
+            while (engine.isReady()) {
+              engine.decode();
+            }
+            if (engine.getResult().text.isNotEmpty) {
+              firstTextMs ??= watch.elapsedMilliseconds;
+            }
+            engine.isEndpoint();
+          }
+
+          final stopWatch = Stopwatch()..start();
+          engine.inputFinished();
+          final text = engine.getResult().text;
+          stopWatch.stop();
+          final cpuMs = processCpuMs() - cpuStart;
+          texts[name] = text;
+
+          final rate = reference == null
+              ? ''
+              : '${(_errorRate(reference, text) * 100).toStringAsFixed(1).padLeft(5)}%';
+          final note = engine is TwoPassEngine
+              ? '  (替换 ${engine.rescoredSegments} 段，'
+                  '保留 ${engine.skippedSegments} 段)'
+              : '';
+          print('${name.padRight(12)}  '
+              '${(firstTextMs?.toString() ?? '-').padLeft(8)}  '
+              '${stopWatch.elapsedMilliseconds.toString().padLeft(10)}  '
+              '${(cpuMs / audioSec).toStringAsFixed(0).padLeft(8)}ms  '
+              '$rate$note');
+        } finally {
+          engine.dispose();
+        }
+      }
+    } finally {
+      calloc.free(buffer);
+    }
+
+    print('');
+    for (final MapEntry(key: name, value: text) in texts.entries) {
+      print('$name: $text');
+    }
+    return 0;
+  }
+
+  /// 编辑距离错误率: 参考文本含中日韩文字时按字，否则按词 (忽略大小写与标点)
+  static double _errorRate(String reference, String hypothesis) {
+    final cjk = RegExp(r'[぀-ヿ㐀-鿿가-힯]');
+    List<String> units(String text) {
+      final cleaned = text
+          .toLowerCase()
+          .replaceAll(RegExp(r"[^\p{L}\p{N}\s']", unicode: true), ' ');
+      return cjk.hasMatch(reference)
+          ? cleaned.replaceAll(RegExp(r'\s'), '').split('')
+          : cleaned.split(RegExp(r'\s+')).where((w) => w.isNotEmpty).toList();
+    }
+
+    final ref = units(reference);
+    final hyp = units(hypothesis);
+    if (ref.isEmpty) return hyp.isEmpty ? 0 : 1;
+    var previous = List<int>.generate(hyp.length + 1, (j) => j);
+    for (var i = 1; i <= ref.length; i++) {
+      final current = List<int>.filled(hyp.length + 1, 0)..[0] = i;
+      for (var j = 1; j <= hyp.length; j++) {
+        final cost = ref[i - 1] == hyp[j - 1] ? 0 : 1;
+        current[j] = math.min(
+          math.min(previous[j] + 1, current[j - 1] + 1),
+          previous[j - 1] + cost,
+        );
+      }
+      previous = current;
+    }
+    return previous[hyp.length] / ref.length;
+  }
+
+  /// 读取多个 WAV 并以 1 秒静音相隔拼接为一份语料
+  static Float32List? _readCorpus(List<String> paths) {
+    const gap = 16000;
+    final parts = <Float32List>[];
+    for (final path in paths) {
+      final part = readWav16kMono(path);
+      if (part == null) {
+        print('错误: 无法读取 $path (需要 16kHz 单声道 16-bit PCM WAV)');
+        return null;
+      }
+      parts.add(part);
+    }
+    final total =
+        parts.fold<int>(0, (sum, p) => sum + p.length) + gap * (parts.length - 1);
+    final out = Float32List(total);
+    var offset = 0;
+    for (final part in parts) {
+      out.setAll(offset, part);
+      offset += part.length + gap;
+    }
+    return out;
+  }
+
+  /// 按 [policy] 分块模拟一次实时识别
+  static _BenchResult _run(
+    ZipformerEngine engine,
+    ChunkPolicy policy,
+    Float32List samples,
+    Pointer<Float> buffer,
+  ) {
+    engine.reset();
+    final scheduler = ChunkScheduler(policy);
+    final cpuStart = processCpuMs();
+
+    var clockUs = 0;
+    var offset = 0;
+    var chunks = 0;
+    int? firstPartialMs;
+    final watch = Stopwatch();
+
+    while (offset < samples.length) {
+      final n = math.min(scheduler.targetSamples, samples.length - offset);
+      buffer.asTypedList(n).setAll(0, samples.sublist(offset, offset + n));
+      offset += n;
+      chunks++;
+
+      // 块在末尾样本录到后才可处理
+      final arrivalUs = offset * 1000000 ~/ 16000;
+      clockUs = math.max(clockUs, arrivalUs);
+
+      watch
+        ..reset()
+        ..start();
+      engine.acceptWaveform(16000, buffer, n);
+      while (engine.isReady()) {
+        engine.decode();
+      }
+      final hasText = engine.getResult().text.isNotEmpty;
+      watch.stop();
+      clockUs += watch.elapsedMicroseconds;
+
+      if (hasText && firstPartialMs == null) {
+        firstPartialMs = clockUs ~/ 1000;
+      }
+      scheduler.advance(n);
+    }
+
+    return _BenchResult(
+      firstPartialMs: firstPartialMs,
+      cpuMs: processCpuMs() - cpuStart,
+      chunks: chunks,
+    );
+  }
+
+  static void _printHelp() {
+    print('''
+用法: nextalk bench <wav> [策略名...]
+      nextalk bench --segments <wav>... [线程数...]
+      nextalk bench --batch <wav>... [批大小...]
+      nextalk bench --alloc <wav>...
+      nextalk bench --two-pass <wav>... [参考.txt]
+      nextalk bench --calibrate [zipformer|sensevoice]
+
+以实时到达模拟比较分块策略的首字延迟与 CPU 开销 (Zipformer)。
+--segments: 语料一次性送入 SenseVoice，比较不同语音段解码线程数下的
+吞吐 (默认 1, 2, 4... 直到 CPU 核数)。
+--batch: 单线程解码，比较每批合并段数 (默认 1, 2, 4, 8) 下的 RTF。
+--alloc: 连续解码两轮，比较缓冲回收前后每段的原生堆分配次数。
+--two-pass: 按实时节奏分别运行 Zipformer、SenseVoice 与两遍识别 (使用
+model.zipformer.two_pass 配置)，比较首字延迟、停止后延迟、CPU 开销与
+相对参考文本的错误率。
+--calibrate: 用模型自带的测试音频按 1..N 个推理线程解码，选出延迟足够低
+且不多占 CPU 的线程数并保存 (默认校准当前引擎，下次启动生效)。
+多个 wav 以 1 秒静音相隔拼接，建议使用含多处停顿的录音。
+wav 须为 16kHz 单声道 16-bit PCM。
+
+内置策略:
+${ChunkPolicy.builtIn.map((p) => '  ${p.name.padRight(10)} $p').join('\n')}
+''');
+  }
+}
+
+class _BenchResult {
+  final int? firstPartialMs;
+  final int cpuMs;
+  final int chunks;
+
+  const _BenchResult({
+    required this.firstPartialMs,
+    required this.cpuMs,
+    required this.chunks,
+  });
+}
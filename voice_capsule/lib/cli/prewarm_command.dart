@@ -0,0 +1,77 @@
+import '../services/model_manager.dart';
+import '../services/ort_model_cache.dart';
+import '../services/settings_service.dart';
+
+// ignore_for_file: avoid_print
+
+/// CLI prewarm 子命令: 把当前引擎的模型文件读入页缓存
+///
+/// 使用方法:
+/// - nextalk prewarm            以空闲 I/O 优先级预热 (可加入会话自启动)
+/// - nextalk prewarm --status   只报告模型文件当前的页缓存状态
+///
+/// 应用启动时也会自动预热；在会话启动时单独运行，可让磁盘读取
+/// 赶在应用启动和首次录音之前完成。
+class PrewarmCommand {
+  PrewarmCommand._();
+
+  /// 执行 prewarm 命令
+  /// 返回退出码: 0=成功, 1=错误
+  static Future<int> execute(List<String> args) async {
+    if (args.isNotEmpty && (args[0] == 'help' || args[0] == '--help')) {
+      _printHelp();
+      return 0;
+    }
+    if (args.isNotEmpty && args[0] != '--status') {
+      print('错误: 未知参数 ${args[0]}');
+      _printHelp();
+      return 1;
+    }
+
+    await SettingsService.instance.initialize();
+    OrtModelCache.instance.enabled = SettingsService.instance.ortModelCache;
+    final modelManager = ModelManager();
+    if (!modelManager.hasAnyEngineReady) {
+      print('错误: 模型未就绪，请先启动应用下载模型');
+      return 1;
+    }
+
+    final files = modelManager.activeModelFiles;
+    final engines = modelManager.activeEngines.map((e) => e.name).join(' + ');
+    print('引擎: $engines (${files.length} 个文件)');
+
+    if (args.isNotEmpty) {
+      final residency = modelManager.pageCacheResidency(files);
+      if (residency == null) {
+        print('错误: 原生库不可用');
+        return 1;
+      }
+      final (resident, total) = residency;
+      final ratio = total > 0 ? resident * 100 ~/ total : 100;
+      print('页缓存: ${_mb(resident)}/${_mb(total)} ($ratio%)');
+      return 0;
+    }
+
+    try {
+      final result = await modelManager.prewarmModelFiles(files);
+      print('预热完成: $result');
+      return 0;
+    } catch (e) {
+      print('错误: 预热失败: $e');
+      return 1;
+    }
+  }
+
+  static String _mb(int bytes) =>
+      '${(bytes / (1024 * 1024)).toStringAsFixed(0)}MB';
+
+  static void _printHelp() {
+    print('''
+用法:
+  nextalk prewarm            以空闲 I/O 优先级把当前引擎的模型文件读入页缓存
+  nextalk prewarm --status   只报告模型文件当前的页缓存状态
+
+可加入会话自启动 (如 ~/.config/autostart)，让首次录音不必从磁盘冷读模型
+''');
+  }
+}
@@ -42,6 +42,25 @@ class AnimationConstants {
   /// 呼吸周期 (完整 sin 波)
   static const Duration breathingPeriod = Duration(milliseconds: 2000);
 
+  // ===== 语音电平跟随 (Voice level) =====
+  /// 电平映射下限: 低于此值视为无声 (dBFS)
+  static const double voiceLevelFloorDb = -60.0;
+
+  /// 电平映射上限: 高于此值视为满幅 (dBFS)
+  static const double voiceLevelCeilDb = -12.0;
+
+  /// 电平上升时间常数 (快速跟随音节起始)
+  static const Duration voiceLevelAttack = Duration(milliseconds: 40);
+
+  /// 电平回落时间常数 (避免动画随音节抖动)
+  static const Duration voiceLevelRelease = Duration(milliseconds: 250);
+
+  /// 满电平时呼吸圆点额外放大量
+  static const double breathingVoiceAmplitude = 0.25;
+
+  /// 满电平时波纹额外扩散量
+  static const double rippleVoiceScaleBoost = 1.0;
+
   // ===== 脉冲动画 (Pulse - Processing) =====
   /// 快速脉冲周期
   static const Duration pulseDuration = Duration(milliseconds: 400);
@@ -18,6 +18,15 @@ enum EngineType {
   sensevoice,
 }
 
+/// 端点检测模式
+enum EndpointMode {
+  /// 仅使用识别器的尾部静音规则 (Rule1/2/3)
+  rules,
+
+  /// Silero VAD 与规则并行，按置信度缩短尾部静音，先到者生效
+  hybrid,
+}
+
 /// 设置服务常量
 class SettingsConstants {
   SettingsConstants._();
@@ -36,6 +45,12 @@ class SettingsConstants {
   /// 音频输入设备名称键名 (Story 3-9)
   static const String keyAudioInputDevice = '${keyPrefix}audio_input_device';
 
+  /// 句内停顿统计键名 (自适应端点静音阈值，JSON)
+  static const String keyPauseStatistics = '${keyPrefix}pause_statistics';
+
+  /// 推理线程数校准结果键名 (JSON)
+  static const String keyThreadCalibration = '${keyPrefix}thread_calibration';
+
   // ===== 配置文件路径 =====
 
   /// XDG 配置目录
@@ -54,9 +69,12 @@ class SettingsConstants {
 
   // ===== 默认值 =====
 
-  /// 默认模型类型 (Zipformer 版本)
+  /// 默认模型类型 (Zipformer 版本，设置服务未初始化时)
   static const ModelType defaultModelType = ModelType.standard;
 
+  /// 默认执行提供者: auto 按 CPU 与 onnxruntime 构建自动选择
+  static const String defaultProvider = 'auto';
+
   /// 默认引擎类型 (Story 2-7 AC5: 默认使用 SenseVoice 引擎)
   static const EngineType defaultEngineType = EngineType.sensevoice;
 
@@ -66,9 +84,82 @@ class SettingsConstants {
   /// SenseVoice 默认配置: 语言 (auto 自动检测)
   static const String defaultSenseVoiceLanguage = 'auto';
 
+  /// SenseVoice 默认配置: 未结束语音段的中间解码间隔 (毫秒)，0 表示关闭
+  static const int defaultSenseVoicePartialIntervalMs = 500;
+
+  /// SenseVoice 中间解码间隔上限 (毫秒)
+  static const int maxSenseVoicePartialIntervalMs = 5000;
+
+  /// SenseVoice 默认配置: 中间解码允许占用的计算比例 (解码耗时 / 音频时长)
+  static const double defaultSenseVoicePartialMaxLoad = 0.5;
+
+  /// 两遍识别默认配置: 是否启用 (Zipformer 实时显示，SenseVoice 在端点处重识别)
+  static const bool defaultTwoPassEnabled = false;
+
+  /// 两遍识别默认配置: 第二遍 (SenseVoice) 使用的推理线程数
+  static const int defaultTwoPassNumThreads = 1;
+
+  /// 两遍识别第二遍推理线程数上限
+  static const int maxTwoPassNumThreads = 8;
+
+  /// 两遍识别默认配置: 每个语音段缓存音频的时长上限 (秒)，超出的语音段保留第一遍结果
+  static const double defaultTwoPassMaxSegmentSec = 30.0;
+
+  /// 两遍识别默认配置: 停止录音时等待第二遍结果的上限 (毫秒)
+  static const int defaultTwoPassMaxWaitMs = 800;
+
+  /// 默认推理线程数 (未配置且未校准时)
+  static const int defaultNumThreads = 2;
+
+  /// 推理线程数上限
+  static const int maxNumThreads = 16;
+
+  /// 默认空闲卸载时间 (分钟): 多久未录音后释放识别模型，0 表示常驻内存
+  static const int defaultIdleUnloadMin = 0;
+
+  /// 空闲卸载时间上限 (分钟)
+  static const int maxIdleUnloadMin = 1440;
+
+  /// 常驻识别宿主默认配置: 是否启用 (Zipformer 在独立进程中识别，模型跨重启保留)
+  static const bool defaultEngineHostEnabled = false;
+
+  /// 常驻识别宿主默认配置: 没有客户端后保留模型的时间 (分钟)
+  static const int defaultEngineHostIdleTimeoutMin = 30;
+
+  /// 常驻识别宿主空闲超时上限 (分钟)
+  static const int maxEngineHostIdleTimeoutMin = 1440;
+
+  /// 默认是否缓存 onnxruntime 优化后的模型 (加快识别器创建)
+  static const bool defaultOrtModelCache = true;
+
   /// 默认音频输入设备 (Story 3-9: "default" 表示使用系统默认设备)
   static const String defaultAudioInputDevice = 'default';
 
+  /// 默认采集目标延迟 (毫秒)，用于协商音频服务器缓冲大小
+  static const int defaultAudioTargetLatencyMs = 20;
+
+  /// 采集目标延迟允许范围 (毫秒)
+  static const int minAudioTargetLatencyMs = 5;
+  static const int maxAudioTargetLatencyMs = 200;
+
+  /// 默认以设备原生采样率/格式采集，由原生库重采样到 16kHz
+  static const bool defaultAudioDeviceNativeFormat = true;
+
+  /// 默认预录时长 (毫秒)，0 表示关闭 (需用户主动开启，隐藏时也会监听麦克风)
+  static const int defaultAudioPrerollMs = 0;
+
+  /// 预录时长上限 (毫秒)，需小于原生环形缓冲区容量
+  static const int maxAudioPrerollMs = 1000;
+
+  /// 默认端点检测模式
+  static const EndpointMode defaultEndpointMode = EndpointMode.rules;
+
+  /// 默认根据用户的句内停顿习惯调整端点静音阈值
+  static const bool defaultAudioAdaptiveSilence = true;
+
+  /// 默认在录音过程中提前提交已稳定的文本
+  static const bool defaultAudioEarlyCommit = true;
+
   // ===== 配置文件模板 =====
 
   /// 检测系统是否为中文环境
@@ -95,16 +186,61 @@ model:
   # sensevoice: 离线识别，VAD 分段后识别，高精度，自动标点
   engine: sensevoice
 
+  # 缓存 onnxruntime 优化后的模型 (~/.cache/nextalk/ort)，加快启动和切换引擎
+  # 首次使用某个模型时在后台生成，下次启动生效
+  ort_cache: true
+
+  # onnxruntime 执行提供者: auto | cpu | xnnpack
+  # auto: arm64 上 onnxruntime 带有 XNNPACK 时使用 xnnpack，其余使用 cpu
+  # 非 cpu 提供者不使用 ort_cache 缓存
+  provider: auto
+
+  # 多久未录音后释放识别模型 (分钟，0-1440)，0 表示一直保留在内存中
+  # 释放后下次录音会重新加载模型 (约 0.3-1 秒)，其间的音频先缓存，不会丢失
+  idle_unload_min: 0
+
   # Zipformer 配置 (流式引擎)
   zipformer:
-    # 模型版本: int8 | standard
-    # int8: 量化版本，速度快，内存占用小
+    # 模型版本: auto | int8 | standard
+    # auto: 按 CPU 自动选择，没有 AVX2 的 x86 CPU 上 int8 较慢，使用 standard
+    # int8: 量化版本，速度快，内存占用小 (VNNI / AMX / dotprod 加速明显)
     # standard: 标准版本，精度高
-    type: int8
+    type: auto
 
     # 自定义模型下载地址 (留空使用默认地址)
     custom_url: ""
 
+    # 送入识别的音频块长度 (毫秒，20-100)，取消注释以覆盖默认值
+    # 录音第一秒使用 first_chunk_ms 以尽快出现首个结果，之后逐步增大到 chunk_ms
+    # first_chunk_ms: 20
+    # chunk_ms: 100
+
+    # 推理线程数 (1-16)，0 为自动: 首次启动后在后台用模型自带的测试音频校准
+    # 可运行 nextalk bench --calibrate 重新校准
+    num_threads: 0
+
+    # 两遍识别: 录音时实时显示 Zipformer 结果，每句话结束后交给 SenseVoice 重新识别并替换
+    # 需已下载 SenseVoice 与 VAD 模型，会额外占用约 250MB 内存
+    two_pass:
+      enabled: false
+
+      # SenseVoice 重新识别使用的线程数 (1-8)，越少越不影响实时识别
+      num_threads: 1
+
+      # 每句话最多缓存的音频 (秒，5-60)，更长的句子保留 Zipformer 结果
+      max_segment_sec: 30
+
+      # 停止录音时最多等待重新识别的时间 (毫秒，0-5000)，超时保留 Zipformer 结果
+      max_wait_ms: 800
+
+    # 常驻识别宿主: Zipformer 在独立进程 nextalk_engine_host 中识别
+    # 模型在应用重启之间保持加载，识别崩溃不影响界面；宿主不可用时自动改为本进程识别
+    engine_host:
+      enabled: false
+
+      # 应用退出后宿主保留模型的时间 (分钟，1-1440)，超时后宿主退出并释放内存
+      idle_timeout_min: 30
+
   # SenseVoice 配置 (离线引擎)
   sensevoice:
     # 是否启用逆文本正则化 (ITN)
@@ -118,6 +254,20 @@ model:
     # 自定义模型下载地址 (留空使用默认地址)
     custom_url: ""
 
+    # 送入识别的音频块长度 (毫秒，20-100)，取消注释以覆盖默认值
+    # first_chunk_ms: 32
+    # chunk_ms: 96
+
+    # 推理线程数 (1-16)，0 为自动: 首次启动后在后台用模型自带的测试音频校准
+    # 可运行 nextalk bench --calibrate 重新校准
+    num_threads: 0
+
+    # 说话过程中每隔多久重新识别当前这句话 (毫秒，0-5000)，0 为只在一句话结束后输出
+    partial_interval_ms: 500
+
+    # 中间识别最多占用的 CPU 比例 (0.1-1.0，相对音频时长)，句子越长单次越慢，间隔会自动拉长
+    partial_max_load: 0.5
+
 # 快捷键设置
 # 请通过系统设置配置全局快捷键来触发 Nextalk：
 #   GNOME: 设置 → 键盘 → 自定义快捷键 → 添加快捷键
@@ -132,6 +282,34 @@ audio:
   #
   # 使用 nextalk audio 命令配置设备
   input_device: default
+
+  # 采集目标延迟 (毫秒，5-200)，常用 10 / 20 / 40
+  # 越小响应越快，但在高负载时更容易丢帧
+  # 实际授予的延迟可通过 nextalk audio list 查看
+  target_latency_ms: 20
+
+  # 以设备原生采样率/格式采集 (如 48kHz 立体声)，由 Nextalk 自行转换为 16kHz 单声道
+  # 不依赖音频服务器的重采样质量设置；设为 false 则由服务器转换
+  device_native_format: true
+
+  # 预录时长 (毫秒，0-1000)，0 为关闭
+  # 开启后胶囊隐藏时麦克风保持监听，只在内存中保留最近这段音频，
+  # 唤醒时立即送入识别，避免首字被截断。监听期间托盘会显示提示。
+  preroll_ms: 0
+
+  # 端点检测模式 (仅 Zipformer): rules | hybrid
+  # rules: 说完后等待固定的尾部静音 (约 1.2 秒)
+  # hybrid: 同时运行 Silero VAD (需已下载 VAD 模型)，语音清晰时约 0.4 秒即判定说完
+  endpoint_mode: rules
+
+  # 根据你说话时的停顿习惯自动调整判定说完所需的静音时长 (0.6-2.0 秒)
+  # 统计只保存在本机，设为 false 则固定为 1.2 秒
+  adaptive_silence: true
+
+  # 录音过程中提前上屏已确定的文字 (需 Fcitx5)
+  # 识别结果中约 1 秒前且连续多次不再变化的部分先行提交，松开快捷键时只提交剩余文字
+  # 仅单遍 Zipformer 流式引擎生效 (两遍识别时关闭)；设为 false 则全部文字在停止录音时一次提交
+  early_commit: true
 ''';
 
   /// English settings template
@@ -144,16 +322,69 @@ model:
   # sensevoice: Offline recognition, VAD segmented, high accuracy, auto punctuation
   engine: sensevoice
 
+  # Cache onnxruntime-optimized models (~/.cache/nextalk/ort) for faster
+  # startup and engine switches; built in the background on first use,
+  # used from the next start
+  ort_cache: true
+
+  # onnxruntime execution provider: auto | cpu | xnnpack
+  # auto: xnnpack on arm64 when onnxruntime includes XNNPACK, otherwise cpu
+  # Providers other than cpu do not use the ort_cache copies
+  provider: auto
+
+  # Free the recognition models after this many idle minutes (0-1440);
+  # 0 keeps them in memory. The next recording reloads them (about 0.3-1s)
+  # and buffers audio meanwhile, so nothing is lost
+  idle_unload_min: 0
+
   # Zipformer configuration (streaming engine)
   zipformer:
-    # Model version: int8 | standard
-    # int8: Quantized version, faster, less memory
+    # Model version: auto | int8 | standard
+    # auto: Chosen from the CPU; x86 CPUs without AVX2 run int8 slowly and use standard
+    # int8: Quantized version, faster, less memory (much faster with VNNI / AMX / dotprod)
     # standard: Standard version, higher accuracy
-    type: int8
+    type: auto
 
     # Custom model download URL (leave empty for default)
     custom_url: ""
 
+    # Audio block length fed to the recognizer (ms, 20-100); uncomment to override
+    # The first second uses first_chunk_ms so the first partial shows up sooner,
+    # then blocks grow to chunk_ms
+    # first_chunk_ms: 20
+    # chunk_ms: 100
+
+    # Inference threads (1-16); 0 = auto: calibrated in the background with the
+    # model's bundled test audio after the first start
+    # Run nextalk bench --calibrate to calibrate again
+    num_threads: 0
+
+    # Two-pass recognition: show Zipformer text live, then re-recognize each
+    # finished sentence with SenseVoice and swap in its text
+    # Needs the SenseVoice and VAD models; uses about 250MB of extra memory
+    two_pass:
+      enabled: false
+
+      # Threads for the SenseVoice pass (1-8); fewer leaves more CPU for live text
+      num_threads: 1
+
+      # Audio kept per sentence (seconds, 5-60); longer sentences keep Zipformer text
+      max_segment_sec: 30
+
+      # How long stopping waits for the SenseVoice pass (ms, 0-5000);
+      # on timeout the Zipformer text is kept
+      max_wait_ms: 800
+
+    # Engine host: run Zipformer in the separate nextalk_engine_host process
+    # Models stay loaded across app restarts and a recognizer crash cannot take
+    # down the UI; falls back to in-process recognition if the host is unavailable
+    engine_host:
+      enabled: false
+
+      # How long the host keeps models after the app exits (minutes, 1-1440);
+      # after that the host exits and frees the memory
+      idle_timeout_min: 30
+
   # SenseVoice configuration (offline engine)
   sensevoice:
     # Enable Inverse Text Normalization (ITN)
@@ -167,6 +398,23 @@ model:
     # Custom model download URL (leave empty for default)
     custom_url: ""
 
+    # Audio block length fed to the recognizer (ms, 20-100); uncomment to override
+    # first_chunk_ms: 32
+    # chunk_ms: 96
+
+    # Inference threads (1-16); 0 = auto: calibrated in the background with the
+    # model's bundled test audio after the first start
+    # Run nextalk bench --calibrate to calibrate again
+    num_threads: 0
+
+    # How often to re-recognize the sentence still being spoken (ms, 0-5000);
+    # 0 outputs text only after each sentence ends
+    partial_interval_ms: 500
+
+    # Maximum CPU share for these interim passes (0.1-1.0, relative to audio time);
+    # longer sentences cost more per pass, so the interval stretches automatically
+    partial_max_load: 0.5
+
 # Hotkey Settings
 # Configure global hotkey via system settings to trigger Nextalk:
 #   GNOME: Settings → Keyboard → Custom Shortcuts → Add Shortcut
@@ -181,5 +429,36 @@ audio:
   #
   # Use 'nextalk audio' command to configure device
   input_device: default
+
+  # Capture target latency (ms, 5-200), typically 10 / 20 / 40
+  # Lower is more responsive but more likely to drop frames under load
+  # Check the granted latency with 'nextalk audio list'
+  target_latency_ms: 20
+
+  # Capture at the device's native rate/format (e.g. 48kHz stereo) and let Nextalk
+  # convert it to 16kHz mono, independent of the audio server's resampler settings;
+  # set to false to let the server convert
+  device_native_format: true
+
+  # Pre-roll length (ms, 0-1000), 0 disables it
+  # When enabled the microphone stays open while the capsule is hidden and only
+  # the most recent audio is kept in memory, then fed to the recognizer on
+  # activation so the first word is never clipped. The tray shows a notice while monitoring.
+  preroll_ms: 0
+
+  # Endpoint detection mode (Zipformer only): rules | hybrid
+  # rules: wait for a fixed trailing silence (about 1.2s) after speech
+  # hybrid: also run Silero VAD (requires the VAD model), ending clear speech after about 0.4s
+  endpoint_mode: rules
+
+  # Learn the end-of-speech silence (0.6-2.0s) from your own pauses while talking
+  # The statistics stay on this machine; set to false to keep a fixed 1.2s
+  adaptive_silence: true
+
+  # Type finalized text while still recording (requires Fcitx5)
+  # Words older than about 1s that stopped changing are committed right away;
+  # the rest is committed when recording stops. Single-pass Zipformer only
+  # (off with two_pass). Set to false to commit all text at stop
+  early_commit: true
 ''';
 }
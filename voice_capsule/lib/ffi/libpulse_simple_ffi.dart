@@ -24,6 +24,27 @@ final class PaSampleSpec extends Struct {
   external int channels;
 }
 
+/// pa_buffer_attr 结构体 (录音流只使用 maxlength 与 fragsize，其余填 -1)
+final class PaBufferAttr extends Struct {
+  @Uint32()
+  external int maxlength;
+
+  @Uint32()
+  external int tlength;
+
+  @Uint32()
+  external int prebuf;
+
+  @Uint32()
+  external int minreq;
+
+  @Uint32()
+  external int fragsize;
+}
+
+/// 缓冲属性中 "由服务器决定" 的取值 ((uint32_t) -1)
+const int PA_BUFFER_ATTR_DEFAULT = 0xFFFFFFFF;
+
 /// Opaque 类型
 final class PaSimple extends Opaque {}
 
@@ -37,7 +58,7 @@ typedef PaSimpleNewC = Pointer<PaSimple> Function(
   Pointer<Utf8> streamName,  // Stream name
   Pointer<PaSampleSpec> ss,  // Sample spec
   Pointer<Void> map,         // Channel map (NULL for default)
-  Pointer<Void> attr,        // Buffer attributes (NULL for default)
+  Pointer<PaBufferAttr> attr, // Buffer attributes (NULL for default)
   Pointer<Int32> error,      // Error code output
 );
 
@@ -50,6 +71,11 @@ typedef PaSimpleReadC = Int32 Function(
 
 typedef PaSimpleFreeC = Void Function(Pointer<PaSimple> s);
 
+typedef PaSimpleGetLatencyC = Uint64 Function(
+  Pointer<PaSimple> s,
+  Pointer<Int32> error,
+);
+
 typedef PaStrerrorC = Pointer<Utf8> Function(Int32 error);
 
 // ===== Dart 函数签名 =====
@@ -62,7 +88,7 @@ typedef PaSimpleNewDart = Pointer<PaSimple> Function(
   Pointer<Utf8> streamName,
   Pointer<PaSampleSpec> ss,
   Pointer<Void> map,
-  Pointer<Void> attr,
+  Pointer<PaBufferAttr> attr,
   Pointer<Int32> error,
 );
 
@@ -75,6 +101,11 @@ typedef PaSimpleReadDart = int Function(
 
 typedef PaSimpleFreeDart = void Function(Pointer<PaSimple> s);
 
+typedef PaSimpleGetLatencyDart = int Function(
+  Pointer<PaSimple> s,
+  Pointer<Int32> error,
+);
+
 typedef PaStrerrorDart = Pointer<Utf8> Function(int error);
 
 // ===== PulseAudio Simple 绑定类 =====
@@ -85,6 +116,7 @@ class LibPulseSimpleBindings {
   late final PaSimpleNewDart simpleNew;
   late final PaSimpleReadDart simpleRead;
   late final PaSimpleFreeDart simpleFree;
+  late final PaSimpleGetLatencyDart simpleGetLatency;
   late final PaStrerrorDart strerror;
 
   LibPulseSimpleBindings() {
@@ -93,6 +125,7 @@ class LibPulseSimpleBindings {
     simpleNew = _lib.lookupFunction<PaSimpleNewC, PaSimpleNewDart>('pa_simple_new');
     simpleRead = _lib.lookupFunction<PaSimpleReadC, PaSimpleReadDart>('pa_simple_read');
     simpleFree = _lib.lookupFunction<PaSimpleFreeC, PaSimpleFreeDart>('pa_simple_free');
+    simpleGetLatency = _lib.lookupFunction<PaSimpleGetLatencyC, PaSimpleGetLatencyDart>('pa_simple_get_latency');
     strerror = _lib.lookupFunction<PaStrerrorC, PaStrerrorDart>('pa_strerror');
   }
 
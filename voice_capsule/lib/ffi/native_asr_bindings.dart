@@ -0,0 +1,117 @@
+// ignore_for_file: constant_identifier_names
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+
+import 'nextalk_native_ffi.dart';
+
+// ===== 错误码 (与 nextalk_asr.h 保持一致) =====
+const int NEXTALK_ASR_OK = 0;
+const int NEXTALK_ASR_ERR_LIBRARY = -1;
+const int NEXTALK_ASR_ERR_STATE = -2;
+
+/// Opaque 类型
+final class NextalkAsrWorkerHandle extends Opaque {}
+
+/// 识别结果增量 (对应 NextalkAsrUpdate)
+final class NextalkAsrUpdate extends Struct {
+  @Int64()
+  external int generation;
+
+  @Int32()
+  external int kept;
+
+  @Int32()
+  external int count;
+
+  external Pointer<Utf8> text;
+
+  external Pointer<Pointer<Utf8>> tokens;
+
+  external Pointer<Float> timestamps;
+
+  /// 产生该结果时已送入识别器的累计样本数
+  @Int64()
+  external int samples;
+}
+
+// ===== C 函数签名 =====
+
+typedef AsrWorkerCreateC = Pointer<NextalkAsrWorkerHandle> Function(
+  Pointer<Void> recognizer,
+  Pointer<Void> stream,
+  Int32 sampleRate,
+);
+typedef AsrWorkerAcceptC = Int32 Function(
+  Pointer<NextalkAsrWorkerHandle> worker,
+  Pointer<Float> samples,
+  Int32 n,
+);
+typedef AsrWorkerFinishC = Int32 Function(
+  Pointer<NextalkAsrWorkerHandle> worker,
+  Int32 timeoutMs,
+);
+typedef AsrWorkerTakeUpdateC = Int32 Function(
+  Pointer<NextalkAsrWorkerHandle> worker,
+  Pointer<NextalkAsrUpdate> out,
+);
+typedef AsrWorkerVoidC = Void Function(Pointer<NextalkAsrWorkerHandle> worker);
+typedef AsrWorkerInt32C = Int32 Function(Pointer<NextalkAsrWorkerHandle> worker);
+typedef AsrWorkerInt64C = Int64 Function(Pointer<NextalkAsrWorkerHandle> worker);
+
+// ===== Dart 函数签名 =====
+
+typedef AsrWorkerCreateDart = Pointer<NextalkAsrWorkerHandle> Function(
+  Pointer<Void> recognizer,
+  Pointer<Void> stream,
+  int sampleRate,
+);
+typedef AsrWorkerAcceptDart = int Function(
+  Pointer<NextalkAsrWorkerHandle> worker,
+  Pointer<Float> samples,
+  int n,
+);
+typedef AsrWorkerFinishDart = int Function(
+  Pointer<NextalkAsrWorkerHandle> worker,
+  int timeoutMs,
+);
+typedef AsrWorkerTakeUpdateDart = int Function(
+  Pointer<NextalkAsrWorkerHandle> worker,
+  Pointer<NextalkAsrUpdate> out,
+);
+typedef AsrWorkerVoidDart = void Function(Pointer<NextalkAsrWorkerHandle> worker);
+typedef AsrWorkerInt32Dart = int Function(Pointer<NextalkAsrWorkerHandle> worker);
+typedef AsrWorkerInt64Dart = int Function(Pointer<NextalkAsrWorkerHandle> worker);
+
+// ===== 识别工作线程绑定类 =====
+
+class NativeAsrBindings {
+  late final DynamicLibrary _lib;
+
+  late final AsrWorkerCreateDart create;
+  late final AsrWorkerAcceptDart accept;
+  late final AsrWorkerVoidDart reset;
+  late final AsrWorkerFinishDart finish;
+  late final AsrWorkerInt32Dart drained;
+  late final AsrWorkerInt64Dart generation;
+  late final AsrWorkerTakeUpdateDart takeUpdate;
+  late final AsrWorkerInt32Dart isEndpoint;
+  late final AsrWorkerInt64Dart decodeNs;
+  late final AsrWorkerInt64Dart decodedFrames;
+  late final AsrWorkerVoidDart destroy;
+
+  NativeAsrBindings() {
+    _lib = loadNextalkNativeLibrary();
+
+    create = _lib.lookupFunction<AsrWorkerCreateC, AsrWorkerCreateDart>('nextalk_asr_worker_create');
+    accept = _lib.lookupFunction<AsrWorkerAcceptC, AsrWorkerAcceptDart>('nextalk_asr_worker_accept');
+    reset = _lib.lookupFunction<AsrWorkerVoidC, AsrWorkerVoidDart>('nextalk_asr_worker_reset');
+    finish = _lib.lookupFunction<AsrWorkerFinishC, AsrWorkerFinishDart>('nextalk_asr_worker_finish');
+    drained = _lib.lookupFunction<AsrWorkerInt32C, AsrWorkerInt32Dart>('nextalk_asr_worker_drained');
+    generation = _lib.lookupFunction<AsrWorkerInt64C, AsrWorkerInt64Dart>('nextalk_asr_worker_generation');
+    takeUpdate = _lib.lookupFunction<AsrWorkerTakeUpdateC, AsrWorkerTakeUpdateDart>('nextalk_asr_worker_take_update');
+    isEndpoint = _lib.lookupFunction<AsrWorkerInt32C, AsrWorkerInt32Dart>('nextalk_asr_worker_is_endpoint');
+    decodeNs = _lib.lookupFunction<AsrWorkerInt64C, AsrWorkerInt64Dart>('nextalk_asr_worker_decode_ns');
+    decodedFrames = _lib.lookupFunction<AsrWorkerInt64C, AsrWorkerInt64Dart>('nextalk_asr_worker_decoded_frames');
+    destroy = _lib.lookupFunction<AsrWorkerVoidC, AsrWorkerVoidDart>('nextalk_asr_worker_destroy');
+  }
+}
@@ -0,0 +1,219 @@
+// ignore_for_file: constant_identifier_names
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+
+import 'nextalk_native_ffi.dart';
+
+// ===== 错误码 (与 nextalk_capture.h 保持一致) =====
+const int NEXTALK_CAPTURE_OK = 0;
+const int NEXTALK_CAPTURE_ERR_LIBRARY = -1;
+const int NEXTALK_CAPTURE_ERR_OPEN = -2;
+const int NEXTALK_CAPTURE_ERR_START = -3;
+const int NEXTALK_CAPTURE_ERR_READ = -4;
+const int NEXTALK_CAPTURE_ERR_DEVICE_LOST = -5;
+const int NEXTALK_CAPTURE_ERR_STATE = -6;
+
+/// Opaque 类型
+final class NextalkCaptureHandle extends Opaque {}
+
+/// 电平快照 (对应 NextalkLevels)
+final class NextalkLevels extends Struct {
+  @Double()
+  external double energy;
+
+  @Int64()
+  external int frames;
+
+  @Int64()
+  external int blocks;
+
+  @Float()
+  external double rms;
+
+  @Float()
+  external double peak;
+
+  @Float()
+  external double centroidHz;
+}
+
+// ===== C 函数签名 =====
+
+/// 唤醒回调: 参数为可读帧数，< 0 表示采集线程出错
+typedef NextalkNotifyC = Void Function(Int64 available);
+
+typedef CaptureCreateC = Pointer<NextalkCaptureHandle> Function(
+  Int32 sampleRate,
+  Int32 channels,
+  Int32 ringFrames,
+  Int32 blockFrames,
+);
+typedef CaptureOpenPulseC = Int32 Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<Utf8> device,
+  Int32 targetLatencyMs,
+);
+typedef CaptureOpenPortAudioC = Int32 Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Int32 deviceIndex,
+  Double suggestedLatency,
+);
+typedef CaptureSetFlagC = Void Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Int32 enabled,
+);
+typedef CaptureArmNotifyAtC = Void Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Int32 minFrames,
+);
+typedef CaptureStartC = Int32 Function(Pointer<NextalkCaptureHandle> capture);
+typedef CaptureVoidC = Void Function(Pointer<NextalkCaptureHandle> capture);
+typedef CaptureReadC = Int32 Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<Float> dst,
+  Int32 maxFrames,
+);
+typedef CaptureReadTimestampedC = Int32 Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<Float> dst,
+  Int32 maxFrames,
+  Pointer<Int64> captureTimeNs,
+);
+typedef CaptureClockC = Int64 Function();
+typedef CaptureTrimC = Int32 Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Int32 keepFrames,
+);
+typedef CaptureLevelsC = Int32 Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<NextalkLevels> out,
+);
+typedef CaptureInt32C = Int32 Function(Pointer<NextalkCaptureHandle> capture);
+typedef CaptureInt64C = Int64 Function(Pointer<NextalkCaptureHandle> capture);
+typedef CaptureSetNotifyC = Void Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<NativeFunction<NextalkNotifyC>> fn,
+);
+typedef CaptureErrorTextC = Int32 Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<Utf8> buf,
+  Int32 bufLen,
+);
+
+// ===== Dart 函数签名 =====
+
+typedef CaptureCreateDart = Pointer<NextalkCaptureHandle> Function(
+  int sampleRate,
+  int channels,
+  int ringFrames,
+  int blockFrames,
+);
+typedef CaptureOpenPulseDart = int Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<Utf8> device,
+  int targetLatencyMs,
+);
+typedef CaptureOpenPortAudioDart = int Function(
+  Pointer<NextalkCaptureHandle> capture,
+  int deviceIndex,
+  double suggestedLatency,
+);
+typedef CaptureSetFlagDart = void Function(
+  Pointer<NextalkCaptureHandle> capture,
+  int enabled,
+);
+typedef CaptureArmNotifyAtDart = void Function(
+  Pointer<NextalkCaptureHandle> capture,
+  int minFrames,
+);
+typedef CaptureStartDart = int Function(Pointer<NextalkCaptureHandle> capture);
+typedef CaptureVoidDart = void Function(Pointer<NextalkCaptureHandle> capture);
+typedef CaptureReadDart = int Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<Float> dst,
+  int maxFrames,
+);
+typedef CaptureReadTimestampedDart = int Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<Float> dst,
+  int maxFrames,
+  Pointer<Int64> captureTimeNs,
+);
+typedef CaptureClockDart = int Function();
+typedef CaptureTrimDart = int Function(
+  Pointer<NextalkCaptureHandle> capture,
+  int keepFrames,
+);
+typedef CaptureLevelsDart = int Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<NextalkLevels> out,
+);
+typedef CaptureInt32Dart = int Function(Pointer<NextalkCaptureHandle> capture);
+typedef CaptureInt64Dart = int Function(Pointer<NextalkCaptureHandle> capture);
+typedef CaptureSetNotifyDart = void Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<NativeFunction<NextalkNotifyC>> fn,
+);
+typedef CaptureErrorTextDart = int Function(
+  Pointer<NextalkCaptureHandle> capture,
+  Pointer<Utf8> buf,
+  int bufLen,
+);
+
+// ===== 原生采集绑定类 =====
+
+class NativeCaptureBindings {
+  late final DynamicLibrary _lib;
+
+  late final CaptureCreateDart create;
+  late final CaptureSetFlagDart setDeviceNative;
+  late final CaptureOpenPulseDart openPulse;
+  late final CaptureOpenPortAudioDart openPortAudio;
+  late final CaptureStartDart start;
+  late final CaptureVoidDart stop;
+  late final CaptureReadDart read;
+  late final CaptureReadTimestampedDart readTimestamped;
+  late final CaptureClockDart clockNs;
+  late final CaptureInt32Dart available;
+  late final CaptureTrimDart trim;
+  late final CaptureLevelsDart levels;
+  late final CaptureSetNotifyDart setNotify;
+  late final CaptureVoidDart armNotify;
+  late final CaptureArmNotifyAtDart armNotifyAt;
+  late final CaptureInt32Dart lastError;
+  late final CaptureErrorTextDart errorText;
+  late final CaptureInt64Dart overruns;
+  late final CaptureInt32Dart isRealtime;
+  late final CaptureInt64Dart grantedLatencyUs;
+  late final CaptureInt64Dart latencyUs;
+  late final CaptureInt32Dart deviceRate;
+  late final CaptureVoidDart destroy;
+
+  NativeCaptureBindings() {
+    _lib = loadNextalkNativeLibrary();
+
+    create = _lib.lookupFunction<CaptureCreateC, CaptureCreateDart>('nextalk_capture_create');
+    setDeviceNative = _lib.lookupFunction<CaptureSetFlagC, CaptureSetFlagDart>('nextalk_capture_set_device_native');
+    openPulse = _lib.lookupFunction<CaptureOpenPulseC, CaptureOpenPulseDart>('nextalk_capture_open_pulse');
+    openPortAudio = _lib.lookupFunction<CaptureOpenPortAudioC, CaptureOpenPortAudioDart>('nextalk_capture_open_portaudio');
+    start = _lib.lookupFunction<CaptureStartC, CaptureStartDart>('nextalk_capture_start');
+    stop = _lib.lookupFunction<CaptureVoidC, CaptureVoidDart>('nextalk_capture_stop');
+    read = _lib.lookupFunction<CaptureReadC, CaptureReadDart>('nextalk_capture_read');
+    readTimestamped = _lib.lookupFunction<CaptureReadTimestampedC, CaptureReadTimestampedDart>('nextalk_capture_read_timestamped');
+    clockNs = _lib.lookupFunction<CaptureClockC, CaptureClockDart>('nextalk_capture_clock_ns');
+    available = _lib.lookupFunction<CaptureInt32C, CaptureInt32Dart>('nextalk_capture_available');
+    trim = _lib.lookupFunction<CaptureTrimC, CaptureTrimDart>('nextalk_capture_trim');
+    levels = _lib.lookupFunction<CaptureLevelsC, CaptureLevelsDart>('nextalk_capture_levels');
+    setNotify = _lib.lookupFunction<CaptureSetNotifyC, CaptureSetNotifyDart>('nextalk_capture_set_notify');
+    armNotify = _lib.lookupFunction<CaptureVoidC, CaptureVoidDart>('nextalk_capture_arm_notify');
+    armNotifyAt = _lib.lookupFunction<CaptureArmNotifyAtC, CaptureArmNotifyAtDart>('nextalk_capture_arm_notify_at');
+    lastError = _lib.lookupFunction<CaptureInt32C, CaptureInt32Dart>('nextalk_capture_last_error');
+    errorText = _lib.lookupFunction<CaptureErrorTextC, CaptureErrorTextDart>('nextalk_capture_error_text');
+    overruns = _lib.lookupFunction<CaptureInt64C, CaptureInt64Dart>('nextalk_capture_overruns');
+    isRealtime = _lib.lookupFunction<CaptureInt32C, CaptureInt32Dart>('nextalk_capture_is_realtime');
+    grantedLatencyUs = _lib.lookupFunction<CaptureInt64C, CaptureInt64Dart>('nextalk_capture_granted_latency_us');
+    latencyUs = _lib.lookupFunction<CaptureInt64C, CaptureInt64Dart>('nextalk_capture_latency_us');
+    deviceRate = _lib.lookupFunction<CaptureInt32C, CaptureInt32Dart>('nextalk_capture_device_rate');
+    destroy = _lib.lookupFunction<CaptureVoidC, CaptureVoidDart>('nextalk_capture_destroy');
+  }
+}
@@ -0,0 +1,124 @@
+// ignore_for_file: constant_identifier_names
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+
+import 'native_asr_bindings.dart';
+import 'nextalk_native_ffi.dart';
+
+// ===== 错误码 (与 nextalk_host.h 保持一致) =====
+const int NEXTALK_HOST_OK = 0;
+const int NEXTALK_HOST_ERR_CONNECT = -1;
+const int NEXTALK_HOST_ERR_LIBRARY = -2;
+const int NEXTALK_HOST_ERR_MODEL = -3;
+const int NEXTALK_HOST_ERR_STATE = -4;
+
+/// Opaque 类型
+final class NextalkHostClientHandle extends Opaque {}
+
+// ===== C 函数签名 =====
+
+typedef HostConnectC = Pointer<NextalkHostClientHandle> Function(
+  Pointer<Utf8> socketPath,
+  Pointer<Utf8> hostExe,
+  Int32 idleTimeoutSec,
+  Int32 timeoutMs,
+);
+typedef HostLoadC = Int32 Function(
+  Pointer<NextalkHostClientHandle> client,
+  Pointer<Utf8> config,
+  Int32 timeoutMs,
+);
+typedef HostErrorC = Pointer<Utf8> Function(
+    Pointer<NextalkHostClientHandle> client);
+typedef HostAcceptC = Int32 Function(
+  Pointer<NextalkHostClientHandle> client,
+  Pointer<Float> samples,
+  Int32 n,
+);
+typedef HostFinishC = Int32 Function(
+  Pointer<NextalkHostClientHandle> client,
+  Int32 timeoutMs,
+);
+typedef HostTakeUpdateC = Int32 Function(
+  Pointer<NextalkHostClientHandle> client,
+  Pointer<NextalkAsrUpdate> out,
+);
+typedef HostVoidC = Void Function(Pointer<NextalkHostClientHandle> client);
+typedef HostInt32C = Int32 Function(Pointer<NextalkHostClientHandle> client);
+typedef HostInt64C = Int64 Function(Pointer<NextalkHostClientHandle> client);
+
+// ===== Dart 函数签名 =====
+
+typedef HostConnectDart = Pointer<NextalkHostClientHandle> Function(
+  Pointer<Utf8> socketPath,
+  Pointer<Utf8> hostExe,
+  int idleTimeoutSec,
+  int timeoutMs,
+);
+typedef HostLoadDart = int Function(
+  Pointer<NextalkHostClientHandle> client,
+  Pointer<Utf8> config,
+  int timeoutMs,
+);
+typedef HostErrorDart = Pointer<Utf8> Function(
+    Pointer<NextalkHostClientHandle> client);
+typedef HostAcceptDart = int Function(
+  Pointer<NextalkHostClientHandle> client,
+  Pointer<Float> samples,
+  int n,
+);
+typedef HostFinishDart = int Function(
+  Pointer<NextalkHostClientHandle> client,
+  int timeoutMs,
+);
+typedef HostTakeUpdateDart = int Function(
+  Pointer<NextalkHostClientHandle> client,
+  Pointer<NextalkAsrUpdate> out,
+);
+typedef HostVoidDart = void Function(Pointer<NextalkHostClientHandle> client);
+typedef HostInt32Dart = int Function(Pointer<NextalkHostClientHandle> client);
+typedef HostInt64Dart = int Function(Pointer<NextalkHostClientHandle> client);
+
+// ===== 识别宿主客户端绑定类 =====
+
+class NativeHostBindings {
+  late final DynamicLibrary _lib;
+
+  late final HostConnectDart connect;
+  late final HostLoadDart load;
+  late final HostInt64Dart loadNs;
+  late final HostInt32Dart loadReused;
+  late final HostErrorDart error;
+  late final HostAcceptDart accept;
+  late final HostVoidDart reset;
+  late final HostFinishDart finish;
+  late final HostInt32Dart drained;
+  late final HostInt64Dart generation;
+  late final HostTakeUpdateDart takeUpdate;
+  late final HostInt32Dart isEndpoint;
+  late final HostInt64Dart decodeNs;
+  late final HostInt64Dart decodedFrames;
+  late final HostInt32Dart alive;
+  late final HostVoidDart disconnect;
+
+  NativeHostBindings() {
+    _lib = loadNextalkNativeLibrary();
+
+    connect = _lib.lookupFunction<HostConnectC, HostConnectDart>('nextalk_host_connect');
+    load = _lib.lookupFunction<HostLoadC, HostLoadDart>('nextalk_host_load');
+    loadNs = _lib.lookupFunction<HostInt64C, HostInt64Dart>('nextalk_host_load_ns');
+    loadReused = _lib.lookupFunction<HostInt32C, HostInt32Dart>('nextalk_host_load_reused');
+    error = _lib.lookupFunction<HostErrorC, HostErrorDart>('nextalk_host_error');
+    accept = _lib.lookupFunction<HostAcceptC, HostAcceptDart>('nextalk_host_accept');
+    reset = _lib.lookupFunction<HostVoidC, HostVoidDart>('nextalk_host_reset');
+    finish = _lib.lookupFunction<HostFinishC, HostFinishDart>('nextalk_host_finish');
+    drained = _lib.lookupFunction<HostInt32C, HostInt32Dart>('nextalk_host_drained');
+    generation = _lib.lookupFunction<HostInt64C, HostInt64Dart>('nextalk_host_generation');
+    takeUpdate = _lib.lookupFunction<HostTakeUpdateC, HostTakeUpdateDart>('nextalk_host_take_update');
+    isEndpoint = _lib.lookupFunction<HostInt32C, HostInt32Dart>('nextalk_host_is_endpoint');
+    decodeNs = _lib.lookupFunction<HostInt64C, HostInt64Dart>('nextalk_host_decode_ns');
+    decodedFrames = _lib.lookupFunction<HostInt64C, HostInt64Dart>('nextalk_host_decoded_frames');
+    alive = _lib.lookupFunction<HostInt32C, HostInt32Dart>('nextalk_host_alive');
+    disconnect = _lib.lookupFunction<HostVoidC, HostVoidDart>('nextalk_host_disconnect');
+  }
+}
@@ -0,0 +1,44 @@
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+
+import 'nextalk_native_ffi.dart';
+
+// ===== C 函数签名 =====
+
+typedef MemoryTrimC = Int32 Function();
+typedef MemoryPrefetchC = Int64 Function(Pointer<Utf8> path);
+typedef MemoryPrewarmC = Int64 Function(
+  Pointer<Pointer<Utf8>> paths,
+  Int32 count,
+  Pointer<Int64> residentBefore,
+);
+
+// ===== Dart 函数签名 =====
+
+typedef MemoryTrimDart = int Function();
+typedef MemoryPrefetchDart = int Function(Pointer<Utf8> path);
+typedef MemoryPrewarmDart = int Function(
+  Pointer<Pointer<Utf8>> paths,
+  int count,
+  Pointer<Int64> residentBefore,
+);
+
+// ===== 模型内存驻留绑定类 =====
+
+class NativeMemoryBindings {
+  late final DynamicLibrary _lib;
+
+  late final MemoryTrimDart trim;
+  late final MemoryPrefetchDart prefetch;
+  late final MemoryPrefetchDart resident;
+  late final MemoryPrewarmDart prewarm;
+
+  NativeMemoryBindings() {
+    _lib = loadNextalkNativeLibrary();
+
+    trim = _lib.lookupFunction<MemoryTrimC, MemoryTrimDart>('nextalk_memory_trim');
+    prefetch = _lib.lookupFunction<MemoryPrefetchC, MemoryPrefetchDart>('nextalk_memory_prefetch');
+    resident = _lib.lookupFunction<MemoryPrefetchC, MemoryPrefetchDart>('nextalk_memory_resident');
+    prewarm = _lib.lookupFunction<MemoryPrewarmC, MemoryPrewarmDart>('nextalk_memory_prewarm');
+  }
+}
@@ -0,0 +1,159 @@
+// ignore_for_file: constant_identifier_names
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+
+import 'nextalk_native_ffi.dart';
+
+// ===== 错误码 (与 nextalk_offline.h 保持一致) =====
+const int NEXTALK_OFFLINE_OK = 0;
+const int NEXTALK_OFFLINE_ERR_LIBRARY = -1;
+const int NEXTALK_OFFLINE_ERR_STATE = -2;
+
+/// Opaque 类型
+final class NextalkOfflineDecoderHandle extends Opaque {}
+
+/// 一次解码的结果 (对应 NextalkOfflineResult)
+final class NextalkOfflineResult extends Struct {
+  @Int64()
+  external int tag;
+
+  @Int64()
+  external int decodeNs;
+
+  @Int32()
+  external int samples;
+
+  @Int32()
+  external int count;
+
+  external Pointer<Utf8> text;
+
+  external Pointer<Utf8> lang;
+
+  external Pointer<Utf8> emotion;
+
+  external Pointer<Pointer<Utf8>> tokens;
+
+  external Pointer<Float> timestamps;
+
+  @Int32()
+  external int batch;
+
+  @Int32()
+  external int tokenBytes;
+
+  external Pointer<Uint8> tokenData;
+
+  @Int32()
+  external int allocs;
+}
+
+// ===== C 函数签名 =====
+
+typedef OfflineDecoderCreateC = Pointer<NextalkOfflineDecoderHandle> Function(
+  Pointer<Void> recognizer,
+  Int32 sampleRate,
+  Int32 segmentThreads,
+);
+typedef OfflineDecoderSubmitC = Int32 Function(
+  Pointer<NextalkOfflineDecoderHandle> decoder,
+  Int64 tag,
+  Pointer<Float> samples,
+  Int32 n,
+);
+typedef OfflineDecoderSubmitSegmentC = Int64 Function(
+  Pointer<NextalkOfflineDecoderHandle> decoder,
+  Pointer<Float> samples,
+  Int32 n,
+);
+typedef OfflineDecoderSetBatchC = Void Function(
+  Pointer<NextalkOfflineDecoderHandle> decoder,
+  Int32 maxSegments,
+  Int32 maxSamples,
+  Int32 waitMs,
+);
+typedef OfflineDecoderWaitC = Int32 Function(
+  Pointer<NextalkOfflineDecoderHandle> decoder,
+  Int32 timeoutMs,
+);
+typedef OfflineDecoderTakeC = Int32 Function(
+  Pointer<NextalkOfflineDecoderHandle> decoder,
+  Pointer<NextalkOfflineResult> out,
+);
+typedef OfflineDecoderVoidC = Void Function(
+    Pointer<NextalkOfflineDecoderHandle> decoder);
+typedef OfflineDecoderInt32C = Int32 Function(
+    Pointer<NextalkOfflineDecoderHandle> decoder);
+
+// ===== Dart 函数签名 =====
+
+typedef OfflineDecoderCreateDart = Pointer<NextalkOfflineDecoderHandle> Function(
+  Pointer<Void> recognizer,
+  int sampleRate,
+  int segmentThreads,
+);
+typedef OfflineDecoderSubmitDart = int Function(
+  Pointer<NextalkOfflineDecoderHandle> decoder,
+  int tag,
+  Pointer<Float> samples,
+  int n,
+);
+typedef OfflineDecoderSubmitSegmentDart = int Function(
+  Pointer<NextalkOfflineDecoderHandle> decoder,
+  Pointer<Float> samples,
+  int n,
+);
+typedef OfflineDecoderSetBatchDart = void Function(
+  Pointer<NextalkOfflineDecoderHandle> decoder,
+  int maxSegments,
+  int maxSamples,
+  int waitMs,
+);
+typedef OfflineDecoderWaitDart = int Function(
+  Pointer<NextalkOfflineDecoderHandle> decoder,
+  int timeoutMs,
+);
+typedef OfflineDecoderTakeDart = int Function(
+  Pointer<NextalkOfflineDecoderHandle> decoder,
+  Pointer<NextalkOfflineResult> out,
+);
+typedef OfflineDecoderVoidDart = void Function(
+    Pointer<NextalkOfflineDecoderHandle> decoder);
+typedef OfflineDecoderInt32Dart = int Function(
+    Pointer<NextalkOfflineDecoderHandle> decoder);
+
+// ===== 离线后台解码绑定类 =====
+
+class NativeOfflineBindings {
+  late final DynamicLibrary _lib;
+
+  late final OfflineDecoderCreateDart create;
+  late final OfflineDecoderSubmitDart submitPartial;
+  late final OfflineDecoderVoidDart cancelPartial;
+  late final OfflineDecoderInt32Dart partialBusy;
+  late final OfflineDecoderTakeDart takePartial;
+  late final OfflineDecoderSubmitSegmentDart submitSegment;
+  late final OfflineDecoderSetBatchDart setSegmentBatch;
+  late final OfflineDecoderTakeDart takeSegment;
+  late final OfflineDecoderInt32Dart pendingSegments;
+  late final OfflineDecoderWaitDart waitSegments;
+  late final OfflineDecoderVoidDart cancelSegments;
+  late final OfflineDecoderVoidDart destroy;
+
+  NativeOfflineBindings() {
+    _lib = loadNextalkNativeLibrary();
+
+    create = _lib.lookupFunction<OfflineDecoderCreateC, OfflineDecoderCreateDart>('nextalk_offline_decoder_create');
+    submitPartial = _lib.lookupFunction<OfflineDecoderSubmitC, OfflineDecoderSubmitDart>('nextalk_offline_decoder_submit_partial');
+    cancelPartial = _lib.lookupFunction<OfflineDecoderVoidC, OfflineDecoderVoidDart>('nextalk_offline_decoder_cancel_partial');
+    partialBusy = _lib.lookupFunction<OfflineDecoderInt32C, OfflineDecoderInt32Dart>('nextalk_offline_decoder_partial_busy');
+    takePartial = _lib.lookupFunction<OfflineDecoderTakeC, OfflineDecoderTakeDart>('nextalk_offline_decoder_take_partial');
+    submitSegment = _lib.lookupFunction<OfflineDecoderSubmitSegmentC, OfflineDecoderSubmitSegmentDart>('nextalk_offline_decoder_submit_segment');
+    setSegmentBatch = _lib.lookupFunction<OfflineDecoderSetBatchC, OfflineDecoderSetBatchDart>('nextalk_offline_decoder_set_segment_batch');
+    takeSegment = _lib.lookupFunction<OfflineDecoderTakeC, OfflineDecoderTakeDart>('nextalk_offline_decoder_take_segment');
+    pendingSegments = _lib.lookupFunction<OfflineDecoderInt32C, OfflineDecoderInt32Dart>('nextalk_offline_decoder_pending_segments');
+    waitSegments = _lib.lookupFunction<OfflineDecoderWaitC, OfflineDecoderWaitDart>('nextalk_offline_decoder_wait_segments');
+    cancelSegments = _lib.lookupFunction<OfflineDecoderVoidC, OfflineDecoderVoidDart>('nextalk_offline_decoder_cancel_segments');
+    destroy = _lib.lookupFunction<OfflineDecoderVoidC, OfflineDecoderVoidDart>('nextalk_offline_decoder_destroy');
+  }
+}
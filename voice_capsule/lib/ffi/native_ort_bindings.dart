@@ -0,0 +1,51 @@
+// ignore_for_file: constant_identifier_names
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+
+import 'nextalk_native_ffi.dart';
+
+// ===== 错误码 (与 nextalk_ort.h 保持一致) =====
+const int NEXTALK_ORT_OK = 0;
+const int NEXTALK_ORT_ERR_LIBRARY = -1;
+const int NEXTALK_ORT_ERR_MODEL = -2;
+const int NEXTALK_ORT_ERR_IO = -3;
+
+// ===== C 函数签名 =====
+
+typedef OrtStringC = Pointer<Utf8> Function();
+typedef OrtOptimizeC = Int32 Function(
+  Pointer<Utf8> src,
+  Pointer<Utf8> dst,
+  Pointer<Utf8> error,
+  Int32 errorLen,
+);
+
+// ===== Dart 函数签名 =====
+
+typedef OrtStringDart = Pointer<Utf8> Function();
+typedef OrtOptimizeDart = int Function(
+  Pointer<Utf8> src,
+  Pointer<Utf8> dst,
+  Pointer<Utf8> error,
+  int errorLen,
+);
+
+// ===== ONNX Runtime 优化模型缓存绑定类 =====
+
+class NativeOrtBindings {
+  late final DynamicLibrary _lib;
+
+  late final OrtStringDart version;
+  late final OrtStringDart cpuFeatures;
+  late final OrtStringDart providers;
+  late final OrtOptimizeDart optimize;
+
+  NativeOrtBindings() {
+    _lib = loadNextalkNativeLibrary();
+
+    version = _lib.lookupFunction<OrtStringC, OrtStringDart>('nextalk_ort_version');
+    cpuFeatures = _lib.lookupFunction<OrtStringC, OrtStringDart>('nextalk_ort_cpu_features');
+    providers = _lib.lookupFunction<OrtStringC, OrtStringDart>('nextalk_ort_providers');
+    optimize = _lib.lookupFunction<OrtOptimizeC, OrtOptimizeDart>('nextalk_ort_optimize');
+  }
+}
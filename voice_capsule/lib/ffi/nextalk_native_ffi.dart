@@ -0,0 +1,74 @@
+/// Nextalk 原生辅助库 (libnextalk_native.so) 加载入口
+///
+/// 原生库随应用 bundle 安装到 lib 目录，缺失时调用方回退到纯 Dart 实现。
+library;
+
+import 'dart:ffi';
+import 'dart:io';
+
+import 'package:path/path.dart' as path;
+
+/// 原生库加载异常
+class NextalkNativeLibraryException implements Exception {
+  final String message;
+  NextalkNativeLibraryException(this.message);
+
+  @override
+  String toString() => 'NextalkNativeLibraryException: $message';
+}
+
+/// 缓存的库实例 (避免重复加载)
+DynamicLibrary? _cachedLibrary;
+
+/// 加载 Nextalk 原生库 (Linux 专用)
+///
+/// 搜索顺序与 [loadSherpaLibrary] 一致:
+/// 1. 基于可执行文件路径的 lib 目录
+/// 2. libnextalk_native.so (RPATH, $ORIGIN/lib)
+/// 3. ./lib/libnextalk_native.so (相对路径)
+///
+/// Throws [NextalkNativeLibraryException] if library cannot be loaded.
+DynamicLibrary loadNextalkNativeLibrary() {
+  if (_cachedLibrary != null) {
+    return _cachedLibrary!;
+  }
+
+  if (!Platform.isLinux) {
+    throw NextalkNativeLibraryException('仅支持 Linux 平台');
+  }
+
+  final exeDir = path.dirname(Platform.resolvedExecutable);
+  final bundleLibPath = path.join(exeDir, 'lib', 'libnextalk_native.so');
+
+  final searchPaths = [
+    bundleLibPath, // 基于可执行文件路径 (最可靠)
+    'libnextalk_native.so', // RPATH ($ORIGIN/lib)
+    './lib/libnextalk_native.so', // 相对路径
+  ];
+
+  for (final libPath in searchPaths) {
+    try {
+      _cachedLibrary = DynamicLibrary.open(libPath);
+      // ignore: avoid_print
+      print('[NextalkNative] ✅ 库加载成功: $libPath');
+      return _cachedLibrary!;
+    } catch (e) {
+      // 继续尝试下一个路径
+    }
+  }
+
+  throw NextalkNativeLibraryException(
+    '无法加载 libnextalk_native.so，搜索路径:\n'
+    '${searchPaths.map((p) => "  - $p").join("\n")}',
+  );
+}
+
+/// 检查原生库是否可用
+bool isNextalkNativeAvailable() {
+  try {
+    loadNextalkNativeLibrary();
+    return true;
+  } catch (_) {
+    return false;
+  }
+}
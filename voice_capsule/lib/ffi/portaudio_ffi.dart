@@ -49,6 +49,17 @@ final class PaDeviceInfo extends Struct {
   external double defaultSampleRate;
 }
 
+final class PaStreamInfo extends Struct {
+  @Int32()
+  external int structVersion;
+  @Double()
+  external double inputLatency;
+  @Double()
+  external double outputLatency;
+  @Double()
+  external double sampleRate;
+}
+
 // ===== FFI 类型签名 (C 类型) =====
 typedef PaInitializeC = Int32 Function();
 typedef PaTerminateC = Int32 Function();
@@ -64,6 +75,7 @@ typedef PaReadStreamC = Int32 Function(
   Uint32 frames,
 );
 typedef PaGetErrorTextC = Pointer<Utf8> Function(Int32 errorCode);
+typedef PaGetStreamInfoC = Pointer<PaStreamInfo> Function(Pointer<Void> stream);
 
 // Pa_OpenStream 完整签名
 typedef PaOpenStreamC = Int32 Function(
@@ -92,6 +104,9 @@ typedef PaReadStreamDart = int Function(
   int frames,
 );
 typedef PaGetErrorTextDart = Pointer<Utf8> Function(int errorCode);
+typedef PaGetStreamInfoDart = Pointer<PaStreamInfo> Function(
+  Pointer<Void> stream,
+);
 
 typedef PaOpenStreamDart = int Function(
   Pointer<Pointer<Void>> stream,
@@ -118,6 +133,7 @@ class PortAudioBindings {
   late final PaStopStreamDart stopStream;
   late final PaReadStreamDart readStream;
   late final PaGetErrorTextDart getErrorText;
+  late final PaGetStreamInfoDart getStreamInfo;
 
   PortAudioBindings() {
     _lib = _openPortAudio();
@@ -152,6 +168,9 @@ class PortAudioBindings {
     getErrorText = _lib.lookupFunction<PaGetErrorTextC, PaGetErrorTextDart>(
       'Pa_GetErrorText',
     );
+    getStreamInfo = _lib.lookupFunction<PaGetStreamInfoC, PaGetStreamInfoDart>(
+      'Pa_GetStreamInfo',
+    );
   }
 
   /// 回退逻辑: 兼容不同发行版
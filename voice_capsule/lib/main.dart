@@ -8,20 +8,28 @@ import 'constants/settings_constants.dart';
 import 'services/asr/asr_engine.dart';
 import 'services/asr/asr_engine_factory.dart';
 import 'services/asr/engine_initializer.dart';
+import 'services/asr/sensevoice_engine.dart';
+import 'services/asr/two_pass_engine.dart';
+import 'services/asr/zipformer_engine.dart';
 import 'services/audio_capture.dart';
 import 'services/audio_inference_pipeline.dart';
+import 'services/cpu_profile.dart';
 import 'services/fcitx_client.dart';
 import 'services/hotkey_controller.dart';
 import 'services/hotkey_service.dart';
 import 'services/language_service.dart';
 import 'services/model_manager.dart';
+import 'services/ort_model_cache.dart';
 import 'services/settings_service.dart';
 import 'services/single_instance.dart';
+import 'services/thread_calibrator.dart';
 import 'services/tray_service.dart';
 import 'services/window_service.dart';
 import 'state/capsule_state.dart';
 import 'utils/diagnostic_logger.dart';
 import 'cli/audio_command.dart';
+import 'cli/bench_command.dart';
+import 'cli/prewarm_command.dart';
 
 /// Nextalk Voice Capsule 入口
 /// Story 3-6: 完整业务流串联
@@ -42,6 +50,8 @@ ASREngineType _toASREngineType(EngineType type) {
 /// 支持的命令：
 /// help: 显示帮助信息
 /// audio [...]: 音频设备配置命令 (Story 3-9)
+/// bench <wav> [...]: 分块策略基准测试
+/// prewarm [--status]: 把模型文件读入页缓存
 /// --toggle: 切换窗口/录音状态
 /// --show: 显示窗口并开始录音
 /// --hide: 隐藏窗口并停止录音
@@ -73,6 +83,20 @@ Future<bool> _handleCommandLineArgs(List<String> args) async {
     exit(exitCode);
   }
 
+  // 分块策略基准测试
+  if (command == 'bench') {
+    final subArgs = args.length > 1 ? args.sublist(1) : <String>[];
+    final exitCode = await BenchCommand.execute(subArgs);
+    exit(exitCode);
+  }
+
+  // 模型文件页缓存预热
+  if (command == 'prewarm') {
+    final subArgs = args.length > 1 ? args.sublist(1) : <String>[];
+    final exitCode = await PrewarmCommand.execute(subArgs);
+    exit(exitCode);
+  }
+
   // 检查是否是命令参数
   if (command == '--toggle' || command == '--show' || command == '--hide') {
     final cmdName = command.substring(2); // 移除 '--' 前缀
@@ -119,6 +143,13 @@ Nextalk - Linux 离线语音输入
   nextalk help               显示此帮助
   nextalk version            显示版本信息
   nextalk audio [子命令]      音频设备配置
+  nextalk bench <wav>        比较分块策略的首字延迟与 CPU 开销
+  nextalk bench --segments <wav>  SenseVoice 语音段解码吞吐 (按线程数)
+  nextalk bench --batch <wav>     SenseVoice 合批解码 RTF (按批大小)
+  nextalk bench --alloc <wav>     SenseVoice 每段原生堆分配次数
+  nextalk bench --two-pass <wav>  两遍识别与单引擎的延迟和错误率
+  nextalk bench --calibrate       校准并保存推理线程数
+  nextalk prewarm            把模型文件读入页缓存 (可加入会话自启动)
 
   nextalk --toggle           切换窗口/录音状态
   nextalk --show             显示窗口并开始录音
@@ -151,30 +182,177 @@ void _printVersion() {
 ///
 /// 在应用启动时预先初始化引擎，触发 onnxruntime JIT 编译，
 /// 避免第一次录音时因编译延迟导致丢失语音。
-Future<void> _preInitializeEngine(ModelManager modelManager) async {
-  if (_asrEngine == null || !_asrEngine!.isInitialized) {
-    // 根据引擎类型创建配置
-    ASRConfig config;
-    if (_asrEngine!.engineType == ASREngineType.zipformer) {
-      config = ZipformerConfig(
-        modelDir: modelManager.modelPath,
-        useInt8Model: SettingsService.instance.modelType == ModelType.int8,
-      );
-    } else {
-      config = SenseVoiceConfig(
-        modelDir: modelManager.getModelPathForEngine(EngineType.sensevoice),
-        vadModelPath: modelManager.vadModelFilePath,
-      );
+/// 由 Pipeline 按录音时的配置 (含端点规则) 创建识别器，首次录音可直接复用。
+Future<void> _preInitializeEngine() async {
+  final pipeline = _pipeline;
+  if (pipeline == null || _asrEngine == null || _asrEngine!.isInitialized) {
+    return;
+  }
+  final error = await pipeline.warmUp();
+  if (error == ASRError.none) {
+    DiagnosticLogger.instance.info('main', '✅ ASR 引擎预初始化完成');
+  } else {
+    DiagnosticLogger.instance.warn('main', '⚠️ ASR 引擎预初始化失败: $error');
+  }
+}
+
+/// 记录识别器创建耗时，并为未命中缓存的模型在后台生成优化副本
+void _traceRecognizerInit(
+    ModelManager modelManager, (int resident, int total)? pageCache) {
+  final engine = _asrEngine;
+  final initTime = switch (engine) {
+    TwoPassEngine e => e.recognizerInitTime,
+    ZipformerEngine e => e.recognizerInitTime,
+    SenseVoiceEngine e => e.recognizerInitTime,
+    _ => null,
+  };
+  if (initTime == null) return;
+
+  final cache = OrtModelCache.instance;
+  final missed = cache.missed.length;
+  final state = !cache.enabled
+      ? '缓存已关闭'
+      : missed == 0 && cache.hits > 0
+          ? 'warm, 命中 ${cache.hits}'
+          : 'cold, 命中 ${cache.hits}/未命中 $missed';
+  // 常驻识别宿主中复用已加载模型时，耗时不含模型加载
+  final hostReused = switch (engine) {
+    TwoPassEngine e => e.reusedHostModel,
+    ZipformerEngine e => e.reusedHostModel,
+    _ => null,
+  };
+  final host = hostReused == null
+      ? ''
+      : hostReused
+          ? ', 识别宿主复用模型'
+          : ', 识别宿主加载模型';
+  // 启动时模型文件的页缓存状态 (登录后首次启动通常为冷)
+  final disk = switch (pageCache) {
+    (final resident, final total) when total > 0 =>
+      ', 页缓存 ${resident >= total ? 'warm' : 'cold'} ${resident * 100 ~/ total}%',
+    _ => '',
+  };
+  DiagnosticLogger.instance.info(
+    'main',
+    '识别器创建耗时: ${initTime.inMilliseconds}ms ($state$host$disk)',
+  );
+  if (missed == 0) return;
+
+  unawaited(modelManager.cacheOptimizedModels().then((results) {
+    for (final r in results) {
+      if (r.ok) {
+        DiagnosticLogger.instance.info('main',
+            '已缓存优化模型: ${r.source} (${r.elapsed.inMilliseconds}ms, 下次启动生效)');
+      } else {
+        DiagnosticLogger.instance
+            .warn('main', '优化模型失败: ${r.source} (${r.code}) ${r.error}');
+      }
     }
+  }));
+}
 
-    // 预初始化引擎
-    final error = await _asrEngine!.initialize(config);
-    if (error == ASRError.none) {
-      DiagnosticLogger.instance.info('main', '✅ ASR 引擎预初始化完成');
-    } else {
-      DiagnosticLogger.instance.warn('main', '⚠️ ASR 引擎预初始化失败: $error');
+/// CPU 特性与据此选择的模型版本、执行提供者和推理线程数 (诊断用)
+String _inferenceStatus() {
+  final settings = SettingsService.instance;
+  final cpu = CpuProfile.current;
+  final engine = settings.actualEngineType;
+  final modelSource =
+      settings.modelTypeAuto ? '自动, ${cpu.modelTypeReason}' : '用户指定';
+  final threadSource = settings.numThreadsConfigured(engine)
+      ? '用户指定'
+      : settings.threadCalibration.threadsFor(engine) != null
+          ? '校准'
+          : '默认';
+  return [
+    'CPU: $cpu',
+    '模型版本: ${settings.modelType.name} ($modelSource)',
+    '执行提供者: ${settings.provider} '
+        '(${settings.providerAuto ? '自动' : '用户指定'})',
+    '推理线程数: ${settings.numThreadsFor(engine)} ($threadSource)',
+  ].join('\n');
+}
+
+/// 流水线空闲多久后开始后台校准推理线程数 (避开启动与连续录音)
+const _threadCalibrationDelay = Duration(seconds: 30);
+
+/// 当前引擎尚未校准推理线程数时，在流水线空闲时于后台校准一次
+///
+/// 结果写入设置，下次创建识别器 (下次启动或空闲卸载后重新加载) 时生效；
+/// 配置文件中固定了 num_threads 的引擎不校准。校准与录音争用 CPU，
+/// 因此只在流水线空闲 [_threadCalibrationDelay] 后开始，开始录音即中止，
+/// 回到空闲后重新计时。
+void _scheduleThreadCalibration(ModelManager modelManager) {
+  final settings = SettingsService.instance;
+  final engine = settings.actualEngineType;
+  if (settings.numThreadsConfigured(engine) ||
+      settings.threadCalibration.threadsFor(engine) != null) {
+    return;
+  }
+  final pipeline = _pipeline;
+  if (pipeline == null) return;
+
+  Timer? timer;
+  Completer<void>? abort;
+  StreamSubscription<PipelineState>? subscription;
+
+  void finish() {
+    timer?.cancel();
+    subscription?.cancel();
+  }
+
+  Future<void> run() async {
+    timer = null;
+    if (pipeline.state != PipelineState.idle) return;
+    if (abort != null) {
+      // 上一轮中止后仍在释放识别器，稍后再试
+      timer = Timer(_threadCalibrationDelay, run);
+      return;
+    }
+    final aborted = abort = Completer<void>();
+    try {
+      final result = await ThreadCalibrator.calibrate(
+        modelManager,
+        engine,
+        useInt8: settings.modelType == ModelType.int8,
+        provider: settings.provider,
+        abortWhen: aborted.future,
+      );
+      if (aborted.isCompleted) {
+        DiagnosticLogger.instance.info('main', '推理线程数校准因开始录音中止，空闲后重试');
+        return;
+      }
+      finish();
+      if (result == null) {
+        DiagnosticLogger.instance.warn('main', '推理线程数校准跳过: 缺少模型或测试音频');
+        return;
+      }
+      final (threads, timings) = result;
+      await settings.saveThreadCalibration(
+          settings.threadCalibration.withResult(engine, threads));
+      DiagnosticLogger.instance.info(
+          'main',
+          '推理线程数校准 (${engine.name}): $threads 线程, 下次启动生效 '
+              '[${timings.join('; ')}]');
+    } catch (e) {
+      finish();
+      DiagnosticLogger.instance.warn('main', '推理线程数校准失败: $e');
+    } finally {
+      abort = null;
     }
   }
+
+  // 录音开始: 取消计时并中止正在进行的校准；回到空闲: 重新计时
+  subscription = pipeline.stateStream.listen((state) {
+    timer?.cancel();
+    timer = null;
+    if (state == PipelineState.idle) {
+      timer = Timer(_threadCalibrationDelay, run);
+      return;
+    }
+    final pending = abort;
+    if (pending != null && !pending.isCompleted) pending.complete();
+  });
+  timer = Timer(_threadCalibrationDelay, run);
 }
 
 /// 全局状态控制器 (用于 UI 更新)
@@ -227,7 +405,10 @@ Future<void> main(List<String> args) async {
 
     // 2. 初始化设置服务 (必须在托盘服务之前)
     await SettingsService.instance.initialize();
+    OrtModelCache.instance.enabled = SettingsService.instance.ortModelCache;
     DiagnosticLogger.instance.info('main', '设置服务初始化完成');
+    DiagnosticLogger.instance.inferenceStatusProvider = _inferenceStatus;
+    DiagnosticLogger.instance.info('main', '推理后端: ${_inferenceStatus().replaceAll('\n', ', ')}');
 
     // Story 3-8: 初始化语言服务 (必须在托盘服务之前)
     await LanguageService.instance.initialize();
@@ -255,15 +436,51 @@ Future<void> main(List<String> args) async {
       // 暂时跳过，允许应用启动
     }
 
+    // 5.1 以空闲 I/O 优先级预热模型文件，与后续初始化并行，首次创建识别器不必冷读磁盘
+    // 预热前先记下页缓存状态，区分冷/热启动的识别器创建耗时
+    final modelFiles = modelManager.activeModelFiles;
+    final pageCache = modelManager.pageCacheResidency(modelFiles);
+    if (modelFiles.isNotEmpty && pageCache != null) {
+      unawaited(modelManager.prewarmModelFiles(modelFiles).then(
+            (r) => DiagnosticLogger.instance.info('main', '预热模型文件: $r'),
+            onError: (Object e) =>
+                DiagnosticLogger.instance.warn('main', '预热模型文件失败: $e'),
+          ));
+    }
+
     // 6. 创建服务实例 (即使模型未就绪也创建，便于后续初始化)
     _audioCapture = AudioCapture();
 
     // 6.1 Story 3-9: 预热音频设备，使用配置的设备名称 (AC2, AC3)
     final configuredDevice = SettingsService.instance.audioInputDevice;
+    _audioCapture!.targetLatencyMs =
+        SettingsService.instance.audioTargetLatencyMs;
+    _audioCapture!.deviceNativeFormat =
+        SettingsService.instance.audioDeviceNativeFormat;
+    // 呼吸/波纹动画跟随原生侧计算的电平 (非原生采集时为 null，保持固定节奏)
+    AnimationTickerService.instance.levelSource =
+        () => _audioCapture?.levels?.dbfs;
+    DiagnosticLogger.instance.audioStatusProvider =
+        () => _audioCapture?.latencyReport.toString() ?? '(未初始化)';
     final warmupError = await _audioCapture!.warmup(deviceName: configuredDevice);
     String? audioErrorDetail;
     if (warmupError == AudioCaptureError.none) {
-      DiagnosticLogger.instance.info('main', '✅ 音频设备预热完成');
+      DiagnosticLogger.instance.info(
+        'main',
+        '✅ 音频设备预热完成 (${_audioCapture!.latencyReport})',
+      );
+      // 预录模式 (用户在配置中主动开启): 隐藏时保持监听，托盘显示隐私提示
+      final prerollMs = SettingsService.instance.audioPrerollMs;
+      if (prerollMs > 0 && !TrayService.instance.isInitialized) {
+        DiagnosticLogger.instance.warn('main', '⚠️ 托盘不可用，无法显示麦克风监听提示，预录模式未开启');
+      } else if (prerollMs > 0) {
+        if (_audioCapture!.arm(prerollMs)) {
+          DiagnosticLogger.instance.info('main', '🎙️ 预录模式已开启 (${prerollMs}ms)');
+          await TrayService.instance.setMicMonitoring(prerollMs);
+        } else {
+          DiagnosticLogger.instance.warn('main', '⚠️ 预录模式不可用 (需要原生采集线程)');
+        }
+      }
       // Story 3-9 AC18: 检测设备回退
       if (_audioCapture!.lastDeviceFallback) {
         DiagnosticLogger.instance.warn('main', '⚠️ 配置的设备不存在，已回退到默认设备');
@@ -333,14 +550,25 @@ Future<void> main(List<String> args) async {
       asrEngine: _asrEngine!,
       modelManager: modelManager,
       enableDebugLog: false,
-      vadConfig: const VadConfig(
+      idleUnloadAfter: SettingsService.instance.idleUnloadAfter,
+      onResidencyEvent: (message) =>
+          DiagnosticLogger.instance.info('pipeline', message),
+      vadConfig: VadConfig(
         autoStopOnEndpoint: false, // 不自动停止，等待用户松开按钮
         autoReset: false, // 不重置，跨停顿累积文本
+        endpointMode: SettingsService.instance.audioEndpointMode,
+        adaptiveSilence: SettingsService.instance.audioAdaptiveSilence,
       ),
     );
+    DiagnosticLogger.instance.endpointStatusProvider =
+        () => _pipeline?.endpointStatus ?? '(未初始化)';
+    DiagnosticLogger.instance.memoryStatusProvider =
+        () => _pipeline?.residencyStatus ?? '(未初始化)';
 
     // 7.1 预初始化 ASR 引擎 (触发 onnxruntime JIT 编译，避免第一次录音延迟)
-    await _preInitializeEngine(modelManager);
+    await _preInitializeEngine();
+    _traceRecognizerInit(modelManager, pageCache);
+    _scheduleThreadCalibration(modelManager);
 
 
     // 8. 创建 FcitxClient (延迟连接)
@@ -421,7 +649,7 @@ Future<void> main(List<String> args) async {
         DiagnosticLogger.instance.info('main', '切换 ASR 引擎: $newEngineType');
 
         // 创建新引擎实例
-        final newEngine = ASREngineFactory.create(_toASREngineType(newEngineType), enableDebugLog: false);
+        final newEngine = EngineInitializer(modelManager).createEngine(newEngineType);
 
         // 切换引擎 (销毁旧引擎，使用新引擎)
         await _pipeline!.switchEngine(newEngine);
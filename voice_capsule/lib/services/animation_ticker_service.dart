@@ -9,6 +9,7 @@ import '../constants/animation_constants.dart';
 ///
 /// 使用单例模式，所有动画组件共享同一个 ticker，
 /// 即使窗口隐藏，ticker 也持续运行。
+/// 录音时每帧从 [levelSource] 读取原生侧算好的电平，呼吸与波纹随语音起伏。
 class AnimationTickerService {
   AnimationTickerService._();
   static final AnimationTickerService instance = AnimationTickerService._();
@@ -16,6 +17,10 @@ class AnimationTickerService {
   Ticker? _ticker;
   Duration _elapsed = Duration.zero;
   bool _isRunning = false;
+  double _voiceLevel = 0.0;
+
+  /// 语音电平来源 (dBFS)，返回 null 表示当前未录音；由 main.dart 注入
+  double? Function()? levelSource;
 
   /// 呼吸动画周期 (毫秒)
   int get _breathingPeriodMs => AnimationConstants.breathingPeriod.inMilliseconds;
@@ -33,11 +38,22 @@ class AnimationTickerService {
     return ms / _breathingPeriodMs;
   }
 
-  /// 获取呼吸缩放值 (已计算好的 scale)
+  /// 平滑后的语音电平 [0.0, 1.0]，未录音时回落到 0
+  double get voiceLevel => _voiceLevel;
+
+  /// 获取呼吸缩放值 (已计算好的 scale)，说话时随电平放大
   double get breathingScale {
     final normalizedSin = (1 + math.sin(breathingValue * 2 * math.pi)) / 2;
     return AnimationConstants.breathingBaseScale +
-        AnimationConstants.breathingAmplitude * normalizedSin;
+        AnimationConstants.breathingAmplitude * normalizedSin +
+        AnimationConstants.breathingVoiceAmplitude * _voiceLevel;
+  }
+
+  /// 将 dBFS 映射到 [0.0, 1.0]
+  static double levelFromDbfs(double dbfs) {
+    const floor = AnimationConstants.voiceLevelFloorDb;
+    const ceil = AnimationConstants.voiceLevelCeilDb;
+    return ((dbfs - floor) / (ceil - floor)).clamp(0.0, 1.0);
   }
 
   /// 获取波纹动画当前值 [0.0, 1.0]，支持多层波纹偏移
@@ -59,7 +75,22 @@ class AnimationTickerService {
   }
 
   void _onTick(Duration elapsed) {
+    final delta = elapsed - _elapsed;
     _elapsed = elapsed;
+    _updateVoiceLevel(delta);
+  }
+
+  /// 一阶平滑: 上升快、回落慢
+  void _updateVoiceLevel(Duration delta) {
+    final dbfs = levelSource?.call();
+    final target = dbfs != null ? levelFromDbfs(dbfs) : 0.0;
+    if (target == _voiceLevel) return;
+    final tau = target > _voiceLevel
+        ? AnimationConstants.voiceLevelAttack
+        : AnimationConstants.voiceLevelRelease;
+    final alpha =
+        1 - math.exp(-delta.inMicroseconds / tau.inMicroseconds.toDouble());
+    _voiceLevel += (target - _voiceLevel) * alpha;
   }
 
   /// 停止 ticker (应用退出时调用)
@@ -69,5 +100,6 @@ class AnimationTickerService {
     _ticker = null;
     _isRunning = false;
     _elapsed = Duration.zero;
+    _voiceLevel = 0.0;
   }
 }
@@ -1,4 +1,6 @@
+import 'dart:convert';
 import 'dart:ffi';
+import 'dart:typed_data';
 
 /// ASR 引擎类型枚举
 enum ASREngineType {
@@ -133,6 +135,27 @@ class SenseVoiceConfig extends ASRConfig {
   /// provider
   final String provider;
 
+  /// 未结束语音段的中间解码间隔 (毫秒)，0 表示只在语音段结束时输出
+  final int partialIntervalMs;
+
+  /// 中间解码允许占用的计算比例 (解码耗时 / 音频时长)
+  final double partialMaxLoad;
+
+  /// 已结束语音段的并发解码线程数，0 表示按 CPU 核数自动选择
+  final int segmentThreads;
+
+  /// 自动选择时的线程数上限 (语音段通常只有几个同时排队)
+  static const int maxAutoSegmentThreads = 4;
+
+  /// 排队的语音段每批最多合并解码的段数，1 表示逐段解码
+  final int segmentBatchSize;
+
+  /// 不足一批时等待后续语音段的时间 (毫秒)，0 表示只合并已排队的语音段
+  final int segmentBatchWaitMs;
+
+  /// 每批语音段的总时长上限 (秒)，批内按最长段补齐，过长浪费计算
+  static const double maxSegmentBatchSec = 30.0;
+
   const SenseVoiceConfig({
     required super.modelDir,
     required this.vadModelPath,
@@ -146,8 +169,23 @@ class SenseVoiceConfig extends ASRConfig {
     this.maxSpeechDuration = 10.0,
     this.vadWindowSize = 512,
     this.provider = 'cpu',
+    this.partialIntervalMs = 500,
+    this.partialMaxLoad = 0.5,
+    this.segmentThreads = 0,
+    this.segmentBatchSize = 4,
+    this.segmentBatchWaitMs = 0,
   });
 
+  /// 实际使用的语音段解码线程数
+  ///
+  /// 每个线程的一次解码会占用 [numThreads] 个 onnxruntime 线程，
+  /// 自动选择时按 [cores] / [numThreads] 取值，限制在 1 至 [maxAutoSegmentThreads]。
+  int resolvedSegmentThreads(int cores) {
+    if (segmentThreads > 0) return segmentThreads;
+    final perDecode = numThreads > 0 ? numThreads : 1;
+    return (cores ~/ perDecode).clamp(1, maxAutoSegmentThreads);
+  }
+
   @override
   String toString() {
     return 'SenseVoiceConfig(modelDir: $modelDir, vadModelPath: $vadModelPath, '
@@ -155,6 +193,76 @@ class SenseVoiceConfig extends ASRConfig {
   }
 }
 
+/// 整块拷贝的 token ('\0' 分隔的 UTF-8)
+///
+/// 离线识别每段都有 token，但多数结果只读取文本；整块拷贝只需一次分配，
+/// 首次读取 [tokens] 时才拆分为字符串列表。
+class PackedTokens {
+  final Uint8List _data;
+
+  /// token 数
+  final int count;
+
+  List<String>? _tokens;
+
+  PackedTokens(this._data, this.count);
+
+  /// 从原生内存拷贝 [bytes] 字节
+  factory PackedTokens.copy(Pointer<Uint8> data, int bytes, int count) {
+    if (data == nullptr || bytes <= 0 || count <= 0) {
+      return PackedTokens(Uint8List(0), 0);
+    }
+    return PackedTokens(Uint8List.fromList(data.asTypedList(bytes)), count);
+  }
+
+  /// 是否已拆分为字符串列表
+  bool get isMaterialized => _tokens != null;
+
+  /// token 列表
+  List<String> get tokens => _tokens ??= List.unmodifiable(_split(0, count));
+
+  /// 与 [other] 相同的前缀 token 数 (按字节比较，不拆分)
+  int commonPrefix(PackedTokens other) {
+    final limit =
+        _data.length < other._data.length ? _data.length : other._data.length;
+    final maxCount = count < other.count ? count : other.count;
+    var kept = 0;
+    for (var i = 0; i < limit && kept < maxCount; i++) {
+      if (_data[i] != other._data[i]) break;
+      if (_data[i] == 0) kept++;
+    }
+    return kept;
+  }
+
+  /// 第 [start] 个及之后的 token (未拆分时只拆分这一部分)
+  List<String> tokensFrom(int start) {
+    if (start <= 0) return tokens;
+    final cached = _tokens;
+    if (cached != null) return cached.sublist(start);
+    var offset = 0;
+    var skipped = 0;
+    while (offset < _data.length && skipped < start) {
+      if (_data[offset] == 0) skipped++;
+      offset++;
+    }
+    return _split(offset, count - skipped);
+  }
+
+  /// 从字节 [offset] 起拆分至多 [limit] 个 token
+  List<String> _split(int offset, int limit) {
+    final out = <String>[];
+    var start = offset;
+    for (var i = offset; i < _data.length && out.length < limit; i++) {
+      if (_data[i] == 0) {
+        out.add(utf8.decode(Uint8List.sublistView(_data, start, i),
+            allowMalformed: true));
+        start = i + 1;
+      }
+    }
+    return out;
+  }
+}
+
 /// 统一 ASR 识别结果
 ///
 /// 适用于所有 ASR 引擎的统一结果格式。
@@ -170,8 +278,8 @@ class ASRResult {
   /// 情感标识 (SenseVoice: NEUTRAL/HAPPY/SAD/ANGRY, Zipformer: null)
   final String? emotion;
 
-  /// token 列表
-  final List<String> tokens;
+  final List<String> _tokens;
+  final PackedTokens? _packedTokens;
 
   /// 时间戳列表
   final List<double> timestamps;
@@ -180,9 +288,33 @@ class ASRResult {
     required this.text,
     this.lang,
     this.emotion,
-    this.tokens = const [],
+    List<String> tokens = const [],
     this.timestamps = const [],
-  });
+  })  : _tokens = tokens,
+        _packedTokens = null;
+
+  /// token 延迟拆分的结果 (由原生结果整块拷贝而来)
+  const ASRResult.packed({
+    required this.text,
+    this.lang,
+    this.emotion,
+    required PackedTokens tokens,
+    this.timestamps = const [],
+  })  : _tokens = const [],
+        _packedTokens = tokens;
+
+  const ASRResult._copy(this.text, this.lang, this.emotion, this._tokens,
+      this._packedTokens, this.timestamps);
+
+  /// token 列表 (延迟拆分的结果在首次读取时转换)
+  List<String> get tokens => _packedTokens?.tokens ?? _tokens;
+
+  /// token 数 (不触发转换)
+  int get tokenCount => _packedTokens?.count ?? _tokens.length;
+
+  /// 替换文本，保留其余字段 (不触发 token 转换)
+  ASRResult withText(String text) =>
+      ASRResult._copy(text, lang, emotion, _tokens, _packedTokens, timestamps);
 
   /// 创建空结果
   factory ASRResult.empty() => const ASRResult(text: '');
@@ -210,6 +342,97 @@ class ASRResult {
   int get hashCode => Object.hash(text, lang, emotion);
 }
 
+/// 识别结果增量
+///
+/// 相对上一次结果保留前 [keptTokens] 个 token (稳定前缀)，其后替换为
+/// [tokens]。流式识别时通常只是末尾追加或修正一两个 token。
+class ASRResultDelta {
+  /// 与上一次结果相同的前缀 token 数
+  final int keptTokens;
+
+  /// 第 [keptTokens] 个之后的 token
+  final List<String> tokens;
+
+  /// [tokens] 对应的时间戳
+  final List<double> timestamps;
+
+  /// 完整文本
+  final String text;
+
+  /// 语言标签 (SenseVoice)，与 [text] 一样随每次增量完整给出
+  final String? lang;
+
+  /// 情感标签 (SenseVoice)
+  final String? emotion;
+
+  const ASRResultDelta({
+    required this.keptTokens,
+    required this.tokens,
+    required this.timestamps,
+    required this.text,
+    this.lang,
+    this.emotion,
+  });
+
+  /// 更新后的 token 总数
+  int get tokenCount => keptTokens + tokens.length;
+
+  /// 是否只在末尾追加 (没有修改已输出的 token)
+  bool isAppendOnly(ASRResult previous) => keptTokens == previous.tokenCount;
+
+  /// 比较两次结果得到增量 (按 token 比较)
+  ///
+  /// 整块拷贝的 token 按字节比较前缀，只拆分 [next] 中变化的部分
+  factory ASRResultDelta.between(ASRResult previous, ASRResult next) {
+    final previousPacked = previous._packedTokens;
+    final nextPacked = next._packedTokens;
+    var kept = 0;
+    if (previous.tokenCount == 0 || next.tokenCount == 0) {
+      kept = 0;
+    } else if (previousPacked != null && nextPacked != null) {
+      kept = previousPacked.commonPrefix(nextPacked);
+    } else {
+      final a = previous.tokens;
+      final b = next.tokens;
+      final limit = a.length < b.length ? a.length : b.length;
+      while (kept < limit && a[kept] == b[kept]) {
+        kept++;
+      }
+    }
+    return ASRResultDelta(
+      keptTokens: kept,
+      tokens: nextPacked != null
+          ? nextPacked.tokensFrom(kept)
+          : next._tokens.sublist(kept),
+      timestamps: next.timestamps.length == next.tokenCount
+          ? next.timestamps.sublist(kept)
+          : const [],
+      text: next.text,
+      lang: next.lang,
+      emotion: next.emotion,
+    );
+  }
+
+  /// 应用到 [previous] 得到新结果
+  ASRResult applyTo(ASRResult previous) {
+    final kept = keptTokens.clamp(0, previous.tokens.length);
+    final keptTimestamps = previous.timestamps.length >= kept
+        ? previous.timestamps.sublist(0, kept)
+        : const <double>[];
+    return ASRResult(
+      text: text,
+      lang: lang,
+      emotion: emotion,
+      tokens: [...previous.tokens.sublist(0, kept), ...tokens],
+      timestamps: [...keptTimestamps, ...timestamps],
+    );
+  }
+
+  @override
+  String toString() =>
+      'ASRResultDelta(kept: $keptTokens, tokens: $tokens, text: "$text")';
+}
+
 /// ASR 引擎抽象接口
 ///
 /// 定义所有 ASR 引擎的统一接口，支持：
@@ -269,6 +492,12 @@ abstract class ASREngine {
   /// 标记输入结束
   void inputFinished();
 
+  /// 标记输入结束并等待已送入的音频解码完成
+  ///
+  /// 与 [inputFinished] 相同，但后台解码的引擎以轮询方式等待，
+  /// 不阻塞调用方 isolate。完成后 [getResult] 即为最终结果。
+  Future<void> finishInput();
+
   /// 释放资源
   void dispose();
 }
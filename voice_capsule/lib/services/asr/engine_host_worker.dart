@@ -0,0 +1,195 @@
+import 'dart:ffi';
+import 'dart:io';
+
+import 'package:ffi/ffi.dart';
+import 'package:path/path.dart' as path;
+
+import '../../ffi/native_asr_bindings.dart';
+import '../../ffi/native_host_bindings.dart';
+import 'asr_engine.dart';
+import 'native_asr_worker.dart';
+
+/// 常驻识别宿主 (nextalk_engine_host) 的位置与空闲退出时间
+class EngineHostOptions {
+  /// 宿主监听的 Unix 域套接字
+  final String socketPath;
+
+  /// 宿主可执行文件 (未运行时由客户端启动)
+  final String hostExecutable;
+
+  /// 没有客户端连接后，宿主保留已加载模型的时间
+  final Duration idleTimeout;
+
+  const EngineHostOptions({
+    required this.socketPath,
+    required this.hostExecutable,
+    this.idleTimeout = const Duration(minutes: 30),
+  });
+
+  /// 默认位置: 套接字位于 $XDG_RUNTIME_DIR/nextalk/，宿主与原生库同在 bundle 的 lib 目录
+  factory EngineHostOptions.standard({
+    Duration idleTimeout = const Duration(minutes: 30),
+  }) {
+    final runtimeDir = Platform.environment['XDG_RUNTIME_DIR'];
+    final base = runtimeDir != null && runtimeDir.isNotEmpty
+        ? runtimeDir
+        : Directory.systemTemp.path;
+    final exeDir = path.dirname(Platform.resolvedExecutable);
+    return EngineHostOptions(
+      socketPath: '$base/nextalk/engine-host.sock',
+      hostExecutable: path.join(exeDir, 'lib', 'nextalk_engine_host'),
+      idleTimeout: idleTimeout,
+    );
+  }
+}
+
+/// 识别宿主中的流式识别会话
+///
+/// 与 [NativeAsrWorker] 接口相同: 音频写入共享内存环，宿主解码后推送结果，
+/// 本进程只读取增量。宿主退出或崩溃时 [isAlive] 变为 false，
+/// 之后的音频被丢弃，由调用方重新连接 (会按需重新启动宿主)。
+class EngineHostWorker implements StreamingAsrWorker {
+  final NativeHostBindings _bindings;
+  final Pointer<NextalkHostClientHandle> _handle;
+  final Pointer<NextalkAsrUpdate> _update;
+
+  /// 在宿主中创建识别器与流的耗时
+  final Duration loadTime;
+
+  /// 是否复用了宿主中已加载的模型 (热启动)
+  final bool reusedModel;
+
+  int _readGeneration = 0;
+  int _resultSamples = 0;
+  bool _disposed = false;
+
+  EngineHostWorker._(
+      this._bindings, this._handle, this.loadTime, this.reusedModel)
+      : _update = calloc<NextalkAsrUpdate>();
+
+  /// 连接宿主 (未运行时启动) 并按 [config] 创建识别会话，失败返回 null
+  ///
+  /// [config] 为识别器配置 (key=value 行)，宿主中已有相同模型时直接复用。
+  /// [onError] 接收失败原因，供调用方记录后回退到本进程识别。
+  static EngineHostWorker? tryConnect(
+    EngineHostOptions options,
+    String config, {
+    Duration connectTimeout = const Duration(seconds: 3),
+    Duration loadTimeout = const Duration(seconds: 60),
+    void Function(String reason)? onError,
+  }) {
+    if (!File(options.hostExecutable).existsSync()) {
+      onError?.call('未找到 ${options.hostExecutable}');
+      return null;
+    }
+    final NativeHostBindings bindings;
+    try {
+      bindings = NativeHostBindings();
+      Directory(path.dirname(options.socketPath)).createSync(recursive: true);
+    } catch (e) {
+      onError?.call('$e');
+      return null;
+    }
+
+    final socketPtr = options.socketPath.toNativeUtf8();
+    final exePtr = options.hostExecutable.toNativeUtf8();
+    final handle = bindings.connect(socketPtr, exePtr,
+        options.idleTimeout.inSeconds, connectTimeout.inMilliseconds);
+    calloc.free(socketPtr);
+    calloc.free(exePtr);
+    if (handle == nullptr) {
+      onError?.call('无法连接识别宿主 ${options.socketPath}');
+      return null;
+    }
+
+    final configPtr = config.toNativeUtf8();
+    final rc = bindings.load(handle, configPtr, loadTimeout.inMilliseconds);
+    calloc.free(configPtr);
+    if (rc != NEXTALK_HOST_OK) {
+      final error = bindings.error(handle).toDartString();
+      onError?.call('宿主加载模型失败 ($rc)${error.isEmpty ? '' : ': $error'}');
+      bindings.disconnect(handle);
+      return null;
+    }
+    return EngineHostWorker._(
+      bindings,
+      handle,
+      Duration(microseconds: bindings.loadNs(handle) ~/ 1000),
+      bindings.loadReused(handle) == 1,
+    );
+  }
+
+  /// 与宿主的连接是否有效
+  bool get isAlive => !_disposed && _bindings.alive(_handle) == 1;
+
+  @override
+  void accept(Pointer<Float> samples, int n) {
+    if (_disposed) return;
+    _bindings.accept(_handle, samples, n);
+  }
+
+  @override
+  void reset() {
+    if (_disposed) return;
+    _bindings.reset(_handle);
+  }
+
+  @override
+  bool finish({Duration timeout = const Duration(seconds: 2)}) {
+    if (_disposed) return false;
+    return _bindings.finish(_handle, timeout.inMilliseconds) == 1;
+  }
+
+  @override
+  void requestFinish() {
+    if (_disposed) return;
+    _bindings.finish(_handle, 0);
+  }
+
+  /// 宿主断开后不会再有应答，视为完成
+  @override
+  bool get drained => _disposed || _bindings.drained(_handle) == 1;
+
+  @override
+  int get resultSamples => _resultSamples;
+
+  @override
+  bool get hasNewResult =>
+      !_disposed && _bindings.generation(_handle) != _readGeneration;
+
+  @override
+  ASRResultDelta? takeUpdate() {
+    if (!hasNewResult) return null;
+    if (_bindings.takeUpdate(_handle, _update) != 1) return null;
+    final u = _update.ref;
+    _readGeneration = u.generation;
+    _resultSamples = u.samples;
+    return ASRResultDelta(
+      keptTokens: u.kept,
+      tokens: List.generate(u.count, (i) => u.tokens[i].toDartString()),
+      timestamps: List.generate(u.count, (i) => u.timestamps[i]),
+      text: u.text.toDartString(),
+    );
+  }
+
+  @override
+  bool get isEndpoint => !_disposed && _bindings.isEndpoint(_handle) == 1;
+
+  /// 宿主中本会话累计解码耗时
+  @override
+  Duration get decodeTime => _disposed
+      ? Duration.zero
+      : Duration(microseconds: _bindings.decodeNs(_handle) ~/ 1000);
+
+  @override
+  int get decodedSamples => _disposed ? 0 : _bindings.decodedFrames(_handle);
+
+  /// 断开连接，宿主中的模型保留到空闲超时
+  @override
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    _bindings.disconnect(_handle);
+    calloc.free(_update);
+  }
+}
@@ -5,8 +5,12 @@ import 'package:flutter/foundation.dart';
 import '../../constants/settings_constants.dart';
 import '../language_service.dart';
 import '../model_manager.dart';
+import '../settings_service.dart';
 import 'asr_engine.dart';
 import 'asr_engine_factory.dart';
+import 'engine_host_worker.dart';
+import 'two_pass_engine.dart';
+import 'zipformer_engine.dart';
 
 /// Story 2-7: 引擎初始化结果
 class EngineInitResult {
@@ -135,15 +139,54 @@ class EngineInitializer {
 
     // 创建引擎实例
     try {
-      final asrType = _toASREngineType(type);
-      final engine = ASREngineFactory.create(asrType, enableDebugLog: enableDebugLog);
-      return engine;
+      return createEngine(type, enableDebugLog: enableDebugLog);
     } catch (e) {
       debugPrint('[EngineInitializer] 创建引擎 $type 失败: $e');
       return null;
     }
   }
 
+  /// 创建指定类型的引擎实例 (不初始化)
+  ///
+  /// Zipformer 启用两遍识别且 SenseVoice 模型就绪时，创建 [TwoPassEngine]；
+  /// 启用常驻识别宿主时 Zipformer 在宿主进程中识别
+  ASREngine createEngine(EngineType type, {bool enableDebugLog = false}) {
+    final settings = SettingsService.instance;
+    final engineHost = settings.isInitialized && settings.engineHostEnabled
+        ? EngineHostOptions.standard(
+            idleTimeout: Duration(minutes: settings.engineHostIdleTimeoutMin))
+        : null;
+    if (type == EngineType.zipformer &&
+        settings.isInitialized &&
+        settings.twoPassEnabled &&
+        _modelManager.isEngineReady(EngineType.sensevoice)) {
+      return TwoPassEngine(
+        secondPass: SenseVoiceConfig(
+          modelDir: _modelManager.getModelPathForEngine(EngineType.sensevoice),
+          vadModelPath: _modelManager.vadModelFilePath,
+          numThreads: settings.twoPassNumThreads,
+          provider: settings.provider,
+          useItn: settings.senseVoiceUseItn,
+          language: settings.senseVoiceLanguage,
+          // 语音段由第一遍的端点切分，逐段在单个线程上解码
+          partialIntervalMs: 0,
+          segmentThreads: 1,
+          segmentBatchSize: 1,
+        ),
+        maxSegmentSec: settings.twoPassMaxSegmentSec,
+        maxWait: Duration(milliseconds: settings.twoPassMaxWaitMs),
+        enableDebugLog: enableDebugLog,
+        engineHost: engineHost,
+      );
+    }
+    if (type == EngineType.zipformer && engineHost != null) {
+      return ZipformerEngine(
+          enableDebugLog: enableDebugLog, engineHost: engineHost);
+    }
+    return ASREngineFactory.create(_toASREngineType(type),
+        enableDebugLog: enableDebugLog);
+  }
+
   /// 将 EngineType 转换为 ASREngineType
   ASREngineType _toASREngineType(EngineType type) {
     return switch (type) {
@@ -0,0 +1,165 @@
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import '../../ffi/native_asr_bindings.dart';
+import 'asr_engine.dart';
+
+/// 流式识别解码端: 本进程内的 [NativeAsrWorker] 或识别宿主进程中的会话
+///
+/// 送入音频只是入队，结果以增量形式读取，调用方不直接访问识别器与流。
+abstract interface class StreamingAsrWorker {
+  /// 送入音频 (拷贝后立即返回)
+  void accept(Pointer<Float> samples, int n);
+
+  /// 重置识别状态，已发布的结果立即清空
+  void reset();
+
+  /// 标记输入结束并等待解码完成，超时返回 false
+  bool finish({Duration timeout = const Duration(seconds: 2)});
+
+  /// 标记输入结束后立即返回，由 [drained] 轮询解码是否完成
+  void requestFinish();
+
+  /// 已送入的音频 (含结束标记) 是否全部解码完毕
+  bool get drained;
+
+  /// 自上次 [takeUpdate] 后结果是否变化
+  bool get hasNewResult;
+
+  /// 最近一次 [takeUpdate] 取到的结果覆盖的累计样本数 (与 [decodedSamples] 同一计数)
+  int get resultSamples;
+
+  /// 取自上次调用以来的结果增量，无变化时返回 null
+  ASRResultDelta? takeUpdate();
+
+  /// 最近一次解码后是否到达端点
+  bool get isEndpoint;
+
+  /// 累计解码耗时
+  Duration get decodeTime;
+
+  /// 累计送入识别器的样本数
+  int get decodedSamples;
+
+  /// 停止解码并释放资源
+  void dispose();
+}
+
+/// 原生流式识别工作线程 (libnextalk_native.so)
+///
+/// 接管 sherpa-onnx 在线识别器与流，解码在独立线程中进行:
+/// - [accept] 只拷贝音频入队，不在调用线程解码
+/// - 结果按 token id 比较，仅在变化时由工作线程发布；[takeUpdate] 只取
+///   相对上次读取的增量 (通常是末尾一两个 token)，未变化时不跨 FFI 拷贝
+/// - [finish] 等待已入队音频解码完成，用于取最终结果
+class NativeAsrWorker implements StreamingAsrWorker {
+  final NativeAsrBindings _bindings;
+  final Pointer<NextalkAsrWorkerHandle> _handle;
+  final Pointer<NextalkAsrUpdate> _update;
+
+  int _readGeneration = 0;
+  int _resultSamples = 0;
+  bool _disposed = false;
+
+  NativeAsrWorker._(this._bindings, this._handle)
+      : _update = calloc<NextalkAsrUpdate>();
+
+  /// 接管 [recognizer]/[stream] 创建工作线程，原生库不可用时返回 null
+  ///
+  /// 返回非 null 后，调用方在 [dispose] 之前不得再直接调用 sherpa 的流接口
+  static NativeAsrWorker? tryCreate(
+    Pointer<NativeType> recognizer,
+    Pointer<NativeType> stream, {
+    int sampleRate = 16000,
+  }) {
+    try {
+      final bindings = NativeAsrBindings();
+      final handle =
+          bindings.create(recognizer.cast(), stream.cast(), sampleRate);
+      if (handle == nullptr) return null;
+      return NativeAsrWorker._(bindings, handle);
+    } catch (_) {
+      return null;
+    }
+  }
+
+  /// 送入音频 (拷贝后立即返回)
+  @override
+  void accept(Pointer<Float> samples, int n) {
+    if (_disposed) return;
+    _bindings.accept(_handle, samples, n);
+  }
+
+  /// 重置识别状态，已发布的结果立即清空
+  @override
+  void reset() {
+    if (_disposed) return;
+    _bindings.reset(_handle);
+  }
+
+  /// 标记输入结束并等待解码完成，超时返回 false
+  @override
+  bool finish({Duration timeout = const Duration(seconds: 2)}) {
+    if (_disposed) return false;
+    return _bindings.finish(_handle, timeout.inMilliseconds) == 1;
+  }
+
+  @override
+  void requestFinish() {
+    if (_disposed) return;
+    _bindings.finish(_handle, 0);
+  }
+
+  @override
+  bool get drained => _disposed || _bindings.drained(_handle) == 1;
+
+  @override
+  int get resultSamples => _resultSamples;
+
+  /// 自上次 [takeUpdate] 后结果是否变化 (只读一个原子计数)
+  @override
+  bool get hasNewResult =>
+      !_disposed && _bindings.generation(_handle) != _readGeneration;
+
+  /// 取自上次调用以来的结果增量，无变化时返回 null
+  ///
+  /// [reset] 之后的第一次增量 keptTokens 为 0，调用方据此从空结果重建
+  @override
+  ASRResultDelta? takeUpdate() {
+    if (!hasNewResult) return null;
+    if (_bindings.takeUpdate(_handle, _update) != 1) return null;
+    final u = _update.ref;
+    _readGeneration = u.generation;
+    _resultSamples = u.samples;
+    return ASRResultDelta(
+      keptTokens: u.kept,
+      tokens: List.generate(u.count, (i) => u.tokens[i].toDartString()),
+      timestamps: List.generate(u.count, (i) => u.timestamps[i]),
+      text: u.text.toDartString(),
+    );
+  }
+
+  /// 最近一次解码后是否到达端点
+  @override
+  bool get isEndpoint => !_disposed && _bindings.isEndpoint(_handle) == 1;
+
+  /// 工作线程累计解码耗时
+  @override
+  Duration get decodeTime => _disposed
+      ? Duration.zero
+      : Duration(microseconds: _bindings.decodeNs(_handle) ~/ 1000);
+
+  /// 工作线程累计送入识别器的样本数
+  @override
+  int get decodedSamples => _disposed ? 0 : _bindings.decodedFrames(_handle);
+
+  /// 停止工作线程，识别器与流交还调用方
+  @override
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    _bindings.destroy(_handle);
+    calloc.free(_update);
+  }
+}
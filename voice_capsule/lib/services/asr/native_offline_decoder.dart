@@ -0,0 +1,170 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import '../../ffi/native_offline_bindings.dart';
+import 'asr_engine.dart';
+
+/// 一次后台离线解码的结果
+class OfflineDecodeResult {
+  /// 提交时的标签
+  final int tag;
+
+  /// 识别结果
+  final ASRResult result;
+
+  /// 解码耗时
+  final Duration decodeTime;
+
+  /// 解码的样本数
+  final int samples;
+
+  /// 同批解码的语音段数 ([decodeTime] 为整批耗时)
+  final int batch;
+
+  /// 原生侧为本结果新分配堆内存的次数 (缓冲复用时为 0)
+  final int allocs;
+
+  const OfflineDecodeResult({
+    required this.tag,
+    required this.result,
+    required this.decodeTime,
+    required this.samples,
+    this.batch = 1,
+    this.allocs = 0,
+  });
+}
+
+/// 原生离线后台解码器 (libnextalk_native.so)
+///
+/// 在后台线程上对提交的音频做离线识别，识别器仍由调用方持有:
+/// - [submitPartial] 只拷贝音频，尚未开始的旧请求被替换
+/// - [takePartial] 取最近完成的结果，按标签区分所属语音段
+/// - [submitSegment] 已结束的语音段交给线程池并发解码，
+///   [takeSegment] 按提交顺序取回
+class NativeOfflineDecoder {
+  final NativeOfflineBindings _bindings;
+  final Pointer<NextalkOfflineDecoderHandle> _handle;
+  final Pointer<NextalkOfflineResult> _result;
+
+  /// 语音段解码线程数
+  final int segmentThreads;
+
+  bool _disposed = false;
+
+  NativeOfflineDecoder._(this._bindings, this._handle, this.segmentThreads)
+      : _result = calloc<NextalkOfflineResult>();
+
+  /// 为 [recognizer] 创建后台解码线程与 [segmentThreads] 个语音段解码线程，
+  /// 原生库不可用时返回 null
+  static NativeOfflineDecoder? tryCreate(
+    Pointer<NativeType> recognizer, {
+    int sampleRate = 16000,
+    int segmentThreads = 1,
+  }) {
+    try {
+      final bindings = NativeOfflineBindings();
+      final handle =
+          bindings.create(recognizer.cast(), sampleRate, segmentThreads);
+      if (handle == nullptr) return null;
+      return NativeOfflineDecoder._(bindings, handle, segmentThreads);
+    } catch (_) {
+      return null;
+    }
+  }
+
+  /// 提交一次中间解码 (拷贝后立即返回)
+  void submitPartial(int tag, Pointer<Float> samples, int n) {
+    if (_disposed || n <= 0) return;
+    _bindings.submitPartial(_handle, tag, samples, n);
+  }
+
+  /// 丢弃排队中的请求与尚未读取的结果
+  void cancelPartial() {
+    if (_disposed) return;
+    _bindings.cancelPartial(_handle);
+  }
+
+  /// 是否有中间解码在排队或进行中
+  bool get isPartialBusy => !_disposed && _bindings.partialBusy(_handle) == 1;
+
+  /// 取最近完成的中间解码结果，无新结果时返回 null
+  OfflineDecodeResult? takePartial() {
+    if (_disposed || _bindings.takePartial(_handle, _result) != 1) return null;
+    return _readResult();
+  }
+
+  /// 提交一个已结束的语音段 (拷贝后立即返回)，返回其序号，失败返回 -1
+  int submitSegment(Pointer<Float> samples, int n) {
+    if (_disposed || n <= 0) return -1;
+    final seq = _bindings.submitSegment(_handle, samples, n);
+    return seq < 0 ? -1 : seq;
+  }
+
+  /// 设置语音段合批: 每批最多 [maxSegments] 段、共 [maxSamples] 个样本
+  /// (0 表示不限)，不足一批时最多等待 [wait]
+  void setSegmentBatch({
+    required int maxSegments,
+    int maxSamples = 0,
+    Duration wait = Duration.zero,
+  }) {
+    if (_disposed) return;
+    _bindings.setSegmentBatch(
+        _handle, maxSegments, maxSamples, wait.inMilliseconds);
+  }
+
+  /// 按提交顺序取下一个已解码的语音段 ([OfflineDecodeResult.tag] 为序号)，
+  /// 前面的语音段尚未解码完时返回 null
+  OfflineDecodeResult? takeSegment() {
+    if (_disposed || _bindings.takeSegment(_handle, _result) != 1) return null;
+    return _readResult();
+  }
+
+  /// 尚未取回的语音段数
+  int get pendingSegments =>
+      _disposed ? 0 : _bindings.pendingSegments(_handle);
+
+  /// 等待已提交的语音段全部解码完成，超时返回 false
+  bool waitSegments({Duration timeout = const Duration(seconds: 5)}) {
+    if (_disposed) return false;
+    return _bindings.waitSegments(_handle, timeout.inMilliseconds) == 1;
+  }
+
+  /// 丢弃全部未取回的语音段
+  void cancelSegments() {
+    if (_disposed) return;
+    _bindings.cancelSegments(_handle);
+  }
+
+  /// token 与时间戳各整块拷贝一次，token 列表在读取时才拆分
+  OfflineDecodeResult _readResult() {
+    final r = _result.ref;
+    final lang = r.lang.toDartString();
+    final emotion = r.emotion.toDartString();
+    return OfflineDecodeResult(
+      tag: r.tag,
+      result: ASRResult.packed(
+        text: r.text.toDartString().trim(),
+        lang: lang.isNotEmpty ? lang : null,
+        emotion: emotion.isNotEmpty ? emotion : null,
+        tokens: PackedTokens.copy(r.tokenData, r.tokenBytes, r.count),
+        timestamps: r.timestamps == nullptr
+            ? const []
+            : Float32List.fromList(r.timestamps.asTypedList(r.count)),
+      ),
+      decodeTime: Duration(microseconds: r.decodeNs ~/ 1000),
+      samples: r.samples,
+      batch: r.batch,
+      allocs: r.allocs,
+    );
+  }
+
+  /// 停止后台线程 (等待进行中的解码结束)，识别器交还调用方
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    _bindings.destroy(_handle);
+    calloc.free(_result);
+  }
+}
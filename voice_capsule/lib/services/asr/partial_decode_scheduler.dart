@@ -0,0 +1,80 @@
+/// SenseVoice 中间解码调度
+///
+/// 离线模型每次都要从头解码整个尚未结束的语音段，段越长单次越贵。
+/// 调度按送入的音频时长计时 (与实时录音同步，也便于测试):
+/// - 两次中间解码的提交间隔至少 [intervalMs]
+/// - 中间解码耗时不超过音频时长的 [maxLoad] 倍: 单次耗时 d 之后至少间隔 d / maxLoad
+/// - 同一时刻只有一次中间解码在进行
+class PartialDecodeScheduler {
+  /// 语音段短于此时不做中间解码 (内容太少，结果不稳定)
+  static const int minSegmentMs = 300;
+
+  /// 提交间隔 (毫秒)，0 表示关闭中间解码
+  final int intervalMs;
+
+  /// 中间解码允许占用的计算比例 (解码耗时 / 音频时长)
+  final double maxLoad;
+
+  final int sampleRate;
+
+  int _elapsedSamples = 0;
+  int _submittedAtMs = 0;
+  int _nextAtMs = 0;
+  bool _inFlight = false;
+
+  PartialDecodeScheduler({
+    required this.intervalMs,
+    required this.maxLoad,
+    this.sampleRate = 16000,
+  });
+
+  /// 是否启用中间解码
+  bool get enabled => intervalMs > 0 && maxLoad > 0;
+
+  /// 是否有中间解码在进行
+  bool get inFlight => _inFlight;
+
+  /// 已送入的音频时长 (毫秒)
+  int get elapsedMs => _elapsedSamples * 1000 ~/ sampleRate;
+
+  /// 送入 [samples] 个样本后推进时钟
+  void advance(int samples) {
+    _elapsedSamples += samples;
+  }
+
+  /// 当前是否应对长度为 [segmentSamples] 的未结束语音段提交中间解码
+  bool shouldSubmit(int segmentSamples) {
+    if (!enabled || _inFlight) return false;
+    if (segmentSamples * 1000 < minSegmentMs * sampleRate) return false;
+    return elapsedMs >= _nextAtMs;
+  }
+
+  /// 记录一次提交
+  void submitted() {
+    _inFlight = true;
+    _submittedAtMs = elapsedMs;
+    _nextAtMs = _submittedAtMs + intervalMs;
+  }
+
+  /// 记录一次解码完成，按耗时推迟下一次提交
+  void completed(Duration decodeTime) {
+    _inFlight = false;
+    final cooldownMs = (decodeTime.inMicroseconds / 1000 / maxLoad).ceil();
+    if (_submittedAtMs + cooldownMs > _nextAtMs) {
+      _nextAtMs = _submittedAtMs + cooldownMs;
+    }
+  }
+
+  /// 提交的解码被取消 (不会有结果)
+  void cancelled() {
+    _inFlight = false;
+  }
+
+  /// 回到初始状态 (新的一次录音)
+  void reset() {
+    _elapsedSamples = 0;
+    _submittedAtMs = 0;
+    _nextAtMs = 0;
+    _inFlight = false;
+  }
+}
@@ -5,16 +5,22 @@
 // 1. Silero VAD 检测语音活动
 // 2. VAD 检测到语音段后送入 SenseVoice 识别
 // 3. 识别结果通过同步接口返回
+// 4. 语音段尚未结束时在后台线程定期重新解码，先行给出中间结果
+// 5. 已结束的语音段交给原生线程池并发 (可合批) 解码，按顺序拼接结果
 
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:typed_data';
 
 import 'package:ffi/ffi.dart';
 
 import '../../ffi/sherpa_ffi.dart';
 import '../../ffi/sherpa_offline_bindings.dart';
 import '../../ffi/sherpa_vad_bindings.dart';
+import '../ort_model_cache.dart';
 import 'asr_engine.dart';
+import 'native_offline_decoder.dart';
+import 'partial_decode_scheduler.dart';
 
 /// SenseVoice 离线 ASR 引擎
 ///
@@ -26,8 +32,17 @@ import 'asr_engine.dart';
 /// 3. 对语音段进行离线识别
 /// 4. 返回识别结果 (含 text, lang, emotion)
 ///
+/// 语音段结束前，后台线程按 [SenseVoiceConfig.partialIntervalMs] 对
+/// 仍在增长的语音段重新解码，中间结果在段结束时被最终识别结果替换。
+///
+/// 已结束的语音段不在调用线程上解码，而是交给 [SenseVoiceConfig.segmentThreads]
+/// 个原生线程并发解码，结果按提交顺序追加到累积文本；返回前先以该段的
+/// 中间结果占位。同时排队的语音段按 [SenseVoiceConfig.segmentBatchSize]
+/// 合批，一次 DecodeMultipleOfflineStreams 调用完成。
+/// 原生库不可用时退回调用线程同步解码。
+///
 /// 特点:
-/// - 按段落输出文字，用户体验接近流式
+/// - 段内给出中间结果，按段落确定文字，用户体验接近流式
 /// - 支持语言自动检测 (zh/en/ja/ko/yue)
 /// - 支持情感识别 (NEUTRAL/HAPPY/SAD/ANGRY)
 /// - 支持 ITN (Inverse Text Normalization) 自动标点
@@ -50,6 +65,49 @@ class SenseVoiceEngine implements ASREngine {
   /// 配置缓存
   SenseVoiceConfig? _config;
 
+  /// 后台解码器 (中间解码 + 语音段线程池)，不可用时为 null
+  NativeOfflineDecoder? _offlineDecoder;
+
+  // === 语音段并发解码 ===
+  /// 已提交、尚未取回的语音段: 序号 -> 占位文本 (该段的中间结果)
+  final Map<int, String> _pendingSegmentText = {};
+
+  /// 最近一个有文字的语音段结果 (提供 lang/emotion 等元数据)
+  ASRResult _lastSegmentResult = ASRResult.empty();
+
+  /// 本次录音已完成识别的语音段数
+  int _decodedSegments = 0;
+
+  /// 本次录音各语音段所在批的段数之和
+  int _segmentBatchSum = 0;
+
+  /// 本次录音各语音段在原生侧新分配堆内存的次数 (按取回顺序)
+  final List<int> _segmentAllocs = [];
+
+  /// inputFinished/finishInput 等待线程池解码剩余语音段的上限
+  static const Duration _segmentWaitTimeout = Duration(seconds: 5);
+
+  /// finishInput 轮询剩余语音段的间隔
+  static const Duration _segmentPollInterval = Duration(milliseconds: 10);
+
+  // === 中间解码 ===
+  PartialDecodeScheduler? _partialScheduler;
+
+  /// 未结束语音段的音频 (语音开始前保留 [_partialLookbackSec] 秒)
+  Pointer<Float> _openAudio = nullptr;
+  int _openCapacity = 0;
+  int _openSamples = 0;
+  bool _speechActive = false;
+
+  /// 当前未结束语音段的标签，段结束或重置时递增，旧段的中间结果被丢弃
+  int _segmentTag = 0;
+
+  /// 当前语音段的中间结果
+  ASRResult _partialResult = ASRResult.empty();
+
+  /// 语音开始前保留的音频 (秒)，覆盖 VAD 判定语音开始的滞后
+  static const double _partialLookbackSec = 1.0;
+
   /// 是否启用调试日志
   final bool enableDebugLog;
 
@@ -64,6 +122,46 @@ class SenseVoiceEngine implements ASREngine {
   @override
   bool get isInitialized => _isInitialized;
 
+  /// 最近一次创建离线识别器的耗时 (未初始化时为 null)
+  Duration? get recognizerInitTime => _recognizerInitTime;
+  Duration? _recognizerInitTime;
+
+  /// 本次录音 (上次 [reset] 之后) 已完成识别的语音段数
+  int get decodedSegments => _decodedSegments;
+
+  /// 本次录音各语音段在原生侧新分配堆内存的次数 (同步解码的语音段不计)
+  List<int> get segmentAllocations => List.unmodifiable(_segmentAllocs);
+
+  /// 语音段平均所在批的段数 (1 表示未合批)
+  double get meanSegmentBatch =>
+      _decodedSegments == 0 ? 0 : _segmentBatchSum / _decodedSegments;
+
+  /// 语音段解码线程数，0 表示在调用线程同步解码
+  int get segmentThreads => _offlineDecoder?.segmentThreads ?? 0;
+
+  // ===== 外部提交的语音段 (两遍识别的第二遍) =====
+  // 与 acceptWaveform 共用语音段线程池，同一实例只应使用其中一种
+
+  /// 是否可在线程池上识别外部提交的音频
+  bool get canRescore => _isInitialized && _offlineDecoder != null;
+
+  /// 提交一段音频 (拷贝后立即返回)，返回其序号，不可用时返回 -1
+  int submitRescore(Pointer<Float> samples, int n) =>
+      _offlineDecoder?.submitSegment(samples, n) ?? -1;
+
+  /// 按提交顺序取下一个识别完成的结果 ([OfflineDecodeResult.tag] 为序号)
+  OfflineDecodeResult? takeRescored() => _offlineDecoder?.takeSegment();
+
+  /// 尚未取回的提交数
+  int get pendingRescores => _offlineDecoder?.pendingSegments ?? 0;
+
+  /// 等待已提交的音频全部识别完成，超时返回 false
+  bool waitRescores(Duration timeout) =>
+      _offlineDecoder?.waitSegments(timeout: timeout) ?? true;
+
+  /// 丢弃全部未取回的提交
+  void cancelRescores() => _offlineDecoder?.cancelSegments();
+
   @override
   ASRError get lastError => _lastError;
 
@@ -144,8 +242,11 @@ class SenseVoiceEngine implements ASREngine {
       return vadError;
     }
 
-    // 6. 初始化离线识别器
-    final recognizerError = _initializeRecognizer(config, modelPath, tokensPath);
+    // 6. 初始化离线识别器 (有优化缓存时改用缓存副本)
+    final recognizerError = _initializeRecognizer(
+        config,
+        OrtModelCache.instance.resolve(modelPath, provider: config.provider),
+        tokensPath);
     if (recognizerError != ASRError.none) {
       _destroyVad();
       return recognizerError;
@@ -154,6 +255,8 @@ class SenseVoiceEngine implements ASREngine {
     _isInitialized = true;
     _lastError = ASRError.none;
 
+    _initializeOfflineDecoder(config);
+
     if (enableDebugLog) {
       // ignore: avoid_print
       print('[SenseVoiceEngine] ✅ SenseVoice 引擎初始化成功');
@@ -248,6 +351,54 @@ class SenseVoiceEngine implements ASREngine {
     }
   }
 
+  /// 初始化后台解码
+  ///
+  /// 原生库不可用时语音段在调用线程同步解码，且只在语音段结束时输出；
+  /// 中间解码已关闭时只启用语音段线程池。
+  void _initializeOfflineDecoder(SenseVoiceConfig config) {
+    if (_recognizer == null) return;
+
+    // 识别器的解码可在多个线程上并发调用 (onnxruntime Run 线程安全)，
+    // 中间解码与各语音段的最终解码各自使用独立的离线流
+    final threads = config.resolvedSegmentThreads(Platform.numberOfProcessors);
+    _offlineDecoder = NativeOfflineDecoder.tryCreate(
+      _recognizer!,
+      sampleRate: config.sampleRate,
+      segmentThreads: threads,
+    );
+    if (_offlineDecoder == null) {
+      if (enableDebugLog) {
+        // ignore: avoid_print
+        print('[SenseVoiceEngine] ⚠️ 后台解码不可用，语音段在调用线程同步解码');
+      }
+      return;
+    }
+    _offlineDecoder!.setSegmentBatch(
+      maxSegments: config.segmentBatchSize,
+      maxSamples:
+          (SenseVoiceConfig.maxSegmentBatchSec * config.sampleRate).round(),
+      wait: Duration(milliseconds: config.segmentBatchWaitMs),
+    );
+    if (enableDebugLog) {
+      // ignore: avoid_print
+      print('[SenseVoiceEngine] ✅ 语音段解码线程: $threads, '
+          '合批: ${config.segmentBatchSize}');
+    }
+
+    final scheduler = PartialDecodeScheduler(
+      intervalMs: config.partialIntervalMs,
+      maxLoad: config.partialMaxLoad,
+      sampleRate: config.sampleRate,
+    );
+    if (!scheduler.enabled) return;
+
+    _partialScheduler = scheduler;
+    _openCapacity =
+        ((config.maxSpeechDuration + _partialLookbackSec) * config.sampleRate)
+            .ceil();
+    _openAudio = calloc<Float>(_openCapacity);
+  }
+
   /// 查找 SenseVoice 模型文件
   String? _findSenseVoiceModel(String modelDir) {
     final dir = Directory(modelDir);
@@ -494,8 +645,10 @@ class SenseVoiceEngine implements ASREngine {
       }
 
       // 创建识别器
+      final initWatch = Stopwatch()..start();
       _recognizer =
           SherpaOnnxOfflineBindings.createOfflineRecognizer(recognizerConfig);
+      _recognizerInitTime = initWatch.elapsed;
       if (enableDebugLog) {
         // ignore: avoid_print
         print('[SenseVoiceEngine] createOfflineRecognizer 调用完成');
@@ -615,9 +768,147 @@ class SenseVoiceEngine implements ASREngine {
 
     // 将音频数据送入 VAD
     SherpaOnnxVadBindings.voiceActivityDetectorAcceptWaveform(_vad!, samples, n);
+    if (_partialScheduler != null) {
+      _appendOpenAudio(samples, n);
+    }
 
     // 检查是否有检测到的语音段
     _processVadSegments();
+
+    if (_partialScheduler != null) {
+      _updatePartial(n);
+    }
+  }
+
+  /// 追加未结束语音段的音频；未检测到语音时只保留最近一小段
+  void _appendOpenAudio(Pointer<Float> samples, int n) {
+    final buffer = _openAudio.asTypedList(_openCapacity);
+    final input = samples.asTypedList(n);
+    if (n >= _openCapacity) {
+      buffer.setRange(0, _openCapacity, input, n - _openCapacity);
+      _openSamples = _openCapacity;
+    } else {
+      if (_openSamples + n > _openCapacity) {
+        final drop = _openSamples + n - _openCapacity;
+        buffer.setRange(0, _openSamples - drop, buffer, drop);
+        _openSamples -= drop;
+      }
+      buffer.setRange(_openSamples, _openSamples + n, input);
+      _openSamples += n;
+    }
+
+    _speechActive =
+        SherpaOnnxVadBindings.voiceActivityDetectorDetected(_vad!) == 1;
+    if (!_speechActive) {
+      final keep = (_partialLookbackSec * (_config?.sampleRate ?? 16000)).ceil();
+      if (_openSamples > keep) {
+        buffer.setRange(0, keep, buffer, _openSamples - keep);
+        _openSamples = keep;
+      }
+    }
+  }
+
+  /// 读取完成的中间解码并按调度提交新的中间解码
+  void _updatePartial(int n) {
+    final decoder = _offlineDecoder!;
+    final scheduler = _partialScheduler!;
+    scheduler.advance(n);
+
+    final done = decoder.takePartial();
+    if (done != null) {
+      scheduler.completed(done.decodeTime);
+      if (done.tag == _segmentTag && done.result.isNotEmpty) {
+        _partialResult = done.result;
+        _publishResult();
+      }
+    } else if (scheduler.inFlight && !decoder.isPartialBusy) {
+      // 请求在完成前被取消
+      scheduler.cancelled();
+    }
+
+    if (_speechActive && scheduler.shouldSubmit(_openSamples)) {
+      decoder.submitPartial(_segmentTag, _openAudio, _openSamples);
+      scheduler.submitted();
+    }
+  }
+
+  /// 语音段已结束: 丢弃该段的中间解码，由最终识别结果替换
+  void _closeOpenSegment() {
+    _segmentTag++;
+    _openSamples = 0;
+    _offlineDecoder?.cancelPartial();
+    if (_partialResult.isNotEmpty) {
+      _partialResult = ASRResult.empty();
+      _publishResult();
+    }
+  }
+
+  /// 清空中间解码状态
+  void _resetPartial() {
+    if (_partialScheduler == null) return;
+    _segmentTag++;
+    _openSamples = 0;
+    _speechActive = false;
+    _partialResult = ASRResult.empty();
+    _offlineDecoder!.cancelPartial();
+    _partialScheduler!.reset();
+  }
+
+  /// 丢弃尚未取回的语音段
+  void _resetSegments() {
+    _offlineDecoder?.cancelSegments();
+    _pendingSegmentText.clear();
+    _lastSegmentResult = ASRResult.empty();
+    _decodedSegments = 0;
+    _segmentBatchSum = 0;
+    _segmentAllocs.clear();
+  }
+
+  /// 按顺序取回线程池已解码的语音段
+  void _drainSegments() {
+    final decoder = _offlineDecoder;
+    if (decoder == null || _pendingSegmentText.isEmpty) return;
+
+    var changed = false;
+    for (var done = decoder.takeSegment();
+        done != null;
+        done = decoder.takeSegment()) {
+      _pendingSegmentText.remove(done.tag);
+      _countSegment(done.result, batch: done.batch);
+      _segmentAllocs.add(done.allocs);
+      changed = true;
+      if (enableDebugLog && done.result.isNotEmpty) {
+        // ignore: avoid_print
+        print('[SenseVoiceEngine] 识别结果 #${done.tag}: "${done.result.text}" '
+            '(${done.decodeTime.inMilliseconds}ms, 批 ${done.batch})');
+      }
+    }
+    if (changed) _publishResult();
+  }
+
+  /// 记录一个语音段的最终识别结果 ([batch] 为同批解码的段数)
+  void _countSegment(ASRResult result, {int batch = 1}) {
+    _decodedSegments++;
+    _segmentBatchSum += batch;
+    if (result.isNotEmpty) {
+      // PTT 累积模式：将新段落追加到累积文本
+      _accumulatedText += result.text;
+      _lastSegmentResult = result;
+    }
+  }
+
+  /// 由累积文本、尚未取回语音段的占位文本与当前中间结果组成对外结果
+  void _publishResult() {
+    final text = _accumulatedText +
+        _pendingSegmentText.values.join() +
+        _partialResult.text;
+    if (text.isEmpty) {
+      _lastResult = ASRResult.empty();
+      return;
+    }
+    final source =
+        _partialResult.isNotEmpty ? _partialResult : _lastSegmentResult;
+    _lastResult = source.withText(text);
   }
 
   /// 处理 VAD 检测到的语音段
@@ -630,23 +921,19 @@ class SenseVoiceEngine implements ASREngine {
       final segment = SherpaOnnxVadBindings.voiceActivityDetectorFront(_vad!);
 
       if (segment != nullptr) {
-        // 对语音段进行识别
-        final result = _recognizeSegment(segment);
-        if (result.isNotEmpty) {
-          // PTT 累积模式：将新段落追加到累积文本
-          if (_accumulatedText.isNotEmpty) {
-            _accumulatedText += result.text;
-          } else {
-            _accumulatedText = result.text;
-          }
-          // 更新 _lastResult，使用累积的文本
-          _lastResult = ASRResult(
-            text: _accumulatedText,
-            lang: result.lang,
-            emotion: result.emotion,
-            tokens: result.tokens,
-            timestamps: result.timestamps,
-          );
+        // 交给线程池解码 (拷贝音频后立即返回)，结果返回前以中间结果占位
+        final seq = _offlineDecoder?.submitSegment(
+                segment.ref.samples, segment.ref.n) ??
+            -1;
+        if (seq >= 0) {
+          _pendingSegmentText[seq] = _partialResult.text;
+          _closeOpenSegment();
+        } else {
+          // 后台解码不可用：在调用线程同步识别
+          final result = _recognizeSegment(segment);
+          _closeOpenSegment();
+          _countSegment(result);
+          _publishResult();
         }
 
         // 销毁语音段
@@ -656,6 +943,8 @@ class SenseVoiceEngine implements ASREngine {
       // 弹出已处理的段
       SherpaOnnxVadBindings.voiceActivityDetectorPop(_vad!);
     }
+
+    _drainSegments();
   }
 
   /// 对语音段进行离线识别
@@ -737,34 +1026,22 @@ class SenseVoiceEngine implements ASREngine {
           ? resultPtr.ref.emotion.toDartString()
           : null;
 
-      // 解析 tokens 和 timestamps
-      List<String> tokens = [];
-      List<double> timestamps = [];
-
+      // tokens 与 timestamps 各整块拷贝，token 列表在读取时才拆分
       final count = resultPtr.ref.count;
-      if (count > 0) {
-        // 从 tokensArr 获取 tokens
-        if (resultPtr.ref.tokensArr != nullptr) {
-          for (int i = 0; i < count; i++) {
-            final tokenPtr = resultPtr.ref.tokensArr[i];
-            if (tokenPtr != nullptr) {
-              tokens.add(tokenPtr.toDartString());
-            }
-          }
-        }
-
-        // 从 timestamps 数组获取时间戳
-        if (resultPtr.ref.timestamps != nullptr) {
-          for (int i = 0; i < count; i++) {
-            timestamps.add(resultPtr.ref.timestamps[i]);
-          }
-        }
-      }
+      final tokens = PackedTokens.copy(
+        resultPtr.ref.tokens.cast(),
+        _tokenBytes(resultPtr.ref.tokens, resultPtr.ref.tokensArr, count),
+        count,
+      );
+      final List<double> timestamps =
+          count > 0 && resultPtr.ref.timestamps != nullptr
+              ? Float32List.fromList(resultPtr.ref.timestamps.asTypedList(count))
+              : const [];
 
       // 销毁结果
       SherpaOnnxOfflineBindings.destroyOfflineRecognizerResult(resultPtr);
 
-      return ASRResult(
+      return ASRResult.packed(
         text: text.trim(),
         lang: lang?.isNotEmpty == true ? lang : null,
         emotion: emotion?.isNotEmpty == true ? emotion : null,
@@ -781,6 +1058,15 @@ class SenseVoiceEngine implements ASREngine {
     }
   }
 
+  /// sherpa 结果中 '\0' 分隔的 tokens 整块字节数 (tokensArr 指向同一块内存)
+  static int _tokenBytes(
+      Pointer<Utf8> tokens, Pointer<Pointer<Utf8>> tokensArr, int count) {
+    if (count <= 0 || tokens == nullptr || tokensArr == nullptr) return 0;
+    final last = tokensArr[count - 1];
+    if (last == nullptr || last.address < tokens.address) return 0;
+    return last.address - tokens.address + last.length + 1;
+  }
+
   @override
   void decode() {
     // SenseVoice 是离线引擎，解码在 acceptWaveform 时自动完成
@@ -818,17 +1104,64 @@ class SenseVoiceEngine implements ASREngine {
     _lastResult = ASRResult.empty();
     _accumulatedText = '';
     _hasEndpoint = false;
+    _resetPartial();
+    _resetSegments();
+  }
+
+  @override
+  Future<void> finishInput() async {
+    if (!_flushInput()) return;
+
+    // 轮询取回线程池解码完的语音段，等待期间让出事件循环；
+    // 超时的语音段保留中间结果占位
+    final decoder = _offlineDecoder;
+    if (decoder == null) return;
+    final watch = Stopwatch()..start();
+    for (;;) {
+      _drainSegments();
+      if (_pendingSegmentText.isEmpty || !identical(decoder, _offlineDecoder)) {
+        return;
+      }
+      if (watch.elapsed >= _segmentWaitTimeout) {
+        if (enableDebugLog) {
+          // ignore: avoid_print
+          print('[SenseVoiceEngine] ⚠️ 等待语音段解码超时');
+        }
+        return;
+      }
+      await Future<void>.delayed(_segmentPollInterval);
+    }
   }
 
   @override
   void inputFinished() {
-    if (!_isInitialized || _vad == null) return;
+    if (!_flushInput()) return;
+
+    // 等待线程池解码完剩余语音段；超时的语音段保留中间结果占位
+    final decoder = _offlineDecoder;
+    if (decoder != null && _pendingSegmentText.isNotEmpty) {
+      if (!decoder.waitSegments(timeout: _segmentWaitTimeout) &&
+          enableDebugLog) {
+        // ignore: avoid_print
+        print('[SenseVoiceEngine] ⚠️ 等待语音段解码超时');
+      }
+      _drainSegments();
+    }
+  }
+
+  /// 刷新 VAD 并提交最后一个语音段，未初始化时返回 false
+  bool _flushInput() {
+    if (!_isInitialized || _vad == null) return false;
 
     // 刷新 VAD，处理剩余缓冲区数据
     SherpaOnnxVadBindings.voiceActivityDetectorFlush(_vad!);
 
     // 处理可能的最后一个语音段
     _processVadSegments();
+
+    // 没有形成语音段的剩余音频不再输出中间结果
+    _closeOpenSegment();
+    return true;
   }
 
   /// 销毁 VAD
@@ -841,6 +1174,23 @@ class SenseVoiceEngine implements ASREngine {
 
   @override
   void dispose() {
+    // 先停止后台解码，再销毁它使用的识别器
+    _offlineDecoder?.dispose();
+    _offlineDecoder = null;
+    _partialScheduler = null;
+    _pendingSegmentText.clear();
+    _lastSegmentResult = ASRResult.empty();
+    _decodedSegments = 0;
+    _segmentBatchSum = 0;
+    _segmentAllocs.clear();
+    if (_openAudio != nullptr) {
+      calloc.free(_openAudio);
+      _openAudio = nullptr;
+    }
+    _openCapacity = 0;
+    _openSamples = 0;
+    _partialResult = ASRResult.empty();
+
     // 销毁 VAD
     _destroyVad();
 
@@ -0,0 +1,430 @@
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import 'asr_engine.dart';
+import 'engine_host_worker.dart';
+import 'sensevoice_engine.dart';
+import 'zipformer_engine.dart';
+
+/// 两遍识别的分段结果
+///
+/// 第一遍 (流式) 的 token 只在末尾追加，在每个端点处按 token 位置切分为语音段；
+/// 语音段的第二遍结果返回后替换该段，最后一个端点之后的部分始终使用第一遍的实时结果。
+class TwoPassTranscript {
+  /// SentencePiece 词首标记
+  static const String _wordBoundary = '▁';
+
+  final List<ASRResult> _segments = [];
+
+  /// 各语音段起点 (秒，相对第一遍流的起点)
+  final List<double> _starts = [];
+
+  final List<bool> _replaced = [];
+  int _replacedCount = 0;
+
+  /// 已切分的第一遍 token 数
+  int _closedTokens = 0;
+
+  ASRResult? _composedFrom;
+  ASRResult _composed = ASRResult.empty();
+
+  /// 已切分的语音段数
+  int get segmentCount => _segments.length;
+
+  /// 已被第二遍结果替换的语音段数
+  int get replacedCount => _replacedCount;
+
+  /// 在端点处切分: [first] 为第一遍当前结果，[startSec] 为该段音频起点
+  ///
+  /// 返回新语音段的下标，上个端点之后没有新 token 时返回 -1
+  int close(ASRResult first, double startSec) {
+    if (first.tokenCount <= _closedTokens) return -1;
+    _segments.add(_slice(first, _closedTokens));
+    _starts.add(startSec);
+    _replaced.add(false);
+    _closedTokens = first.tokenCount;
+    return _segments.length - 1;
+  }
+
+  /// 用第二遍结果 [second] 替换语音段 [index] (时间戳相对该段起点)
+  void replace(int index, ASRResult second) {
+    if (index < 0 || index >= _segments.length || second.isEmpty) return;
+    final start = _starts[index];
+    _segments[index] = ASRResult(
+      text: second.text,
+      lang: second.lang,
+      emotion: second.emotion,
+      tokens: second.tokens,
+      timestamps: [for (final t in second.timestamps) t + start],
+    );
+    if (!_replaced[index]) {
+      _replaced[index] = true;
+      _replacedCount++;
+    }
+    _composedFrom = null;
+  }
+
+  /// 由各语音段与第一遍当前结果 [first] 组成对外结果
+  ASRResult compose(ASRResult first) {
+    // 尚无替换时与第一遍结果完全相同
+    if (_replacedCount == 0) return first;
+    if (identical(first, _composedFrom)) return _composed;
+
+    final tail = _slice(first, _closedTokens);
+    final parts = [..._segments, tail];
+    final tokens = <String>[];
+    final timestamps = <double>[];
+    var timed = true;
+    ASRResult? meta;
+    for (final part in parts) {
+      tokens.addAll(part.tokens);
+      timed = timed && part.timestamps.length == part.tokens.length;
+      if (timed) timestamps.addAll(part.timestamps);
+      if (part.lang != null) meta = part;
+    }
+    _composed = ASRResult(
+      text: parts.map((p) => p.text).join().trimLeft(),
+      lang: meta?.lang,
+      emotion: meta?.emotion,
+      tokens: tokens,
+      // 缺少时间戳的语音段无法对齐，整体不提供时间戳
+      timestamps: timed ? timestamps : const [],
+    );
+    _composedFrom = first;
+    return _composed;
+  }
+
+  /// 清空 (新的一次录音)
+  void clear() {
+    _segments.clear();
+    _starts.clear();
+    _replaced.clear();
+    _replacedCount = 0;
+    _closedTokens = 0;
+    _composedFrom = null;
+    _composed = ASRResult.empty();
+  }
+
+  /// 第一遍结果第 [from] 个 token 之后的部分
+  static ASRResult _slice(ASRResult result, int from) {
+    final tokens = result.tokens;
+    final start = from.clamp(0, tokens.length);
+    final part = tokens.sublist(start);
+    return ASRResult(
+      text: part.join().replaceAll(_wordBoundary, ' '),
+      tokens: part,
+      timestamps: result.timestamps.length == tokens.length
+          ? result.timestamps.sublist(start)
+          : const [],
+    );
+  }
+}
+
+/// 两遍识别引擎: Zipformer 实时结果 + SenseVoice 端点重识别
+///
+/// 对调用方表现为 Zipformer 流式引擎 ([engineType] 为 zipformer)，
+/// 录音时显示第一遍的实时结果；每个端点处把该语音段的音频交给 SenseVoice
+/// 语音段线程池在后台重新识别，结果返回后替换该段文本。
+/// [finishInput] 最多等待 [maxWait] 让最后一段换上第二遍结果 (异步轮询)。
+///
+/// 资源预算:
+/// - 内存: 额外加载 SenseVoice 模型，每段最多缓存 [maxSegmentSec] 秒音频
+/// - CPU: 第二遍使用 [secondPass] 的 numThreads 个推理线程、一个解码线程，
+///   排队超过 [maxPendingRescores] 段时新语音段保留第一遍结果
+///
+/// SenseVoice 初始化失败或原生后台解码不可用时只运行第一遍。
+class TwoPassEngine implements ASREngine {
+  /// 排队等待第二遍的语音段上限
+  static const int maxPendingRescores = 2;
+
+  /// [finishInput] 轮询第二遍结果的间隔
+  static const Duration _rescorePollInterval = Duration(milliseconds: 10);
+
+  /// 端点处没有新文字时保留的音频 (秒)，覆盖下一句开头尚未解码出文字的部分
+  static const double _idleLookbackSec = 0.5;
+
+  /// 第二遍 (SenseVoice) 配置
+  final SenseVoiceConfig secondPass;
+
+  /// 每个语音段缓存音频的时长上限 (秒)
+  final double maxSegmentSec;
+
+  /// 停止录音时等待第二遍结果的上限
+  final Duration maxWait;
+
+  /// 是否启用调试日志
+  final bool enableDebugLog;
+
+  final ZipformerEngine _first;
+  final SenseVoiceEngine _second;
+  final TwoPassTranscript _transcript = TwoPassTranscript();
+
+  bool _rescoring = false;
+  int _sampleRate = 16000;
+
+  /// 当前语音段的音频
+  Pointer<Float> _audio = nullptr;
+  int _capacity = 0;
+  int _samples = 0;
+
+  /// 当前语音段超出缓存上限，不再重识别
+  bool _overflow = false;
+
+  /// 本次录音送入的样本总数 / 当前语音段起点
+  int _totalSamples = 0;
+  int _segmentStart = 0;
+
+  /// 等待第二遍的语音段: 序号 -> 语音段下标
+  final Map<int, int> _pending = {};
+
+  int _rescoredSegments = 0;
+  int _skippedSegments = 0;
+  Duration _rescoreTime = Duration.zero;
+
+  /// 创建 TwoPassEngine 实例
+  ///
+  /// [secondPass] 第二遍使用的 SenseVoice 配置 (在 [initialize] 时一并初始化)
+  /// [engineHost] 第一遍 Zipformer 使用的常驻识别宿主 (null 为本进程)
+  TwoPassEngine({
+    required this.secondPass,
+    this.maxSegmentSec = 30.0,
+    this.maxWait = const Duration(milliseconds: 800),
+    this.enableDebugLog = false,
+    EngineHostOptions? engineHost,
+  })  : _first = ZipformerEngine(
+            enableDebugLog: enableDebugLog, engineHost: engineHost),
+        _second = SenseVoiceEngine(enableDebugLog: enableDebugLog);
+
+  @override
+  ASREngineType get engineType => ASREngineType.zipformer;
+
+  @override
+  bool get isInitialized => _first.isInitialized;
+
+  @override
+  ASRError get lastError => _first.lastError;
+
+  /// 第一遍是否使用常驻识别宿主
+  bool get usesEngineHost => _first.usesEngineHost;
+
+  /// 第一遍是否复用了宿主中已加载的模型 (未使用宿主时为 null)
+  bool? get reusedHostModel => _first.reusedHostModel;
+
+  /// 第一遍工作线程累计解码耗时 (未使用工作线程时为 null)
+  Duration? get workerDecodeTime => _first.workerDecodeTime;
+
+  /// 第一遍已送入但尚未反映在结果中的样本数 (未使用工作线程时为 null)
+  int? get workerPendingSamples => _first.workerPendingSamples;
+
+  /// 两个识别器创建耗时之和 (第二遍不可用时只计第一遍)
+  Duration? get recognizerInitTime {
+    final first = _first.recognizerInitTime;
+    if (first == null) return null;
+    return first + (_second.recognizerInitTime ?? Duration.zero);
+  }
+
+  /// 第二遍是否可用
+  bool get isRescoring => _rescoring;
+
+  /// 本次录音已换上第二遍结果的语音段数
+  int get rescoredSegments => _rescoredSegments;
+
+  /// 本次录音因超出预算或不可用而保留第一遍结果的语音段数
+  int get skippedSegments => _skippedSegments;
+
+  /// 本次录音第二遍累计解码耗时
+  Duration get rescoreTime => _rescoreTime;
+
+  @override
+  Future<ASRError> initialize(ASRConfig config) async {
+    final error = await _first.initialize(config);
+    if (error != ASRError.none || _rescoring) return error;
+
+    _sampleRate = config.sampleRate;
+    final secondError = await _second.initialize(secondPass);
+    if (secondError != ASRError.none || !_second.canRescore) {
+      if (enableDebugLog) {
+        // ignore: avoid_print
+        print('[TwoPassEngine] ⚠️ 第二遍不可用 ($secondError)，只运行 Zipformer');
+      }
+      _second.dispose();
+      return ASRError.none;
+    }
+
+    _capacity = (maxSegmentSec * _sampleRate).ceil();
+    _audio = calloc<Float>(_capacity);
+    _rescoring = true;
+    if (enableDebugLog) {
+      // ignore: avoid_print
+      print('[TwoPassEngine] ✅ 两遍识别已启用 (第二遍线程: ${secondPass.numThreads})');
+    }
+    return ASRError.none;
+  }
+
+  @override
+  void acceptWaveform(int sampleRate, Pointer<Float> samples, int n) {
+    _first.acceptWaveform(sampleRate, samples, n);
+    if (!_rescoring || n <= 0) return;
+    _totalSamples += n;
+    if (_overflow) return;
+    if (_samples + n > _capacity) {
+      _overflow = true;
+      return;
+    }
+    _audio
+        .asTypedList(_capacity)
+        .setRange(_samples, _samples + n, samples.asTypedList(n));
+    _samples += n;
+  }
+
+  @override
+  void decode() => _first.decode();
+
+  @override
+  bool isReady() => _first.isReady();
+
+  @override
+  ASRResult getResult() {
+    _drain();
+    return _transcript.compose(_first.getResult());
+  }
+
+  @override
+  bool isEndpoint() {
+    final endpoint = _first.isEndpoint();
+    if (endpoint && _rescoring) _closeSegment();
+    return endpoint;
+  }
+
+  /// 端点处结束当前语音段并交给第二遍
+  void _closeSegment() {
+    final index = _transcript.close(
+        _first.getResult(), _segmentStart / _sampleRate);
+    if (index < 0) {
+      // 没有新文字: 只保留最近一小段，避免长时间静音占满缓存
+      final keep = (_idleLookbackSec * _sampleRate).round();
+      if (!_overflow && _samples > keep) {
+        final audio = _audio.asTypedList(_capacity);
+        audio.setRange(0, keep, audio, _samples - keep);
+        _samples = keep;
+      } else if (_overflow) {
+        _samples = 0;
+      }
+      _segmentStart = _totalSamples - _samples;
+      _overflow = false;
+      return;
+    }
+
+    if (_overflow ||
+        _samples == 0 ||
+        _second.pendingRescores >= maxPendingRescores) {
+      _skippedSegments++;
+    } else {
+      final seq = _second.submitRescore(_audio, _samples);
+      if (seq >= 0) {
+        _pending[seq] = index;
+      } else {
+        _skippedSegments++;
+      }
+    }
+    _segmentStart = _totalSamples;
+    _samples = 0;
+    _overflow = false;
+  }
+
+  /// 取回第二遍结果并替换对应语音段
+  void _drain() {
+    if (_pending.isEmpty) return;
+    for (var done = _second.takeRescored();
+        done != null;
+        done = _second.takeRescored()) {
+      final index = _pending.remove(done.tag);
+      if (index == null) continue;
+      _rescoreTime += done.decodeTime;
+      if (done.result.isEmpty) {
+        // 第二遍没有识别出文字时保留第一遍结果
+        _skippedSegments++;
+        continue;
+      }
+      _transcript.replace(index, done.result);
+      _rescoredSegments++;
+      if (enableDebugLog) {
+        // ignore: avoid_print
+        print('[TwoPassEngine] 语音段 #$index: "${done.result.text}" '
+            '(${done.decodeTime.inMilliseconds}ms)');
+      }
+    }
+  }
+
+  @override
+  void reset() {
+    _first.reset();
+    if (_rescoring) _second.cancelRescores();
+    _pending.clear();
+    _transcript.clear();
+    _samples = 0;
+    _overflow = false;
+    _totalSamples = 0;
+    _segmentStart = 0;
+    _rescoredSegments = 0;
+    _skippedSegments = 0;
+    _rescoreTime = Duration.zero;
+  }
+
+  @override
+  void inputFinished() {
+    _first.inputFinished();
+    if (!_rescoring) return;
+
+    // 最后一段 (松开快捷键时尚未形成端点) 同样交给第二遍
+    _closeSegment();
+    if (_pending.isEmpty) return;
+    if (!_second.waitRescores(maxWait)) _logRescoreTimeout();
+    _drain();
+  }
+
+  @override
+  Future<void> finishInput() async {
+    await _first.finishInput();
+    if (!_rescoring) return;
+
+    _closeSegment();
+    // 轮询取回第二遍结果，等待期间让出事件循环
+    final watch = Stopwatch()..start();
+    for (;;) {
+      _drain();
+      if (_pending.isEmpty || !_rescoring) return;
+      if (watch.elapsed >= maxWait) {
+        _logRescoreTimeout();
+        return;
+      }
+      await Future<void>.delayed(_rescorePollInterval);
+    }
+  }
+
+  void _logRescoreTimeout() {
+    if (!enableDebugLog) return;
+    // ignore: avoid_print
+    print('[TwoPassEngine] ⚠️ 等待第二遍超时，未完成的语音段保留第一遍结果');
+  }
+
+  @override
+  void dispose() {
+    // 先停止第二遍的后台解码，再释放它读取的缓存
+    _second.dispose();
+    _first.dispose();
+    if (_audio != nullptr) {
+      calloc.free(_audio);
+      _audio = nullptr;
+    }
+    _capacity = 0;
+    _rescoring = false;
+    _pending.clear();
+    _transcript.clear();
+    _samples = 0;
+    _overflow = false;
+    _totalSamples = 0;
+    _segmentStart = 0;
+  }
+}
@@ -5,7 +5,10 @@ import 'dart:io';
 import 'package:ffi/ffi.dart';
 
 import '../../ffi/sherpa_ffi.dart';
+import '../ort_model_cache.dart';
 import 'asr_engine.dart';
+import 'engine_host_worker.dart';
+import 'native_asr_worker.dart';
 
 /// Zipformer 流式 ASR 引擎
 ///
@@ -16,9 +19,25 @@ import 'asr_engine.dart';
 /// - 边听边识别，实时输出
 /// - 极低延迟 (<200ms)
 /// - 内置 VAD 端点检测
+///
+/// 原生库可用时解码交给 [NativeAsrWorker] 工作线程，调用方接口不变:
+/// [acceptWaveform] 只入队，[isReady] 恒为 false，[getResult] 返回最近发布的结果，
+/// [finishInput] 异步等待已入队音频解码完成。
+///
+/// 指定 [engineHost] 时识别器放在常驻宿主进程中 (见 [EngineHostWorker])，
+/// 模型在应用重启之间保留，宿主不可用时回退到本进程。
 class ZipformerEngine implements ASREngine {
+  /// [finishInput] 等待工作线程解码完成的上限
+  static const Duration finishTimeout = Duration(seconds: 2);
+
+  /// [finishInput] 的轮询间隔
+  static const Duration _finishPollInterval = Duration(milliseconds: 5);
+
   Pointer<SherpaOnnxOnlineRecognizer>? _recognizer;
   Pointer<SherpaOnnxOnlineStream>? _stream;
+  StreamingAsrWorker? _worker;
+  ASRResult _workerResult = ASRResult.empty();
+  int _workerAcceptedSamples = 0; // 送入当前工作线程的累计样本数
   bool _isInitialized = false;
   ASRError _lastError = ASRError.none;
   DynamicLibrary? _lib;
@@ -29,10 +48,22 @@ class ZipformerEngine implements ASREngine {
   /// 是否启用调试日志
   final bool enableDebugLog;
 
+  /// 是否使用原生工作线程解码 (不可用时自动回退到同步解码)
+  final bool useInferenceWorker;
+
+  /// 常驻识别宿主 (null 表示在本进程中识别)
+  final EngineHostOptions? engineHost;
+
   /// 创建 ZipformerEngine 实例
   ///
   /// [enableDebugLog] 是否启用调试日志输出 (默认 false)
-  ZipformerEngine({this.enableDebugLog = false});
+  /// [useInferenceWorker] 是否在原生工作线程中解码 (默认 true)
+  /// [engineHost] 在常驻宿主进程中识别 (默认 null，即本进程)
+  ZipformerEngine({
+    this.enableDebugLog = false,
+    this.useInferenceWorker = true,
+    this.engineHost,
+  });
 
   @override
   ASREngineType get engineType => ASREngineType.zipformer;
@@ -46,6 +77,42 @@ class ZipformerEngine implements ASREngine {
   /// 当前使用的是否为 int8 模型
   bool get useInt8Model => _useInt8Model;
 
+  /// 是否正在使用原生工作线程解码
+  bool get usesInferenceWorker => _worker != null;
+
+  /// 是否正在使用常驻识别宿主
+  bool get usesEngineHost => _worker is EngineHostWorker;
+
+  /// 是否复用了宿主中已加载的模型 (未使用宿主时为 null)
+  bool? get reusedHostModel => switch (_worker) {
+        EngineHostWorker w => w.reusedModel,
+        _ => null,
+      };
+
+  /// 识别宿主是否已退出或崩溃 (再次 [initialize] 时重新连接)
+  bool get hostDisconnected => switch (_worker) {
+        EngineHostWorker w => !w.isAlive,
+        _ => false,
+      };
+
+  /// 工作线程累计解码耗时 (未使用工作线程时为 null)
+  Duration? get workerDecodeTime => _worker?.decodeTime;
+
+  /// 已送入但尚未反映在 [getResult] 中的样本数 (未使用工作线程时为 null)
+  ///
+  /// 当前结果对应的最后一个样本 = 最近送入的样本之前这么多个样本，
+  /// 用于从该样本的采集时刻计算结果延迟。
+  int? get workerPendingSamples {
+    final worker = _worker;
+    if (worker == null) return null;
+    final pending = _workerAcceptedSamples - worker.resultSamples;
+    return pending > 0 ? pending : 0;
+  }
+
+  /// 最近一次创建识别器的耗时 (未初始化时为 null)
+  Duration? get recognizerInitTime => _recognizerInitTime;
+  Duration? _recognizerInitTime;
+
   /// 在模型目录中查找指定类型的模型文件
   String? _findModelFile(String modelDir, String prefix,
       {required bool useInt8}) {
@@ -85,7 +152,16 @@ class ZipformerEngine implements ASREngine {
   @override
   Future<ASRError> initialize(ASRConfig config) async {
     if (_isInitialized) {
-      return ASRError.none;
+      // 识别宿主退出或崩溃后重新连接 (必要时重新启动宿主)
+      final worker = _worker;
+      if (worker is! EngineHostWorker || worker.isAlive) {
+        return ASRError.none;
+      }
+      if (enableDebugLog) {
+        // ignore: avoid_print
+        print('[ZipformerEngine] ⚠️ 识别宿主已断开，重新连接');
+      }
+      dispose();
     }
 
     if (config is! ZipformerConfig) {
@@ -130,6 +206,41 @@ class ZipformerEngine implements ASREngine {
       return _lastError;
     }
 
+    // 有优化缓存时改用缓存副本
+    final cache = OrtModelCache.instance;
+
+    // 2.1 常驻识别宿主 (不可用时回退到本进程)
+    final host = engineHost;
+    if (host != null) {
+      final worker = EngineHostWorker.tryConnect(
+        host,
+        _hostConfig(
+            config,
+            cache.resolve(encoderPath, provider: config.provider),
+            cache.resolve(decoderPath, provider: config.provider),
+            cache.resolve(joinerPath, provider: config.provider),
+            tokensPath),
+        onError: (reason) {
+          // ignore: avoid_print
+          print('[ZipformerEngine] ⚠️ 识别宿主不可用，改为本进程识别: $reason');
+        },
+      );
+      if (worker != null) {
+        _worker = worker;
+        _workerResult = ASRResult.empty();
+        _recognizerInitTime = worker.loadTime;
+        _isInitialized = true;
+        _lastError = ASRError.none;
+        if (enableDebugLog) {
+          // ignore: avoid_print
+          print('[ZipformerEngine] ✅ 识别宿主就绪 '
+              '(${worker.reusedModel ? '复用已加载模型' : '加载模型'}, '
+              '${worker.loadTime.inMilliseconds}ms)');
+        }
+        return ASRError.none;
+      }
+    }
+
     // 3. 加载动态库
     try {
       _lib = loadSherpaLibrary();
@@ -156,9 +267,12 @@ class ZipformerEngine implements ASREngine {
       c.ref.feat.featureDim = config.featureDim;
 
       // Transducer 模型配置
-      c.ref.model.transducer.encoder = encoderPath.toNativeUtf8();
-      c.ref.model.transducer.decoder = decoderPath.toNativeUtf8();
-      c.ref.model.transducer.joiner = joinerPath.toNativeUtf8();
+      c.ref.model.transducer.encoder =
+          cache.resolve(encoderPath, provider: config.provider).toNativeUtf8();
+      c.ref.model.transducer.decoder =
+          cache.resolve(decoderPath, provider: config.provider).toNativeUtf8();
+      c.ref.model.transducer.joiner =
+          cache.resolve(joinerPath, provider: config.provider).toNativeUtf8();
 
       // 其他模型配置 (空字符串)
       c.ref.model.paraformer.encoder = ''.toNativeUtf8();
@@ -207,7 +321,9 @@ class ZipformerEngine implements ASREngine {
       c.ref.hr.ruleFsts = ''.toNativeUtf8();
 
       // 5. 创建识别器
+      final initWatch = Stopwatch()..start();
       _recognizer = SherpaOnnxBindings.createOnlineRecognizer(c);
+      _recognizerInitTime = initWatch.elapsed;
 
       // 释放配置中分配的字符串内存
       _freeConfigStrings(c);
@@ -228,11 +344,18 @@ class ZipformerEngine implements ASREngine {
         return _lastError;
       }
 
+      if (useInferenceWorker) {
+        _worker = NativeAsrWorker.tryCreate(_recognizer!, _stream!,
+            sampleRate: config.sampleRate);
+        _workerResult = ASRResult.empty();
+      }
+
       _isInitialized = true;
       _lastError = ASRError.none;
       if (enableDebugLog) {
         // ignore: avoid_print
-        print('[ZipformerEngine] ✅ 识别器初始化成功');
+        print('[ZipformerEngine] ✅ 识别器初始化成功'
+            '${_worker != null ? ' (工作线程解码)' : ''}');
       }
       return ASRError.none;
     } catch (e) {
@@ -270,20 +393,30 @@ class ZipformerEngine implements ASREngine {
 
   @override
   void acceptWaveform(int sampleRate, Pointer<Float> samples, int n) {
-    if (!_isInitialized || _stream == null) return;
+    if (!_isInitialized) return;
+    final worker = _worker;
+    if (worker != null) {
+      worker.accept(samples, n);
+      _workerAcceptedSamples += n;
+      return;
+    }
+    if (_stream == null) return;
     SherpaOnnxBindings.onlineStreamAcceptWaveform(
         _stream!, sampleRate, samples, n);
   }
 
   @override
   void decode() {
-    if (!_isInitialized || _recognizer == null || _stream == null) return;
+    // 工作线程自行解码
+    if (!_isInitialized || _worker != null) return;
+    if (_recognizer == null || _stream == null) return;
     SherpaOnnxBindings.decodeOnlineStream(_recognizer!, _stream!);
   }
 
   @override
   bool isReady() {
-    if (!_isInitialized || _recognizer == null || _stream == null) return false;
+    if (!_isInitialized || _worker != null) return false;
+    if (_recognizer == null || _stream == null) return false;
     final result =
         SherpaOnnxBindings.isOnlineStreamReady(_recognizer!, _stream!);
     return result == 1;
@@ -291,9 +424,18 @@ class ZipformerEngine implements ASREngine {
 
   @override
   ASRResult getResult() {
-    if (!_isInitialized || _recognizer == null || _stream == null) {
-      return ASRResult.empty();
+    if (!_isInitialized) return ASRResult.empty();
+
+    final worker = _worker;
+    if (worker != null) {
+      // 结果未变化时不跨 FFI 拷贝；变化时只取增量 token
+      final delta = worker.takeUpdate();
+      if (delta != null) {
+        _workerResult = delta.applyTo(_workerResult);
+      }
+      return _workerResult;
     }
+    if (_recognizer == null || _stream == null) return ASRResult.empty();
 
     final jsonPtr =
         SherpaOnnxBindings.getOnlineStreamResultAsJson(_recognizer!, _stream!);
@@ -302,10 +444,34 @@ class ZipformerEngine implements ASREngine {
       return ASRResult.empty();
     }
 
-    try {
-      final jsonStr = jsonPtr.toDartString();
-      SherpaOnnxBindings.destroyOnlineStreamResultJson(jsonPtr);
+    final jsonStr = jsonPtr.toDartString();
+    SherpaOnnxBindings.destroyOnlineStreamResultJson(jsonPtr);
+    return _parseResult(jsonStr);
+  }
+
+  /// 识别宿主中的识别器配置 (key=value 行，与 engine_host.cc 对应)
+  String _hostConfig(ZipformerConfig config, String encoder, String decoder,
+      String joiner, String tokens) {
+    return [
+      'encoder=$encoder',
+      'decoder=$decoder',
+      'joiner=$joiner',
+      'tokens=$tokens',
+      'num_threads=${config.numThreads}',
+      'provider=${config.provider}',
+      'decoding_method=${config.decodingMethod}',
+      'sample_rate=${config.sampleRate}',
+      'feature_dim=${config.featureDim}',
+      'enable_endpoint=${config.enableEndpoint ? 1 : 0}',
+      'rule1=${config.rule1MinTrailingSilence}',
+      'rule2=${config.rule2MinTrailingSilence}',
+      'rule3=${config.rule3MinUtteranceLength}',
+    ].join('\n');
+  }
 
+  /// 解析 sherpa 结果 JSON
+  ASRResult _parseResult(String jsonStr) {
+    try {
       final parsed = jsonDecode(jsonStr) as Map<String, dynamic>;
       return ASRResult(
         text: parsed['text'] as String? ?? '',
@@ -325,25 +491,73 @@ class ZipformerEngine implements ASREngine {
 
   @override
   bool isEndpoint() {
-    if (!_isInitialized || _recognizer == null || _stream == null) return false;
+    if (!_isInitialized) return false;
+    if (_worker != null) return _worker!.isEndpoint;
+    if (_recognizer == null || _stream == null) return false;
     final result = SherpaOnnxBindings.isEndpoint(_recognizer!, _stream!);
     return result == 1;
   }
 
   @override
   void reset() {
-    if (!_isInitialized || _recognizer == null || _stream == null) return;
+    if (!_isInitialized) return;
+    final worker = _worker;
+    if (worker != null) {
+      worker.reset();
+      _workerResult = ASRResult.empty();
+      return;
+    }
+    if (_recognizer == null || _stream == null) return;
     SherpaOnnxBindings.reset(_recognizer!, _stream!);
   }
 
   @override
   void inputFinished() {
-    if (!_isInitialized || _stream == null) return;
+    if (!_isInitialized) return;
+    final worker = _worker;
+    if (worker != null) {
+      // 等待已入队音频解码完成，调用方随后的 getResult 即为最终结果
+      if (!worker.finish() && enableDebugLog) {
+        // ignore: avoid_print
+        print('[ZipformerEngine] ⚠️ 等待工作线程解码超时');
+      }
+      return;
+    }
+    if (_stream == null) return;
     SherpaOnnxBindings.onlineStreamInputFinished(_stream!);
   }
 
+  @override
+  Future<void> finishInput() async {
+    if (!_isInitialized) return;
+    final worker = _worker;
+    if (worker == null) {
+      inputFinished();
+      return;
+    }
+    // 只入队结束标记，解码完成前让出事件循环
+    worker.requestFinish();
+    final watch = Stopwatch()..start();
+    while (!worker.drained) {
+      if (!identical(worker, _worker)) return; // 等待期间已释放
+      if (watch.elapsed >= finishTimeout) {
+        if (enableDebugLog) {
+          // ignore: avoid_print
+          print('[ZipformerEngine] ⚠️ 等待工作线程解码超时');
+        }
+        return;
+      }
+      await Future<void>.delayed(_finishPollInterval);
+    }
+  }
+
   @override
   void dispose() {
+    // 先停止工作线程，再销毁它使用的流与识别器
+    _worker?.dispose();
+    _worker = null;
+    _workerAcceptedSamples = 0;
+
     if (_stream != null && _stream != nullptr) {
       SherpaOnnxBindings.destroyOnlineStream(_stream!);
       _stream = null;
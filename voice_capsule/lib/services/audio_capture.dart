@@ -1,6 +1,9 @@
+import 'dart:async';
 import 'dart:ffi';
 import 'package:ffi/ffi.dart';
+import '../constants/settings_constants.dart';
 import '../ffi/portaudio_ffi.dart';
+import 'native_audio_capture.dart';
 import 'pulse_audio_capture.dart';
 import 'audio_device_service.dart';
 
@@ -12,6 +15,39 @@ class AudioConfig {
   static const int firstFrameBuffer = 320; // 20ms @ 16kHz (首帧快速响应)
 }
 
+/// 采集延迟报告 (用于 `nextalk audio list` 与诊断报告)
+class CaptureLatencyReport {
+  const CaptureLatencyReport({
+    required this.backend,
+    required this.targetMs,
+    this.grantedMs,
+    this.measuredMs,
+    this.deviceRate,
+  });
+
+  /// 实际使用的采集后端 (native-pulse / native-portaudio / pulse-simple / portaudio / none)
+  final String backend;
+
+  /// 请求的缓冲延迟
+  final int targetMs;
+
+  /// 音频服务器授予的缓冲延迟，后端不支持回读时为 null
+  final double? grantedMs;
+
+  /// 实测采集延迟，未在采集或后端不支持时为 null
+  final double? measuredMs;
+
+  /// 设备侧采样率，由原生库重采样时不同于 16kHz；未知时为 null
+  final int? deviceRate;
+
+  static String _format(double? ms) => ms != null ? ms.toStringAsFixed(1) : '-';
+
+  @override
+  String toString() =>
+      'backend=$backend, target=${targetMs}ms, granted=${_format(grantedMs)}ms, '
+      'measured=${_format(measuredMs)}ms, device_rate=${deviceRate ?? '-'}';
+}
+
 /// 音频采集错误类型
 enum AudioCaptureError {
   none,
@@ -35,8 +71,8 @@ enum AudioDeviceStatus {
 
 /// 音频采集服务
 ///
-/// 优先使用 libpulse-simple 进行音频采集（与系统设置一致），
-/// 回退到 PortAudio。
+/// 优先使用原生采集线程 (libnextalk_native.so)，其内部优先 libpulse 异步流 (pa_stream)
+/// 并回退到 PortAudio；原生库不可用时回退到 Dart 侧阻塞读取实现。
 /// 采样参数: 16kHz, 单声道, Float32
 class AudioCapture {
   final PortAudioBindings _bindings;
@@ -55,11 +91,41 @@ class AudioCapture {
   Pointer<Float>? _prebuffer;
   int _prebufferSamples = 0;
   bool _hasPrebuffer = false;
+  DateTime? _prebufferCaptureTime;
+
+  // 最近一次 read() 所读首个样本的采集时刻 (端到端延迟测量起点)
+  DateTime? _lastReadCaptureTime;
+
+  // 最近一次 read() 所读音频的平均电平 (原生采集线程写入时已算好)
+  double? _lastReadDbfs;
+  AudioLevels? _lastReadLevels;
 
   // PulseAudio 支持
   PulseAudioCapture? _pulseCapture;
   bool _usePulse = false; // 是否使用 PulseAudio
 
+  // 原生采集线程支持 (事件驱动，非阻塞读取)
+  NativeAudioCapture? _nativeCapture;
+  bool _useNative = false;
+
+  // 缓冲延迟协商
+  String _backendName = 'none';
+  double? _portAudioGrantedMs; // Dart 侧 PortAudio 流打开后协商的输入延迟
+
+  // 预录 (armed) 模式: 未录音时采集流保持运行，只保留最近一段音频
+  bool _armed = false;
+  int _prerollSamples = 0;
+  Timer? _prerollTimer;
+  static const Duration _prerollTrimInterval = Duration(milliseconds: 100);
+
+  /// 请求的采集缓冲延迟 (毫秒)，需在 warmup/start 之前设置
+  ///
+  /// libpulse 路径据此设置 fragsize，PortAudio 路径作为 suggestedLatency。
+  int targetLatencyMs = SettingsConstants.defaultAudioTargetLatencyMs;
+
+  /// 原生采集是否以设备原生采样率/格式打开并在本进程内重采样，需在 warmup 之前设置
+  bool deviceNativeFormat = SettingsConstants.defaultAudioDeviceNativeFormat;
+
   AudioCapture() : _bindings = PortAudioBindings();
 
   /// 智能选择默认设备
@@ -225,15 +291,24 @@ class AudioCapture {
       print('[AudioCapture] 📋 解析为 libpulse name: $pulseName');
     }
 
-    // 1. 优先尝试 PulseAudioCapture（与系统设置一致）
+    // 0. 优先使用原生采集线程 (不阻塞 Dart isolate)
+    if (_warmupNative(deviceName: deviceName, pulseName: pulseName)) {
+      return AudioCaptureError.none;
+    }
+
+    // 1. 回退到 Dart 侧 PulseAudioCapture（与系统设置一致）
     if (PulseAudioCapture.isAvailable()) {
       // ignore: avoid_print
       print('[AudioCapture] 🔍 尝试使用 libpulse-simple...');
       _pulseCapture = PulseAudioCapture();
-      final pulseResult = await _pulseCapture!.initialize(deviceName: pulseName);
+      final pulseResult = await _pulseCapture!.initialize(
+        deviceName: pulseName,
+        targetLatencyMs: targetLatencyMs,
+      );
       if (pulseResult == PulseAudioError.none) {
         _usePulse = true;
         _isWarmedUp = true;
+        _backendName = 'pulse-simple';
         _buffer = _pulseCapture!.buffer;
         // ignore: avoid_print
         print('[AudioCapture] ✅ 使用 libpulse-simple 预热成功');
@@ -254,16 +329,98 @@ class AudioCapture {
     return _warmupPortAudio(deviceName: deviceName);
   }
 
+  /// 使用原生采集线程预热
+  ///
+  /// 原生库内部依次尝试 libpulse 异步流与 PortAudio，设备解析沿用 Dart 侧逻辑。
+  /// 返回 false 时调用方回退到 Dart 侧实现。
+  bool _warmupNative({String? deviceName, String? pulseName}) {
+    final nativeCapture = NativeAudioCapture.tryCreate();
+    if (nativeCapture == null) {
+      // ignore: avoid_print
+      print('[AudioCapture] ⚠️ 原生采集库不可用，使用 Dart 采集');
+      return false;
+    }
+
+    // ignore: avoid_print
+    print('[AudioCapture] 🔍 尝试原生采集线程 (libpulse)...');
+    if (nativeCapture.initializePulse(
+          deviceName: pulseName,
+          targetLatencyMs: targetLatencyMs,
+          deviceNativeFormat: deviceNativeFormat,
+        ) ==
+        NativeCaptureError.none) {
+      _adoptNative(nativeCapture, 'native-pulse');
+      return true;
+    }
+
+    // ignore: avoid_print
+    print('[AudioCapture] 🔍 尝试原生采集线程 (PortAudio)...');
+    if (!_isInitialized) {
+      if (_bindings.initialize() != paNoError) {
+        nativeCapture.dispose();
+        return false;
+      }
+      _isInitialized = true;
+    }
+
+    final (deviceIndex, fallback) = _resolveDeviceIndex(deviceName);
+    _lastDeviceFallback = fallback;
+    final deviceInfo =
+        deviceIndex != paNoDevice ? _bindings.getDeviceInfo(deviceIndex) : nullptr;
+    if (deviceInfo != nullptr &&
+        nativeCapture.initializePortAudio(
+              deviceIndex,
+              _suggestedLatency(deviceInfo),
+              deviceNativeFormat: deviceNativeFormat,
+            ) ==
+            NativeCaptureError.none) {
+      _adoptNative(nativeCapture, 'native-portaudio');
+      return true;
+    }
+
+    _lastErrorDetail = nativeCapture.lastError;
+    // ignore: avoid_print
+    print('[AudioCapture] ⚠️ 原生采集初始化失败: ${nativeCapture.lastError}');
+    nativeCapture.dispose();
+    return false;
+  }
+
+  void _adoptNative(NativeAudioCapture nativeCapture, String backend) {
+    _nativeCapture = nativeCapture;
+    _useNative = true;
+    _isWarmedUp = true;
+    _backendName = backend;
+    _buffer ??= calloc<Float>(AudioConfig.framesPerBuffer);
+    // ignore: avoid_print
+    print('[AudioCapture] ✅ 使用原生采集线程预热成功 ($latencyReport)');
+  }
+
+  /// PortAudio suggestedLatency: 目标延迟不低于设备支持的最低输入延迟
+  double _suggestedLatency(Pointer<PaDeviceInfo> deviceInfo) {
+    final target = targetLatencyMs / 1000.0;
+    final minimum = deviceInfo.ref.defaultLowInputLatency;
+    return target > minimum ? target : minimum;
+  }
+
+  /// 记录 PortAudio 流打开后实际协商的输入延迟
+  void _recordPortAudioLatency() {
+    final info = _bindings.getStreamInfo(_stream!);
+    _portAudioGrantedMs =
+        info != nullptr ? info.ref.inputLatency * 1000.0 : null;
+  }
+
   /// 使用 PortAudio 预热（回退方案）
   Future<AudioCaptureError> _warmupPortAudio({String? deviceName}) async {
-    // 初始化 PortAudio
-    final initResult = _bindings.initialize();
-    if (initResult != paNoError) {
-      // ignore: avoid_print
-      print('[AudioCapture] ⚠️ PortAudio 初始化失败: $initResult');
-      return AudioCaptureError.initializationFailed;
+    // 初始化 PortAudio (原生采集尝试时可能已初始化)
+    if (!_isInitialized) {
+      final initResult = _bindings.initialize();
+      if (initResult != paNoError) {
+        // ignore: avoid_print
+        print('[AudioCapture] ⚠️ PortAudio 初始化失败: $initResult');
+        return AudioCaptureError.initializationFailed;
+      }
+      _isInitialized = true;
     }
-    _isInitialized = true;
 
     // 解析设备索引
     final (deviceIndex, fallback) = _resolveDeviceIndex(deviceName);
@@ -294,7 +451,7 @@ class AudioCapture {
     _inputParams!.ref.device = deviceIndex;
     _inputParams!.ref.channelCount = AudioConfig.channels;
     _inputParams!.ref.sampleFormat = paFloat32;
-    _inputParams!.ref.suggestedLatency = deviceInfo.ref.defaultLowInputLatency;
+    _inputParams!.ref.suggestedLatency = _suggestedLatency(deviceInfo);
     _inputParams!.ref.hostApiSpecificStreamInfo = nullptr;
 
     // 打开音频流
@@ -325,6 +482,7 @@ class AudioCapture {
     }
 
     _stream = _streamPtr!.value;
+    _recordPortAudioLatency();
 
     // 启动音频流，读取一帧数据让硬件准备好
     final startResult = _bindings.startStream(_stream!);
@@ -336,6 +494,7 @@ class AudioCapture {
     _isWarmedUp = true;
     _isCapturing = false;
     _usePulse = false;
+    _backendName = 'portaudio';
 
     // ignore: avoid_print
     print('[AudioCapture] ✅ 使用 PortAudio 预热成功');
@@ -446,6 +605,32 @@ class AudioCapture {
       return AudioCaptureError.none;
     }
 
+    // 未预热时优先尝试原生采集线程
+    if (!_isWarmedUp) {
+      final pulseName = deviceName != null && deviceName != 'default'
+          ? AudioDeviceService.instance.getDevicePulseName(deviceName)
+          : null;
+      _warmupNative(deviceName: deviceName, pulseName: pulseName);
+    }
+
+    // 预录模式: 采集流已在运行，保留的预录音频作为录音开头立即可读
+    if (_armed && _nativeCapture != null && _nativeCapture!.isCapturing) {
+      _nativeCapture!.trim(_prerollSamples);
+      _isCapturing = true;
+      return AudioCaptureError.none;
+    }
+
+    // 如果使用原生采集线程
+    if (_useNative && _nativeCapture != null) {
+      final result = _nativeCapture!.start();
+      if (result == NativeCaptureError.none) {
+        _isCapturing = true;
+        return AudioCaptureError.none;
+      }
+      _lastErrorDetail = _nativeCapture!.lastError;
+      return AudioCaptureError.streamStartFailed;
+    }
+
     // 如果使用 PulseAudio
     if (_usePulse && _pulseCapture != null) {
       final result = _pulseCapture!.start();
@@ -509,7 +694,7 @@ class AudioCapture {
     _inputParams!.ref.device = deviceIndex;
     _inputParams!.ref.channelCount = AudioConfig.channels;
     _inputParams!.ref.sampleFormat = paFloat32;
-    _inputParams!.ref.suggestedLatency = deviceInfo.ref.defaultLowInputLatency;
+    _inputParams!.ref.suggestedLatency = _suggestedLatency(deviceInfo);
     _inputParams!.ref.hostApiSpecificStreamInfo = nullptr;
 
     // 6. 打开音频流
@@ -542,6 +727,8 @@ class AudioCapture {
     }
 
     _stream = _streamPtr!.value;
+    _recordPortAudioLatency();
+    _backendName = 'portaudio';
 
     // 7. 启动音频流
     final startResult = _bindings.startStream(_stream!);
@@ -579,6 +766,7 @@ class AudioCapture {
     if (result == paNoError || result == paInputOverflowed) {
       _prebufferSamples = AudioConfig.firstFrameBuffer;
       _hasPrebuffer = true;
+      _prebufferCaptureTime = _blockingCaptureTime(_prebufferSamples);
       // ignore: avoid_print
       print('[AudioCapture] ✅ 首帧预缓冲完成 (${AudioConfig.firstFrameBuffer} samples)');
     } else {
@@ -594,8 +782,39 @@ class AudioCapture {
   ///
   /// 返回值:
   /// - > 0: 实际读取的样本数
+  /// - 0: 原生采集模式下暂无新数据 (不阻塞，配合 [waitForData] 使用)
   /// - -1: 读取失败 (检查 [lastReadError] 获取详细错误类型)
   int read(Pointer<Float> buffer, int samples) {
+    // 如果使用原生采集线程 (非阻塞)
+    if (_useNative && _nativeCapture != null) {
+      if (!_isCapturing) {
+        _lastReadError = AudioCaptureError.readFailed;
+        return -1;
+      }
+      final result = _nativeCapture!.read(buffer, samples);
+      if (result < 0) {
+        _lastReadError =
+            NativeAudioCapture.mapError(result) == NativeCaptureError.deviceLost
+                ? AudioCaptureError.deviceUnavailable
+                : AudioCaptureError.readFailed;
+        _lastErrorDetail = _nativeCapture!.lastError;
+        return -1;
+      }
+      _lastReadError = AudioCaptureError.none;
+      if (result > 0) {
+        _lastReadCaptureTime = _nativeCapture!.lastReadCaptureTime;
+        final levels = _nativeCapture!.levels;
+        if (levels != null) {
+          // 首次读取时没有上一快照，退化为最近一块的电平
+          _lastReadDbfs = _lastReadLevels == null
+              ? levels.dbfs
+              : levels.dbfsSince(_lastReadLevels);
+          _lastReadLevels = levels;
+        }
+      }
+      return result;
+    }
+
     // 如果使用 PulseAudio
     if (_usePulse && _pulseCapture != null) {
       if (!_isCapturing) {
@@ -608,6 +827,7 @@ class AudioCapture {
         return -1;
       }
       _lastReadError = AudioCaptureError.none;
+      _lastReadCaptureTime = _blockingCaptureTime(result);
       return result;
     }
 
@@ -627,6 +847,7 @@ class AudioCapture {
       final prebufferUsed = _prebufferSamples;
       _hasPrebuffer = false;
       _prebufferSamples = 0;
+      _lastReadCaptureTime = _prebufferCaptureTime;
 
       // 如果预缓冲数据不够，从流中读取剩余数据
       if (prebufferUsed < samples) {
@@ -654,6 +875,7 @@ class AudioCapture {
     // paInputOverflowed 时继续读取 (不视为错误)
     if (result == paInputOverflowed) {
       _lastReadError = AudioCaptureError.none;
+      _lastReadCaptureTime = _blockingCaptureTime(samples);
       return samples; // 数据仍然有效
     }
 
@@ -669,14 +891,109 @@ class AudioCapture {
     }
 
     _lastReadError = AudioCaptureError.none;
+    _lastReadCaptureTime = _blockingCaptureTime(samples);
     return samples;
   }
 
+  /// 阻塞读取刚返回时，倒推所读首个样本的采集时刻
+  ///
+  /// 末尾样本在 (服务器/设备延迟) 之前被采集，首个样本再早 [samples] 个样本时长。
+  /// libpulse-simple 的延迟查询包含尚未读走的数据；PortAudio 使用打开时协商的输入延迟。
+  DateTime _blockingCaptureTime(int samples) {
+    final now = DateTime.now();
+    final double latencyMs;
+    if (_usePulse && _pulseCapture != null) {
+      latencyMs = _pulseCapture!.latencyMs ?? 0;
+    } else {
+      latencyMs = _portAudioGrantedMs ?? 0;
+    }
+    final blockUs = samples * 1000000 ~/ AudioConfig.sampleRate;
+    return now.subtract(
+      Duration(microseconds: (latencyMs * 1000).round() + blockUs),
+    );
+  }
+
+  /// 进入预录模式
+  ///
+  /// 未录音时采集流保持运行，定期丢弃旧数据，只保留最近 [prerollMs] 毫秒；
+  /// 下一次 [start] 时这段音频作为录音开头立即可读，避免首字被截断。
+  /// 仅原生采集线程模式支持 (Dart 侧阻塞读取无法在后台持续采集)。
+  ///
+  /// 注意: 预录期间麦克风处于打开状态，调用方需向用户显示提示。
+  bool arm(int prerollMs) {
+    if (prerollMs <= 0) return false;
+    if (!_useNative || _nativeCapture == null) {
+      // ignore: avoid_print
+      print('[AudioCapture] ⚠️ 预录模式需要原生采集线程，已忽略');
+      return false;
+    }
+    if (!_nativeCapture!.isCapturing &&
+        _nativeCapture!.start() != NativeCaptureError.none) {
+      _lastErrorDetail = _nativeCapture!.lastError;
+      return false;
+    }
+
+    _prerollSamples = AudioConfig.sampleRate * prerollMs ~/ 1000;
+    _armed = true;
+    _prerollTimer?.cancel();
+    _prerollTimer = Timer.periodic(_prerollTrimInterval, (_) {
+      if (!_isCapturing) {
+        _nativeCapture?.trim(_prerollSamples);
+      }
+    });
+    // ignore: avoid_print
+    print('[AudioCapture] 🎙️ 预录模式已开启 (保留最近 ${prerollMs}ms)');
+    return true;
+  }
+
+  /// 退出预录模式，未录音时关闭采集流
+  void disarm() {
+    if (!_armed) return;
+    _armed = false;
+    _prerollTimer?.cancel();
+    _prerollTimer = null;
+    if (!_isCapturing) {
+      _nativeCapture?.stop();
+    }
+    // ignore: avoid_print
+    print('[AudioCapture] 🎙️ 预录模式已关闭');
+  }
+
+  /// 是否处于预录模式 (麦克风在未录音时也保持打开)
+  bool get isArmed => _armed;
+
+  /// 等待新的音频数据 (仅原生采集模式有效)
+  ///
+  /// 由采集线程在可读样本达到 [minSamples] 后唤醒，替代固定周期轮询。
+  /// 阻塞读取模式下立即返回 true，由 [read] 自身阻塞。
+  Future<bool> waitForData(Duration timeout, {int minSamples = 1}) async {
+    if (_useNative && _nativeCapture != null && _isCapturing) {
+      return _nativeCapture!.waitForData(timeout, minFrames: minSamples);
+    }
+    return true;
+  }
+
   /// 停止音频采集
   Future<void> stop() async {
     if (!_isCapturing) {
       return;
     }
+    _lastReadCaptureTime = null;
+    _lastReadDbfs = null;
+    _lastReadLevels = null;
+
+    // 预录模式: 只结束本次录音，采集流继续运行并回到监听状态
+    if (_armed) {
+      _isCapturing = false;
+      return;
+    }
+
+    // 如果使用原生采集线程
+    if (_useNative && _nativeCapture != null) {
+      _nativeCapture!.stop();
+      _isCapturing = false;
+      return;
+    }
 
     // 如果使用 PulseAudio
     if (_usePulse && _pulseCapture != null) {
@@ -700,6 +1017,19 @@ class AudioCapture {
 
   /// 释放所有资源
   void dispose() {
+    disarm();
+    _backendName = 'none';
+    _portAudioGrantedMs = null;
+
+    // 如果使用原生采集线程 (缓冲区由 AudioCapture 分配，交给 _cleanup 释放)
+    if (_useNative && _nativeCapture != null) {
+      _nativeCapture!.dispose();
+      _nativeCapture = null;
+      _useNative = false;
+      _isCapturing = false;
+      _isWarmedUp = false;
+    }
+
     // 如果使用 PulseAudio
     if (_usePulse && _pulseCapture != null) {
       _pulseCapture!.dispose();
@@ -764,6 +1094,57 @@ class AudioCapture {
   /// 是否正在采集
   bool get isCapturing => _isCapturing;
 
+  /// 最近一次 [read] 所读首个样本被麦克风采集的时刻
+  ///
+  /// 已扣除缓冲区驻留时间与音频服务器/设备延迟，用于测量语音到文字的端到端延迟。
+  /// 尚未读到数据时为 null。
+  DateTime? get lastReadCaptureTime => _lastReadCaptureTime;
+
+  /// 最近一次 [read] 所读音频的平均电平 (dBFS)
+  ///
+  /// 仅原生采集模式可用 (由采集线程的电平累计量差分得到，无需再遍历样本)，
+  /// 其他模式为 null。
+  double? get lastReadDbfs => _lastReadDbfs;
+
+  /// 是否为事件驱动模式 (原生采集线程，read 非阻塞)
+  bool get isEventDriven => _useNative;
+
+  /// 实测采集延迟 (毫秒)，仅原生采集模式可用
+  double? get captureLatencyMs => _nativeCapture?.latencyMs;
+
+  /// 最近一块音频的电平，仅原生采集模式且正在录音时可用
+  ///
+  /// 预录 (armed) 模式下未在录音时返回 null，动画不会跟随后台监听的声音。
+  AudioLevels? get levels =>
+      _useNative && _isCapturing ? _nativeCapture?.levels : null;
+
+  /// 当前采集后端的延迟协商结果
+  ///
+  /// libpulse-simple 无法回读授予的缓冲属性，granted 为 null；
+  /// PortAudio 只有打开时协商的输入延迟，measured 与 granted 相同。
+  CaptureLatencyReport get latencyReport {
+    double? granted;
+    double? measured;
+    int? deviceRate;
+    if (_useNative && _nativeCapture != null) {
+      granted = _nativeCapture!.grantedLatencyMs;
+      measured = _isCapturing ? _nativeCapture!.latencyMs : null;
+      deviceRate = _nativeCapture!.deviceSampleRate;
+    } else if (_usePulse && _pulseCapture != null) {
+      measured = _isCapturing ? _pulseCapture!.latencyMs : null;
+    } else if (_stream != null) {
+      granted = _portAudioGrantedMs;
+      measured = _isCapturing ? _portAudioGrantedMs : null;
+    }
+    return CaptureLatencyReport(
+      backend: _backendName,
+      targetMs: targetLatencyMs,
+      grantedMs: granted,
+      measuredMs: measured,
+      deviceRate: deviceRate,
+    );
+  }
+
   /// 是否已初始化
   bool get isInitialized => _isInitialized;
 
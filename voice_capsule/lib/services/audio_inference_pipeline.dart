@@ -1,9 +1,17 @@
 import 'dart:async';
+import 'dart:io';
 
 import '../constants/settings_constants.dart';
+import '../ffi/native_memory_bindings.dart';
 import 'asr/asr_engine.dart';
+import 'asr/two_pass_engine.dart';
+import 'asr/zipformer_engine.dart';
 import 'audio_capture.dart';
+import 'chunk_scheduler.dart';
+import 'energy_gate.dart';
+import 'hybrid_endpoint_detector.dart';
 import 'model_manager.dart';
+import 'pause_statistics.dart';
 import 'settings_service.dart';
 
 /// 流水线状态枚举
@@ -25,6 +33,9 @@ enum PipelineError {
 }
 
 /// 延迟统计信息 (AC5: 端到端延迟 < 200ms)
+///
+/// 从音频块首个样本被麦克风采集的时刻 (AudioCapture.lastReadCaptureTime) 计到
+/// 识别结果输出，包含缓冲区驻留、音频服务器/设备延迟与解码耗时。
 class LatencyStats {
   final int sampleCount;
   final double avgLatencyMs;
@@ -51,6 +62,38 @@ class LatencyStats {
       'max: ${maxLatencyMs.toStringAsFixed(1)}ms, over200ms: $overThresholdCount)';
 }
 
+/// 端点提交延迟统计
+///
+/// 从最后一个语音块结束 (混合模式取 Silero VAD 判定，规则模式取识别文本最后一次变化的块)
+/// 计到端点事件发出，即用户说完到整句提交的等待时间。
+class CommitLatencyStats {
+  final int sampleCount;
+  final double avgMs;
+  final double maxMs;
+
+  /// 由混合端点 (而非识别器规则) 先触发的次数
+  final int vadTriggeredCount;
+
+  const CommitLatencyStats({
+    required this.sampleCount,
+    required this.avgMs,
+    required this.maxMs,
+    required this.vadTriggeredCount,
+  });
+
+  factory CommitLatencyStats.empty() => const CommitLatencyStats(
+        sampleCount: 0,
+        avgMs: 0,
+        maxMs: 0,
+        vadTriggeredCount: 0,
+      );
+
+  @override
+  String toString() =>
+      'CommitLatencyStats(samples: $sampleCount, avg: ${avgMs.toStringAsFixed(0)}ms, '
+      'max: ${maxMs.toStringAsFixed(0)}ms, byVad: $vadTriggeredCount)';
+}
+
 /// VAD 端点事件 (Story 2-6)
 class EndpointEvent {
   /// 最终识别文本
@@ -68,17 +111,22 @@ class EndpointEvent {
   /// Story 3-7: 是否由设备断开触发
   final bool isDeviceLost;
 
+  /// 语音结束到本事件发出的延迟 (毫秒)，无法确定语音结束时刻时为 null
+  final double? commitLatencyMs;
+
   const EndpointEvent({
     required this.finalText,
     required this.isVadTriggered,
     required this.durationMs,
     required this.latencyStats,
     this.isDeviceLost = false,
+    this.commitLatencyMs,
   });
 
   @override
   String toString() =>
-      'EndpointEvent(text: "$finalText", vad: $isVadTriggered, duration: ${durationMs}ms, deviceLost: $isDeviceLost)';
+      'EndpointEvent(text: "$finalText", vad: $isVadTriggered, duration: ${durationMs}ms, deviceLost: $isDeviceLost'
+      '${commitLatencyMs != null ? ', commit: ${commitLatencyMs!.toStringAsFixed(0)}ms' : ''})';
 }
 
 /// VAD 配置 (Story 2-6)
@@ -93,19 +141,36 @@ class VadConfig {
   /// 注意: 此值在 start() 时传递给 Sherpa，运行时修改需重启 Pipeline
   final double? silenceThresholdSec;
 
+  /// 未指定 [silenceThresholdSec] 时，按持久化的句内停顿统计调整 Rule 2 阈值
+  ///
+  /// 统计在录音过程中更新、停止时保存，新阈值从下次录音开始生效
+  final bool adaptiveSilence;
+
+  /// 是否在识别前启用能量门限 (长时间静音不送入识别引擎)
+  ///
+  /// 仅对 Zipformer 生效；门限拖尾覆盖端点规则所需的尾部静音，不影响端点触发
+  final bool energyGate;
+
+  /// 端点检测模式，hybrid 仅对 Zipformer 生效且需要已下载 Silero VAD 模型
+  final EndpointMode endpointMode;
+
   const VadConfig({
     this.autoStopOnEndpoint = true,
     this.autoReset = false,
     this.silenceThresholdSec,
+    this.adaptiveSilence = false,
+    this.energyGate = false,
+    this.endpointMode = EndpointMode.rules,
   });
 
   /// 默认配置: 自动停止，不自动重置
   factory VadConfig.defaultConfig() => const VadConfig();
 
-  /// 连续识别配置: 不停止，自动重置
+  /// 连续识别配置: 不停止，自动重置，静音期间跳过解码
   factory VadConfig.continuous() => const VadConfig(
         autoStopOnEndpoint: false,
         autoReset: true,
+        energyGate: true,
       );
 }
 
@@ -132,6 +197,12 @@ class AudioInferencePipeline {
   // === 常量定义 ===
   /// 默认 Rule2 静音阈值 (秒) - 与 ZipformerConfig 默认值保持一致
   static const double kDefaultRule2Silence = 1.2;
+
+  /// Rule1 最小尾部静音 (秒) - 未说话时的端点
+  static const double kRule1MinTrailingSilence = 2.4;
+
+  /// 能量门限拖尾在端点规则之外多保留的时长 (毫秒)
+  static const int kEnergyGateHangoverMarginMs = 500;
   // === 依赖注入 (通过构造函数传入，便于测试) ===
   final AudioCapture _audioCapture;
   ASREngine _asrEngine; // 改为 ASREngine 抽象接口
@@ -140,6 +211,15 @@ class AudioInferencePipeline {
   // === 配置选项 ===
   final bool enableDebugLog;
 
+  /// 指定分块策略 (基准测试/测试用)，null 时按引擎读取设置
+  final ChunkPolicy? chunkPolicy;
+
+  /// 多久未录音后释放识别模型 (null 表示常驻内存)
+  final Duration? idleUnloadAfter;
+
+  /// 模型卸载/重新加载事件 (含 RSS，供诊断日志记录)
+  void Function(String message)? onResidencyEvent;
+
   // === 状态管理 ===
   final StreamController<String> _resultController =
       StreamController.broadcast();
@@ -147,10 +227,13 @@ class AudioInferencePipeline {
       StreamController.broadcast();
   final StreamController<EndpointEvent> _endpointController =
       StreamController.broadcast(); // Story 2-6: VAD 端点事件流
+  final StreamController<ASRResultDelta> _deltaController =
+      StreamController.broadcast();
   PipelineState _state = PipelineState.idle;
   PipelineError _lastError = PipelineError.none;
   bool _stopRequested = false;
   String _lastEmittedText = ''; // 用于去重
+  ASRResult _lastEmittedResult = ASRResult.empty(); // 用于计算增量
   Completer<void>? _loopCompleter; // 跟踪循环完成状态
   Completer<void>? _firstChunkCompleter; // 首帧处理完成信号 (冷启动优化)
   bool _isDisposed = false; // M1 修复: 防止在关闭后访问 StreamController
@@ -165,12 +248,48 @@ class AudioInferencePipeline {
   final List<double> _latencySamples = [];
   double _maxLatencyMs = 0;
 
+  // 识别前能量门限 (VadConfig.energyGate 且为 Zipformer 时创建)
+  EnergyGate? _energyGate;
+  EnergyGateStats? _lastGateStats; // 最近一次录音的门限统计
+  int _gatedMsTotal = 0; // 本进程累计拦下的音频 (毫秒)
+  double _savedDecodeMsTotal = 0; // 本进程累计估算节省的解码耗时 (毫秒)
+
+  // 混合端点 (EndpointMode.hybrid): VAD 跨录音复用，避免重复加载模型
+  SileroSpeechDetector? _speechDetector;
+  HybridEndpointDetector? _hybridEndpoint;
+  bool _endpointSinceSpeech = false; // 本段已触发端点，等待新的语音
+  DateTime? _lastSpeechEnd; // 最近一个语音块的结束时刻 (提交延迟起点)
+  final List<double> _commitLatencySamples = [];
+  int _vadCommitCount = 0;
+
+  // 自适应端点静音 (VadConfig.adaptiveSilence): 句内停顿统计与本次生效的阈值
+  PauseStatistics? _pauseStatistics;
+  NoiseFloorTracker? _pauseSpeechTracker; // 无 VAD 时以能量判定语音
+  double _silenceThresholdSec = kDefaultRule2Silence;
+
+  // 分块调度: 每块读取的样本数随录音进行变化
+  ChunkScheduler _chunkScheduler = ChunkScheduler(ChunkPolicy.fixed);
+
+  // 空闲卸载: 释放识别器与 VAD，下次 start 时重新加载
+  Timer? _idleUnloadTimer;
+  bool _modelsUnloaded = false;
+  int _idleUnloadCount = 0;
+  Duration? _lastReloadTime;
+  int? _lastUnloadFreedBytes;
+  Duration? _firstStartLatency;
+
+  // 当前识别器创建时使用的配置 (端点规则变化时需重建识别器)
+  ASRConfig? _loadedConfig;
+
   // === 构造函数 ===
   AudioInferencePipeline({
     required AudioCapture audioCapture,
     required ASREngine asrEngine,
     required ModelManager modelManager,
     this.enableDebugLog = false,
+    this.chunkPolicy,
+    this.idleUnloadAfter,
+    this.onResidencyEvent,
     VadConfig? vadConfig, // Story 2-6: 可选 VAD 配置
   })  : _audioCapture = audioCapture,
         _asrEngine = asrEngine,
@@ -185,6 +304,11 @@ class AudioInferencePipeline {
   /// 识别结果流 (去重后的文本)
   Stream<String> get resultStream => _resultController.stream;
 
+  /// 识别结果增量流 (与 [resultStream] 同步发送，按 token 比较上一次结果)
+  ///
+  /// 下游可据 [ASRResultDelta.keptTokens] 只处理变化的部分
+  Stream<ASRResultDelta> get deltaStream => _deltaController.stream;
+
   /// 状态变化流
   Stream<PipelineState> get stateStream => _stateController.stream;
 
@@ -206,6 +330,15 @@ class AudioInferencePipeline {
   /// Story 2-6: 当前 VAD 配置
   VadConfig get vadConfig => _vadConfig;
 
+  /// 结果的 token 是否覆盖完整文本且不会被整段改写，可按 token 判定
+  /// 稳定前缀提前上屏
+  ///
+  /// 只有单遍 Zipformer 流式引擎满足: SenseVoice 的文本为各语音段累积，
+  /// token 只含最近一段；两遍识别会在端点后用第二遍结果替换整段文本
+  bool get supportsEarlyCommit =>
+      _asrEngine.engineType == ASREngineType.zipformer &&
+      _asrEngine is! TwoPassEngine;
+
   /// Story 2-6: 设置 VAD 配置 (仅在 idle 状态有效)
   ///
   /// 返回 true 表示设置成功，返回 false 表示当前状态不允许修改。
@@ -250,6 +383,8 @@ class AudioInferencePipeline {
 
     // 2. 释放旧引擎资源 (但不关闭 StreamController)
     _asrEngine.dispose();
+    _modelsUnloaded = false;
+    _loadedConfig = null;
 
     // 3. 替换为新引擎
     _asrEngine = newEngine;
@@ -257,6 +392,7 @@ class AudioInferencePipeline {
     // 4. 重置状态
     _lastError = PipelineError.none;
     _lastEmittedText = '';
+    _lastEmittedResult = ASRResult.empty();
 
     if (enableDebugLog) {
       // ignore: avoid_print
@@ -285,6 +421,198 @@ class AudioInferencePipeline {
     );
   }
 
+  /// 能量门限统计 (拦下的静音时长与估算节省的解码耗时)，未启用门限时为 null
+  ///
+  /// 每次 [start] 清零，连续识别模式下跨端点累计。
+  EnergyGateStats? get energyGateStats => _energyGate?.stats;
+
+  /// 能量门限节省的解码耗时摘要 (最近一次录音与本进程累计)，未拦下过音频时为 null
+  String? get energyGateStatus {
+    final last = _lastGateStats;
+    if (last == null) return null;
+    return 'last $last, total gated ${(_gatedMsTotal / 1000).toStringAsFixed(1)}s, '
+        'saved ${_savedDecodeMsTotal.toStringAsFixed(0)}ms';
+  }
+
+  /// 端点提交延迟统计 (语音结束到端点事件)，每次 [start] 清零
+  CommitLatencyStats get commitLatencyStats {
+    if (_commitLatencySamples.isEmpty) {
+      return CommitLatencyStats.empty();
+    }
+    final sum = _commitLatencySamples.reduce((a, b) => a + b);
+    return CommitLatencyStats(
+      sampleCount: _commitLatencySamples.length,
+      avgMs: sum / _commitLatencySamples.length,
+      maxMs: _commitLatencySamples.reduce((a, b) => a > b ? a : b),
+      vadTriggeredCount: _vadCommitCount,
+    );
+  }
+
+  /// 本次录音生效的分块策略
+  ChunkPolicy get activeChunkPolicy => _chunkScheduler.policy;
+
+  /// 本次录音生效的 Rule 2 静音阈值 (秒)
+  double get silenceThresholdSec => _silenceThresholdSec;
+
+  /// 句内停顿统计，未启用自适应阈值时为 null
+  PauseStatistics? get pauseStatistics => _pauseStatistics;
+
+  /// 端点检测状态摘要 (用于诊断报告)
+  String get endpointStatus {
+    final buffer = StringBuffer()
+      ..write('mode=${_vadConfig.endpointMode.name}')
+      ..write(isHybridEndpointActive ? '' : '(rules)')
+      ..write(', rule2=${_silenceThresholdSec.toStringAsFixed(2)}s');
+    if (_vadConfig.silenceThresholdSec != null) {
+      buffer.write(' (fixed)');
+    } else if (_pauseStatistics != null) {
+      buffer.write(' (adaptive), $_pauseStatistics');
+    }
+    buffer.write(', $commitLatencyStats');
+    final gate = energyGateStatus;
+    if (gate != null) {
+      buffer.write('\ngate: $gate');
+    }
+    return buffer.toString();
+  }
+
+  /// 混合端点是否生效 (模式为 hybrid 且 VAD 模型加载成功)
+  bool get isHybridEndpointActive => _hybridEndpoint != null;
+
+  /// 识别模型是否已因空闲而释放 (下次 [start] 时重新加载)
+  bool get isModelUnloaded => _modelsUnloaded;
+
+  /// 本进程空闲卸载次数
+  int get idleUnloadCount => _idleUnloadCount;
+
+  /// 最近一次空闲卸载后重新加载的耗时
+  Duration? get lastReloadTime => _lastReloadTime;
+
+  /// 最近一次空闲卸载释放的 RSS 字节数 (卸载前减卸载后，未卸载过时为 null)
+  ///
+  /// 不大于 0 说明模型内存没有归还给系统，卸载没有达到目的。
+  int? get lastUnloadFreedBytes => _lastUnloadFreedBytes;
+
+  /// [engine] 创建识别器时读取模型文件的引擎 (两遍识别含第二遍的 SenseVoice)
+  static List<EngineType> modelEnginesFor(ASREngine engine) => [
+        engine.engineType == ASREngineType.zipformer
+            ? EngineType.zipformer
+            : EngineType.sensevoice,
+        if (engine is TwoPassEngine) EngineType.sensevoice,
+      ];
+
+  /// 本进程首次 [start] 的耗时 (按下快捷键到开始采集，含未完成的模型加载)
+  Duration? get firstStartLatency => _firstStartLatency;
+
+  /// 模型驻留状态摘要 (用于诊断报告)
+  String get residencyStatus {
+    final after = idleUnloadAfter;
+    final buffer = StringBuffer()
+      ..write(_modelsUnloaded ? 'unloaded' : 'resident')
+      ..write(', idle_unload=${after != null ? '${after.inMinutes}min' : 'off'}')
+      ..write(', unloads=$_idleUnloadCount');
+    final first = _firstStartLatency;
+    if (first != null) {
+      buffer.write(', first start=${first.inMilliseconds}ms');
+    }
+    final reload = _lastReloadTime;
+    if (reload != null) {
+      buffer.write(', last reload=${reload.inMilliseconds}ms');
+    }
+    final freed = _lastUnloadFreedBytes;
+    if (freed != null) {
+      buffer.write(', last unload freed=${_formatMb(freed)}');
+    }
+    buffer.write(', rss=${_formatMb(ProcessInfo.currentRss)}');
+    return buffer.toString();
+  }
+
+  /// 预加载识别器 (应用启动时调用，避免首次录音等待模型加载)
+  ///
+  /// 使用与 [start] 相同的配置，自适应阈值取当前停顿统计的推荐值，
+  /// 使首次录音无需因端点规则不同而重建识别器。
+  Future<ASRError> warmUp() async {
+    if (_asrEngine.isInitialized) return ASRError.none;
+    final adaptive = _vadConfig.adaptiveSilence &&
+            _asrEngine.engineType == ASREngineType.zipformer &&
+            SettingsService.instance.isInitialized
+        ? _adaptiveThreshold(SettingsService.instance.pauseStatistics)
+        : null;
+    final config = _buildConfig(
+        _vadConfig.silenceThresholdSec ?? adaptive ?? kDefaultRule2Silence);
+    final error = await _asrEngine.initialize(config);
+    if (error != ASRError.none) {
+      _loadedConfig = null;
+      return error;
+    }
+    _loadedConfig = config;
+    _modelsUnloaded = false;
+    return error;
+  }
+
+  /// 自适应 Rule2 阈值，按 0.1 秒取整 (避免统计的微小变化反复重建识别器)
+  static double? _adaptiveThreshold(PauseStatistics? statistics) {
+    if (statistics == null) return null;
+    final sec = statistics.recommendedThresholdSec(kDefaultRule2Silence);
+    return (sec * 10).round() / 10;
+  }
+
+  bool get _useInt8 => SettingsService.instance.isInitialized
+      ? SettingsService.instance.modelType == ModelType.int8
+      : true; // 默认使用 int8
+
+  /// 根据引擎类型创建配置 (推理线程数: 配置值或本机校准值)
+  ASRConfig _buildConfig(double silenceThreshold) {
+    final engineType = _asrEngine.engineType == ASREngineType.zipformer
+        ? EngineType.zipformer
+        : EngineType.sensevoice;
+    final numThreads = SettingsService.instance.isInitialized
+        ? SettingsService.instance.numThreadsFor(engineType)
+        : SettingsConstants.defaultNumThreads;
+    final provider = SettingsService.instance.isInitialized
+        ? SettingsService.instance.provider
+        : 'cpu';
+    if (engineType == EngineType.zipformer) {
+      return ZipformerConfig(
+        modelDir: _modelManager.getModelPathForEngine(EngineType.zipformer),
+        useInt8Model: _useInt8,
+        numThreads: numThreads,
+        provider: provider,
+        sampleRate: 16000,
+        enableEndpoint: true, // Story 2-6: VAD 端点检测
+        rule1MinTrailingSilence: kRule1MinTrailingSilence,
+        rule2MinTrailingSilence: silenceThreshold,
+        rule3MinUtteranceLength: 20.0,
+      );
+    }
+    // SenseVoice 配置
+    final settings = SettingsService.instance;
+    return SenseVoiceConfig(
+      modelDir: _modelManager.getModelPathForEngine(EngineType.sensevoice),
+      vadModelPath: _modelManager.vadModelFilePath,
+      numThreads: numThreads,
+      provider: provider,
+      partialIntervalMs: settings.isInitialized
+          ? settings.senseVoicePartialIntervalMs
+          : SettingsConstants.defaultSenseVoicePartialIntervalMs,
+      partialMaxLoad: settings.isInitialized
+          ? settings.senseVoicePartialMaxLoad
+          : SettingsConstants.defaultSenseVoicePartialMaxLoad,
+    );
+  }
+
+  /// 两份配置的端点规则是否一致 (未记录配置时视为不一致)
+  static bool _sameEndpointRules(ASRConfig? loaded, ASRConfig config) {
+    if (loaded == null) return false;
+    if (loaded is! ZipformerConfig || config is! ZipformerConfig) {
+      return loaded.runtimeType == config.runtimeType;
+    }
+    return loaded.enableEndpoint == config.enableEndpoint &&
+        loaded.rule1MinTrailingSilence == config.rule1MinTrailingSilence &&
+        loaded.rule2MinTrailingSilence == config.rule2MinTrailingSilence &&
+        loaded.rule3MinUtteranceLength == config.rule3MinUtteranceLength;
+  }
+
   /// 启动流水线
   ///
   /// 初始化音频采集和识别引擎，然后开始采集循环。
@@ -300,6 +628,9 @@ class AudioInferencePipeline {
     }
 
     _setState(PipelineState.initializing);
+    final startWatch = Stopwatch()..start();
+    _idleUnloadTimer?.cancel();
+    _idleUnloadTimer = null;
 
     // AC5: 重置延迟统计
     _latencySamples.clear();
@@ -308,6 +639,10 @@ class AudioInferencePipeline {
     // Story 2-6: 重置 VAD 状态
     _recordingStartTime = DateTime.now();
     _vadTriggeredStop = false;
+    _commitLatencySamples.clear();
+    _vadCommitCount = 0;
+    _lastSpeechEnd = null;
+    _endpointSinceSpeech = false;
 
     // 1. 检查当前引擎的模型就绪状态
     final engineType = _asrEngine.engineType == ASREngineType.zipformer
@@ -319,38 +654,108 @@ class AudioInferencePipeline {
     }
 
     // 2. 初始化 ASREngine (使用 VadConfig 中的静音阈值和 SettingsService 中的模型类型)
-    final silenceThreshold =
-        _vadConfig.silenceThresholdSec ?? kDefaultRule2Silence;
-    final useInt8 = SettingsService.instance.isInitialized
-        ? SettingsService.instance.modelType == ModelType.int8
-        : true; // 默认使用 int8
-
-    // 根据引擎类型创建配置
-    final ASRConfig config;
-    if (_asrEngine.engineType == ASREngineType.zipformer) {
-      config = ZipformerConfig(
-        modelDir: _modelManager.getModelPathForEngine(EngineType.zipformer),
-        useInt8Model: useInt8,
-        numThreads: 2,
-        sampleRate: 16000,
-        enableEndpoint: true, // Story 2-6: VAD 端点检测
-        rule1MinTrailingSilence: 2.4,
-        rule2MinTrailingSilence: silenceThreshold,
-        rule3MinUtteranceLength: 20.0,
-      );
-    } else {
-      // SenseVoice 配置
-      config = SenseVoiceConfig(
-        modelDir: _modelManager.getModelPathForEngine(EngineType.sensevoice),
-        vadModelPath: _modelManager.vadModelFilePath,
-      );
+    // 未指定阈值时，按用户的句内停顿统计在安全范围内调整
+    _pauseStatistics = null;
+    _pauseSpeechTracker = null;
+    if (_vadConfig.adaptiveSilence &&
+        _vadConfig.silenceThresholdSec == null &&
+        _asrEngine.engineType == ASREngineType.zipformer &&
+        SettingsService.instance.isInitialized) {
+      _pauseStatistics = SettingsService.instance.pauseStatistics
+        ..beginSession();
+      _pauseSpeechTracker = NoiseFloorTracker();
+    }
+    final silenceThreshold = _vadConfig.silenceThresholdSec ??
+        _adaptiveThreshold(_pauseStatistics) ??
+        kDefaultRule2Silence;
+    _silenceThresholdSec = silenceThreshold;
+    final config = _buildConfig(silenceThreshold);
+
+    // 识别器已加载但端点规则不同 (阈值或 VAD 配置变化): 端点规则在创建
+    // 识别器时固定，需重建后才能生效
+    if (_asrEngine.isInitialized &&
+        !_sameEndpointRules(_loadedConfig, config)) {
+      _reportResidency('端点规则变化，重建识别器 '
+          '(Rule2 ${silenceThreshold.toStringAsFixed(1)}s)');
+      _asrEngine.dispose();
+      _modelsUnloaded = true;
+    }
+
+    // 模型已卸载 (空闲卸载或重建识别器): 预读模型文件并先启动采集，
+    // 重新加载期间的音频留在采集环形缓冲区中，加载完成后由采集循环照常读取
+    final reloadWatch = _modelsUnloaded ? (Stopwatch()..start()) : null;
+    if (reloadWatch != null) {
+      for (final engine in modelEnginesFor(_asrEngine)) {
+        _modelManager.prefetchModelFiles(engine, useInt8: _useInt8);
+      }
+      final audioError = await _audioCapture.start();
+      if (audioError != AudioCaptureError.none) {
+        _setError(PipelineError.audioInitFailed);
+        return _lastError;
+      }
     }
 
     final asrError = await _asrEngine.initialize(config);
     if (asrError != ASRError.none) {
+      if (reloadWatch != null) await _audioCapture.stop();
+      _loadedConfig = null;
       _setError(PipelineError.recognizerFailed);
       return _lastError;
     }
+    _loadedConfig = config;
+    if (reloadWatch != null) {
+      _modelsUnloaded = false;
+      _lastReloadTime = reloadWatch.elapsed;
+      _reportResidency('重新加载识别模型: ${reloadWatch.elapsedMilliseconds}ms, '
+          'RSS ${_formatMb(ProcessInfo.currentRss)}');
+    }
+
+    // 能量门限: 拖尾需覆盖两条端点规则中较长的尾部静音
+    _energyGate?.dispose();
+    _energyGate = null;
+    if (_vadConfig.energyGate &&
+        _asrEngine.engineType == ASREngineType.zipformer) {
+      final ruleSec = silenceThreshold > kRule1MinTrailingSilence
+          ? silenceThreshold
+          : kRule1MinTrailingSilence;
+      _energyGate = EnergyGate(
+        config: EnergyGateConfig(
+          hangoverMs: (ruleSec * 1000).round() + kEnergyGateHangoverMarginMs,
+        ),
+        sampleRate: AudioConfig.sampleRate,
+      );
+    }
+
+    // 混合端点: 低置信度时的静音上限与 Rule2 一致，规则端点仍作兜底
+    _hybridEndpoint = null;
+    if (_vadConfig.endpointMode == EndpointMode.hybrid &&
+        _asrEngine.engineType == ASREngineType.zipformer) {
+      final endpointConfig =
+          HybridEndpointConfig(maxSilenceSec: silenceThreshold);
+      _speechDetector ??= SileroSpeechDetector.create(
+        _modelManager.vadModelFilePath,
+        config: endpointConfig,
+        sampleRate: AudioConfig.sampleRate,
+      );
+      if (_speechDetector != null) {
+        _speechDetector!.reset();
+        _hybridEndpoint = HybridEndpointDetector(config: endpointConfig);
+      } else {
+        // ignore: avoid_print
+        print('[Pipeline] ⚠️ Silero VAD 不可用，端点检测回退为规则模式');
+      }
+    }
+
+    // 分块策略: 未加载设置时保持固定 100ms 块
+    final ChunkPolicy policy;
+    if (chunkPolicy != null) {
+      policy = chunkPolicy!;
+    } else if (SettingsService.instance.isInitialized) {
+      policy = SettingsService.instance.chunkPolicyFor(engineType);
+    } else {
+      policy = ChunkPolicy.fixed;
+    }
+    _chunkScheduler = ChunkScheduler(policy, sampleRate: AudioConfig.sampleRate);
 
     // 3. 启动 AudioCapture
     final audioError = await _audioCapture.start();
@@ -379,6 +784,10 @@ class AudioInferencePipeline {
       // 忽略超时异常
     }
 
+    if (_firstStartLatency == null) {
+      _firstStartLatency = startWatch.elapsed;
+      _reportResidency('首次录音启动耗时: ${startWatch.elapsedMilliseconds}ms');
+    }
     return PipelineError.none;
   }
 
@@ -404,8 +813,29 @@ class AudioInferencePipeline {
       }
     }
 
-    // 获取最终识别结果
-    _asrEngine.inputFinished();
+    final gateStats = _energyGate?.stats;
+    if (gateStats != null && gateStats.gatedMs > 0) {
+      // 计入诊断报告 (端点检测一节)
+      _lastGateStats = gateStats;
+      _gatedMsTotal += gateStats.gatedMs;
+      _savedDecodeMsTotal += gateStats.savedDecodeMs;
+    }
+    if (_commitLatencySamples.isNotEmpty) {
+      // ignore: avoid_print
+      print('[Pipeline] 端点提交延迟: $commitLatencyStats');
+    }
+    final pauseStatistics = _pauseStatistics;
+    if (pauseStatistics != null) {
+      await SettingsService.instance.savePauseStatistics(pauseStatistics);
+      if (enableDebugLog) {
+        // ignore: avoid_print
+        print('[Pipeline] 句内停顿: $pauseStatistics, 下次阈值: '
+            '${pauseStatistics.recommendedThresholdSec(kDefaultRule2Silence).toStringAsFixed(2)}s');
+      }
+    }
+
+    // 获取最终识别结果 (后台解码的引擎异步等待，不阻塞 UI isolate)
+    await _asrEngine.finishInput();
     while (_asrEngine.isReady()) {
       _asrEngine.decode();
     }
@@ -434,18 +864,72 @@ class AudioInferencePipeline {
     // 重置状态
     _stopRequested = false;
     _lastEmittedText = '';
+    _lastEmittedResult = ASRResult.empty();
     _loopCompleter = null;
     _vadTriggeredStop = false; // Story 2-6: 重置标志
     _recordingStartTime = null; // Story 2-6: 清空录音开始时间
     _setState(PipelineState.idle);
+    _scheduleIdleUnload();
 
     return finalResult.text;
   }
 
+  /// 录音结束后开始空闲计时
+  void _scheduleIdleUnload() {
+    _idleUnloadTimer?.cancel();
+    _idleUnloadTimer = null;
+    final after = idleUnloadAfter;
+    if (after == null || after <= Duration.zero) return;
+    _idleUnloadTimer = Timer(after, _unloadIdleModels);
+  }
+
+  /// 空闲超时: 释放识别器与 VAD，并把释放的内存归还给系统
+  void _unloadIdleModels() {
+    _idleUnloadTimer = null;
+    if (_isDisposed ||
+        _state != PipelineState.idle ||
+        !_asrEngine.isInitialized) {
+      return;
+    }
+
+    final rssBefore = ProcessInfo.currentRss;
+    _asrEngine.dispose();
+    _loadedConfig = null;
+    _speechDetector?.dispose();
+    _speechDetector = null;
+    _hybridEndpoint = null;
+    // onnxruntime 释放的内存多留在 malloc 空闲链表中，不归还则 RSS 不降
+    try {
+      NativeMemoryBindings().trim();
+    } catch (_) {
+      // 原生库不可用时只释放模型
+    }
+    _modelsUnloaded = true;
+    _idleUnloadCount++;
+    final rssAfter = ProcessInfo.currentRss;
+    _lastUnloadFreedBytes = rssBefore - rssAfter;
+    _reportResidency('空闲 ${idleUnloadAfter!.inMinutes} 分钟，已释放识别模型: '
+        'RSS ${_formatMb(rssBefore)} → ${_formatMb(rssAfter)}'
+        '${rssAfter >= rssBefore ? ' (⚠️ RSS 未下降)' : ''}');
+  }
+
+  void _reportResidency(String message) {
+    onResidencyEvent?.call(message);
+    if (enableDebugLog) {
+      // ignore: avoid_print
+      print('[Pipeline] $message');
+    }
+  }
+
+  static String _formatMb(int bytes) =>
+      '${(bytes / (1024 * 1024)).toStringAsFixed(0)}MB';
+
   /// 释放所有资源
   Future<void> dispose() async {
     // M1 修复: 标记已释放，防止后续访问 StreamController
     _isDisposed = true;
+    _idleUnloadTimer?.cancel();
+    _idleUnloadTimer = null;
 
     // 1. 如果正在运行或正在停止，先确保停止
     if (_state == PipelineState.running || _state == PipelineState.stopping) {
@@ -462,11 +946,15 @@ class AudioInferencePipeline {
       }
       await _audioCapture.stop();
     }
+    _energyGate?.dispose();
+    _speechDetector?.dispose();
+    _speechDetector = null;
 
     // 2. 关闭 StreamController
     await _resultController.close();
     await _stateController.close();
     await _endpointController.close(); // Story 2-6: 关闭端点事件流
+    await _deltaController.close();
 
     // 3. 释放原生资源
     _audioCapture.dispose();
@@ -482,13 +970,28 @@ class AudioInferencePipeline {
   // === 私有方法 ===
 
   /// 启动采集-推理循环
+  ///
+  /// 块长由 [ChunkScheduler] 决定 (录音开头小块，之后逐步增大)。
+  /// 原生采集线程模式下由采集线程在攒够一块后唤醒 (事件驱动)；
+  /// 阻塞读取模式下按块长周期读取。
   Future<void> _startCaptureLoop() async {
     _loopCompleter = Completer<void>();
     final stopwatch = Stopwatch();
-    const targetDurationMs = 100;
+    const checkIntervalMs = 100;
     bool isFirstChunk = true; // 首帧标记
+    final eventDriven = _audioCapture.isEventDriven;
 
     while (!_stopRequested && _state == PipelineState.running) {
+      if (eventDriven) {
+        // 超时仅用于定期检查停止标志，不影响数据到达后的响应
+        await _audioCapture.waitForData(
+          const Duration(milliseconds: checkIntervalMs),
+          minSamples: _chunkScheduler.targetSamples,
+        );
+        if (_stopRequested || _state != PipelineState.running) break;
+      }
+      final targetDurationMs = _chunkScheduler.targetMs;
+
       stopwatch.reset();
       stopwatch.start();
 
@@ -516,7 +1019,7 @@ class AudioInferencePipeline {
 
       // 可中断的延迟: 每 10ms 检查一次停止标志
       final elapsedMs = stopwatch.elapsedMilliseconds;
-      if (elapsedMs < targetDurationMs) {
+      if (!eventDriven && elapsedMs < targetDurationMs) {
         final remainingMs = targetDurationMs - elapsedMs;
         await _interruptibleDelay(remainingMs);
       }
@@ -533,6 +1036,7 @@ class AudioInferencePipeline {
       _asrEngine.reset();
       _stopRequested = false;
       _lastEmittedText = '';
+      _lastEmittedResult = ASRResult.empty();
       _vadTriggeredStop = false;
       _recordingStartTime = null;
       _setState(PipelineState.idle);
@@ -558,19 +1062,26 @@ class AudioInferencePipeline {
     // M1 修复: 如果已释放，直接返回
     if (_isDisposed) return;
 
-    // AC5 延迟测量: 记录音频采集开始时间
-    final chunkStartTime = DateTime.now();
+    // 采集层无法提供时间戳时，退化为以读取开始时刻作为延迟起点
+    final readStartTime = DateTime.now();
 
     // 零拷贝: 直接使用 AudioCapture 的内部缓冲区
     final buffer = _audioCapture.buffer;
-    final samplesRead = _audioCapture.read(buffer, AudioConfig.framesPerBuffer);
+    final samplesRead =
+        _audioCapture.read(buffer, _chunkScheduler.targetSamples);
+    if (samplesRead > 0) {
+      _chunkScheduler.advance(samplesRead);
+    }
+
+    // AC5 延迟测量: 以本块首个样本的真实采集时刻为起点
+    final captureTime = _audioCapture.lastReadCaptureTime ?? readStartTime;
 
     // 错误检查: read() 返回 -1 表示错误
     if (samplesRead == -1) {
       final error = _audioCapture.lastReadError;
       if (error == AudioCaptureError.deviceUnavailable) {
         // Story 3-7: 设备丢失时发送 EndpointEvent 并保存已识别文本
-        _handleDeviceLost();
+        await _handleDeviceLost();
         _setError(PipelineError.deviceUnavailable);
         _stopRequested = true; // 触发循环退出
       }
@@ -578,21 +1089,96 @@ class AudioInferencePipeline {
     }
 
     if (samplesRead > 0) {
+      // 能量门限: 纯静音块不送入识别，只保留最近一段供重新打开时补送
+      final chunkSec = samplesRead / AudioConfig.sampleRate;
+      double? chunkDbfs;
+      double blockDbfs() => chunkDbfs ??= _audioCapture.lastReadDbfs ??
+          EnergyGate.measureDbfs(buffer, samplesRead);
+
+      final gate = _energyGate;
+      if (gate != null) {
+        if (!gate.process(blockDbfs(), samplesRead)) {
+          gate.hold(buffer, samplesRead);
+          _pauseStatistics?.feed(false, chunkSec);
+          return;
+        }
+      }
+      final decodeWatch = gate != null ? (Stopwatch()..start()) : null;
+      // 工作线程异步解码: 取其累计解码耗时的增量 (按会话累计近似)
+      final asrEngine = _asrEngine;
+      final workerDecodeStart =
+          gate != null ? _workerDecodeTime(asrEngine) : null;
+
+      final speechDetector = _hybridEndpoint != null ? _speechDetector : null;
+      var fedSamples = samplesRead;
+      gate?.drainHeld((held, heldSamples) {
+        _asrEngine.acceptWaveform(AudioConfig.sampleRate, held, heldSamples);
+        speechDetector?.accept(held, heldSamples);
+        fedSamples += heldSamples;
+      });
+
       // 同一指针传给 ASREngine (零拷贝)
       _asrEngine.acceptWaveform(AudioConfig.sampleRate, buffer, samplesRead);
+      final isSpeech = speechDetector?.accept(buffer, samplesRead) ?? false;
+
+      // 句内停顿统计: 有 VAD 时用 VAD 判定，否则按噪声底判定
+      final pauseStatistics = _pauseStatistics;
+      if (pauseStatistics != null) {
+        final speech = speechDetector != null
+            ? isSpeech
+            : _pauseSpeechTracker!.update(blockDbfs(), chunkSec);
+        pauseStatistics.feed(speech, chunkSec);
+      }
 
       // 解码并获取结果 (仅当有足够数据时)
       while (_asrEngine.isReady()) {
         _asrEngine.decode();
       }
+      if (decodeWatch != null) {
+        final workerDecodeEnd = _workerDecodeTime(asrEngine);
+        gate!.recordDecode(
+          fedSamples,
+          workerDecodeStart != null && workerDecodeEnd != null
+              ? workerDecodeEnd - workerDecodeStart
+              : decodeWatch.elapsed,
+        );
+      }
 
       final result = _asrEngine.getResult();
+      final textChanged =
+          result.text.isNotEmpty && result.text != _lastEmittedText;
+      final chunkEnd = captureTime.add(Duration(
+          microseconds: samplesRead * 1000000 ~/ AudioConfig.sampleRate));
+
+      // 混合端点: 以 VAD 计时尾部静音；规则模式以文本最后变化的块近似语音结束
+      var hybridEndpoint = false;
+      final hybrid = _hybridEndpoint;
+      if (hybrid != null) {
+        if (isSpeech) _endpointSinceSpeech = false;
+        hybridEndpoint = hybrid.update(
+          speech: isSpeech,
+          seconds: chunkSec,
+          chunkEnd: chunkEnd,
+          hasText: result.text.isNotEmpty,
+          textChanged: textChanged,
+        );
+        _lastSpeechEnd = hybrid.lastSpeechEnd;
+      } else if (textChanged) {
+        _lastSpeechEnd = chunkEnd;
+      }
 
       // 去重: 只在文本变化时发送事件
-      if (result.text.isNotEmpty && result.text != _lastEmittedText) {
-        // AC5 延迟测量: 计算端到端延迟 (音频采集到结果输出)
+      if (textChanged) {
+        // AC5 延迟测量: 计算端到端延迟 (语音被采集到结果输出)
+        // 工作线程解码可能落后于刚送入的块: 以结果覆盖到的最后一个样本的
+        // 采集时刻为起点，而不是本块的采集时刻
+        final pending = _workerPendingSamples(_asrEngine);
+        final latencyStart = pending == null
+            ? captureTime
+            : chunkEnd.subtract(Duration(
+                microseconds: pending * 1000000 ~/ AudioConfig.sampleRate));
         final latencyMs =
-            DateTime.now().difference(chunkStartTime).inMilliseconds.toDouble();
+            DateTime.now().difference(latencyStart).inMicroseconds / 1000.0;
         _latencySamples.add(latencyMs);
         if (latencyMs > _maxLatencyMs) {
           _maxLatencyMs = latencyMs;
@@ -603,30 +1189,53 @@ class AudioInferencePipeline {
               '[Pipeline] ⚠️ 延迟超标: ${latencyMs.toStringAsFixed(1)}ms > ${_latencyThresholdMs}ms');
         }
 
+        // 增量只在有订阅者时计算 (比较 token 需要拆分整块拷贝的 token)
+        final delta = _deltaController.hasListener
+            ? ASRResultDelta.between(_lastEmittedResult, result)
+            : null;
         _lastEmittedText = result.text;
+        _lastEmittedResult = result;
         // M1 修复: 检查 StreamController 是否已关闭
         if (!_isDisposed && !_resultController.isClosed) {
           _resultController.add(result.text);
         }
+        if (delta != null && !_isDisposed && !_deltaController.isClosed) {
+          _deltaController.add(delta);
+        }
       }
 
-      // Story 2-6: VAD 端点检测
-      final isEndpointDetected = _asrEngine.isEndpoint();
+      // Story 2-6: VAD 端点检测 (混合模式下与规则端点先到者生效，同一段只触发一次)
+      final ruleEndpoint = _asrEngine.isEndpoint() && !_endpointSinceSpeech;
+      final isEndpointDetected = ruleEndpoint || hybridEndpoint;
       // 调试：只在有识别结果或端点检测时打印
       if (enableDebugLog && (result.text.isNotEmpty || isEndpointDetected)) {
         // ignore: avoid_print
         print('[Pipeline] 识别: "${result.text}", endpoint: $isEndpointDetected');
       }
       if (isEndpointDetected && !_vadTriggeredStop) {
-        await _handleEndpoint();
+        await _handleEndpoint(byVad: hybridEndpoint && !ruleEndpoint);
       }
     }
   }
 
+  /// 引擎工作线程累计解码耗时 (同步解码的引擎返回 null)
+  static Duration? _workerDecodeTime(ASREngine engine) => switch (engine) {
+        ZipformerEngine e => e.workerDecodeTime,
+        TwoPassEngine e => e.workerDecodeTime,
+        _ => null,
+      };
+
+  /// 引擎已送入但尚未反映在结果中的样本数 (同步解码的引擎返回 null)
+  static int? _workerPendingSamples(ASREngine engine) => switch (engine) {
+        ZipformerEngine e => e.workerPendingSamples,
+        TwoPassEngine e => e.workerPendingSamples,
+        _ => null,
+      };
+
   /// Story 3-7: 处理设备丢失事件
   /// 当 PortAudio 检测到设备不可用时调用
   /// 发送带有 isDeviceLost=true 的 EndpointEvent，保存当前识别的文本
-  void _handleDeviceLost() {
+  Future<void> _handleDeviceLost() async {
     if (_isDisposed || _endpointController.isClosed) return;
 
     // 1. 尝试获取当前已识别的文本
@@ -634,7 +1243,7 @@ class AudioInferencePipeline {
 
     // 尝试从 ASREngine 获取最新结果
     try {
-      _asrEngine.inputFinished();
+      await _asrEngine.finishInput();
       while (_asrEngine.isReady()) {
         _asrEngine.decode();
       }
@@ -663,6 +1272,7 @@ class AudioInferencePipeline {
       latencyStats: latencyStats,
       isDeviceLost: true,
     );
+    if (_isDisposed || _endpointController.isClosed) return;
     _endpointController.add(event);
 
     if (enableDebugLog) {
@@ -672,7 +1282,24 @@ class AudioInferencePipeline {
   }
 
   /// Story 2-6: 处理 VAD 端点检测
-  Future<void> _handleEndpoint() async {
+  ///
+  /// [byVad] 为 true 表示由混合端点 (Silero VAD) 先于识别器规则触发
+  Future<void> _handleEndpoint({bool byVad = false}) async {
+    // 提交延迟: 语音结束到端点事件发出
+    final speechEnd = _lastSpeechEnd;
+    final commitLatencyMs = speechEnd != null
+        ? DateTime.now().difference(speechEnd).inMicroseconds / 1000.0
+        : null;
+    if (commitLatencyMs != null) {
+      _commitLatencySamples.add(commitLatencyMs);
+      if (byVad) _vadCommitCount++;
+    }
+    _lastSpeechEnd = null;
+    if (_hybridEndpoint != null) {
+      _endpointSinceSpeech = true;
+      _hybridEndpoint!.reset();
+    }
+
     try {
       // PTT 累积模式：不调用 inputFinished()，只获取当前结果
       // inputFinished() 会使引擎进入"结束"状态，导致后续音频无法累积
@@ -680,8 +1307,12 @@ class AudioInferencePipeline {
           !_vadConfig.autoStopOnEndpoint && !_vadConfig.autoReset;
 
       if (!isPttAccumulateMode) {
+        // 端点真正结束了这句话，尾部静音不计入句内停顿；
+        // PTT 累积模式下端点不截断，之后继续说话的停顿正是需要学习的样本
+        _pauseStatistics?.endUtterance();
+
         // 非 PTT 累积模式：调用 inputFinished() 确保最终解码
-        _asrEngine.inputFinished();
+        await _asrEngine.finishInput();
         while (_asrEngine.isReady()) {
           _asrEngine.decode();
         }
@@ -700,6 +1331,7 @@ class AudioInferencePipeline {
         isVadTriggered: true,
         durationMs: durationMs,
         latencyStats: latencyStats,
+        commitLatencyMs: commitLatencyMs,
       );
       if (!_isDisposed && !_endpointController.isClosed) {
         _endpointController.add(event);
@@ -718,6 +1350,7 @@ class AudioInferencePipeline {
       } else if (_vadConfig.autoReset) {
         _asrEngine.reset();
         _lastEmittedText = '';
+        _lastEmittedResult = ASRResult.empty();
         _recordingStartTime = DateTime.now();
       }
       // PTT 累积模式 (!autoStopOnEndpoint && !autoReset)：什么都不做，继续累积
@@ -0,0 +1,135 @@
+import 'dart:math' as math;
+
+import '../constants/settings_constants.dart';
+
+/// 分块策略: 每次送入识别引擎的音频块长度随录音进行而变化
+///
+/// 录音开头用小块，首个部分结果不必等满一个大块；流稳定后逐步加倍到大块，
+/// 减少每块固定开销 (FFI 调用、取结果、端点判断) 以提高吞吐。
+class ChunkPolicy {
+  /// 策略名 (用于基准测试输出与设置)
+  final String name;
+
+  /// 起始块长 (毫秒)
+  final int initialMs;
+
+  /// 稳定块长 (毫秒)
+  final int steadyMs;
+
+  /// 起始阶段时长 (毫秒)，之后块长每块加倍直到 [steadyMs]
+  final int rampAfterMs;
+
+  const ChunkPolicy({
+    required this.name,
+    required this.initialMs,
+    required this.steadyMs,
+    this.rampAfterMs = 1000,
+  });
+
+  /// 块长允许范围 (毫秒): 下限为首帧预缓冲 (20ms)，上限受 AudioCapture 缓冲区 (100ms) 限制
+  static const int minChunkMs = 20;
+  static const int maxChunkMs = 100;
+
+  /// 固定 100ms 块 (原有行为)
+  static const ChunkPolicy fixed = ChunkPolicy(
+    name: 'fixed',
+    initialMs: 100,
+    steadyMs: 100,
+    rampAfterMs: 0,
+  );
+
+  /// 首秒 20ms 块，之后加倍到 100ms
+  static const ChunkPolicy adaptive = ChunkPolicy(
+    name: 'adaptive',
+    initialMs: 20,
+    steadyMs: 100,
+  );
+
+  /// 全程 20ms 块 (最低延迟，开销最大)
+  static const ChunkPolicy small = ChunkPolicy(
+    name: 'small',
+    initialMs: 20,
+    steadyMs: 20,
+    rampAfterMs: 0,
+  );
+
+  /// 内置策略 (基准测试按此顺序比较)
+  static const List<ChunkPolicy> builtIn = [fixed, adaptive, small];
+
+  /// 引擎默认策略
+  ///
+  /// Zipformer 流式解码，首块越小首个部分结果越早；
+  /// SenseVoice 由 VAD 分段后离线识别，起始块取 Silero 窗口 (512 样本 = 32ms)
+  static ChunkPolicy forEngine(EngineType engine) {
+    switch (engine) {
+      case EngineType.zipformer:
+        return adaptive;
+      case EngineType.sensevoice:
+        return const ChunkPolicy(
+          name: 'adaptive',
+          initialMs: 32,
+          steadyMs: 96,
+        );
+    }
+  }
+
+  /// 按名称查找内置策略
+  static ChunkPolicy? byName(String name) {
+    for (final policy in builtIn) {
+      if (policy.name == name) return policy;
+    }
+    return null;
+  }
+
+  /// 截断到允许范围的副本
+  ChunkPolicy clamped() => ChunkPolicy(
+        name: name,
+        initialMs: initialMs.clamp(minChunkMs, maxChunkMs),
+        steadyMs: steadyMs.clamp(minChunkMs, maxChunkMs),
+        rampAfterMs: math.max(0, rampAfterMs),
+      );
+
+  @override
+  String toString() =>
+      '$name(${initialMs}ms→${steadyMs}ms after ${rampAfterMs}ms)';
+}
+
+/// 分块调度器: 按 [ChunkPolicy] 给出下一块的目标样本数
+class ChunkScheduler {
+  final ChunkPolicy policy;
+  final int sampleRate;
+
+  int _elapsedSamples = 0;
+  int _currentMs;
+
+  ChunkScheduler(ChunkPolicy policy, {this.sampleRate = 16000})
+      : policy = policy.clamped(),
+        _currentMs = policy.clamped().initialMs;
+
+  /// 下一块的目标样本数
+  int get targetSamples => _currentMs * sampleRate ~/ 1000;
+
+  /// 下一块的目标时长 (毫秒)
+  int get targetMs => _currentMs;
+
+  /// 自开始以来已送入的音频时长 (毫秒)
+  int get elapsedMs => _elapsedSamples * 1000 ~/ sampleRate;
+
+  /// 重新开始 (每次开始录音时调用)
+  void reset() {
+    _elapsedSamples = 0;
+    _currentMs = policy.initialMs;
+  }
+
+  /// 记录已处理 [samples] 个样本，并推进块长
+  void advance(int samples) {
+    if (samples <= 0) return;
+    _elapsedSamples += samples;
+    if (_currentMs == policy.steadyMs || elapsedMs < policy.rampAfterMs) {
+      return;
+    }
+    _currentMs = _currentMs < policy.steadyMs
+        ? math.min(policy.steadyMs, _currentMs * 2)
+        : policy.steadyMs;
+  }
+}
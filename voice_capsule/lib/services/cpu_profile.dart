@@ -0,0 +1,85 @@
+import 'package:ffi/ffi.dart';
+
+import '../constants/settings_constants.dart';
+import '../ffi/native_ort_bindings.dart';
+
+/// 本机 CPU 特性与 onnxruntime 可用的执行提供者
+///
+/// 用于自动选择 Zipformer 模型版本与推理后端 (model.zipformer.type 与
+/// model.provider 为 auto 时):
+/// - 没有 AVX2 的 x86 CPU 上 int8 内核反而比 fp32 慢，改用标准版本
+/// - 其余 CPU 使用 int8；有 VNNI / AMX / dotprod / i8mm 时 int8 加速明显
+/// - arm64 上 onnxruntime 带有 XNNPACK 时使用 XNNPACK，其余使用默认 CPU 提供者
+class CpuProfile {
+  /// 原生层检测到的特性串 (如 "x86_64+avx2+fma+avxvnni")
+  final String features;
+
+  /// onnxruntime 可用的执行提供者 (如 "CPUExecutionProvider")
+  final List<String> providers;
+
+  final Set<String> _flags;
+
+  CpuProfile(this.features, {this.providers = const []})
+      : _flags = features.split('+').skip(1).toSet();
+
+  /// XNNPACK 执行提供者名称
+  static const String xnnpackProvider = 'XnnpackExecutionProvider';
+
+  /// 提供 int8 点积或矩阵运算的指令集 (按加速程度排列)
+  static const List<String> int8Extensions = [
+    'amxint8',
+    'avx512vnni',
+    'avxvnni',
+    'i8mm',
+    'asimddp',
+  ];
+
+  static CpuProfile? _current;
+
+  /// 本机的检测结果 (原生库不可用时为 "generic"，按默认规则选择)
+  static CpuProfile get current => _current ??= _detect();
+
+  static CpuProfile _detect() {
+    try {
+      final bindings = NativeOrtBindings();
+      final providers = bindings.providers().toDartString();
+      return CpuProfile(
+        bindings.cpuFeatures().toDartString(),
+        providers: providers.isEmpty ? const [] : providers.split(','),
+      );
+    } catch (_) {
+      return CpuProfile('generic');
+    }
+  }
+
+  /// CPU 架构 (x86_64 | aarch64 | generic)
+  String get arch => features.split('+').first;
+
+  /// 是否支持指令集 [flag]
+  bool has(String flag) => _flags.contains(flag);
+
+  /// 可加速 int8 推理的指令集 (没有时为 null)
+  String? get int8Extension =>
+      int8Extensions.where(_flags.contains).firstOrNull;
+
+  /// 自动选择的 Zipformer 模型版本
+  ModelType get preferredModelType =>
+      arch == 'x86_64' && !has('avx2') ? ModelType.standard : ModelType.int8;
+
+  /// 选择该模型版本的原因 (诊断用)
+  String get modelTypeReason {
+    if (preferredModelType == ModelType.standard) return '无 AVX2，int8 较慢';
+    final extension = int8Extension;
+    return extension != null ? '$extension 加速 int8' : '默认';
+  }
+
+  /// 自动选择的执行提供者 (sherpa-onnx provider 名称)
+  String get preferredProvider =>
+      arch == 'aarch64' && providers.contains(xnnpackProvider)
+          ? 'xnnpack'
+          : 'cpu';
+
+  @override
+  String toString() =>
+      '$features (${providers.isEmpty ? '提供者未知' : providers.join(', ')})';
+}
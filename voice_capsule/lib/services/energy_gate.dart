@@ -0,0 +1,259 @@
+import 'dart:ffi';
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+/// 能量门限配置
+class EnergyGateConfig {
+  /// 高于噪声底多少 dB 视为语音
+  final double marginDb;
+
+  /// 启动时的噪声底估计 (dBFS)
+  final double initialFloorDbfs;
+
+  /// 低于此值视为数字静音，不参与噪声底估计 (dBFS)
+  final double digitalSilenceDbfs;
+
+  /// 噪声底下降的时间常数 (秒)，快速跟随环境变安静
+  final double floorFallSec;
+
+  /// 静音期间噪声底上升的时间常数 (秒)，缓慢适应持续噪声 (风扇等)
+  final double floorRiseSec;
+
+  /// 语音期间噪声底上升的时间常数 (秒)，避免长句把噪声底抬高
+  final double floorRiseSpeechSec;
+
+  /// 最后一个语音块之后继续送入识别的时长 (毫秒)
+  ///
+  /// 需覆盖端点规则所需的尾部静音，否则端点永远不会触发
+  final int hangoverMs;
+
+  /// 门限关闭期间保留的最近音频 (毫秒)，重新打开时先补送，避免截断字首
+  final int prerollMs;
+
+  const EnergyGateConfig({
+    this.marginDb = 9.0,
+    this.initialFloorDbfs = -60.0,
+    this.digitalSilenceDbfs = -90.0,
+    this.floorFallSec = 0.2,
+    this.floorRiseSec = 5.0,
+    this.floorRiseSpeechSec = 30.0,
+    this.hangoverMs = 3000,
+    this.prerollMs = 300,
+  });
+}
+
+/// 能量门限统计
+class EnergyGateStats {
+  /// 送入流水线的音频总时长 (毫秒)
+  final int totalMs;
+
+  /// 被门限拦下、未送入识别的音频时长 (毫秒)
+  final int gatedMs;
+
+  /// 每秒音频的解码耗时 (毫秒)，由实际送入的音频测得
+  final double decodeMsPerAudioSec;
+
+  const EnergyGateStats({
+    required this.totalMs,
+    required this.gatedMs,
+    required this.decodeMsPerAudioSec,
+  });
+
+  /// 估算节省的解码耗时 (毫秒)
+  double get savedDecodeMs => gatedMs / 1000.0 * decodeMsPerAudioSec;
+
+  /// 被拦下的比例
+  double get gatedRatio => totalMs > 0 ? gatedMs / totalMs : 0.0;
+
+  @override
+  String toString() =>
+      'EnergyGateStats(total: ${(totalMs / 1000).toStringAsFixed(1)}s, '
+      'gated: ${(gatedMs / 1000).toStringAsFixed(1)}s '
+      '(${(gatedRatio * 100).toStringAsFixed(0)}%), '
+      'decode: ${decodeMsPerAudioSec.toStringAsFixed(1)}ms/s, '
+      'saved: ${savedDecodeMs.toStringAsFixed(0)}ms)';
+}
+
+/// 自适应噪声底与逐块语音判定
+///
+/// 噪声底低于当前估计时快速下降，静音时缓慢上升，语音时几乎不动；
+/// 块电平高于噪声底 [EnergyGateConfig.marginDb] 视为语音。
+class NoiseFloorTracker {
+  final EnergyGateConfig config;
+
+  late double _floorDbfs;
+
+  NoiseFloorTracker({this.config = const EnergyGateConfig()}) {
+    reset();
+  }
+
+  /// 当前噪声底估计 (dBFS)
+  double get floorDbfs => _floorDbfs;
+
+  /// 恢复初始噪声底
+  void reset() {
+    _floorDbfs = config.initialFloorDbfs;
+  }
+
+  /// 送入一块的电平 [dbfs] 与时长 [seconds]，返回该块是否为语音
+  bool update(double dbfs, double seconds) {
+    final isSpeech = dbfs > _floorDbfs + config.marginDb;
+    if (dbfs > config.digitalSilenceDbfs) {
+      final double tau;
+      if (dbfs < _floorDbfs) {
+        tau = config.floorFallSec;
+      } else {
+        tau = isSpeech ? config.floorRiseSpeechSec : config.floorRiseSec;
+      }
+      _floorDbfs += (dbfs - _floorDbfs) * (1 - math.exp(-seconds / tau));
+    }
+    return isSpeech;
+  }
+}
+
+/// 识别前的自适应能量门限
+///
+/// 长时间静音 (连续识别模式下麦克风可能开启数分钟) 时不再把音频送入识别引擎，
+/// 省去 Zipformer 编码器在空白音频上的计算:
+/// - 语音判定: 见 [NoiseFloorTracker]
+/// - 拖尾: 语音后继续送入 [EnergyGateConfig.hangoverMs]，保证端点规则能看到足够的尾部静音；
+///   启动时同样处于拖尾中，未说话时的端点行为与不开门限时一致
+/// - 预录: 关闭期间保留最近 [EnergyGateConfig.prerollMs] 音频，重新打开时先补送
+class EnergyGate {
+  final EnergyGateConfig config;
+  final int sampleRate;
+
+  final NoiseFloorTracker _floor;
+  int _hangoverRemainingSamples = 0;
+
+  // 关闭期间的预录缓冲 (原生内存，可直接交给 acceptWaveform)
+  Pointer<Float>? _held;
+  Float32List? _heldView;
+  int _heldSamples = 0;
+
+  int _totalSamples = 0;
+  int _gatedSamples = 0;
+  int _fedSamples = 0;
+  int _decodeMicros = 0;
+
+  EnergyGate({
+    this.config = const EnergyGateConfig(),
+    this.sampleRate = 16000,
+  }) : _floor = NoiseFloorTracker(config: config) {
+    reset();
+  }
+
+  /// 当前噪声底估计 (dBFS)
+  double get noiseFloorDbfs => _floor.floorDbfs;
+
+  /// 是否处于语音或拖尾中 (音频正在送入识别)
+  bool get isOpen => _hangoverRemainingSamples > 0;
+
+  /// 统计信息
+  EnergyGateStats get stats => EnergyGateStats(
+        totalMs: _samplesToMs(_totalSamples),
+        gatedMs: _samplesToMs(_gatedSamples),
+        decodeMsPerAudioSec: _fedSamples > 0
+            ? _decodeMicros / 1000.0 / (_fedSamples / sampleRate)
+            : 0.0,
+      );
+
+  /// 重新开始 (每次开始录音时调用)，统计一并清零
+  void reset() {
+    _floor.reset();
+    _hangoverRemainingSamples = _msToSamples(config.hangoverMs);
+    _heldSamples = 0;
+    _totalSamples = 0;
+    _gatedSamples = 0;
+    _fedSamples = 0;
+    _decodeMicros = 0;
+  }
+
+  /// 判定一个音频块，返回 true 表示应送入识别
+  ///
+  /// [dbfs] 块的平均电平，[samples] 块的样本数
+  bool process(double dbfs, int samples) {
+    _totalSamples += samples;
+    final isSpeech = _floor.update(dbfs, samples / sampleRate);
+
+    if (isSpeech) {
+      _hangoverRemainingSamples = _msToSamples(config.hangoverMs);
+      return true;
+    }
+    if (_hangoverRemainingSamples > 0) {
+      _hangoverRemainingSamples -= samples;
+      return true;
+    }
+    _gatedSamples += samples;
+    return false;
+  }
+
+  /// 保存一个被拦下的块 (只保留最近 prerollMs)
+  void hold(Pointer<Float> buffer, int samples) {
+    final capacity = _msToSamples(config.prerollMs);
+    if (capacity <= 0 || samples <= 0) return;
+    if (_held == null) {
+      _held = calloc<Float>(capacity);
+      _heldView = _held!.asTypedList(capacity);
+    }
+    final view = _heldView!;
+    final incoming = buffer.asTypedList(samples);
+    if (samples >= capacity) {
+      view.setRange(0, capacity, incoming, samples - capacity);
+      _heldSamples = capacity;
+      return;
+    }
+    final keep = math.min(_heldSamples, capacity - samples);
+    if (keep > 0) {
+      view.setRange(0, keep, view, _heldSamples - keep);
+    }
+    view.setRange(keep, keep + samples, incoming);
+    _heldSamples = keep + samples;
+  }
+
+  /// 取出预录音频 (门限重新打开时调用)，[consume] 收到原生指针与样本数
+  void drainHeld(void Function(Pointer<Float> data, int samples) consume) {
+    if (_heldSamples == 0 || _held == null) return;
+    final samples = _heldSamples;
+    _heldSamples = 0;
+    // 补送的音频最终仍被解码，不计入节省
+    _gatedSamples -= samples;
+    consume(_held!, samples);
+  }
+
+  /// 记录一次送入识别的解码耗时，用于估算节省的计算量
+  void recordDecode(int samples, Duration elapsed) {
+    _fedSamples += samples;
+    _decodeMicros += elapsed.inMicroseconds;
+  }
+
+  /// 释放预录缓冲
+  void dispose() {
+    if (_held != null) {
+      calloc.free(_held!);
+      _held = null;
+      _heldView = null;
+    }
+    _heldSamples = 0;
+  }
+
+  /// 计算块的平均电平 (dBFS)
+  ///
+  /// 仅在采集层无法提供电平时使用 (原生采集线程已在写入时算好)
+  static double measureDbfs(Pointer<Float> buffer, int samples) {
+    if (samples <= 0) return -100.0;
+    final data = buffer.asTypedList(samples);
+    var sum = 0.0;
+    for (var i = 0; i < samples; i++) {
+      sum += data[i] * data[i];
+    }
+    final meanSquare = sum / samples;
+    if (meanSquare <= 0) return -100.0;
+    return math.max(-100.0, 10 * math.log(meanSquare) / math.ln10);
+  }
+
+  int _msToSamples(int ms) => ms * sampleRate ~/ 1000;
+  int _samplesToMs(int samples) => samples * 1000 ~/ sampleRate;
+}
@@ -8,6 +8,8 @@ import 'tray_service.dart';
 import 'window_service.dart';
 import 'fcitx_client.dart';
 import 'hotkey_service.dart';
+import 'settings_service.dart';
+import 'stability_tracker.dart';
 import '../state/capsule_state.dart';
 
 /// 快捷键控制器状态
@@ -24,7 +26,7 @@ enum HotkeyState {
 /// - HotkeyService: 加载配置并同步到 Fcitx5
 /// - WindowService: 控制窗口显隐
 /// - AudioInferencePipeline: 控制录音和识别
-/// - FcitxClient: 提交文本
+/// - FcitxClient: 提交文本 (录音中稳定的文本提前上屏，停止时提交其余部分)
 /// - CapsuleStateData: 更新 UI 状态
 ///
 /// 状态机:
@@ -47,6 +49,7 @@ class HotkeyController {
   HotkeyState _state = HotkeyState.idle;
   StreamSubscription<EndpointEvent>? _endpointSubscription;
   StreamSubscription<String>? _resultSubscription;
+  StreamSubscription<ASRResultDelta>? _deltaSubscription;
   bool _isInitialized = false;
   bool _isProcessing = false; // 防止快速按键竞态条件
   DateTime? _lastHotkeyTime; // 防抖：记录上次按键时间
@@ -58,6 +61,16 @@ class HotkeyController {
   /// Story 3-7: 保存提交失败的文本 (AC15: 文本保护)
   String? _lastRecognizedText;
 
+  // === 提前上屏 ===
+  /// 录音中判定稳定的文本先行提交，停止时只提交其余部分。
+  /// 胶囊窗口不接受焦点，录音期间目标应用仍持有焦点，commitString 可以生效。
+  final StabilityTracker _stabilityTracker = StabilityTracker();
+  bool _earlyCommitEnabled = false;
+  bool _earlyCommitFailed = false;
+
+  /// 本次录音的提前提交串行链，完成值为已提交的文本
+  Future<String> _earlyCommit = Future.value('');
+
   /// 当前状态
   HotkeyState get state => _state;
 
@@ -218,6 +231,9 @@ class HotkeyController {
     // 监听识别结果 (更新 UI)
     _resultSubscription = _pipeline!.resultStream.listen(_onRecognitionResult);
 
+    // 监听结果增量 (稳定前缀提前上屏)
+    _deltaSubscription = _pipeline!.deltaStream.listen(_onResultDelta);
+
     _isInitialized = true;
 
     // ignore: avoid_print
@@ -265,6 +281,7 @@ class HotkeyController {
   /// AC2: 自动开始录音
   Future<void> _startRecording() async {
     _state = HotkeyState.recording;
+    _resetEarlyCommit();
 
     // 1. 先更新 UI 状态为聆听中 (确保呼吸灯渲染就绪)
     _updateState(CapsuleStateData.listening());
@@ -299,16 +316,28 @@ class HotkeyController {
   Future<void> _stopAndSubmit() async {
     _state = HotkeyState.submitting;
     _submitInterrupted = false; // 重置中断标志
+    final earlyCommit = _earlyCommit; // 快速重按会开始新一轮提前提交
 
     // 1. 更新 UI 状态为处理中
     _updateState(CapsuleStateData.processing());
 
     // 2. 停止录音，获取最终文本 (AC3)
     // 注意：pipeline.stop() 会等待所有处理中的数据完成
-    final finalText = await _pipeline!.stop();
+    final recognizedText = await _pipeline!.stop();
+
+    // 录音中已提前上屏的部分不再重复提交
+    final committedText = await earlyCommit;
+    final finalText =
+        StabilityTracker.remainder(committedText, recognizedText);
+    if (StabilityTracker.diverges(committedText, recognizedText)) {
+      // ignore: avoid_print
+      print('[HotkeyController] ⚠️ 最终结果修正了已提前提交的文本，'
+          '按位置提交剩余部分 "$finalText": "$recognizedText"');
+    }
 
     // ignore: avoid_print
-    print('[HotkeyController] 📝 最终文本: "$finalText"');
+    print('[HotkeyController] 📝 最终文本: "$recognizedText"'
+        '${committedText.isEmpty ? '' : ' (已提前提交 "$committedText")'}');
 
     // 3. 检查是否被中断（用户快速重按）
     if (_submitInterrupted) {
@@ -456,9 +485,10 @@ class HotkeyController {
         'text="${event.finalText}", duration=${event.durationMs}ms, '
         'deviceLost=${event.isDeviceLost}');
 
-    // Story 3-7 AC13: 设备断开时保存文本并显示警告
+    // Story 3-7 AC13: 设备断开时保存文本并显示警告 (不含已提前上屏的部分)
     if (event.isDeviceLost) {
-      _handleDeviceLost(event.finalText);
+      _earlyCommit.then((committed) => _handleDeviceLost(
+          StabilityTracker.remainder(committed, event.finalText)));
       return;
     }
 
@@ -517,6 +547,48 @@ class HotkeyController {
     _updateState(CapsuleStateData.idle());
   }
 
+  /// 重置提前上屏状态 (每次开始录音)
+  void _resetEarlyCommit() {
+    _stabilityTracker.reset();
+    // 只有 token 覆盖完整文本的流式引擎才能按 token 判定稳定前缀
+    _earlyCommitEnabled = SettingsService.instance.audioEarlyCommit &&
+        (_pipeline?.supportsEarlyCommit ?? false);
+    _earlyCommitFailed = false;
+    _earlyCommit = Future.value('');
+  }
+
+  /// 结果增量处理: 新判定稳定的文本在录音过程中提前上屏
+  void _onResultDelta(ASRResultDelta delta) {
+    if (_state != HotkeyState.recording || !_earlyCommitEnabled) return;
+
+    final stable = _stabilityTracker.update(delta);
+    if (stable.isEmpty) return;
+    _earlyCommit =
+        _earlyCommit.then((committed) => _commitStableText(committed, stable));
+  }
+
+  /// 提交一段稳定文本，返回累计已提交的文本
+  ///
+  /// 失败时本次录音不再提前提交，全部剩余文本在停止时按常规流程提交
+  Future<String> _commitStableText(String committed, String text) async {
+    if (_earlyCommitFailed) return committed;
+    try {
+      if (!await _fcitxClient!.isAvailable()) {
+        _earlyCommitFailed = true;
+        return committed;
+      }
+      await _fcitxClient!.sendText(text);
+      // ignore: avoid_print
+      print('[HotkeyController] ⏩ 提前提交: "$text"');
+      return committed + text;
+    } catch (e) {
+      _earlyCommitFailed = true;
+      // ignore: avoid_print
+      print('[HotkeyController] ⚠️ 提前提交失败，改为停止时提交: $e');
+      return committed;
+    }
+  }
+
   /// 识别结果处理 (更新 UI 文本)
   void _onRecognitionResult(String text) {
     if (_state == HotkeyState.recording) {
@@ -617,6 +689,7 @@ class HotkeyController {
   Future<void> dispose() async {
     await _endpointSubscription?.cancel();
     await _resultSubscription?.cancel();
+    await _deltaSubscription?.cancel();
     HotkeyService.instance.onHotkeyPressed = null;
     _isInitialized = false;
     _isProcessing = false;
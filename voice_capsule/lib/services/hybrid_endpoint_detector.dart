@@ -0,0 +1,192 @@
+import 'dart:ffi';
+import 'dart:io';
+
+import 'package:ffi/ffi.dart';
+
+import '../ffi/sherpa_ffi.dart';
+import '../ffi/sherpa_vad_bindings.dart';
+
+/// 混合端点检测配置
+class HybridEndpointConfig {
+  /// Silero 语音概率阈值
+  final double vadThreshold;
+
+  /// Silero 判定语音结束所需的最短静音 (秒)
+  ///
+  /// 只作为 VAD 自身的去抖，真正的端点静音由下方置信度加权决定
+  final double vadMinSilenceSec;
+
+  /// 高置信度 (语音足够长且识别已稳定) 时所需的尾部静音 (秒)
+  final double minSilenceSec;
+
+  /// 低置信度时所需的尾部静音 (秒)，通常与 Rule2 相同
+  final double maxSilenceSec;
+
+  /// 语音累计达到此时长后视为完全可信 (秒)
+  final double fullConfidenceSpeechSec;
+
+  /// 语音累计短于此时长不触发端点 (咳嗽、键盘声等)
+  final double minSpeechSec;
+
+  const HybridEndpointConfig({
+    this.vadThreshold = 0.5,
+    this.vadMinSilenceSec = 0.1,
+    this.minSilenceSec = 0.4,
+    this.maxSilenceSec = 1.2,
+    this.fullConfidenceSpeechSec = 1.5,
+    this.minSpeechSec = 0.25,
+  });
+}
+
+/// 混合端点判定 (Silero VAD + 流式识别结果)
+///
+/// Zipformer 的规则端点只看尾部静音时长 (Rule2 默认 1.2s)，每次说完都要等满阈值。
+/// 这里以 Silero 的语音状态计时尾部静音，并按置信度缩短所需时长:
+/// - 本段语音越长越可信，所需静音从 [HybridEndpointConfig.maxSilenceSec]
+///   线性缩短到 [HybridEndpointConfig.minSilenceSec]
+/// - 静音期间识别结果仍在变化，说明解码器还在输出尾字，静音计时重新开始
+/// - 尚无识别文本或语音过短时不触发，交给规则端点兜底
+///
+/// 本类只含判定逻辑，VAD 推理见 [SileroSpeechDetector]。
+class HybridEndpointDetector {
+  final HybridEndpointConfig config;
+
+  double _speechSec = 0;
+  double _silenceSec = 0;
+  bool _inSpeech = false;
+  DateTime? _lastSpeechEnd;
+
+  HybridEndpointDetector({this.config = const HybridEndpointConfig()});
+
+  /// 本段已累计的语音时长 (秒)
+  double get speechSec => _speechSec;
+
+  /// 当前尾部静音时长 (秒)
+  double get silenceSec => _silenceSec;
+
+  /// 最近一个语音块的结束时刻 (按采集时刻计，块精度)
+  ///
+  /// 用于测量语音结束到端点提交的延迟，无语音时为 null
+  DateTime? get lastSpeechEnd => _lastSpeechEnd;
+
+  /// 当前置信度下所需的尾部静音 (秒)
+  double get requiredSilenceSec {
+    final confidence = config.fullConfidenceSpeechSec > 0
+        ? (_speechSec / config.fullConfidenceSpeechSec).clamp(0.0, 1.0)
+        : 1.0;
+    return config.maxSilenceSec -
+        (config.maxSilenceSec - config.minSilenceSec) * confidence;
+  }
+
+  /// 送入一个音频块的判定结果，返回 true 表示到达端点
+  ///
+  /// [speech] VAD 是否处于语音中，[seconds] 块时长，[chunkEnd] 块末尾的采集时刻，
+  /// [hasText] 当前是否已有识别文本，[textChanged] 本块是否改变了识别文本
+  bool update({
+    required bool speech,
+    required double seconds,
+    required DateTime chunkEnd,
+    required bool hasText,
+    required bool textChanged,
+  }) {
+    if (speech) {
+      _speechSec += seconds;
+      _silenceSec = 0;
+      _inSpeech = true;
+      _lastSpeechEnd = chunkEnd;
+      return false;
+    }
+    if (!_inSpeech) return false;
+
+    // VAD 翻转为静音时已经过了它自身的去抖时长
+    _silenceSec = _silenceSec == 0
+        ? config.vadMinSilenceSec + seconds
+        : _silenceSec + seconds;
+    if (textChanged) {
+      _silenceSec = config.vadMinSilenceSec;
+    }
+
+    if (!hasText || _speechSec < config.minSpeechSec) return false;
+    if (_silenceSec < requiredSilenceSec) return false;
+
+    reset(keepLastSpeechEnd: true);
+    return true;
+  }
+
+  /// 清空本段状态 (端点触发或流水线重置时调用)
+  void reset({bool keepLastSpeechEnd = false}) {
+    _speechSec = 0;
+    _silenceSec = 0;
+    _inSpeech = false;
+    if (!keepLastSpeechEnd) _lastSpeechEnd = null;
+  }
+}
+
+/// Silero VAD 流式语音状态
+///
+/// 与 SenseVoiceEngine 使用同一模型文件 (ModelManager.vadModelFilePath)，
+/// 只读取"当前是否在语音中"，不保留语音段。
+class SileroSpeechDetector {
+  final Pointer<SherpaOnnxVoiceActivityDetector> _vad;
+
+  SileroSpeechDetector._(this._vad);
+
+  /// 创建检测器，模型不存在或创建失败时返回 null
+  static SileroSpeechDetector? create(
+    String modelPath, {
+    HybridEndpointConfig config = const HybridEndpointConfig(),
+    int sampleRate = 16000,
+  }) {
+    if (!File(modelPath).existsSync()) return null;
+
+    try {
+      SherpaOnnxVadBindings.init(loadSherpaLibrary());
+    } catch (_) {
+      return null;
+    }
+
+    final vadConfig = calloc<SherpaOnnxVadModelConfig>();
+    final model = modelPath.toNativeUtf8();
+    final provider = 'cpu'.toNativeUtf8();
+    try {
+      vadConfig.ref.sileroVad.model = model;
+      vadConfig.ref.sileroVad.threshold = config.vadThreshold;
+      vadConfig.ref.sileroVad.minSilenceDuration = config.vadMinSilenceSec;
+      vadConfig.ref.sileroVad.minSpeechDuration = 0.1;
+      vadConfig.ref.sileroVad.maxSpeechDuration = 30.0;
+      vadConfig.ref.sileroVad.windowSize = 512;
+      vadConfig.ref.sampleRate = sampleRate;
+      vadConfig.ref.numThreads = 1;
+      vadConfig.ref.provider = provider;
+      vadConfig.ref.debug = 0;
+      vadConfig.ref.tenVad.model = nullptr;
+
+      final vad =
+          SherpaOnnxVadBindings.createVoiceActivityDetector(vadConfig, 30.0);
+      if (vad == nullptr) return null;
+      return SileroSpeechDetector._(vad);
+    } finally {
+      calloc.free(model);
+      calloc.free(provider);
+      calloc.free(vadConfig);
+    }
+  }
+
+  /// 送入音频，返回处理后是否处于语音中
+  bool accept(Pointer<Float> samples, int n) {
+    SherpaOnnxVadBindings.voiceActivityDetectorAcceptWaveform(_vad, samples, n);
+    // 只关心语音状态，丢弃累积的语音段
+    SherpaOnnxVadBindings.voiceActivityDetectorClear(_vad);
+    return SherpaOnnxVadBindings.voiceActivityDetectorDetected(_vad) != 0;
+  }
+
+  /// 重置 VAD 状态
+  void reset() {
+    SherpaOnnxVadBindings.voiceActivityDetectorReset(_vad);
+  }
+
+  /// 销毁 VAD
+  void dispose() {
+    SherpaOnnxVadBindings.destroyVoiceActivityDetector(_vad);
+  }
+}
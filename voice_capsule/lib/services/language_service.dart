@@ -145,6 +145,8 @@ class LanguageService {
       'tray_audio_device': '音频输入设备',
       'tray_audio_default': '系统默认',
       'tray_audio_restart_notice': '音频设备已更改，重启应用后生效',
+      'tray_mic_monitoring': '🎙️ 麦克风预录中 (最近 {ms}ms)',
+      'tray_mic_monitoring_tooltip': 'Nextalk - 麦克风预录中',
       'audio_error_title': '音频设备不可用',
       'audio_error_device': '设备:',
       'audio_error_reason': '原因:',
@@ -211,6 +213,8 @@ class LanguageService {
       'tray_audio_device': 'Audio Input Device',
       'tray_audio_default': 'System Default',
       'tray_audio_restart_notice': 'Audio device changed, restart app to take effect',
+      'tray_mic_monitoring': '🎙️ Microphone pre-roll active (last {ms}ms)',
+      'tray_mic_monitoring_tooltip': 'Nextalk - microphone pre-roll active',
       'audio_error_title': 'Audio Device Unavailable',
       'audio_error_device': 'Device:',
       'audio_error_reason': 'Reason:',
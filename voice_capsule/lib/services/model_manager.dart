@@ -1,12 +1,16 @@
 import 'dart:convert';
+import 'dart:ffi';
 import 'dart:io';
 import 'dart:isolate';
 
 import 'package:archive/archive.dart';
 import 'package:crypto/crypto.dart';
 import 'package:dio/dio.dart';
+import 'package:ffi/ffi.dart';
 
 import '../constants/settings_constants.dart';
+import '../ffi/native_memory_bindings.dart';
+import 'ort_model_cache.dart';
 import 'settings_service.dart';
 
 /// 模型状态枚举
@@ -70,6 +74,40 @@ class ModelConfig {
   });
 }
 
+/// 模型文件页缓存预热结果
+class ModelPrewarmResult {
+  /// 预热的文件
+  final List<String> files;
+
+  /// 文件总字节数
+  final int totalBytes;
+
+  /// 预热前已在页缓存中的字节数
+  final int residentBefore;
+
+  /// 预热耗时
+  final Duration elapsed;
+
+  const ModelPrewarmResult({
+    required this.files,
+    required this.totalBytes,
+    required this.residentBefore,
+    required this.elapsed,
+  });
+
+  /// 预热前已缓存的比例 (0-1)
+  double get residentRatio => totalBytes > 0 ? residentBefore / totalBytes : 1.0;
+
+  /// 预热前文件已全部在页缓存中
+  bool get wasWarm => residentBefore >= totalBytes;
+
+  @override
+  String toString() =>
+      '${files.length} 个文件 ${(totalBytes / (1024 * 1024)).toStringAsFixed(0)}MB, '
+      '预热前已缓存 ${(residentRatio * 100).toStringAsFixed(0)}%, '
+      '耗时 ${elapsed.inMilliseconds}ms';
+}
+
 /// 预定义模型配置
 class ModelConfigs {
   ModelConfigs._();
@@ -1142,8 +1180,161 @@ models/vad/
     if (dir.existsSync()) {
       await dir.delete(recursive: true);
     }
+    OrtModelCache.instance.evict(dir.path);
   }
 
+  /// 指定引擎创建识别器时读取的模型文件 (有优化缓存时为缓存副本)
+  ///
+  /// 与引擎的选择规则一致: 优先 [useInt8] 对应的版本，缺失时取任意版本；
+  /// SenseVoice 另含 VAD 模型。用于重新加载前的页缓存预读。
+  List<String> modelFilesForEngine(EngineType engineType,
+      {bool useInt8 = true}) {
+    final modelDir = getModelPathForEngine(engineType);
+    final dir = Directory(modelDir);
+    if (!dir.existsSync()) return const [];
+
+    final List<String> names;
+    try {
+      names = [
+        for (final entity in dir.listSync())
+          if (entity is File) entity.path.split('/').last,
+      ];
+    } catch (_) {
+      return const [];
+    }
+
+    final files = <String>[];
+    for (final prefix in ModelConfigs.forEngine(engineType).requiredFilePrefixes) {
+      final candidates = names
+          .where((n) => n.startsWith(prefix) && n.endsWith('.onnx'))
+          .toList();
+      if (candidates.isEmpty) continue;
+      final name = candidates.firstWhere(
+        (n) => n.contains('.int8.') == useInt8,
+        orElse: () => candidates.first,
+      );
+      final path = '$modelDir/$name';
+      final cached = OrtModelCache.instance.enabled
+          ? OrtModelCache.instance.cachePathFor(path)
+          : null;
+      files.add(cached != null && File(cached).existsSync() ? cached : path);
+    }
+    if (names.contains('tokens.txt')) files.add('$modelDir/tokens.txt');
+    if (engineType == EngineType.sensevoice && isVadModelReady) {
+      files.add(vadModelFilePath);
+    }
+    return files;
+  }
+
+  /// 提示内核预读指定引擎的模型文件 (立即返回)，返回提示的总字节数
+  ///
+  /// 空闲卸载后重新加载时，磁盘读取与识别器创建并行进行。
+  int prefetchModelFiles(EngineType engineType, {bool useInt8 = true}) {
+    final files = modelFilesForEngine(engineType, useInt8: useInt8);
+    if (files.isEmpty) return 0;
+    final NativeMemoryBindings bindings;
+    try {
+      bindings = NativeMemoryBindings();
+    } catch (_) {
+      return 0;
+    }
+    var total = 0;
+    for (final file in files) {
+      final pathPtr = file.toNativeUtf8();
+      final size = bindings.prefetch(pathPtr);
+      calloc.free(pathPtr);
+      if (size > 0) total += size;
+    }
+    return total;
+  }
+
+  /// 按当前设置会加载的引擎 (启用两遍识别时含第二遍的 SenseVoice)
+  List<EngineType> get activeEngines {
+    final settings = SettingsService.instance;
+    final primary =
+        settings.isInitialized ? settings.engineType : EngineType.zipformer;
+    return [
+      primary,
+      if (primary == EngineType.zipformer &&
+          settings.isInitialized &&
+          settings.twoPassEnabled &&
+          isEngineReady(EngineType.sensevoice))
+        EngineType.sensevoice,
+    ];
+  }
+
+  /// 当前设置下识别器创建时读取的模型文件
+  List<String> get activeModelFiles {
+    final settings = SettingsService.instance;
+    final useInt8 =
+        !settings.isInitialized || settings.modelType == ModelType.int8;
+    return [
+      for (final engine in activeEngines)
+        ...modelFilesForEngine(engine, useInt8: useInt8),
+    ];
+  }
+
+  /// [files] 当前在页缓存中的字节数与总字节数 (原生库不可用时为 null)
+  (int resident, int total)? pageCacheResidency(List<String> files) {
+    final NativeMemoryBindings bindings;
+    try {
+      bindings = NativeMemoryBindings();
+    } catch (_) {
+      return null;
+    }
+    var resident = 0;
+    var total = 0;
+    for (final file in files) {
+      final pathPtr = file.toNativeUtf8();
+      final bytes = bindings.resident(pathPtr);
+      calloc.free(pathPtr);
+      if (bytes < 0) continue;
+      resident += bytes;
+      total += File(file).lengthSync();
+    }
+    return (resident, total);
+  }
+
+  /// 以空闲 I/O 优先级把模型文件整个读入页缓存 (默认为 [activeModelFiles])
+  ///
+  /// 在后台 isolate 中执行，只在磁盘空闲时读取；登录后调用，
+  /// 首次录音创建识别器时不必再从磁盘冷读 (机械硬盘与加密主目录上可达数秒)。
+  Future<ModelPrewarmResult> prewarmModelFiles([List<String>? files]) {
+    final targets = files ?? activeModelFiles;
+    return Isolate.run(() => _prewarmInIsolate(targets));
+  }
+
+  static ModelPrewarmResult _prewarmInIsolate(List<String> files) {
+    final watch = Stopwatch()..start();
+    final bindings = NativeMemoryBindings();
+    final paths = calloc<Pointer<Utf8>>(files.isEmpty ? 1 : files.length);
+    final residentBefore = calloc<Int64>();
+    try {
+      for (var i = 0; i < files.length; i++) {
+        paths[i] = files[i].toNativeUtf8();
+      }
+      final total = bindings.prewarm(paths, files.length, residentBefore);
+      return ModelPrewarmResult(
+        files: files,
+        totalBytes: total,
+        residentBefore: residentBefore.value,
+        elapsed: watch.elapsed,
+      );
+    } finally {
+      for (var i = 0; i < files.length; i++) {
+        calloc.free(paths[i]);
+      }
+      calloc.free(paths);
+      calloc.free(residentBefore);
+    }
+  }
+
+  /// 为本次启动中未命中缓存的模型生成 onnxruntime 优化副本
+  ///
+  /// 在后台 isolate 中执行，下次创建识别器时生效 (见 [OrtModelCache])
+  Future<List<OrtOptimizeResult>> cacheOptimizedModels() =>
+      OrtModelCache.instance.optimizeMissed();
+
   /// 删除 VAD 模型
   Future<void> deleteVadModel() async {
     final file = File(vadModelFilePath);
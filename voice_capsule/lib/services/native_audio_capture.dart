@@ -0,0 +1,415 @@
+import 'dart:async';
+import 'dart:ffi';
+import 'dart:math' as math;
+import 'package:ffi/ffi.dart';
+import '../ffi/native_capture_bindings.dart';
+
+/// 原生采集配置
+class NativeCaptureConfig {
+  static const int sampleRate = 16000;
+  static const int channels = 1;
+  static const int blockFrames = 160; // 10ms @ 16kHz (采集线程单次读取)
+  static const int ringFrames = 80000; // 5s 环形缓冲区，吸收 UI 卡顿与空闲卸载后的模型重新加载
+  static const int targetLatencyMs = 20; // libpulse 请求的分片时长 (fragsize)
+}
+
+/// 音频电平快照 (由原生采集线程按块计算，UI isolate 无需遍历样本)
+class AudioLevels {
+  const AudioLevels({
+    required this.rms,
+    required this.peak,
+    required this.centroidHz,
+    required this.energy,
+    required this.frames,
+    required this.blocks,
+  });
+
+  /// 静音时的 dBFS 下限
+  static const double silenceDbfs = -100.0;
+
+  /// 最近一块的均方根 (满幅 1.0)
+  final double rms;
+
+  /// 最近一块的峰值绝对值
+  final double peak;
+
+  /// 最近一块的频谱质心估计 (Hz)
+  final double centroidHz;
+
+  /// 自开始录音起累计的样本平方和
+  final double energy;
+
+  /// 自开始录音起累计计量的样本数
+  final int frames;
+
+  /// 已计量的块数 (变化即表示有新数据)
+  final int blocks;
+
+  /// 最近一块的电平 (dBFS)
+  double get dbfs => _toDbfs(rms * rms);
+
+  /// 自 [earlier] 以来的平均电平 (dBFS)，用于按读取区间判断静音
+  double dbfsSince(AudioLevels? earlier) {
+    final frameDelta = frames - (earlier?.frames ?? 0);
+    if (frameDelta <= 0) return dbfs;
+    return _toDbfs((energy - (earlier?.energy ?? 0.0)) / frameDelta);
+  }
+
+  static double _toDbfs(double meanSquare) {
+    if (meanSquare <= 0) return silenceDbfs;
+    return math.max(silenceDbfs, 10 * math.log(meanSquare) / math.ln10);
+  }
+}
+
+/// 原生采集错误类型
+enum NativeCaptureError {
+  none,
+  libraryNotFound,
+  openFailed,
+  startFailed,
+  readFailed,
+  deviceLost,
+  notInitialized,
+}
+
+/// 原生线程音频采集服务 (libnextalk_native.so)
+///
+/// 采集在独立的实时优先级线程中进行，数据写入无锁 SPSC 环形缓冲区。
+/// libpulse 路径使用 pa_stream 异步读回调，并按目标延迟显式请求 fragsize。
+/// - [read] 非阻塞，只拷贝已就绪的数据
+/// - [waitForData] 通过 NativeCallable.listener 等待采集线程唤醒，
+///   替代 Dart 侧固定周期的阻塞读取 + sleep
+class NativeAudioCapture {
+  final NativeCaptureBindings _bindings;
+  Pointer<NextalkCaptureHandle>? _handle;
+  NativeCallable<NextalkNotifyC>? _notifyCallable;
+  Completer<bool>? _waiter;
+  Pointer<Int64>? _captureTimeNs;
+  Pointer<NextalkLevels>? _levels;
+  DateTime? _lastReadCaptureTime;
+
+  bool _isInitialized = false;
+  bool _isCapturing = false;
+  String? _lastError;
+
+  NativeAudioCapture._(this._bindings);
+
+  /// 检查原生库是否可用
+  static bool isAvailable() => tryCreate() != null;
+
+  /// 创建实例，原生库不可用时返回 null
+  static NativeAudioCapture? tryCreate() {
+    try {
+      return NativeAudioCapture._(NativeCaptureBindings());
+    } catch (_) {
+      return null;
+    }
+  }
+
+  /// 通过 libpulse 异步流打开录音流
+  ///
+  /// [deviceName] libpulse 设备名，null 或 "default" 使用系统默认设备
+  /// [targetLatencyMs] 请求的分片时长，服务器可能按设备能力调整
+  /// [deviceNativeFormat] 以源的原生采样率/格式打开，由原生库重采样到 16kHz
+  NativeCaptureError initializePulse({
+    String? deviceName,
+    int targetLatencyMs = NativeCaptureConfig.targetLatencyMs,
+    bool deviceNativeFormat = true,
+  }) {
+    if (_isInitialized) {
+      return NativeCaptureError.none;
+    }
+    if (!_createHandle(deviceNativeFormat)) {
+      return NativeCaptureError.notInitialized;
+    }
+
+    final devicePtr = (deviceName != null && deviceName != 'default')
+        ? deviceName.toNativeUtf8()
+        : nullptr;
+    final result = _bindings.openPulse(_handle!, devicePtr.cast(), targetLatencyMs);
+    if (devicePtr.address != 0) {
+      calloc.free(devicePtr);
+    }
+    return _finishOpen(result, 'libpulse');
+  }
+
+  /// 通过 PortAudio 打开录音流
+  ///
+  /// [deviceIndex] 由 AudioCapture 的设备解析逻辑给出
+  /// [deviceNativeFormat] 以设备默认采样率打开，由原生库重采样到 16kHz
+  NativeCaptureError initializePortAudio(
+    int deviceIndex,
+    double suggestedLatency, {
+    bool deviceNativeFormat = true,
+  }) {
+    if (_isInitialized) {
+      return NativeCaptureError.none;
+    }
+    if (!_createHandle(deviceNativeFormat)) {
+      return NativeCaptureError.notInitialized;
+    }
+    final result = _bindings.openPortAudio(_handle!, deviceIndex, suggestedLatency);
+    return _finishOpen(result, 'PortAudio');
+  }
+
+  bool _createHandle(bool deviceNativeFormat) {
+    final handle = _bindings.create(
+      NativeCaptureConfig.sampleRate,
+      NativeCaptureConfig.channels,
+      NativeCaptureConfig.ringFrames,
+      NativeCaptureConfig.blockFrames,
+    );
+    if (handle.address == 0) {
+      _lastError = 'nextalk_capture_create 失败';
+      return false;
+    }
+    _bindings.setDeviceNative(handle, deviceNativeFormat ? 1 : 0);
+    _handle = handle;
+    return true;
+  }
+
+  NativeCaptureError _finishOpen(int result, String backend) {
+    if (result != NEXTALK_CAPTURE_OK) {
+      _lastError = '$backend: ${_errorText()}';
+      // ignore: avoid_print
+      print('[NativeAudioCapture] ❌ 打开失败 ($result): $_lastError');
+      _bindings.destroy(_handle!);
+      _handle = null;
+      return result == NEXTALK_CAPTURE_ERR_LIBRARY
+          ? NativeCaptureError.libraryNotFound
+          : NativeCaptureError.openFailed;
+    }
+
+    _notifyCallable = NativeCallable<NextalkNotifyC>.listener(_onNotify);
+    _bindings.setNotify(_handle!, _notifyCallable!.nativeFunction);
+    _isInitialized = true;
+    // ignore: avoid_print
+    print('[NativeAudioCapture] ✓ 初始化成功 ($backend)');
+    return NativeCaptureError.none;
+  }
+
+  /// 采集线程唤醒回调 (在 Dart 事件循环中执行)
+  void _onNotify(int available) {
+    final waiter = _waiter;
+    _waiter = null;
+    if (waiter != null && !waiter.isCompleted) {
+      waiter.complete(true);
+    }
+  }
+
+  /// 启动采集线程
+  NativeCaptureError start() {
+    if (!_isInitialized) {
+      return NativeCaptureError.notInitialized;
+    }
+    if (_isCapturing) {
+      return NativeCaptureError.none;
+    }
+    final result = _bindings.start(_handle!);
+    if (result != NEXTALK_CAPTURE_OK) {
+      _lastError = _errorText();
+      // ignore: avoid_print
+      print('[NativeAudioCapture] ❌ 启动失败: $_lastError');
+      return NativeCaptureError.startFailed;
+    }
+    _isCapturing = true;
+    _lastReadCaptureTime = null;
+    // ignore: avoid_print
+    print('[NativeAudioCapture] ▶️ 开始录音 (realtime=$isRealtime)');
+    return NativeCaptureError.none;
+  }
+
+  /// 停止采集线程
+  void stop() {
+    if (!_isCapturing) {
+      return;
+    }
+    _bindings.stop(_handle!);
+    _isCapturing = false;
+    _onNotify(0);
+    // ignore: avoid_print
+    print('[NativeAudioCapture] ⏹️ 停止录音 (overruns=$overruns, latency=${latencyMs?.toStringAsFixed(1)}ms)');
+  }
+
+  /// 非阻塞读取
+  ///
+  /// 返回实际读取的样本数 (可能为 0)，失败返回 NEXTALK_CAPTURE_ERR_* 错误码。
+  /// 读到数据时同时更新 [lastReadCaptureTime]。
+  int read(Pointer<Float> buffer, int samples) {
+    if (!_isInitialized || !_isCapturing) {
+      return NEXTALK_CAPTURE_ERR_STATE;
+    }
+    _captureTimeNs ??= calloc<Int64>();
+    final result =
+        _bindings.readTimestamped(_handle!, buffer, samples, _captureTimeNs!);
+    if (result > 0) {
+      _lastReadCaptureTime = _toWallClock(_captureTimeNs!.value);
+    }
+    if (result < 0) {
+      _lastError = _errorText();
+      // ignore: avoid_print
+      print('[NativeAudioCapture] ❌ 采集线程错误 ($result): $_lastError');
+    }
+    return result;
+  }
+
+  /// 最近一块的电平快照，未在录音时为 null
+  ///
+  /// 只读取原生侧已算好的统计量，可在每个动画帧调用
+  AudioLevels? get levels {
+    if (!_isCapturing) return null;
+    final out = _levels ??= calloc<NextalkLevels>();
+    if (_bindings.levels(_handle!, out) != NEXTALK_CAPTURE_OK) return null;
+    final ref = out.ref;
+    return AudioLevels(
+      rms: ref.rms,
+      peak: ref.peak,
+      centroidHz: ref.centroidHz,
+      energy: ref.energy,
+      frames: ref.frames,
+      blocks: ref.blocks,
+    );
+  }
+
+  /// 丢弃最旧的数据，只保留最近 [keepSamples] 个样本 (预录模式)
+  ///
+  /// 返回丢弃的样本数
+  int trim(int keepSamples) {
+    if (!_isCapturing) return 0;
+    return _bindings.trim(_handle!, keepSamples);
+  }
+
+  /// 将原生单调时钟时间戳换算为 DateTime (与 Dart 侧计时方式一致)
+  DateTime? _toWallClock(int captureTimeNs) {
+    if (captureTimeNs < 0) return null;
+    final ageUs = (_bindings.clockNs() - captureTimeNs) ~/ 1000;
+    return DateTime.now().subtract(Duration(microseconds: ageUs));
+  }
+
+  /// 等待采集线程写入新数据
+  ///
+  /// 可读帧数达到 [minFrames] 后唤醒 (按块调度时避免每 10ms 唤醒一次)。
+  /// 返回 true 表示数据已足够 (或采集线程出错，需调用 [read] 获取错误)，
+  /// 超时时返回是否有任意数据可读
+  Future<bool> waitForData(Duration timeout, {int minFrames = 1}) async {
+    if (!_isCapturing) {
+      return false;
+    }
+    if (available >= minFrames) {
+      return true;
+    }
+
+    final waiter = Completer<bool>();
+    _waiter = waiter;
+    _bindings.armNotifyAt(_handle!, minFrames);
+
+    // arm 之前刚写入的数据不会触发回调，再检查一次
+    if (available >= minFrames || _bindings.lastError(_handle!) < 0) {
+      _waiter = null;
+      return true;
+    }
+
+    return waiter.future.timeout(timeout, onTimeout: () {
+      if (identical(_waiter, waiter)) {
+        _waiter = null;
+      }
+      return available > 0;
+    });
+  }
+
+  /// 将原生错误码映射为 [NativeCaptureError]
+  static NativeCaptureError mapError(int code) {
+    switch (code) {
+      case NEXTALK_CAPTURE_OK:
+        return NativeCaptureError.none;
+      case NEXTALK_CAPTURE_ERR_LIBRARY:
+        return NativeCaptureError.libraryNotFound;
+      case NEXTALK_CAPTURE_ERR_OPEN:
+        return NativeCaptureError.openFailed;
+      case NEXTALK_CAPTURE_ERR_START:
+        return NativeCaptureError.startFailed;
+      case NEXTALK_CAPTURE_ERR_DEVICE_LOST:
+        return NativeCaptureError.deviceLost;
+      case NEXTALK_CAPTURE_ERR_STATE:
+        return NativeCaptureError.notInitialized;
+      default:
+        return NativeCaptureError.readFailed;
+    }
+  }
+
+  String _errorText() {
+    if (_handle == null) return '';
+    const bufLen = 512;
+    final buf = calloc<Uint8>(bufLen).cast<Utf8>();
+    try {
+      _bindings.errorText(_handle!, buf, bufLen);
+      return buf.toDartString();
+    } finally {
+      calloc.free(buf);
+    }
+  }
+
+  /// 当前可读样本数
+  int get available => _handle != null ? _bindings.available(_handle!) : 0;
+
+  /// 因消费者跟不上而丢弃的样本数
+  int get overruns => _handle != null ? _bindings.overruns(_handle!) : 0;
+
+  /// 音频服务器授予的缓冲延迟 (毫秒)，后端未提供时为 null
+  double? get grantedLatencyMs {
+    if (_handle == null) return null;
+    final us = _bindings.grantedLatencyUs(_handle!);
+    return us >= 0 ? us / 1000.0 : null;
+  }
+
+  /// 实测采集延迟 (毫秒)，后端未提供时为 null
+  double? get latencyMs {
+    if (_handle == null) return null;
+    final us = _bindings.latencyUs(_handle!);
+    return us >= 0 ? us / 1000.0 : null;
+  }
+
+  /// 设备侧实际采样率 (由原生库重采样时不同于 16kHz)，未知时为 null
+  int? get deviceSampleRate {
+    if (_handle == null) return null;
+    final rate = _bindings.deviceRate(_handle!);
+    return rate > 0 ? rate : null;
+  }
+
+  /// 最近一次 [read] 所读首个样本被麦克风采集的时刻 (已扣除服务器与设备延迟)
+  DateTime? get lastReadCaptureTime => _lastReadCaptureTime;
+
+  /// 采集线程是否获得了实时调度优先级
+  bool get isRealtime => _handle != null && _bindings.isRealtime(_handle!) != 0;
+
+  /// 是否已初始化
+  bool get isInitialized => _isInitialized;
+
+  /// 是否正在录音
+  bool get isCapturing => _isCapturing;
+
+  /// 最后的错误信息
+  String? get lastError => _lastError;
+
+  /// 释放资源 (会先停止采集线程并关闭设备)
+  void dispose() {
+    // ignore: avoid_print
+    print('[NativeAudioCapture] 🗑️ 释放资源');
+    stop();
+    if (_handle != null) {
+      _bindings.destroy(_handle!);
+      _handle = null;
+    }
+    _notifyCallable?.close();
+    _notifyCallable = null;
+    if (_captureTimeNs != null) {
+      calloc.free(_captureTimeNs!);
+      _captureTimeNs = null;
+    }
+    if (_levels != null) {
+      calloc.free(_levels!);
+      _levels = null;
+    }
+    _isInitialized = false;
+  }
+}
@@ -0,0 +1,204 @@
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:isolate';
+
+import 'package:ffi/ffi.dart';
+import 'package:path/path.dart' as path;
+
+import '../ffi/native_ort_bindings.dart';
+
+/// 一个模型的优化结果
+class OrtOptimizeResult {
+  /// 原始 ONNX 模型路径
+  final String source;
+
+  /// 原生返回码 (NEXTALK_ORT_*)
+  final int code;
+
+  /// onnxruntime 的错误信息 (成功时为空)
+  final String error;
+
+  /// 优化耗时
+  final Duration elapsed;
+
+  const OrtOptimizeResult({
+    required this.source,
+    required this.code,
+    required this.error,
+    required this.elapsed,
+  });
+
+  bool get ok => code == NEXTALK_ORT_OK;
+}
+
+/// ONNX Runtime 优化模型缓存
+///
+/// 识别器每次创建都要解析 ONNX 并做图优化。首次使用某个模型时仍加载原文件，
+/// 并记下未命中；随后在后台 isolate 中由 onnxruntime 优化并另存为 ORT 格式，
+/// 之后创建识别器时改为加载缓存副本。
+///
+/// 缓存位于 $XDG_CACHE_HOME/nextalk/ort/<键>/，键由 onnxruntime 版本与
+/// CPU 特性组成；文件名包含原模型的大小与修改时间，模型更新后自动失效。
+/// 缓存副本在默认 CPU 提供者下以 ORT_ENABLE_ALL 优化，含 CPU 专用的融合算子，
+/// 只能交给 CPU 提供者执行，其他提供者 (如 xnnpack) 始终加载原模型。
+class OrtModelCache {
+  OrtModelCache._();
+
+  static final OrtModelCache instance = OrtModelCache._();
+
+  /// 是否启用 (model.ort_cache)
+  bool enabled = true;
+
+  String? _key;
+  bool _keyResolved = false;
+
+  int _hits = 0;
+  final Set<String> _missed = {};
+
+  /// 缓存根目录
+  static String get rootDirectory {
+    final xdgCache = Platform.environment['XDG_CACHE_HOME'];
+    final base = xdgCache != null && xdgCache.isNotEmpty
+        ? xdgCache
+        : '${Platform.environment['HOME']}/.cache';
+    return '$base/nextalk/ort';
+  }
+
+  /// 缓存键 (如 ort-1.17.1-x86_64+avx2+fma)，原生库不可用时为 null
+  String? get key {
+    if (_keyResolved) return _key;
+    _keyResolved = true;
+    try {
+      final bindings = NativeOrtBindings();
+      final version = bindings.version().toDartString();
+      if (version.isNotEmpty) {
+        _key = 'ort-$version-${bindings.cpuFeatures().toDartString()}';
+      }
+    } catch (_) {
+      _key = null;
+    }
+    return _key;
+  }
+
+  /// 本进程命中缓存的模型数
+  int get hits => _hits;
+
+  /// 本进程未命中缓存、尚待优化的模型
+  List<String> get missed => List.unmodifiable(_missed);
+
+  /// [onnxPath] 对应的缓存路径 (不检查是否已生成)，无法缓存时返回 null
+  String? cachePathFor(String onnxPath) {
+    final cacheKey = key;
+    if (cacheKey == null || !onnxPath.endsWith('.onnx')) return null;
+    final FileStat stat;
+    try {
+      stat = File(onnxPath).statSync();
+    } catch (_) {
+      return null;
+    }
+    if (stat.type != FileSystemEntityType.file) return null;
+    final stem = path.basenameWithoutExtension(onnxPath);
+    final modelDir = path.basename(path.dirname(onnxPath));
+    final mtime = stat.modified.millisecondsSinceEpoch ~/ 1000;
+    return '$rootDirectory/$cacheKey/$modelDir/$stem-${stat.size}-$mtime.ort';
+  }
+
+  /// [provider] 能否执行缓存副本 (只有生成缓存时使用的 cpu 提供者可以)
+  static bool supportsProvider(String provider) => provider == 'cpu';
+
+  /// 创建识别器前调用: 有缓存时返回缓存路径，否则返回原路径并记为未命中
+  ///
+  /// [provider] 为识别器使用的执行提供者，非 cpu 时直接返回原路径。
+  String resolve(String onnxPath, {required String provider}) {
+    if (!enabled || !supportsProvider(provider)) return onnxPath;
+    final cached = cachePathFor(onnxPath);
+    if (cached == null) return onnxPath;
+    final file = File(cached);
+    if (file.existsSync() && file.lengthSync() > 0) {
+      _hits++;
+      _missed.remove(onnxPath);
+      return cached;
+    }
+    _missed.add(onnxPath);
+    return onnxPath;
+  }
+
+  /// 在后台 isolate 中优化未命中的模型，下次创建识别器时生效
+  Future<List<OrtOptimizeResult>> optimizeMissed() async {
+    final cacheKey = key;
+    if (!enabled || cacheKey == null || _missed.isEmpty) return const [];
+    final jobs = <(String, String)>[
+      for (final source in _missed)
+        if (cachePathFor(source) case final target?) (source, target),
+    ];
+    _missed.clear();
+    final root = rootDirectory;
+    return Isolate.run(() => _optimizeInIsolate(root, cacheKey, jobs));
+  }
+
+  /// 删除 [modelDir] 中模型的缓存 (模型删除或重新下载时)
+  void evict(String modelDir) {
+    final cacheKey = key;
+    if (cacheKey == null) return;
+    final dir = Directory('$rootDirectory/$cacheKey/${path.basename(modelDir)}');
+    try {
+      if (dir.existsSync()) dir.deleteSync(recursive: true);
+    } catch (_) {}
+  }
+
+  /// 在 isolate 中逐个优化 (每个耗时与一次模型加载相当)
+  static List<OrtOptimizeResult> _optimizeInIsolate(
+      String root, String cacheKey, List<(String, String)> jobs) {
+    // 其他 onnxruntime 版本或 CPU 的缓存已无法使用
+    try {
+      for (final entry in Directory(root).listSync()) {
+        if (entry is Directory && path.basename(entry.path) != cacheKey) {
+          entry.deleteSync(recursive: true);
+        }
+      }
+    } catch (_) {}
+
+    final bindings = NativeOrtBindings();
+    const errorLen = 512;
+    final error = calloc<Uint8>(errorLen).cast<Utf8>();
+    final results = <OrtOptimizeResult>[];
+    try {
+      for (final (source, target) in jobs) {
+        _removeStale(target);
+        Directory(path.dirname(target)).createSync(recursive: true);
+        final src = source.toNativeUtf8();
+        final dst = target.toNativeUtf8();
+        final watch = Stopwatch()..start();
+        final code = bindings.optimize(src, dst, error, errorLen);
+        watch.stop();
+        calloc.free(src);
+        calloc.free(dst);
+        results.add(OrtOptimizeResult(
+          source: source,
+          code: code,
+          error: code == NEXTALK_ORT_OK ? '' : error.toDartString(),
+          elapsed: watch.elapsed,
+        ));
+      }
+    } finally {
+      calloc.free(error);
+    }
+    return results;
+  }
+
+  /// 删除同一模型旧版本 (大小或修改时间不同) 的缓存
+  static void _removeStale(String target) {
+    final dir = Directory(path.dirname(target));
+    if (!dir.existsSync()) return;
+    final name = path.basename(target);
+    // <stem>-<size>-<mtime>.ort
+    final stem = name.replaceFirst(RegExp(r'-\d+-\d+\.ort$'), '');
+    final stale = RegExp('^${RegExp.escape(stem)}-\\d+-\\d+\\.ort\$');
+    for (final entry in dir.listSync()) {
+      final entryName = path.basename(entry.path);
+      if (entry is File && entryName != name && stale.hasMatch(entryName)) {
+        entry.deleteSync();
+      }
+    }
+  }
+}
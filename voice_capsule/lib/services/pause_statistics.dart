@@ -0,0 +1,149 @@
+import 'dart:convert';
+import 'dart:math' as math;
+
+/// 句内停顿统计，用于自适应端点静音阈值
+///
+/// 记录同一句话中两段语音之间的停顿 (之后又继续说话的静音)，以 50ms 分桶的
+/// 直方图累计，跨录音持久化。阈值取停顿分布的高分位数加安全余量:
+/// - 说话快、停顿短的用户阈值下降，说完后更快提交
+/// - 习惯长停顿的用户阈值上升，减少句中被截断
+///
+/// 阈值只在录音之间调整 (每次开始录音时计算一次)，并限制在
+/// [minThresholdSec] 与 [maxThresholdSec] 之间；样本不足时向默认值收缩。
+class PauseStatistics {
+  /// 直方图桶宽 (秒)
+  static const double binSec = 0.05;
+
+  /// 计入统计的最短停顿 (秒)，更短的是音节间隙
+  static const double minPauseSec = 0.15;
+
+  /// 计入统计的最长停顿 (秒)，更长的视为两句话之间
+  static const double maxPauseSec = 2.0;
+
+  /// 阈值下限 (秒)
+  static const double minThresholdSec = 0.6;
+
+  /// 阈值上限 (秒)
+  static const double maxThresholdSec = 2.0;
+
+  /// 取停顿分布的分位数
+  static const double quantile = 0.9;
+
+  /// 分位数之上的安全余量 (秒)
+  static const double marginSec = 0.2;
+
+  /// 样本权重达到此值后完全采用学习到的阈值
+  static const double fullWeightPauses = 50;
+
+  /// 每次录音开始时旧样本的衰减系数，让统计跟随用户习惯变化
+  static const double sessionDecay = 0.95;
+
+  static final int _binCount = (maxPauseSec / binSec).round();
+
+  final List<double> _bins;
+
+  // 本次录音的停顿跟踪 (不持久化)
+  bool _inUtterance = false;
+  double _pauseSec = 0;
+
+  PauseStatistics() : _bins = List<double>.filled(_binCount, 0);
+
+  PauseStatistics._(this._bins);
+
+  /// 累计的停顿样本权重 (衰减后)
+  double get sampleWeight => _bins.fold(0.0, (a, b) => a + b);
+
+  /// 停顿分布的分位数 (秒)，无样本时为 null
+  double? quantileSec(double q) {
+    final total = sampleWeight;
+    if (total <= 0) return null;
+    final target = total * q;
+    var acc = 0.0;
+    for (var i = 0; i < _bins.length; i++) {
+      acc += _bins[i];
+      if (acc >= target) return (i + 1) * binSec;
+    }
+    return maxPauseSec;
+  }
+
+  /// 根据停顿分布推荐的端点静音阈值 (秒)
+  ///
+  /// 样本权重不足 [fullWeightPauses] 时按比例向 [defaultSec] 收缩
+  double recommendedThresholdSec(double defaultSec) {
+    final q = quantileSec(quantile);
+    if (q == null) return defaultSec;
+    final learned =
+        (q + marginSec).clamp(minThresholdSec, maxThresholdSec).toDouble();
+    final weight = math.min(1.0, sampleWeight / fullWeightPauses);
+    final blended = defaultSec + (learned - defaultSec) * weight;
+    return blended.clamp(minThresholdSec, maxThresholdSec).toDouble();
+  }
+
+  /// 开始一次录音: 衰减旧样本并清空句内状态
+  void beginSession() {
+    for (var i = 0; i < _bins.length; i++) {
+      _bins[i] *= sessionDecay;
+    }
+    endUtterance();
+  }
+
+  /// 送入一块的语音判定 [speech] 与时长 [seconds]
+  void feed(bool speech, double seconds) {
+    if (speech) {
+      if (_inUtterance && _pauseSec >= minPauseSec) {
+        _record(_pauseSec);
+      }
+      _inUtterance = true;
+      _pauseSec = 0;
+      return;
+    }
+    if (!_inUtterance) return;
+    _pauseSec += seconds;
+    if (_pauseSec > maxPauseSec) {
+      // 停顿过长，视为两句话之间
+      endUtterance();
+    }
+  }
+
+  /// 一句话结束 (端点触发): 尾部静音不是句内停顿，丢弃
+  void endUtterance() {
+    _inUtterance = false;
+    _pauseSec = 0;
+  }
+
+  void _record(double pauseSec) {
+    final bin = (pauseSec / binSec).floor().clamp(0, _bins.length - 1);
+    _bins[bin] += 1;
+  }
+
+  /// 序列化为 JSON 字符串 (持久化到设置)
+  String toJson() => jsonEncode({
+        'bin_ms': (binSec * 1000).round(),
+        'bins': _bins.map((w) => double.parse(w.toStringAsFixed(3))).toList(),
+      });
+
+  /// 从 JSON 字符串恢复，格式不符 (如桶宽变化) 时返回空统计
+  static PauseStatistics fromJson(String? json) {
+    if (json == null || json.isEmpty) return PauseStatistics();
+    try {
+      final map = jsonDecode(json) as Map<String, dynamic>;
+      final bins = (map['bins'] as List).map((e) => (e as num).toDouble());
+      if (map['bin_ms'] != (binSec * 1000).round() ||
+          bins.length != _binCount) {
+        return PauseStatistics();
+      }
+      return PauseStatistics._(bins.toList());
+    } catch (_) {
+      return PauseStatistics();
+    }
+  }
+
+  @override
+  String toString() {
+    final p50 = quantileSec(0.5);
+    final p90 = quantileSec(quantile);
+    String fmt(double? v) => v == null ? '-' : '${v.toStringAsFixed(2)}s';
+    return 'PauseStatistics(weight: ${sampleWeight.toStringAsFixed(1)}, '
+        'p50: ${fmt(p50)}, p90: ${fmt(p90)})';
+  }
+}
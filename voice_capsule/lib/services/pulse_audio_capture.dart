@@ -7,6 +7,7 @@ class PulseAudioConfig {
   static const int sampleRate = 16000;
   static const int channels = 1;
   static const int framesPerBuffer = 1600; // 100ms @ 16kHz
+  static const int targetLatencyMs = 20; // 请求的分片时长 (fragsize)
 }
 
 /// PulseAudio 录音错误类型
@@ -30,6 +31,7 @@ class PulseAudioCapture {
   Pointer<Float>? _buffer;
   Pointer<Int32>? _errorPtr;
   Pointer<PaSampleSpec>? _sampleSpec;
+  Pointer<PaBufferAttr>? _bufferAttr;
 
   bool _isInitialized = false;
   bool _isCapturing = false;
@@ -49,7 +51,11 @@ class PulseAudioCapture {
   ///
   /// [deviceName] 设备名（如 "alsa_input.pci-0000_00_08.0.analog-stereo"），
   /// 传入 null 或 "default" 使用系统默认设备
-  Future<PulseAudioError> initialize({String? deviceName}) async {
+  /// [targetLatencyMs] 请求的分片时长，避免服务器默认选择数百毫秒的分片
+  Future<PulseAudioError> initialize({
+    String? deviceName,
+    int targetLatencyMs = PulseAudioConfig.targetLatencyMs,
+  }) async {
     if (_isInitialized) {
       return PulseAudioError.none;
     }
@@ -70,12 +76,25 @@ class PulseAudioCapture {
     _buffer = calloc<Float>(PulseAudioConfig.framesPerBuffer);
     _errorPtr = calloc<Int32>();
     _sampleSpec = calloc<PaSampleSpec>();
+    _bufferAttr = calloc<PaBufferAttr>();
 
     // 配置采样格式
     _sampleSpec!.ref.format = PA_SAMPLE_FLOAT32NE;
     _sampleSpec!.ref.rate = PulseAudioConfig.sampleRate;
     _sampleSpec!.ref.channels = PulseAudioConfig.channels;
 
+    // 按目标延迟请求分片大小 (录音流只有 fragsize/maxlength 生效)
+    final fragsize = PulseAudioConfig.sampleRate *
+        targetLatencyMs ~/
+        1000 *
+        PulseAudioConfig.channels *
+        sizeOf<Float>();
+    _bufferAttr!.ref.fragsize = fragsize;
+    _bufferAttr!.ref.maxlength = fragsize * 4;
+    _bufferAttr!.ref.tlength = PA_BUFFER_ATTR_DEFAULT;
+    _bufferAttr!.ref.prebuf = PA_BUFFER_ATTR_DEFAULT;
+    _bufferAttr!.ref.minreq = PA_BUFFER_ATTR_DEFAULT;
+
     // 创建录音流
     final appName = 'Nextalk'.toNativeUtf8();
     final streamName = 'Voice Input'.toNativeUtf8();
@@ -94,7 +113,7 @@ class PulseAudioCapture {
       streamName,
       _sampleSpec!,
       nullptr, // 默认 channel map
-      nullptr, // 默认缓冲属性
+      _bufferAttr!,
       _errorPtr!,
     );
 
@@ -167,6 +186,15 @@ class PulseAudioCapture {
     return samples;
   }
 
+  /// 实测采集延迟 (毫秒)，查询失败返回 null
+  double? get latencyMs {
+    if (!_isInitialized || _stream == null) return null;
+    final usec = _bindings!.simpleGetLatency(_stream!, _errorPtr!);
+    // 失败时返回 (pa_usec_t) -1，映射到 Dart int 为 -1
+    if (usec < 0) return null;
+    return usec / 1000.0;
+  }
+
   /// 获取内部缓冲区（零拷贝接口）
   Pointer<Float>? get buffer => _buffer;
 
@@ -204,6 +232,10 @@ class PulseAudioCapture {
       calloc.free(_sampleSpec!);
       _sampleSpec = null;
     }
+    if (_bufferAttr != null) {
+      calloc.free(_bufferAttr!);
+      _bufferAttr = null;
+    }
     _isInitialized = false;
     _isCapturing = false;
   }
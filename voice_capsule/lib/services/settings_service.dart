@@ -5,6 +5,10 @@ import 'package:shared_preferences/shared_preferences.dart';
 import 'package:yaml/yaml.dart';
 
 import '../constants/settings_constants.dart';
+import 'chunk_scheduler.dart';
+import 'cpu_profile.dart';
+import 'pause_statistics.dart';
+import 'thread_calibration.dart';
 
 /// 模型切换回调类型 (Zipformer 版本切换)
 typedef ModelSwitchCallback = Future<void> Function(ModelType newType);
@@ -84,9 +88,72 @@ class SettingsService {
     if (!settingsFile.existsSync()) {
       settingsFile.writeAsStringSync(SettingsConstants.defaultSettingsYaml);
       debugPrint('SettingsService: 创建默认配置文件');
+      return;
+    }
+
+    // 托盘菜单选择过模型版本时以选择为准，配置文件保持一致，不迁移
+    if (_prefs!.getString(SettingsConstants.keyModelType) != null) return;
+    try {
+      final content = settingsFile.readAsStringSync();
+      final migrated = migrateLegacyModelType(content);
+      if (migrated != content) {
+        settingsFile.writeAsStringSync(migrated);
+        debugPrint('SettingsService: 旧模板的 zipformer.type: int8 已迁移为 auto');
+      }
+    } catch (e) {
+      debugPrint('SettingsService: 迁移配置文件失败: $e');
     }
   }
 
+  // 旧模板中未修改过的 zipformer 模型版本块 (中文与英文模板)
+  static final List<(RegExp, List<String>)> _legacyModelTypeBlocks = [
+    (
+      RegExp(
+          r'^([ \t]*)# 模型版本: int8 \| standard\n'
+          r'[ \t]*# int8: 量化版本，速度快，内存占用小\n'
+          r'[ \t]*# standard: 标准版本，精度高\n'
+          r'[ \t]*type:[ \t]*int8[ \t]*$',
+          multiLine: true),
+      [
+        '# 模型版本: auto | int8 | standard',
+        '# auto: 按 CPU 自动选择，没有 AVX2 的 x86 CPU 上 int8 较慢，使用 standard',
+        '# int8: 量化版本，速度快，内存占用小 (VNNI / AMX / dotprod 加速明显)',
+        '# standard: 标准版本，精度高',
+        'type: auto',
+      ],
+    ),
+    (
+      RegExp(
+          r'^([ \t]*)# Model version: int8 \| standard\n'
+          r'[ \t]*# int8: Quantized version, faster, less memory\n'
+          r'[ \t]*# standard: Standard version, higher accuracy\n'
+          r'[ \t]*type:[ \t]*int8[ \t]*$',
+          multiLine: true),
+      [
+        '# Model version: auto | int8 | standard',
+        '# auto: Chosen from the CPU; x86 CPUs without AVX2 run int8 slowly and use standard',
+        '# int8: Quantized version, faster, less memory (much faster with VNNI / AMX / dotprod)',
+        '# standard: Standard version, higher accuracy',
+        'type: auto',
+      ],
+    ),
+  ];
+
+  /// 把旧模板默认的 `zipformer.type: int8` 迁移为 auto
+  ///
+  /// 旧模板把 int8 写死为默认值，无法与用户的选择区分，原样保留会使
+  /// 按 CPU 自动选择永远不生效。只迁移与旧模板逐行一致的块，
+  /// 用户改过的值 (或注释) 保持不变，仍视为明确指定。
+  static String migrateLegacyModelType(String content) {
+    for (final (pattern, lines) in _legacyModelTypeBlocks) {
+      content = content.replaceFirstMapped(pattern, (match) {
+        final indent = match.group(1)!;
+        return lines.map((line) => '$indent$line').join('\n');
+      });
+    }
+    return content;
+  }
+
   /// 加载 YAML 配置
   Future<void> _loadYamlConfig() async {
     try {
@@ -128,18 +195,27 @@ class SettingsService {
   // ===== 模型类型 =====
 
   /// 获取当前模型类型
+  ///
+  /// 托盘菜单选择过或配置文件指定了 int8 / standard 时按用户选择；
+  /// 否则 (auto 或未配置) 按 [CpuProfile.preferredModelType] 自动选择
   ModelType get modelType {
     if (_prefs == null) return SettingsConstants.defaultModelType;
+    return _explicitModelType ?? CpuProfile.current.preferredModelType;
+  }
 
-    final typeStr = _prefs!.getString(SettingsConstants.keyModelType);
-    if (typeStr == null) {
-      // 尝试从 YAML 读取
-      final yamlType = _yamlConfig?['model']?['type'] as String?;
-      if (yamlType == 'standard') return ModelType.standard;
-      return SettingsConstants.defaultModelType;
-    }
-
-    return typeStr == 'standard' ? ModelType.standard : ModelType.int8;
+  /// 模型类型是否按 CPU 自动选择
+  bool get modelTypeAuto => _prefs != null && _explicitModelType == null;
+
+  /// 用户指定的模型类型 (托盘菜单优先于配置文件)，auto 或未配置时为 null
+  ModelType? get _explicitModelType {
+    final typeStr = _prefs!.getString(SettingsConstants.keyModelType) ??
+        _yamlConfig?['model']?['zipformer']?['type'] as String? ??
+        _yamlConfig?['model']?['type'] as String?;
+    return switch (typeStr) {
+      'standard' => ModelType.standard,
+      'int8' => ModelType.int8,
+      _ => null,
+    };
   }
 
   /// 设置模型类型
@@ -284,6 +360,58 @@ class SettingsService {
     }
   }
 
+  /// onnxruntime 执行提供者 (model.provider)，auto 时按 [CpuProfile.preferredProvider]
+  String get provider =>
+      providerAuto ? CpuProfile.current.preferredProvider : _configuredProvider;
+
+  /// 执行提供者是否自动选择
+  bool get providerAuto => _configuredProvider == 'auto';
+
+  String get _configuredProvider {
+    final value = _yamlConfig?['model']?['provider'];
+    return value is String && value.isNotEmpty
+        ? value
+        : SettingsConstants.defaultProvider;
+  }
+
+  /// 是否缓存 onnxruntime 优化后的模型 (model.ort_cache)
+  ///
+  /// 缓存按默认 CPU 提供者优化，使用其他提供者时不使用缓存
+  bool get ortModelCache {
+    if (provider != 'cpu') return false;
+    final value = _yamlConfig?['model']?['ort_cache'];
+    if (value is bool) return value;
+    return SettingsConstants.defaultOrtModelCache;
+  }
+
+  /// 多久未录音后释放识别模型 (model.idle_unload_min)，null 表示常驻内存
+  Duration? get idleUnloadAfter {
+    final value = _yamlConfig?['model']?['idle_unload_min'];
+    final minutes = value is int
+        ? value.clamp(0, SettingsConstants.maxIdleUnloadMin)
+        : SettingsConstants.defaultIdleUnloadMin;
+    return minutes > 0 ? Duration(minutes: minutes) : null;
+  }
+
+  /// 获取指定引擎的推理线程数
+  ///
+  /// model.<engine>.num_threads 大于 0 时按配置；为 0 或未配置时使用本机的
+  /// 校准结果 ([threadCalibration])，尚未校准时使用 [SettingsConstants.defaultNumThreads]
+  int numThreadsFor(EngineType engine) {
+    final value = _yamlConfig?['model']?[engine.name]?['num_threads'];
+    if (value is int && value > 0) {
+      return value.clamp(1, SettingsConstants.maxNumThreads);
+    }
+    return threadCalibration.threadsFor(engine) ??
+        SettingsConstants.defaultNumThreads;
+  }
+
+  /// 指定引擎的线程数是否由配置文件固定 (为 false 时使用校准结果)
+  bool numThreadsConfigured(EngineType engine) {
+    final value = _yamlConfig?['model']?[engine.name]?['num_threads'];
+    return value is int && value > 0;
+  }
+
   // ===== SenseVoice 配置 =====
 
   /// 获取 SenseVoice use_itn 配置
@@ -300,6 +428,102 @@ class SettingsService {
     return SettingsConstants.defaultSenseVoiceLanguage;
   }
 
+  /// 获取 SenseVoice 中间解码间隔 (毫秒)，0 表示只在语音段结束时输出
+  int get senseVoicePartialIntervalMs {
+    final value = _yamlConfig?['model']?['sensevoice']?['partial_interval_ms'];
+    if (value is int) {
+      return value.clamp(0, SettingsConstants.maxSenseVoicePartialIntervalMs);
+    }
+    return SettingsConstants.defaultSenseVoicePartialIntervalMs;
+  }
+
+  /// 获取 SenseVoice 中间解码允许占用的计算比例
+  double get senseVoicePartialMaxLoad {
+    final value = _yamlConfig?['model']?['sensevoice']?['partial_max_load'];
+    if (value is num) return value.toDouble().clamp(0.1, 1.0);
+    return SettingsConstants.defaultSenseVoicePartialMaxLoad;
+  }
+
+  // ===== 两遍识别配置 =====
+
+  /// 两遍识别配置节 (model.zipformer.two_pass)
+  Map? get _twoPassSection {
+    final value = _yamlConfig?['model']?['zipformer']?['two_pass'];
+    return value is Map ? value : null;
+  }
+
+  /// 是否启用两遍识别 (仅 Zipformer 引擎)
+  bool get twoPassEnabled {
+    final value = _twoPassSection?['enabled'];
+    if (value is bool) return value;
+    return SettingsConstants.defaultTwoPassEnabled;
+  }
+
+  /// 两遍识别第二遍使用的推理线程数
+  int get twoPassNumThreads {
+    final value = _twoPassSection?['num_threads'];
+    if (value is int) {
+      return value.clamp(1, SettingsConstants.maxTwoPassNumThreads);
+    }
+    return SettingsConstants.defaultTwoPassNumThreads;
+  }
+
+  /// 两遍识别每个语音段缓存音频的时长上限 (秒)
+  double get twoPassMaxSegmentSec {
+    final value = _twoPassSection?['max_segment_sec'];
+    if (value is num) return value.toDouble().clamp(5.0, 60.0);
+    return SettingsConstants.defaultTwoPassMaxSegmentSec;
+  }
+
+  /// 两遍识别停止录音时等待第二遍结果的上限 (毫秒)
+  int get twoPassMaxWaitMs {
+    final value = _twoPassSection?['max_wait_ms'];
+    if (value is int) return value.clamp(0, 5000);
+    return SettingsConstants.defaultTwoPassMaxWaitMs;
+  }
+
+  // ===== 常驻识别宿主配置 =====
+
+  /// 常驻识别宿主配置节 (model.zipformer.engine_host)
+  Map? get _engineHostSection {
+    final value = _yamlConfig?['model']?['zipformer']?['engine_host'];
+    return value is Map ? value : null;
+  }
+
+  /// 是否在常驻识别宿主中运行 Zipformer
+  bool get engineHostEnabled {
+    final value = _engineHostSection?['enabled'];
+    if (value is bool) return value;
+    return SettingsConstants.defaultEngineHostEnabled;
+  }
+
+  /// 没有客户端连接后宿主保留模型的时间 (分钟)
+  int get engineHostIdleTimeoutMin {
+    final value = _engineHostSection?['idle_timeout_min'];
+    if (value is int) {
+      return value.clamp(1, SettingsConstants.maxEngineHostIdleTimeoutMin);
+    }
+    return SettingsConstants.defaultEngineHostIdleTimeoutMin;
+  }
+
+  /// 获取指定引擎的分块策略
+  ///
+  /// model.<engine>.first_chunk_ms / chunk_ms 覆盖 [ChunkPolicy.forEngine] 的默认值
+  ChunkPolicy chunkPolicyFor(EngineType engine) {
+    final defaults = ChunkPolicy.forEngine(engine);
+    final section = _yamlConfig?['model']?[engine.name];
+    if (section is! Map) return defaults;
+    final first = section['first_chunk_ms'];
+    final steady = section['chunk_ms'];
+    if (first is! int && steady is! int) return defaults;
+    return ChunkPolicy(
+      name: 'custom',
+      initialMs: first is int ? first : defaults.initialMs,
+      steadyMs: steady is int ? steady : defaults.steadyMs,
+      rampAfterMs: defaults.rampAfterMs,
+    ).clamped();
+  }
+
   // ===== 自定义下载 URL =====
 
   /// 获取 Zipformer 自定义模型下载 URL (从 YAML 读取)
@@ -365,6 +589,77 @@ class SettingsService {
     return SettingsConstants.defaultAudioInputDevice;
   }
 
+  /// 获取采集目标延迟 (毫秒)，超出范围时截断到允许区间
+  int get audioTargetLatencyMs {
+    final value = _yamlConfig?['audio']?['target_latency_ms'];
+    if (value is int) {
+      return value.clamp(
+        SettingsConstants.minAudioTargetLatencyMs,
+        SettingsConstants.maxAudioTargetLatencyMs,
+      );
+    }
+    return SettingsConstants.defaultAudioTargetLatencyMs;
+  }
+
+  /// 是否以设备原生采样率/格式采集 (由原生库重采样)
+  bool get audioDeviceNativeFormat {
+    final value = _yamlConfig?['audio']?['device_native_format'];
+    if (value is bool) return value;
+    return SettingsConstants.defaultAudioDeviceNativeFormat;
+  }
+
+  /// 获取预录时长 (毫秒)，0 表示关闭
+  int get audioPrerollMs {
+    final value = _yamlConfig?['audio']?['preroll_ms'];
+    if (value is int) {
+      return value.clamp(0, SettingsConstants.maxAudioPrerollMs);
+    }
+    return SettingsConstants.defaultAudioPrerollMs;
+  }
+
+  /// 获取端点检测模式
+  EndpointMode get audioEndpointMode {
+    final value = _yamlConfig?['audio']?['endpoint_mode'];
+    if (value == 'hybrid') return EndpointMode.hybrid;
+    if (value == 'rules') return EndpointMode.rules;
+    return SettingsConstants.defaultEndpointMode;
+  }
+
+  /// 是否根据句内停顿统计自适应端点静音阈值
+  bool get audioAdaptiveSilence {
+    final value = _yamlConfig?['audio']?['adaptive_silence'];
+    if (value is bool) return value;
+    return SettingsConstants.defaultAudioAdaptiveSilence;
+  }
+
+  /// 是否在录音过程中提前提交已稳定的文本
+  bool get audioEarlyCommit {
+    final value = _yamlConfig?['audio']?['early_commit'];
+    if (value is bool) return value;
+    return SettingsConstants.defaultAudioEarlyCommit;
+  }
+
+  /// 读取持久化的句内停顿统计 (未初始化或无记录时为空统计)
+  PauseStatistics get pauseStatistics => PauseStatistics.fromJson(
+      _prefs?.getString(SettingsConstants.keyPauseStatistics));
+
+  /// 保存句内停顿统计
+  Future<void> savePauseStatistics(PauseStatistics stats) async {
+    if (_prefs == null) return;
+    await _prefs!.setString(SettingsConstants.keyPauseStatistics, stats.toJson());
+  }
+
+  /// 读取持久化的推理线程数校准结果 (未初始化或无记录时为空)
+  ThreadCalibration get threadCalibration => ThreadCalibration.fromJson(
+      _prefs?.getString(SettingsConstants.keyThreadCalibration));
+
+  /// 保存推理线程数校准结果
+  Future<void> saveThreadCalibration(ThreadCalibration calibration) async {
+    if (_prefs == null) return;
+    await _prefs!
+        .setString(SettingsConstants.keyThreadCalibration, calibration.toJson());
+  }
+
   /// 设置音频输入设备 (Story 3-9: AC6, AC7, AC12)
   /// [deviceName] 设备名称或 "default"
   Future<void> setAudioInputDevice(String deviceName) async {
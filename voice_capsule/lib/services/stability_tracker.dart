@@ -0,0 +1,126 @@
+import 'dart:math' as math;
+
+import 'asr/asr_engine.dart';
+
+/// 流式识别稳定前缀检测
+///
+/// 流式解码的假设只在末尾反复修正，较早的 token 通常不再变化。
+/// 一个 token 同时满足以下条件时视为稳定:
+/// - 连续 [minPersistence] 次结果更新中保持不变
+/// - 时间戳落后最新 token 至少 [minAgeSec] 秒 (其后已有足够的右侧上下文)
+///
+/// 稳定文本只增不减，可在录音过程中提前上屏，其余部分在停止时提交。
+/// 已判定稳定的 token 若仍被修正，则暂停输出，直到新的假设重新延续已输出文本。
+class StabilityTracker {
+  /// 默认连续不变的更新次数
+  static const int defaultMinPersistence = 3;
+
+  /// 默认时间戳落后最新 token 的秒数
+  static const double defaultMinAgeSec = 1.0;
+
+  /// SentencePiece 词首标记
+  static const String _wordBoundary = '▁';
+
+  final int minPersistence;
+  final double minAgeSec;
+
+  ASRResult _result = ASRResult.empty();
+
+  /// 每个 token 连续未变化的更新次数
+  List<int> _persistence = const [];
+
+  String _stableText = '';
+
+  StabilityTracker({
+    this.minPersistence = defaultMinPersistence,
+    this.minAgeSec = defaultMinAgeSec,
+  });
+
+  /// 当前完整假设
+  ASRResult get result => _result;
+
+  /// 已输出的稳定文本
+  String get stableText => _stableText;
+
+  /// 送入一次结果增量，返回新增的稳定文本 (无新增时为空串)
+  String update(ASRResultDelta delta) {
+    final kept = delta.keptTokens.clamp(0, _persistence.length);
+    _result = delta.applyTo(_result);
+    _persistence = [
+      for (var i = 0; i < kept; i++) _persistence[i] + 1,
+      for (var i = 0; i < delta.tokens.length; i++) 1,
+    ];
+
+    final candidate = _textOf(_stableTokenCount());
+    if (candidate.length <= _stableText.length ||
+        !candidate.startsWith(_stableText) ||
+        !_result.text.startsWith(candidate)) {
+      return '';
+    }
+    final added = candidate.substring(_stableText.length);
+    _stableText = candidate;
+    return added;
+  }
+
+  /// 清空状态 (新的一次录音)
+  void reset() {
+    _result = ASRResult.empty();
+    _persistence = const [];
+    _stableText = '';
+  }
+
+  /// 已提交 [committed] 后，[finalText] 中尚需提交的部分
+  ///
+  /// 提交后的文本无法撤回。最终结果修正了已提交部分 (见 [diverges]) 时
+  /// 按位置接续: 跳过与已提交文本等长的前缀，提交其后的部分。
+  /// 修正通常只替换个别字符，长度不变，这样既不重复输出已上屏的文字，
+  /// 也不丢失其后说出的内容。
+  static String remainder(String committed, String finalText) =>
+      finalText.substring(math.min(committed.length, finalText.length));
+
+  /// 最终结果是否修正了已提交的文本
+  static bool diverges(String committed, String finalText) =>
+      !finalText.startsWith(committed);
+
+  /// 满足稳定条件的前缀 token 数 (不在英文单词中间截断)
+  int _stableTokenCount() {
+    final tokens = _result.tokens;
+    final timestamps = _result.timestamps;
+    // 没有时间戳时无法判断右侧上下文，不提前输出
+    if (tokens.isEmpty || timestamps.length != tokens.length) return 0;
+
+    final latest = timestamps.last;
+    var count = 0;
+    while (count < tokens.length &&
+        _persistence[count] >= minPersistence &&
+        latest - timestamps[count] >= minAgeSec) {
+      count++;
+    }
+    while (count > 0 &&
+        count < tokens.length &&
+        _continuesWord(tokens[count])) {
+      count--;
+    }
+    return count;
+  }
+
+  /// 前 [count] 个 token 对应的文本
+  String _textOf(int count) {
+    if (count == 0) return '';
+    return _result.tokens
+        .take(count)
+        .join()
+        .replaceAll(_wordBoundary, ' ')
+        .trimLeft();
+  }
+
+  /// token 是否接续前一个英文子词 (不以词首标记开头的字母/数字片段)
+  static bool _continuesWord(String token) {
+    if (token.isEmpty || token.startsWith(_wordBoundary)) return false;
+    final c = token.codeUnitAt(0);
+    return (c >= 0x30 && c <= 0x39) ||
+        (c >= 0x41 && c <= 0x5A) ||
+        (c >= 0x61 && c <= 0x7A) ||
+        c == 0x27;
+  }
+}
@@ -0,0 +1,118 @@
+import 'dart:convert';
+import 'dart:io';
+import 'dart:math' as math;
+
+import '../constants/settings_constants.dart';
+
+/// 一个线程数下解码测试音频的耗时
+class ThreadTiming {
+  /// onnxruntime 推理线程数
+  final int threads;
+
+  /// 解码墙钟耗时 (多轮取最短)
+  final Duration wall;
+
+  /// 进程 CPU 耗时 (多轮取最短)
+  final Duration cpu;
+
+  /// 测试音频时长 (秒)
+  final double audioSec;
+
+  const ThreadTiming({
+    required this.threads,
+    required this.wall,
+    required this.cpu,
+    required this.audioSec,
+  });
+
+  /// 实时率 (解码耗时 / 音频时长)
+  double get rtf => wall.inMicroseconds / 1e6 / audioSec;
+
+  /// 每秒音频消耗的 CPU 秒数
+  double get cpuLoad => cpu.inMicroseconds / 1e6 / audioSec;
+
+  @override
+  String toString() => '$threads 线程: RTF ${rtf.toStringAsFixed(3)}, '
+      'CPU ${cpuLoad.toStringAsFixed(2)}s/音频秒';
+}
+
+/// 各引擎校准得到的推理线程数 (JSON 持久化，CPU 核数变化后作废)
+///
+/// [pick] 在 CPU 开销可接受的线程数中选延迟最低的；多线程收益不足
+/// [latencyTolerance] 时取更少的线程，把 CPU 留给界面和其他程序。
+class ThreadCalibration {
+  /// 校准时的 CPU 核数
+  final int cores;
+
+  /// 引擎 -> 线程数
+  final Map<EngineType, int> threads;
+
+  const ThreadCalibration({required this.cores, this.threads = const {}});
+
+  /// 延迟与最快结果相差不超过该比例时视为相同，取线程更少者
+  static const double latencyTolerance = 0.10;
+
+  /// CPU 开销不超过最省结果的倍数 (线程同步与空转的额外开销)
+  static const double maxCpuGrowth = 1.5;
+
+  /// 参与校准的最大线程数
+  static const int maxThreads = 8;
+
+  /// 按 CPU 核数列出参与校准的线程数
+  static List<int> candidates(int cores) =>
+      [for (var n = 1; n <= math.min(cores, maxThreads); n++) n];
+
+  /// 从测量结果中选出线程数
+  static int pick(List<ThreadTiming> timings) {
+    if (timings.isEmpty) return SettingsConstants.defaultNumThreads;
+    final minCpu = timings.map((t) => t.cpu.inMicroseconds).reduce(math.min);
+    final affordable = timings
+        .where((t) => t.cpu.inMicroseconds <= minCpu * maxCpuGrowth)
+        .toList();
+    final best = affordable.map((t) => t.wall.inMicroseconds).reduce(math.min);
+    return affordable
+        .where((t) => t.wall.inMicroseconds <= best * (1 + latencyTolerance))
+        .map((t) => t.threads)
+        .reduce(math.min);
+  }
+
+  /// 本机的校准值 (未校准或 CPU 核数已变化时为 null)
+  int? threadsFor(EngineType engine, {int? cores}) =>
+      this.cores == (cores ?? Platform.numberOfProcessors)
+          ? threads[engine]
+          : null;
+
+  /// 记录 [engine] 的校准结果 (CPU 核数变化时丢弃其他引擎的旧值)
+  ThreadCalibration withResult(EngineType engine, int value, {int? cores}) {
+    final current = cores ?? Platform.numberOfProcessors;
+    return ThreadCalibration(
+      cores: current,
+      threads: {
+        if (this.cores == current) ...threads,
+        engine: value,
+      },
+    );
+  }
+
+  String toJson() => jsonEncode({
+        'cores': cores,
+        for (final entry in threads.entries) entry.key.name: entry.value,
+      });
+
+  /// 从 JSON 字符串恢复，格式不符时返回空结果
+  static ThreadCalibration fromJson(String? json) {
+    if (json == null || json.isEmpty) return const ThreadCalibration(cores: 0);
+    try {
+      final map = jsonDecode(json) as Map<String, dynamic>;
+      return ThreadCalibration(
+        cores: map['cores'] as int,
+        threads: {
+          for (final engine in EngineType.values)
+            if (map[engine.name] case final int n when n > 0) engine: n,
+        },
+      );
+    } catch (_) {
+      return const ThreadCalibration(cores: 0);
+    }
+  }
+}
@@ -0,0 +1,216 @@
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:isolate';
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import '../constants/settings_constants.dart';
+import '../utils/process_cpu.dart';
+import '../utils/wav_reader.dart';
+import 'asr/asr_engine.dart';
+import 'asr/sensevoice_engine.dart';
+import 'asr/zipformer_engine.dart';
+import 'model_manager.dart';
+import 'ort_model_cache.dart';
+import 'thread_calibration.dart';
+
+/// 推理线程数校准
+///
+/// 用模型包自带的测试音频 (test_wavs/) 按 1..N 个线程各解码数轮，
+/// 由 [ThreadCalibration.pick] 选出线程数。
+class ThreadCalibrator {
+  ThreadCalibrator._();
+
+  /// 每个线程数的测量轮数 (另有一轮预热)
+  static const int measureRuns = 2;
+
+  /// 模型包自带的测试音频 (不存在时为 null)
+  static String? clipFor(ModelManager modelManager, EngineType engine) {
+    final dir =
+        Directory('${modelManager.getModelPathForEngine(engine)}/test_wavs');
+    if (!dir.existsSync()) return null;
+    final wavs = [
+      for (final entity in dir.listSync())
+        if (entity is File && entity.path.endsWith('.wav')) entity.path,
+    ]..sort();
+    for (final path in wavs) {
+      if (readWav16kMono(path) != null) return path;
+    }
+    return null;
+  }
+
+  /// 校准 [engine] 的推理线程数 (在后台 isolate 中执行，耗时约数秒到数十秒)
+  ///
+  /// 模型或测试音频不可用时返回 null。[threads] 为空时按 CPU 核数取候选值。
+  /// [abortWhen] 完成时 (如开始录音) 在下一个音频块处停止测量并返回 null，
+  /// 测量用的识别器照常释放。
+  static Future<(int, List<ThreadTiming>)?> calibrate(
+    ModelManager modelManager,
+    EngineType engine, {
+    required bool useInt8,
+    String provider = 'cpu',
+    List<int>? threads,
+    Future<void>? abortWhen,
+  }) async {
+    if (!modelManager.isEngineReady(engine)) return null;
+    final clip = clipFor(modelManager, engine);
+    if (clip == null) return null;
+
+    final modelDir = modelManager.getModelPathForEngine(engine);
+    final vadPath = modelManager.vadModelFilePath;
+    final ortCache = OrtModelCache.instance.enabled;
+    final candidates =
+        threads ?? ThreadCalibration.candidates(Platform.numberOfProcessors);
+    // isolate 之间不共享 Dart 对象，中止标志放在原生内存中按地址传递
+    final abort = calloc<Int32>();
+    final abortAddress = abort.address;
+    var finished = false;
+    abortWhen?.then((_) {
+      if (!finished) abort.value = 1;
+    });
+    try {
+      final timings = await Isolate.run(() => _measureInIsolate(
+          engine, modelDir, vadPath, clip, useInt8, provider, ortCache,
+          candidates, abortAddress));
+      if (abort.value != 0 || timings.isEmpty) return null;
+      return (ThreadCalibration.pick(timings), timings);
+    } finally {
+      finished = true;
+      calloc.free(abort);
+    }
+  }
+
+  static Future<List<ThreadTiming>> _measureInIsolate(
+    EngineType engine,
+    String modelDir,
+    String vadPath,
+    String clip,
+    bool useInt8,
+    String provider,
+    bool ortCache,
+    List<int> candidates,
+    int abortAddress,
+  ) async {
+    OrtModelCache.instance.enabled = ortCache;
+    final abort = Pointer<Int32>.fromAddress(abortAddress);
+    final samples = readWav16kMono(clip)!;
+    final timings = <ThreadTiming>[];
+    for (final n in candidates) {
+      final timing = engine == EngineType.zipformer
+          ? await _measureZipformer(
+              modelDir, useInt8, provider, samples, n, abort)
+          : await _measureSenseVoice(
+              modelDir, vadPath, provider, samples, n, abort);
+      if (timing == null) break;
+      timings.add(timing);
+    }
+    return timings;
+  }
+
+  /// 同步解码整段音频 (不等待实时到达)，测量每轮的墙钟与 CPU 耗时
+  static Future<ThreadTiming?> _measureZipformer(
+      String modelDir,
+      bool useInt8,
+      String provider,
+      Float32List samples,
+      int threads,
+      Pointer<Int32> abort) async {
+    final engine = ZipformerEngine(useInferenceWorker: false);
+    final error = await engine.initialize(ZipformerConfig(
+      modelDir: modelDir,
+      useInt8Model: useInt8,
+      numThreads: threads,
+      provider: provider,
+    ));
+    if (error != ASRError.none) return null;
+    try {
+      return _measure(samples, threads, abort, (buffer, n) {
+        engine.acceptWaveform(16000, buffer, n);
+        while (engine.isReady()) {
+          engine.decode();
+        }
+      }, finish: () {
+        engine.inputFinished();
+        while (engine.isReady()) {
+          engine.decode();
+        }
+        engine.reset();
+      });
+    } finally {
+      engine.dispose();
+    }
+  }
+
+  /// 整段音频经 VAD 切分后在单个线程上逐段解码
+  static Future<ThreadTiming?> _measureSenseVoice(
+      String modelDir,
+      String vadPath,
+      String provider,
+      Float32List samples,
+      int threads,
+      Pointer<Int32> abort) async {
+    final engine = SenseVoiceEngine();
+    final error = await engine.initialize(SenseVoiceConfig(
+      modelDir: modelDir,
+      vadModelPath: vadPath,
+      numThreads: threads,
+      provider: provider,
+      partialIntervalMs: 0,
+      segmentThreads: 1,
+      segmentBatchSize: 1,
+    ));
+    if (error != ASRError.none) return null;
+    try {
+      return _measure(samples, threads, abort, (buffer, n) {
+        engine.acceptWaveform(16000, buffer, n);
+      }, finish: () {
+        engine.inputFinished();
+        engine.reset();
+      });
+    } finally {
+      engine.dispose();
+    }
+  }
+
+  /// 已中止时返回 null
+  static ThreadTiming? _measure(
+    Float32List samples,
+    int threads,
+    Pointer<Int32> abort,
+    void Function(Pointer<Float> buffer, int n) feed, {
+    required void Function() finish,
+  }) {
+    const chunk = 1600;
+    final buffer = calloc<Float>(chunk);
+    var wall = const Duration(days: 1);
+    var cpuMs = 1 << 30;
+    try {
+      // 首轮为预热，不计入结果
+      for (var run = 0; run <= measureRuns; run++) {
+        final cpuStart = processCpuMs();
+        final watch = Stopwatch()..start();
+        for (var offset = 0; offset < samples.length; offset += chunk) {
+          if (abort.value != 0) return null;
+          final n = math.min(chunk, samples.length - offset);
+          buffer.asTypedList(n).setAll(0, samples.sublist(offset, offset + n));
+          feed(buffer, n);
+        }
+        finish();
+        watch.stop();
+        if (run == 0) continue;
+        if (watch.elapsed < wall) wall = watch.elapsed;
+        cpuMs = math.min(cpuMs, processCpuMs() - cpuStart);
+      }
+    } finally {
+      calloc.free(buffer);
+    }
+    return ThreadTiming(
+      threads: threads,
+      wall: wall,
+      cpu: Duration(milliseconds: cpuMs),
+      audioSec: samples.length / 16000,
+    );
+  }
+}
@@ -66,6 +66,9 @@ class TrayService {
   /// Story 3-7: 当前托盘状态
   TrayStatus _currentStatus = TrayStatus.normal;
 
+  /// 预录模式下的保留时长 (毫秒)，null 表示麦克风未在后台监听
+  int? _micMonitoringMs;
+
   /// 是否已初始化
   bool get isInitialized => _isInitialized;
 
@@ -75,6 +78,27 @@ class TrayService {
   /// Story 3-7: 当前托盘状态
   TrayStatus get currentStatus => _currentStatus;
 
+  /// 麦克风是否在后台监听 (预录模式)
+  bool get isMicMonitoring => _micMonitoringMs != null;
+
+  /// 更新麦克风后台监听提示 (隐私提示: tooltip + 菜单首行)
+  ///
+  /// [prerollMs] 为 null 表示已停止监听
+  Future<void> setMicMonitoring(int? prerollMs) async {
+    if (_micMonitoringMs == prerollMs) return;
+    _micMonitoringMs = prerollMs;
+    if (!_isInitialized) return;
+
+    try {
+      await _systemTray.setToolTip(prerollMs != null
+          ? LanguageService.instance.tr('tray_mic_monitoring_tooltip')
+          : TrayConstants.appName);
+    } catch (e) {
+      debugPrint('TrayService: 更新 tooltip 失败: $e');
+    }
+    await _buildMenu();
+  }
+
   /// 设置 ModelManager 引用 (由 main.dart 在初始化时调用)
   void setModelManager(ModelManager manager) {
     _modelManager = manager;
@@ -167,6 +191,15 @@ class TrayService {
     final menu = Menu();
     await menu.buildFrom([
       MenuItemLabel(label: TrayConstants.appName, enabled: false),
+      // 预录模式隐私提示: 麦克风在胶囊隐藏时仍保持打开
+      if (_micMonitoringMs != null)
+        MenuItemLabel(
+          label: lang.trWithParams(
+            'tray_mic_monitoring',
+            {'ms': '$_micMonitoringMs'},
+          ),
+          enabled: false,
+        ),
       MenuSeparator(),
       MenuItemLabel(
         label: lang.tr('tray_show_hide'),
@@ -100,11 +100,12 @@ class _RippleEffectState extends State<RippleEffect>
               widget.rippleCount,
             );
 
-            // 计算 scale 和 opacity
+            // 计算 scale 和 opacity，说话时波纹扩散得更远
+            final endScale = AnimationConstants.rippleEndScale +
+                AnimationConstants.rippleVoiceScaleBoost *
+                    AnimationTickerService.instance.voiceLevel;
             final scale = AnimationConstants.rippleStartScale +
-                (AnimationConstants.rippleEndScale -
-                        AnimationConstants.rippleStartScale) *
-                    value;
+                (endScale - AnimationConstants.rippleStartScale) * value;
             final opacity = AnimationConstants.rippleStartOpacity +
                 (AnimationConstants.rippleEndOpacity -
                         AnimationConstants.rippleStartOpacity) *
@@ -33,6 +33,18 @@ class DiagnosticLogger {
   /// 是否已初始化
   bool get isInitialized => _isInitialized;
 
+  /// 音频采集状态提供者 (导出报告时调用，获取当前后端与延迟协商结果)
+  String Function()? audioStatusProvider;
+
+  /// 端点检测状态提供者 (静音阈值、句内停顿统计与提交延迟)
+  String Function()? endpointStatusProvider;
+
+  /// 模型内存驻留状态提供者 (是否已空闲卸载、重新加载耗时与当前 RSS)
+  String Function()? memoryStatusProvider;
+
+  /// 推理后端状态提供者 (CPU 特性，自动或指定的模型版本、执行提供者与线程数)
+  String Function()? inferenceStatusProvider;
+
   /// 初始化日志系统 (创建目录)
   Future<void> initialize() async {
     if (_isInitialized) return;
@@ -128,7 +140,39 @@ class DiagnosticLogger {
       buffer.writeln();
     }
 
-    // 3. 最近日志 (最后 50 行)
+    // 2.1 推理后端
+    final inferenceStatus = inferenceStatusProvider?.call();
+    if (inferenceStatus != null) {
+      buffer.writeln('=== 推理后端 ===');
+      buffer.writeln(inferenceStatus);
+      buffer.writeln();
+    }
+
+    // 3. 音频采集状态
+    final audioStatus = audioStatusProvider?.call();
+    if (audioStatus != null) {
+      buffer.writeln('=== 音频采集 ===');
+      buffer.writeln(audioStatus);
+      buffer.writeln();
+    }
+
+    // 4. 端点检测
+    final endpointStatus = endpointStatusProvider?.call();
+    if (endpointStatus != null) {
+      buffer.writeln('=== 端点检测 ===');
+      buffer.writeln(endpointStatus);
+      buffer.writeln();
+    }
+
+    // 5. 模型内存驻留
+    final memoryStatus = memoryStatusProvider?.call();
+    if (memoryStatus != null) {
+      buffer.writeln('=== 内存 ===');
+      buffer.writeln(memoryStatus);
+      buffer.writeln();
+    }
+
+    // 6. 最近日志 (最后 50 行)
     buffer.writeln('=== 最近日志 ===');
     final logFile = File(logPath);
     if (logFile.existsSync()) {
@@ -0,0 +1,17 @@
+import 'dart:io';
+
+/// Linux 时钟节拍 (USER_HZ)，/proc/self/stat 中 CPU 时间的单位
+const int _clockTicksPerSec = 100;
+
+/// 本进程累计 CPU 时间 (毫秒，含 onnxruntime 工作线程)，读取失败时为 0
+int processCpuMs() {
+  try {
+    final stat = File('/proc/self/stat').readAsStringSync();
+    // 第 2 字段 (comm) 可能含空格，从右括号之后开始解析
+    final fields = stat.substring(stat.lastIndexOf(')') + 2).split(' ');
+    final ticks = int.parse(fields[11]) + int.parse(fields[12]);
+    return ticks * 1000 ~/ _clockTicksPerSec;
+  } catch (_) {
+    return 0;
+  }
+}
@@ -0,0 +1,40 @@
+import 'dart:io';
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+/// 读取 16kHz 单声道 16-bit PCM WAV，格式不符时返回 null
+Float32List? readWav16kMono(String path) {
+  final file = File(path);
+  if (!file.existsSync()) return null;
+  final bytes = file.readAsBytesSync();
+  if (bytes.length < 12) return null;
+  final data = ByteData.sublistView(bytes);
+  if (String.fromCharCodes(bytes, 0, 4) != 'RIFF' ||
+      String.fromCharCodes(bytes, 8, 12) != 'WAVE') {
+    return null;
+  }
+
+  var pos = 12;
+  var formatOk = false;
+  while (pos + 8 <= bytes.length) {
+    final id = String.fromCharCodes(bytes, pos, pos + 4);
+    final size = data.getUint32(pos + 4, Endian.little);
+    final body = pos + 8;
+    if (id == 'fmt ') {
+      formatOk = data.getUint16(body, Endian.little) == 1 &&
+          data.getUint16(body + 2, Endian.little) == 1 &&
+          data.getUint32(body + 4, Endian.little) == 16000 &&
+          data.getUint16(body + 14, Endian.little) == 16;
+    } else if (id == 'data') {
+      if (!formatOk) return null;
+      final count = math.min(size, bytes.length - body) ~/ 2;
+      final out = Float32List(count);
+      for (var i = 0; i < count; i++) {
+        out[i] = data.getInt16(body + i * 2, Endian.little) / 32768.0;
+      }
+      return out;
+    }
+    pos = body + size + (size & 1);
+  }
+  return null;
+}
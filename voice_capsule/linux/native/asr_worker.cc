@@ -0,0 +1,312 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 流式识别工作线程
+ *
+ * Dart 侧每块音频只做一次入队拷贝；工作线程按到达顺序执行音频/重置/结束
+ * 命令，连续的音频块合并后再解码。解码结果交给 ResultTracker 按 token 比较
+ * 发布。每条命令带有入队时的 epoch，reset 递增 epoch，旧 epoch 的解码结果
+ * 不再发布，保证 reset 之后读到的结果不含旧音频。
+ * libsherpa-onnx-c-api 已由 Dart 侧加载，这里按同名 dlopen 取得同一实例。
+ */
+
+#include "dynlib.h"
+#include "nextalk_asr.h"
+#include "result_tracker.h"
+
+#include <pthread.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// sherpa-onnx C API 中用到的部分 (对象均为不透明指针)
+struct SherpaOnlineRecognizer;
+struct SherpaOnlineStream;
+
+// 与 sherpa-onnx c-api.h 中 SherpaOnnxOnlineRecognizerResult 布局一致
+struct SherpaOnlineResult {
+    const char *text;
+    const char *tokens;
+    const char *const *tokensArr;
+    float *timestamps;
+    int32_t count;
+    const char *json;
+};
+
+struct SherpaApi {
+    nextalk::DynLib lib{"libsherpa-onnx-c-api.so"};
+    void (*acceptWaveform)(const SherpaOnlineStream *, int32_t, const float *,
+                           int32_t) = nullptr;
+    int32_t (*isReady)(const SherpaOnlineRecognizer *,
+                       const SherpaOnlineStream *) = nullptr;
+    void (*decode)(const SherpaOnlineRecognizer *,
+                   const SherpaOnlineStream *) = nullptr;
+    const SherpaOnlineResult *(*result)(const SherpaOnlineRecognizer *,
+                                        const SherpaOnlineStream *) = nullptr;
+    void (*destroyResult)(const SherpaOnlineResult *) = nullptr;
+    void (*reset)(const SherpaOnlineRecognizer *,
+                  const SherpaOnlineStream *) = nullptr;
+    int32_t (*isEndpoint)(const SherpaOnlineRecognizer *,
+                          const SherpaOnlineStream *) = nullptr;
+    void (*inputFinished)(const SherpaOnlineStream *) = nullptr;
+
+    bool load() {
+        return lib.bind(acceptWaveform, "SherpaOnnxOnlineStreamAcceptWaveform") &&
+               lib.bind(isReady, "SherpaOnnxIsOnlineStreamReady") &&
+               lib.bind(decode, "SherpaOnnxDecodeOnlineStream") &&
+               lib.bind(result, "SherpaOnnxGetOnlineStreamResult") &&
+               lib.bind(destroyResult, "SherpaOnnxDestroyOnlineRecognizerResult") &&
+               lib.bind(reset, "SherpaOnnxOnlineStreamReset") &&
+               lib.bind(isEndpoint, "SherpaOnnxOnlineStreamIsEndpoint") &&
+               lib.bind(inputFinished, "SherpaOnnxOnlineStreamInputFinished");
+    }
+};
+
+// 进程内只加载一次 (与 Dart 侧共享同一个库实例)
+const SherpaApi *sherpaApi() {
+    static SherpaApi *api = [] {
+        auto *loaded = new SherpaApi();
+        if (!loaded->load()) {
+            delete loaded;
+            return static_cast<SherpaApi *>(nullptr);
+        }
+        return loaded;
+    }();
+    return api;
+}
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+struct NextalkAsrWorker {
+    enum class Op { Audio, Reset, Finish };
+
+    struct Command {
+        Op op;
+        uint64_t epoch;
+        uint64_t ticket;
+        std::vector<float> samples;
+    };
+
+    NextalkAsrWorker(const SherpaApi &sherpa, void *rec, void *str,
+                     int32_t rate)
+        : api(sherpa), recognizer(static_cast<SherpaOnlineRecognizer *>(rec)),
+          stream(static_cast<SherpaOnlineStream *>(str)), sampleRate(rate) {}
+
+    const SherpaApi &api;
+    SherpaOnlineRecognizer *recognizer;
+    SherpaOnlineStream *stream;
+    int32_t sampleRate;
+
+    std::thread thread;
+
+    // 命令队列 (queueMutex 保护)
+    std::mutex queueMutex;
+    std::condition_variable queueCv;   // 有新命令
+    std::condition_variable drainedCv; // 有命令执行完毕
+    std::deque<Command> queue;
+    uint64_t nextTicket = 1;
+    uint64_t doneTicket = 0;
+    bool stopping = false;
+
+    nextalk::ResultTracker tracker;
+
+    std::atomic<int64_t> decodeNs{0};
+    std::atomic<int64_t> decodedFrames{0};
+
+    // 入队并返回命令序号
+    uint64_t enqueue(Command &&cmd) {
+        uint64_t ticket;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            ticket = cmd.ticket = nextTicket++;
+            queue.push_back(std::move(cmd));
+        }
+        queueCv.notify_one();
+        return ticket;
+    }
+
+    void run() {
+        pthread_setname_np(pthread_self(), "nextalk-asr");
+        std::unique_lock<std::mutex> lock(queueMutex);
+        for (;;) {
+            queueCv.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            Command cmd = std::move(queue.front());
+            queue.pop_front();
+            // 后面紧跟音频时先不解码，合并到最后一块再解码
+            const bool moreAudio =
+                !queue.empty() && queue.front().op == Op::Audio;
+            lock.unlock();
+
+            execute(cmd, moreAudio);
+
+            lock.lock();
+            doneTicket = cmd.ticket;
+            drainedCv.notify_all();
+        }
+    }
+
+    void execute(const Command &cmd, bool moreAudio) {
+        switch (cmd.op) {
+        case Op::Audio:
+            api.acceptWaveform(stream, sampleRate, cmd.samples.data(),
+                               static_cast<int32_t>(cmd.samples.size()));
+            decodedFrames.fetch_add(static_cast<int64_t>(cmd.samples.size()),
+                                    std::memory_order_relaxed);
+            if (!moreAudio) {
+                decodeAndPublish(cmd.epoch);
+            }
+            break;
+        case Op::Reset:
+            api.reset(recognizer, stream);
+            break;
+        case Op::Finish:
+            api.inputFinished(stream);
+            decodeAndPublish(cmd.epoch);
+            break;
+        }
+    }
+
+    void decodeAndPublish(uint64_t cmdEpoch) {
+        const int64_t start = nowNs();
+        while (api.isReady(recognizer, stream) == 1) {
+            api.decode(recognizer, stream);
+        }
+        decodeNs.fetch_add(nowNs() - start, std::memory_order_relaxed);
+        // 只有工作线程写入，此刻的值即本次解码覆盖到的样本数
+        const int64_t samples = decodedFrames.load(std::memory_order_relaxed);
+
+        const bool isEndpoint = api.isEndpoint(recognizer, stream) == 1;
+        const SherpaOnlineResult *r = api.result(recognizer, stream);
+        if (!r) {
+            tracker.offer(cmdEpoch, isEndpoint, "", nullptr, nullptr, 0,
+                          samples);
+            return;
+        }
+        tracker.offer(cmdEpoch, isEndpoint, r->text, r->tokensArr,
+                      r->timestamps, r->tokensArr ? r->count : 0, samples);
+        api.destroyResult(r);
+    }
+
+    void join() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+            queue.clear();
+        }
+        queueCv.notify_all();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+};
+
+NEXTALK_EXPORT NextalkAsrWorker *nextalk_asr_worker_create(void *recognizer,
+                                                           void *stream,
+                                                           int32_t sample_rate) {
+    if (!recognizer || !stream || sample_rate <= 0) {
+        return nullptr;
+    }
+    const SherpaApi *api = sherpaApi();
+    if (!api) {
+        return nullptr;
+    }
+    auto *worker = new NextalkAsrWorker(*api, recognizer, stream, sample_rate);
+    worker->thread = std::thread([worker] { worker->run(); });
+    return worker;
+}
+
+NEXTALK_EXPORT int32_t nextalk_asr_worker_accept(NextalkAsrWorker *worker,
+                                                 const float *samples,
+                                                 int32_t n) {
+    if (!worker || !samples || n < 0) {
+        return NEXTALK_ASR_ERR_STATE;
+    }
+    if (n == 0) {
+        return NEXTALK_ASR_OK;
+    }
+    NextalkAsrWorker::Command cmd{NextalkAsrWorker::Op::Audio,
+                                  worker->tracker.epoch(), 0,
+                                  std::vector<float>(samples, samples + n)};
+    worker->enqueue(std::move(cmd));
+    return NEXTALK_ASR_OK;
+}
+
+NEXTALK_EXPORT void nextalk_asr_worker_reset(NextalkAsrWorker *worker) {
+    if (!worker) {
+        return;
+    }
+    const uint64_t newEpoch = worker->tracker.reset();
+    worker->enqueue({NextalkAsrWorker::Op::Reset, newEpoch, 0, {}});
+}
+
+NEXTALK_EXPORT int32_t nextalk_asr_worker_finish(NextalkAsrWorker *worker,
+                                                 int32_t timeout_ms) {
+    if (!worker) {
+        return 0;
+    }
+    const uint64_t ticket = worker->enqueue(
+        {NextalkAsrWorker::Op::Finish, worker->tracker.epoch(), 0, {}});
+
+    std::unique_lock<std::mutex> lock(worker->queueMutex);
+    const bool done = worker->drainedCv.wait_for(
+        lock, std::chrono::milliseconds(timeout_ms),
+        [worker, ticket] { return worker->doneTicket >= ticket; });
+    return done ? 1 : 0;
+}
+
+NEXTALK_EXPORT int32_t nextalk_asr_worker_drained(NextalkAsrWorker *worker) {
+    if (!worker) {
+        return 1;
+    }
+    std::lock_guard<std::mutex> lock(worker->queueMutex);
+    return worker->doneTicket + 1 >= worker->nextTicket ? 1 : 0;
+}
+
+NEXTALK_EXPORT int64_t nextalk_asr_worker_generation(NextalkAsrWorker *worker) {
+    return worker ? worker->tracker.generation() : 0;
+}
+
+NEXTALK_EXPORT int32_t nextalk_asr_worker_take_update(NextalkAsrWorker *worker,
+                                                      NextalkAsrUpdate *out) {
+    if (!worker || !out) {
+        return 0;
+    }
+    return worker->tracker.take(out) ? 1 : 0;
+}
+
+NEXTALK_EXPORT int32_t nextalk_asr_worker_is_endpoint(NextalkAsrWorker *worker) {
+    return worker && worker->tracker.endpoint() ? 1 : 0;
+}
+
+NEXTALK_EXPORT int64_t nextalk_asr_worker_decode_ns(NextalkAsrWorker *worker) {
+    return worker ? worker->decodeNs.load(std::memory_order_relaxed) : 0;
+}
+
+NEXTALK_EXPORT int64_t nextalk_asr_worker_decoded_frames(NextalkAsrWorker *worker) {
+    return worker ? worker->decodedFrames.load(std::memory_order_relaxed) : 0;
+}
+
+NEXTALK_EXPORT void nextalk_asr_worker_destroy(NextalkAsrWorker *worker) {
+    if (!worker) {
+        return;
+    }
+    worker->join();
+    delete worker;
+}
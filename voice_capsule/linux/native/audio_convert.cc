@@ -0,0 +1,355 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 采样格式转换与多相 FIR 重采样
+ */
+
+#include "audio_convert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NEXTALK_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define NEXTALK_NEON 1
+#endif
+
+namespace nextalk {
+
+namespace {
+
+// 通带上限相对输出奈奎斯特频率的比例 (16kHz 输出时约 7kHz)
+constexpr double kPassbandRatio = 0.875;
+// Kaiser 窗参数 (约 -60dB 阻带)
+constexpr double kKaiserBeta = 6.0;
+
+std::atomic<bool> gSimdEnabled{true};
+
+// ---------- 点积内核 ----------
+
+float dotScalar(const float *a, const float *b, int n) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void int16ToFloatScalar(const int16_t *src, float *dst, size_t n) {
+    constexpr float kScale = 1.0f / 32768.0f;
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = static_cast<float>(src[i]) * kScale;
+    }
+}
+
+#if defined(NEXTALK_X86)
+
+__attribute__((target("avx2,fma"))) float dotAvx2(const float *a, const float *b, int n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    const __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_hadd_ps(sum, sum);
+    sum = _mm_hadd_ps(sum, sum);
+    float result = _mm_cvtss_f32(sum);
+    for (; i < n; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+__attribute__((target("avx2"))) void int16ToFloatAvx2(const int16_t *src, float *dst, size_t n) {
+    const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i s16 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(s16));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(f, scale));
+    }
+    int16ToFloatScalar(src + i, dst + i, n - i);
+}
+
+bool cpuHasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+}
+
+#elif defined(NEXTALK_NEON)
+
+float dotNeon(const float *a, const float *b, int n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float result = vaddvq_f32(vaddq_f32(acc0, acc1));
+    for (; i < n; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+void int16ToFloatNeon(const int16_t *src, float *dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t s16 = vld1q_s16(src + i);
+        vst1q_f32(dst + i, vcvtq_n_f32_s32(vmovl_s16(vget_low_s16(s16)), 15));
+        vst1q_f32(dst + i + 4, vcvtq_n_f32_s32(vmovl_s16(vget_high_s16(s16)), 15));
+    }
+    int16ToFloatScalar(src + i, dst + i, n - i);
+}
+
+#endif
+
+float dot(const float *a, const float *b, int n) {
+    switch (activeSimdLevel()) {
+#if defined(NEXTALK_X86)
+    case SimdLevel::Avx2:
+        return dotAvx2(a, b, n);
+#elif defined(NEXTALK_NEON)
+    case SimdLevel::Neon:
+        return dotNeon(a, b, n);
+#endif
+    default:
+        return dotScalar(a, b, n);
+    }
+}
+
+void int16ToFloat(const int16_t *src, float *dst, size_t n) {
+    switch (activeSimdLevel()) {
+#if defined(NEXTALK_X86)
+    case SimdLevel::Avx2:
+        int16ToFloatAvx2(src, dst, n);
+        break;
+#elif defined(NEXTALK_NEON)
+    case SimdLevel::Neon:
+        int16ToFloatNeon(src, dst, n);
+        break;
+#endif
+    default:
+        int16ToFloatScalar(src, dst, n);
+        break;
+    }
+}
+
+// 第一类零阶修正贝塞尔函数 (Kaiser 窗)
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+void setSimdEnabled(bool enabled) {
+    gSimdEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+SimdLevel activeSimdLevel() {
+    if (gSimdEnabled.load(std::memory_order_relaxed)) {
+#if defined(NEXTALK_X86)
+        if (cpuHasAvx2()) {
+            return SimdLevel::Avx2;
+        }
+#elif defined(NEXTALK_NEON)
+        return SimdLevel::Neon;
+#endif
+    }
+    return SimdLevel::Scalar;
+}
+
+const char *simdKernelName() {
+    switch (activeSimdLevel()) {
+    case SimdLevel::Avx2:
+        return "avx2";
+    case SimdLevel::Neon:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
+
+size_t DeviceFormat::bytesPerFrame() const {
+    const size_t sampleBytes = sampleFormat == SampleFormat::Int16 ? 2 : 4;
+    return sampleBytes * static_cast<size_t>(channels);
+}
+
+// ---------- PolyphaseResampler ----------
+
+bool PolyphaseResampler::configure(int32_t inRate, int32_t outRate) {
+    if (inRate <= 0 || outRate <= 0) {
+        return false;
+    }
+    const int32_t g = std::gcd(inRate, outRate);
+    interp_ = outRate / g;
+    decim_ = inRate / g;
+    if (interp_ > kMaxInterpolation) {
+        return false;
+    }
+
+    bank_.clear();
+    const int ratio = (decim_ + interp_ - 1) / interp_;
+    taps_ = kTapsPerPhase * std::max(1, (ratio + 2) / 3);
+    if (!passthrough()) {
+        // 原型低通滤波器长度 L*T，截止频率取插值后采样率下输入/输出奈奎斯特的较小者
+        const int length = interp_ * taps_;
+        const double cutoff = 0.5 / std::max(interp_, decim_) * kPassbandRatio;
+        const double center = (length - 1) / 2.0;
+        const double norm = besselI0(kKaiserBeta);
+        std::vector<double> prototype(static_cast<size_t>(length));
+        for (int i = 0; i < length; ++i) {
+            const double t = i - center;
+            const double sinc =
+                t == 0.0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+            const double r = t / center;
+            const double window = besselI0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+            // 插值补零后能量下降 L 倍，乘 L 恢复增益
+            prototype[static_cast<size_t>(i)] = sinc * window * interp_;
+        }
+
+        // 第 p 相系数 h[k*L + p]，按 k 倒序存放: y = dot(bank_p, x[i-T+1 .. i])
+        bank_.resize(static_cast<size_t>(length));
+        for (int p = 0; p < interp_; ++p) {
+            float *dst = bank_.data() + static_cast<size_t>(p) * taps_;
+            for (int k = 0; k < taps_; ++k) {
+                dst[taps_ - 1 - k] =
+                    static_cast<float>(prototype[static_cast<size_t>(k * interp_ + p)]);
+            }
+        }
+    }
+    reset();
+    return true;
+}
+
+void PolyphaseResampler::reset() {
+    history_.assign(taps_ - 1, 0.0f);
+    index_ = taps_ - 1;
+    phase_ = 0;
+}
+
+size_t PolyphaseResampler::process(const float *in, size_t n, std::vector<float> &out) {
+    if (passthrough()) {
+        out.insert(out.end(), in, in + n);
+        return n;
+    }
+
+    history_.insert(history_.end(), in, in + n);
+    const size_t before = out.size();
+    while (index_ < history_.size()) {
+        const float *coeffs = bank_.data() + static_cast<size_t>(phase_) * taps_;
+        out.push_back(dot(coeffs, history_.data() + index_ + 1 - taps_, taps_));
+        phase_ += decim_;
+        index_ += static_cast<size_t>(phase_ / interp_);
+        phase_ %= interp_;
+    }
+
+    // 只保留下一次输出所需的 T-1 个历史样本
+    const size_t keep = taps_ - 1;
+    const size_t consumed = std::min(index_ - keep, history_.size() - keep);
+    history_.erase(history_.begin(), history_.begin() + static_cast<std::ptrdiff_t>(consumed));
+    index_ -= consumed;
+    return out.size() - before;
+}
+
+// ---------- FormatConverter ----------
+
+bool FormatConverter::configure(const DeviceFormat &in, int32_t outRate) {
+    if (in.channels <= 0) {
+        return false;
+    }
+    in_ = in;
+    outRate_ = outRate;
+    return resampler_.configure(in.sampleRate, outRate);
+}
+
+bool FormatConverter::passthrough() const {
+    return in_.sampleFormat == SampleFormat::Float32 && in_.channels == 1 &&
+           resampler_.passthrough();
+}
+
+int32_t FormatConverter::inputFramesFor(int32_t maxOutFrames) const {
+    // 重采样器的相位余量最多多产生 1 个输出样本
+    const int64_t frames =
+        static_cast<int64_t>(std::max(0, maxOutFrames - 1)) * in_.sampleRate / outRate_;
+    return static_cast<int32_t>(std::max<int64_t>(1, frames));
+}
+
+int64_t FormatConverter::delayNs() const {
+    if (resampler_.passthrough()) {
+        return 0;
+    }
+    return static_cast<int64_t>(resampler_.delayInputSamples() * 1e9 / in_.sampleRate);
+}
+
+size_t FormatConverter::process(const void *data, int32_t frames, std::vector<float> &out) {
+    out.clear();
+    if (frames <= 0) {
+        return 0;
+    }
+    const size_t n = static_cast<size_t>(frames);
+    const size_t channels = static_cast<size_t>(in_.channels);
+    const size_t samples = n * channels;
+
+    // 1. 转为 float (交错)
+    const float *interleaved = nullptr;
+    if (in_.sampleFormat == SampleFormat::Float32) {
+        interleaved = static_cast<const float *>(data);
+    } else {
+        mono_.resize(samples);
+        if (in_.sampleFormat == SampleFormat::Int16) {
+            int16ToFloat(static_cast<const int16_t *>(data), mono_.data(), samples);
+        } else {
+            constexpr float kScale = 1.0f / 2147483648.0f;
+            const int32_t *src = static_cast<const int32_t *>(data);
+            for (size_t i = 0; i < samples; ++i) {
+                mono_[i] = static_cast<float>(src[i]) * kScale;
+            }
+        }
+        interleaved = mono_.data();
+    }
+
+    // 2. 多声道取平均混为单声道 (原地写回 mono_ 的前 n 个元素)
+    const float *mono = interleaved;
+    if (channels > 1) {
+        mono_.resize(std::max(mono_.size(), n));
+        const float gain = 1.0f / static_cast<float>(channels);
+        for (size_t i = 0; i < n; ++i) {
+            const float *frame = interleaved + i * channels;
+            float sum = 0.0f;
+            for (size_t c = 0; c < channels; ++c) {
+                sum += frame[c];
+            }
+            mono_[i] = sum * gain;
+        }
+        mono = mono_.data();
+    }
+
+    // 3. 重采样
+    return resampler_.process(mono, n, out);
+}
+
+} // namespace nextalk
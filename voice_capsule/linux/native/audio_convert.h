@@ -0,0 +1,115 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 采样格式转换与重采样
+ *
+ * 让采集后端以设备原生格式/采样率打开 (如 48kHz 立体声 int16)，
+ * 在本进程内完成 int16/int32/float → float、多声道混音为单声道，
+ * 以及多相 FIR 重采样到识别所需的 16kHz，不再依赖音频服务器的重采样质量与设置。
+ * 热点 (FIR 点积、int16 转换) 提供 AVX2/NEON 实现，运行时按 CPU 能力选择。
+ */
+
+#ifndef _NEXTALK_NATIVE_AUDIO_CONVERT_H_
+#define _NEXTALK_NATIVE_AUDIO_CONVERT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nextalk {
+
+enum class SampleFormat {
+    Float32,
+    Int16,
+    Int32,
+};
+
+// 设备侧数据格式 (交错存储)
+struct DeviceFormat {
+    SampleFormat sampleFormat = SampleFormat::Float32;
+    int32_t sampleRate = 16000;
+    int32_t channels = 1;
+
+    size_t bytesPerFrame() const;
+};
+
+// 关闭 SIMD 内核 (仅供基准测试对比)
+void setSimdEnabled(bool enabled);
+
+// 当前可用的 SIMD 指令集 (运行时检测，其他内核据此分派)
+enum class SimdLevel {
+    Scalar,
+    Avx2,
+    Neon,
+};
+SimdLevel activeSimdLevel();
+
+// 当前使用的内核名称 ("avx2" / "neon" / "scalar")
+const char *simdKernelName();
+
+// 有理数比例多相 FIR 重采样器 (单声道 float)
+// 输入/输出采样率之比约分后为 M/L，先 L 倍插值、低通，再 M 倍抽取
+class PolyphaseResampler {
+public:
+    // 每相抽头数: 决定过渡带宽度，64 抽头时阻带约 -60dB (抽取倍数 ≤ 3)；
+    // 抽取倍数更高 (如 96kHz → 16kHz) 时按比例增加，保持过渡带宽度不变
+    static constexpr int kTapsPerPhase = 64;
+    // 约分后的插值倍数上限 (滤波器组内存 = L * kTapsPerPhase)
+    static constexpr int kMaxInterpolation = 1024;
+
+    PolyphaseResampler() = default;
+
+    // 比例不受支持时返回 false
+    bool configure(int32_t inRate, int32_t outRate);
+
+    // 处理 n 个输入样本，输出追加到 out，返回输出样本数
+    size_t process(const float *in, size_t n, std::vector<float> &out);
+
+    // 清空历史 (重新开始采集时调用)
+    void reset();
+
+    // 滤波器群延迟 (输入样本数)，用于修正采集时间戳
+    double delayInputSamples() const { return (taps_ - 1) / 2.0; }
+
+    bool passthrough() const { return interp_ == 1 && decim_ == 1; }
+
+private:
+    int interp_ = 1; // L
+    int decim_ = 1;  // M
+    int taps_ = kTapsPerPhase;
+    std::vector<float> bank_; // 每相系数按时间倒序连续存放，便于与输入做连续点积
+    std::vector<float> history_;
+    size_t index_ = 0; // 当前输出对应的输入位置 (history_ 下标)
+    int phase_ = 0;
+};
+
+// 设备格式 → 单声道 float @ outRate
+class FormatConverter {
+public:
+    bool configure(const DeviceFormat &in, int32_t outRate);
+
+    // 转换 frames 个设备帧，输出追加到 out (先清空)，返回输出帧数
+    size_t process(const void *data, int32_t frames, std::vector<float> &out);
+
+    void reset() { resampler_.reset(); }
+
+    // 为保证输出不超过 maxOutFrames，单次最多可输入的设备帧数
+    int32_t inputFramesFor(int32_t maxOutFrames) const;
+
+    // 转换引入的延迟 (纳秒)
+    int64_t delayNs() const;
+
+    const DeviceFormat &input() const { return in_; }
+    bool passthrough() const;
+
+private:
+    DeviceFormat in_;
+    int32_t outRate_ = 16000;
+    PolyphaseResampler resampler_;
+    std::vector<float> mono_;
+};
+
+} // namespace nextalk
+
+#endif // _NEXTALK_NATIVE_AUDIO_CONVERT_H_
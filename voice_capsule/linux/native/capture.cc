@@ -0,0 +1,532 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 原生音频采集
+ *
+ * 推送式后端 (libpulse 异步流) 在 mainloop 线程回调中写入 SPSC 环形缓冲区；
+ * 拉取式后端 (PortAudio) 由采集线程以小块 (默认 10ms) 阻塞读取后写入。
+ * Dart 侧只做非阻塞读取。消费者在等待前调用 arm_notify，
+ * 生产者写入后若发现已 arm 则通过回调唤醒，避免固定周期轮询。
+ */
+
+#include "capture_backend.h"
+#include "level_meter.h"
+#include "nextalk_capture.h"
+#include "spsc_ring.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 采集线程 SCHED_FIFO 优先级 (低于 PipeWire/PulseAudio 自身的实时线程)
+constexpr int kRealtimePriority = 10;
+// 无法获得实时调度时的 nice 值
+constexpr int kFallbackNice = -10;
+// 时间戳标记队列容量 (每次写入一个标记，10ms 块时约可缓存 10 秒)
+constexpr size_t kTimeMarkCapacity = 1024;
+// 读取电平快照时与生产者冲突的最大重试次数
+constexpr int kLevelReadRetries = 8;
+
+// RMS 放在高 32 位、峰值放在低 32 位 (按位保存 float)
+uint64_t packLevels(float rms, float peak) {
+    uint32_t r;
+    uint32_t p;
+    std::memcpy(&r, &rms, sizeof r);
+    std::memcpy(&p, &peak, sizeof p);
+    return (static_cast<uint64_t>(r) << 32) | p;
+}
+
+void unpackLevels(uint64_t packed, float &rms, float &peak) {
+    const uint32_t r = static_cast<uint32_t>(packed >> 32);
+    const uint32_t p = static_cast<uint32_t>(packed);
+    std::memcpy(&rms, &r, sizeof rms);
+    std::memcpy(&peak, &p, sizeof peak);
+}
+
+// 尝试提升当前线程为实时优先级，失败时回退到较高 nice 值
+bool promoteCurrentThread() {
+    sched_param param{};
+    param.sched_priority = kRealtimePriority;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0) {
+        return true;
+    }
+    // 普通用户通常没有 CAP_SYS_NICE，按线程 id 调整 nice 值尽力而为
+    const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+    setpriority(PRIO_PROCESS, static_cast<id_t>(tid), kFallbackNice);
+    return false;
+}
+
+} // namespace
+
+struct NextalkCapture : public nextalk::CaptureSink {
+    // 采集时间戳标记: 环形缓冲区中第 frameIndex 帧的采集时刻
+    struct TimeMark {
+        int64_t frameIndex;
+        int64_t timeNs;
+    };
+
+    NextalkCapture(const nextalk::StreamFormat &fmt, size_t ringSamples)
+        : format(fmt), ring(ringSamples),
+          block(static_cast<size_t>(fmt.blockFrames) * fmt.channels),
+          marks(kTimeMarkCapacity) {}
+
+    nextalk::StreamFormat format;
+    nextalk::SpscRing<float> ring;
+    std::vector<float> block;
+
+    // 每次写入附带一个时间戳标记，消费者按帧序号插值出任意位置的采集时刻
+    nextalk::SpscRing<TimeMark> marks;
+    int64_t framesWritten = 0; // 仅生产者线程访问
+    int64_t framesRead = 0;    // 以下仅消费者线程访问
+    TimeMark currentMark{0, -1};
+    TimeMark pendingMark{0, -1};
+    bool hasPendingMark = false;
+    std::unique_ptr<nextalk::CaptureBackend> backend;
+
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<int32_t> lastError{NEXTALK_CAPTURE_OK};
+    std::atomic<int64_t> overruns{0};
+    std::atomic<bool> realtime{false};
+    bool producerPromoted = false; // 仅生产者线程访问
+
+    // 电平计量: 生产者每写入一块更新一次，消费者按序号 (seqlock) 读取一致快照
+    // RMS 与峰值打包为一个 64 位原子值: 重试次数用尽时两者仍来自同一块
+    std::atomic<uint32_t> levelSeq{0};
+    std::atomic<uint64_t> levelRmsPeak{0};
+    std::atomic<float> levelCentroid{0.0f};
+    std::atomic<double> levelEnergy{0.0};
+    std::atomic<int64_t> levelFrames{0};
+    std::atomic<int64_t> levelBlocks{0};
+    float levelPrevSample = 0.0f; // 仅生产者线程访问
+
+    std::atomic<nextalk_notify_fn> notify{nullptr};
+    std::atomic<bool> wantNotify{false};
+    std::atomic<int64_t> notifyAtFrames{1};
+
+    std::mutex errorMutex;
+    std::string errorText;
+
+    void setError(int32_t code, const std::string &text) {
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            errorText = text;
+        }
+        lastError.store(code, std::memory_order_release);
+    }
+
+    int64_t availableFrames() const {
+        return static_cast<int64_t>(ring.size() / format.channels);
+    }
+
+    void wake(int64_t value) {
+        nextalk_notify_fn fn = notify.load(std::memory_order_acquire);
+        if (fn) {
+            fn(value);
+        }
+    }
+
+    // 生产者写入 (拉取式采集线程或推送式后端线程)
+    void onFrames(const float *data, int32_t frames, int64_t captureTimeNs) override {
+        if (!running.load(std::memory_order_acquire)) {
+            return; // 停止后到达的残留数据直接丢弃
+        }
+        if (!producerPromoted) {
+            producerPromoted = true;
+            realtime.store(promoteCurrentThread(), std::memory_order_relaxed);
+        }
+
+        const size_t samples = static_cast<size_t>(frames) * format.channels;
+        if (ring.size() < ring.capacity()) {
+            // 标记先于数据写入，消费者读到数据时对应标记一定可见；
+            // 标记队列满时丢弃即可，消费者沿用上一个标记外推
+            const TimeMark mark{framesWritten, captureTimeNs};
+            marks.write(&mark, 1);
+        }
+        const size_t written = ring.write(data, samples);
+        framesWritten += static_cast<int64_t>(written / format.channels);
+        if (written < samples) {
+            // 消费者跟不上: 丢弃最新数据并计数 (不阻塞生产者)
+            overruns.fetch_add(static_cast<int64_t>(samples - written),
+                               std::memory_order_relaxed);
+        }
+
+        publishLevels(data, frames);
+
+        if (wantNotify.load(std::memory_order_acquire)) {
+            const int64_t available = availableFrames();
+            if (available >= notifyAtFrames.load(std::memory_order_relaxed) &&
+                wantNotify.exchange(false, std::memory_order_acq_rel)) {
+                wake(available);
+            }
+        }
+    }
+
+    // 生产者: 计量本块并发布 (多声道时按交错样本整体计量，质心仅对单声道有意义)
+    void publishLevels(const float *data, int32_t frames) {
+        const size_t samples = static_cast<size_t>(frames) * format.channels;
+        const nextalk::BlockLevels block =
+            nextalk::measureBlock(data, samples, levelPrevSample);
+        if (samples == 0) {
+            return;
+        }
+        const float rms = static_cast<float>(std::sqrt(block.sumSquares / samples));
+        const float centroid = format.channels == 1
+            ? static_cast<float>(nextalk::spectralCentroidHz(block, format.sampleRate))
+            : 0.0f;
+
+        const uint32_t seq = levelSeq.load(std::memory_order_relaxed);
+        levelSeq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        levelRmsPeak.store(packLevels(rms, block.peak), std::memory_order_relaxed);
+        levelCentroid.store(centroid, std::memory_order_relaxed);
+        levelEnergy.store(levelEnergy.load(std::memory_order_relaxed) + block.sumSquares,
+                          std::memory_order_relaxed);
+        levelFrames.fetch_add(frames, std::memory_order_relaxed);
+        levelBlocks.fetch_add(1, std::memory_order_relaxed);
+        levelSeq.store(seq + 2, std::memory_order_release);
+    }
+
+    // 消费者: 读取电平快照，与生产者更新冲突时重试
+    void readLevels(NextalkLevels &out) const {
+        for (int attempt = 0; attempt < kLevelReadRetries; ++attempt) {
+            const uint32_t before = levelSeq.load(std::memory_order_acquire);
+            unpackLevels(levelRmsPeak.load(std::memory_order_relaxed), out.rms, out.peak);
+            out.centroid_hz = levelCentroid.load(std::memory_order_relaxed);
+            out.energy = levelEnergy.load(std::memory_order_relaxed);
+            out.frames = levelFrames.load(std::memory_order_relaxed);
+            out.blocks = levelBlocks.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((before & 1) == 0 && levelSeq.load(std::memory_order_relaxed) == before) {
+                return;
+            }
+        }
+    }
+
+    // running 为 false 时由消费者调用
+    void resetLevels() {
+        levelRmsPeak.store(0, std::memory_order_relaxed);
+        levelCentroid.store(0.0f, std::memory_order_relaxed);
+        levelEnergy.store(0.0, std::memory_order_relaxed);
+        levelFrames.store(0, std::memory_order_relaxed);
+        levelBlocks.store(0, std::memory_order_relaxed);
+        levelPrevSample = 0.0f;
+    }
+
+    void onError(int32_t code, const std::string &text) override {
+        if (!running.exchange(false, std::memory_order_acq_rel)) {
+            return; // 未在采集时的断开由下一次 start 检测
+        }
+        setError(code, text);
+        // 出错时无条件唤醒，让消费者尽快看到错误
+        wake(code);
+    }
+
+    // 拉取式后端的采集线程
+    void run() {
+        pthread_setname_np(pthread_self(), "nextalk-capture");
+        producerPromoted = false;
+
+        while (running.load(std::memory_order_acquire)) {
+            int64_t captureTimeNs = 0;
+            const int32_t frames =
+                backend->read(block.data(), format.blockFrames, captureTimeNs);
+            if (frames < 0) {
+                onError(frames, backend->errorText());
+                return;
+            }
+            if (frames > 0) {
+                onFrames(block.data(), std::min(frames, format.blockFrames), captureTimeNs);
+            }
+        }
+    }
+
+    // 消费者: 第 framesRead 帧的采集时刻，无标记时返回 -1
+    int64_t readPositionTimeNs() {
+        for (;;) {
+            if (!hasPendingMark) {
+                hasPendingMark = marks.read(&pendingMark, 1) == 1;
+            }
+            if (!hasPendingMark || pendingMark.frameIndex > framesRead) {
+                break;
+            }
+            currentMark = pendingMark;
+            hasPendingMark = false;
+        }
+        if (currentMark.timeNs < 0) {
+            return -1;
+        }
+        return currentMark.timeNs +
+               (framesRead - currentMark.frameIndex) * 1000000000LL / format.sampleRate;
+    }
+
+    // 消费者: 在 running 为 false 时重置时间轴 (与 ring.clear 相同的前提)
+    void resetTimeline() {
+        marks.clear();
+        framesWritten = 0;
+        framesRead = 0;
+        currentMark = TimeMark{0, -1};
+        hasPendingMark = false;
+    }
+
+    void join() {
+        running.store(false, std::memory_order_release);
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+};
+
+NEXTALK_EXPORT NextalkCapture *nextalk_capture_create(int32_t sample_rate,
+                                                      int32_t channels,
+                                                      int32_t ring_frames,
+                                                      int32_t block_frames) {
+    if (sample_rate <= 0 || channels <= 0 || ring_frames <= 0 || block_frames <= 0) {
+        return nullptr;
+    }
+    nextalk::StreamFormat format;
+    format.sampleRate = sample_rate;
+    format.channels = channels;
+    format.blockFrames = block_frames;
+    return new NextalkCapture(format, static_cast<size_t>(ring_frames) * channels);
+}
+
+NEXTALK_EXPORT void nextalk_capture_set_device_native(NextalkCapture *capture,
+                                                      int32_t enabled) {
+    if (capture && !capture->backend) {
+        capture->format.deviceNative = enabled != 0;
+    }
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_open_pulse(NextalkCapture *capture,
+                                                  const char *device,
+                                                  int32_t target_latency_ms) {
+    if (!capture || capture->backend) {
+        return NEXTALK_CAPTURE_ERR_STATE;
+    }
+    int32_t error = NEXTALK_CAPTURE_OK;
+    std::string text;
+    capture->backend = nextalk::createPulseStreamBackend(
+        capture->format, device, target_latency_ms, capture, error, text);
+    if (!capture->backend) {
+        capture->setError(error, text);
+    }
+    return error;
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_open_portaudio(
+    NextalkCapture *capture, int32_t device_index, double suggested_latency) {
+    if (!capture || capture->backend) {
+        return NEXTALK_CAPTURE_ERR_STATE;
+    }
+    int32_t error = NEXTALK_CAPTURE_OK;
+    std::string text;
+    capture->backend = nextalk::createPortAudioBackend(
+        capture->format, device_index, suggested_latency, error, text);
+    if (!capture->backend) {
+        capture->setError(error, text);
+    }
+    return error;
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_start(NextalkCapture *capture) {
+    if (!capture || !capture->backend) {
+        return NEXTALK_CAPTURE_ERR_STATE;
+    }
+    if (capture->running.load(std::memory_order_acquire)) {
+        return NEXTALK_CAPTURE_OK;
+    }
+    // 上一次采集因错误退出时线程仍需回收
+    capture->join();
+
+    // running 为 false 时生产者丢弃数据，此时由消费者侧清空是安全的
+    capture->ring.clear();
+    capture->resetTimeline();
+    capture->resetLevels();
+    capture->lastError.store(NEXTALK_CAPTURE_OK, std::memory_order_release);
+
+    const bool pushes = capture->backend->pushesData();
+    if (pushes) {
+        // 推送式后端启动后回调立即开始写入，需先置 running
+        capture->running.store(true, std::memory_order_release);
+    }
+    const int32_t result = capture->backend->start();
+    if (result != NEXTALK_CAPTURE_OK) {
+        capture->running.store(false, std::memory_order_release);
+        capture->setError(result, capture->backend->errorText());
+        return result;
+    }
+
+    if (!pushes) {
+        capture->running.store(true, std::memory_order_release);
+        capture->thread = std::thread([capture] { capture->run(); });
+    }
+    return NEXTALK_CAPTURE_OK;
+}
+
+NEXTALK_EXPORT void nextalk_capture_stop(NextalkCapture *capture) {
+    if (!capture) {
+        return;
+    }
+    capture->join();
+    if (capture->backend) {
+        capture->backend->stop();
+    }
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_read_timestamped(NextalkCapture *capture,
+                                                        float *dst,
+                                                        int32_t max_frames,
+                                                        int64_t *capture_time_ns) {
+    if (!capture || !dst || max_frames < 0) {
+        return NEXTALK_CAPTURE_ERR_STATE;
+    }
+    // 先读取错误状态: 错误发生前写入的数据此时一定可见，
+    // 缓冲区读空后再上报错误，保证已采集的数据不丢失
+    const int32_t error = capture->lastError.load(std::memory_order_acquire);
+    const size_t channels = static_cast<size_t>(capture->format.channels);
+    const size_t samples = capture->ring.read(dst, static_cast<size_t>(max_frames) * channels);
+    if (samples == 0 && error < 0) {
+        return error;
+    }
+    const int32_t frames = static_cast<int32_t>(samples / channels);
+    if (frames > 0) {
+        const int64_t timeNs = capture->readPositionTimeNs();
+        if (capture_time_ns) {
+            *capture_time_ns = timeNs;
+        }
+        capture->framesRead += frames;
+    }
+    return frames;
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_read(NextalkCapture *capture, float *dst,
+                                            int32_t max_frames) {
+    return nextalk_capture_read_timestamped(capture, dst, max_frames, nullptr);
+}
+
+NEXTALK_EXPORT int64_t nextalk_capture_clock_ns(void) {
+    return nextalk::monotonicNowNs();
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_trim(NextalkCapture *capture,
+                                            int32_t keep_frames) {
+    if (!capture || keep_frames < 0) {
+        return 0;
+    }
+    const int64_t available = capture->availableFrames();
+    if (available <= keep_frames) {
+        return 0;
+    }
+    const size_t channels = static_cast<size_t>(capture->format.channels);
+    const size_t skipped =
+        capture->ring.skip(static_cast<size_t>(available - keep_frames) * channels);
+    const int32_t frames = static_cast<int32_t>(skipped / channels);
+    // 丢弃的数据同样推进读位置，保持时间戳标记与帧序号对齐
+    capture->framesRead += frames;
+    return frames;
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_levels(NextalkCapture *capture,
+                                             NextalkLevels *out) {
+    if (!capture || !out) {
+        return NEXTALK_CAPTURE_ERR_STATE;
+    }
+    capture->readLevels(*out);
+    return NEXTALK_CAPTURE_OK;
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_available(NextalkCapture *capture) {
+    return capture ? static_cast<int32_t>(capture->availableFrames()) : 0;
+}
+
+NEXTALK_EXPORT void nextalk_capture_set_notify(NextalkCapture *capture,
+                                               nextalk_notify_fn fn) {
+    if (!capture) {
+        return;
+    }
+    capture->notify.store(fn, std::memory_order_release);
+    if (!fn) {
+        capture->wantNotify.store(false, std::memory_order_release);
+    }
+}
+
+NEXTALK_EXPORT void nextalk_capture_arm_notify(NextalkCapture *capture) {
+    nextalk_capture_arm_notify_at(capture, 1);
+}
+
+NEXTALK_EXPORT void nextalk_capture_arm_notify_at(NextalkCapture *capture,
+                                                  int32_t min_frames) {
+    if (capture) {
+        capture->notifyAtFrames.store(std::max<int64_t>(1, min_frames),
+                                      std::memory_order_relaxed);
+        capture->wantNotify.store(true, std::memory_order_release);
+    }
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_last_error(NextalkCapture *capture) {
+    return capture ? capture->lastError.load(std::memory_order_acquire)
+                   : NEXTALK_CAPTURE_ERR_STATE;
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_error_text(NextalkCapture *capture,
+                                                  char *buf, int32_t buf_len) {
+    if (buf && buf_len > 0) {
+        buf[0] = '\0';
+    }
+    if (!capture) {
+        return 0;
+    }
+    // 在锁内复制: 后端线程随时可能更新错误信息，不能把内部指针交给调用方
+    std::lock_guard<std::mutex> lock(capture->errorMutex);
+    if (buf && buf_len > 0) {
+        std::snprintf(buf, static_cast<size_t>(buf_len), "%s",
+                      capture->errorText.c_str());
+    }
+    return static_cast<int32_t>(capture->errorText.size());
+}
+
+NEXTALK_EXPORT int64_t nextalk_capture_overruns(NextalkCapture *capture) {
+    return capture ? capture->overruns.load(std::memory_order_relaxed) : 0;
+}
+
+NEXTALK_EXPORT int64_t nextalk_capture_granted_latency_us(NextalkCapture *capture) {
+    return capture && capture->backend ? capture->backend->grantedLatencyUsec() : -1;
+}
+
+NEXTALK_EXPORT int64_t nextalk_capture_latency_us(NextalkCapture *capture) {
+    return capture && capture->backend ? capture->backend->latencyUsec() : -1;
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_device_rate(NextalkCapture *capture) {
+    return capture && capture->backend ? capture->backend->deviceSampleRate() : -1;
+}
+
+NEXTALK_EXPORT int32_t nextalk_capture_is_realtime(NextalkCapture *capture) {
+    return capture && capture->realtime.load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+NEXTALK_EXPORT void nextalk_capture_destroy(NextalkCapture *capture) {
+    if (!capture) {
+        return;
+    }
+    capture->notify.store(nullptr, std::memory_order_release);
+    capture->join();
+    capture->backend.reset();
+    delete capture;
+}
@@ -0,0 +1,97 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 音频采集后端接口
+ *
+ * 两类后端:
+ * - 拉取式 (PortAudio 阻塞读取): 由 Capture 的采集线程循环调用 read()
+ * - 推送式 (libpulse 异步流): 后端在自己的线程回调中把数据交给 CaptureSink
+ * 环形缓冲区与唤醒通知统一由 Capture 处理。
+ */
+
+#ifndef _NEXTALK_NATIVE_CAPTURE_BACKEND_H_
+#define _NEXTALK_NATIVE_CAPTURE_BACKEND_H_
+
+#include "nextalk_capture.h"
+
+#include <time.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace nextalk {
+
+struct StreamFormat {
+    int32_t sampleRate = 16000;
+    int32_t channels = 1;
+    int32_t blockFrames = 160; // 采集线程单次读取帧数 (10ms @ 16kHz)
+    // 以设备原生采样率/格式打开，由 FormatConverter 转换 (仅单声道输出时生效)
+    bool deviceNative = false;
+};
+
+// 采集时间戳使用的时钟 (CLOCK_MONOTONIC，纳秒)
+inline int64_t monotonicNowNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// 推送式后端的数据接收方 (在后端线程中调用)
+class CaptureSink {
+public:
+    virtual ~CaptureSink() = default;
+    // captureTimeNs: 本块首帧被麦克风采集的时刻 (monotonicNowNs 时钟)
+    virtual void onFrames(const float *data, int32_t frames, int64_t captureTimeNs) = 0;
+    virtual void onError(int32_t code, const std::string &text) = 0;
+};
+
+class CaptureBackend {
+public:
+    virtual ~CaptureBackend() = default;
+
+    // 启动/停止音频流 (在调用线程执行)
+    virtual int32_t start() = 0;
+    virtual void stop() = 0;
+
+    // 是否为推送式后端 (无需采集线程)
+    virtual bool pushesData() const { return false; }
+
+    // 拉取式后端: 阻塞读取 frames 帧 (在采集线程执行)，返回读取帧数或错误码
+    // captureTimeNs 返回首帧的采集时刻
+    virtual int32_t read(float *dst, int32_t frames, int64_t &captureTimeNs) {
+        (void)dst;
+        (void)frames;
+        (void)captureTimeNs;
+        return NEXTALK_CAPTURE_ERR_STATE;
+    }
+
+    // 音频服务器实际授予的缓冲延迟 (微秒)，未知时返回 -1
+    virtual int64_t grantedLatencyUsec() { return -1; }
+
+    // 实测采集延迟 (微秒)，未知时返回 -1
+    virtual int64_t latencyUsec() { return -1; }
+
+    // 设备侧实际采样率 (由本库重采样时与输出采样率不同)，未知时返回 -1
+    virtual int32_t deviceSampleRate() const { return -1; }
+
+    // 最近一次错误的描述
+    const std::string &errorText() const { return errorText_; }
+
+protected:
+    std::string errorText_;
+};
+
+// 创建后端，失败时返回 nullptr，并通过 error/errorText 返回原因
+std::unique_ptr<CaptureBackend> createPulseStreamBackend(
+    const StreamFormat &format, const char *device, int32_t targetLatencyMs,
+    CaptureSink *sink, int32_t &error, std::string &errorText);
+
+std::unique_ptr<CaptureBackend> createPortAudioBackend(
+    const StreamFormat &format, int32_t deviceIndex, double suggestedLatency,
+    int32_t &error, std::string &errorText);
+
+} // namespace nextalk
+
+#endif // _NEXTALK_NATIVE_CAPTURE_BACKEND_H_
@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 运行时动态库加载辅助
+ *
+ * 与 Dart 侧 DynamicLibrary.open 的回退逻辑保持一致:
+ * 依次尝试多个库名，兼容不同发行版，缺库时不影响整个原生库加载。
+ */
+
+#ifndef _NEXTALK_NATIVE_DYNLIB_H_
+#define _NEXTALK_NATIVE_DYNLIB_H_
+
+#include <dlfcn.h>
+#include <initializer_list>
+
+namespace nextalk {
+
+class DynLib {
+public:
+    DynLib(std::initializer_list<const char *> names) {
+        for (const char *name : names) {
+            handle_ = dlopen(name, RTLD_NOW | RTLD_LOCAL);
+            if (handle_) {
+                break;
+            }
+        }
+    }
+
+    ~DynLib() {
+        if (handle_) {
+            dlclose(handle_);
+        }
+    }
+
+    DynLib(const DynLib &) = delete;
+    DynLib &operator=(const DynLib &) = delete;
+
+    bool loaded() const { return handle_ != nullptr; }
+
+    // 解析符号到函数指针，fn 的类型决定转换目标
+    template <typename Fn>
+    bool bind(Fn &fn, const char *symbol) const {
+        fn = handle_ ? reinterpret_cast<Fn>(dlsym(handle_, symbol)) : nullptr;
+        return fn != nullptr;
+    }
+
+private:
+    void *handle_ = nullptr;
+};
+
+} // namespace nextalk
+
+#endif // _NEXTALK_NATIVE_DYNLIB_H_
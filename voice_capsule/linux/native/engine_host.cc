@@ -0,0 +1,678 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * nextalk_engine_host: 常驻识别宿主进程
+ *
+ * 由客户端 (nextalk_host_connect) 按需启动，在 Unix 域套接字上接受连接，
+ * 每个连接一个会话线程。识别器按模型配置缓存在进程内，应用重启后的新连接
+ * 直接复用，只新建流；没有会话且空闲超过 --idle-timeout 秒后退出。
+ * 音频从客户端的共享内存环读取，解码在会话线程中同步进行，
+ * 连续到达的音频合并后再解码，结果变化时推送完整假设。
+ *
+ * 用法: nextalk_engine_host --socket <path> [--idle-timeout <sec>]
+ */
+
+#include "dynlib.h"
+#include "host_protocol.h"
+#include "nextalk_host.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using nextalk::host::AudioRing;
+using nextalk::host::MsgHeader;
+using nextalk::host::MsgType;
+
+// ===== sherpa-onnx C API 中用到的部分 =====
+
+struct SherpaOnlineRecognizer;
+struct SherpaOnlineStream;
+
+// 以下结构体与 sherpa-onnx c-api.h (v1.12.20) 布局一致，
+// 与 Dart 侧 sherpa_onnx_bindings.dart 中的定义一一对应
+struct SherpaFeatureConfig {
+    int32_t sampleRate;
+    int32_t featureDim;
+};
+
+struct SherpaTransducerConfig {
+    const char *encoder;
+    const char *decoder;
+    const char *joiner;
+};
+
+struct SherpaParaformerConfig {
+    const char *encoder;
+    const char *decoder;
+};
+
+struct SherpaSingleModelConfig {
+    const char *model;
+};
+
+struct SherpaCtcFstDecoderConfig {
+    const char *graph;
+    int32_t maxActive;
+};
+
+struct SherpaHomophoneReplacerConfig {
+    const char *dictDir;
+    const char *lexicon;
+    const char *ruleFsts;
+};
+
+struct SherpaOnlineModelConfig {
+    SherpaTransducerConfig transducer;
+    SherpaParaformerConfig paraformer;
+    SherpaSingleModelConfig zipformer2Ctc;
+    const char *tokens;
+    int32_t numThreads;
+    const char *provider;
+    int32_t debug;
+    const char *modelType;
+    const char *modelingUnit;
+    const char *bpeVocab;
+    const char *tokensBuf;
+    int32_t tokensBufSize;
+    SherpaSingleModelConfig nemoCtc;
+    SherpaSingleModelConfig toneCtc;
+};
+
+struct SherpaOnlineRecognizerConfig {
+    SherpaFeatureConfig feat;
+    SherpaOnlineModelConfig model;
+    const char *decodingMethod;
+    int32_t maxActivePaths;
+    int32_t enableEndpoint;
+    float rule1MinTrailingSilence;
+    float rule2MinTrailingSilence;
+    float rule3MinUtteranceLength;
+    const char *hotwordsFile;
+    float hotwordsScore;
+    SherpaCtcFstDecoderConfig ctcFstDecoderConfig;
+    const char *ruleFsts;
+    const char *ruleFars;
+    float blankPenalty;
+    const char *hotwordsBuf;
+    int32_t hotwordsBufSize;
+    SherpaHomophoneReplacerConfig hr;
+};
+
+// 与 SherpaOnnxOnlineRecognizerResult 布局一致
+struct SherpaOnlineResult {
+    const char *text;
+    const char *tokens;
+    const char *const *tokensArr;
+    float *timestamps;
+    int32_t count;
+    const char *json;
+};
+
+struct SherpaApi {
+    nextalk::DynLib lib{"libsherpa-onnx-c-api.so"};
+    const SherpaOnlineRecognizer *(*createRecognizer)(
+        const SherpaOnlineRecognizerConfig *) = nullptr;
+    void (*destroyRecognizer)(const SherpaOnlineRecognizer *) = nullptr;
+    const SherpaOnlineStream *(*createStream)(
+        const SherpaOnlineRecognizer *) = nullptr;
+    void (*destroyStream)(const SherpaOnlineStream *) = nullptr;
+    void (*acceptWaveform)(const SherpaOnlineStream *, int32_t, const float *,
+                           int32_t) = nullptr;
+    int32_t (*isReady)(const SherpaOnlineRecognizer *,
+                       const SherpaOnlineStream *) = nullptr;
+    void (*decode)(const SherpaOnlineRecognizer *,
+                   const SherpaOnlineStream *) = nullptr;
+    const SherpaOnlineResult *(*result)(const SherpaOnlineRecognizer *,
+                                        const SherpaOnlineStream *) = nullptr;
+    void (*destroyResult)(const SherpaOnlineResult *) = nullptr;
+    void (*reset)(const SherpaOnlineRecognizer *,
+                  const SherpaOnlineStream *) = nullptr;
+    int32_t (*isEndpoint)(const SherpaOnlineRecognizer *,
+                          const SherpaOnlineStream *) = nullptr;
+    void (*inputFinished)(const SherpaOnlineStream *) = nullptr;
+
+    bool load() {
+        return lib.bind(createRecognizer, "SherpaOnnxCreateOnlineRecognizer") &&
+               lib.bind(destroyRecognizer, "SherpaOnnxDestroyOnlineRecognizer") &&
+               lib.bind(createStream, "SherpaOnnxCreateOnlineStream") &&
+               lib.bind(destroyStream, "SherpaOnnxDestroyOnlineStream") &&
+               lib.bind(acceptWaveform, "SherpaOnnxOnlineStreamAcceptWaveform") &&
+               lib.bind(isReady, "SherpaOnnxIsOnlineStreamReady") &&
+               lib.bind(decode, "SherpaOnnxDecodeOnlineStream") &&
+               lib.bind(result, "SherpaOnnxGetOnlineStreamResult") &&
+               lib.bind(destroyResult, "SherpaOnnxDestroyOnlineRecognizerResult") &&
+               lib.bind(reset, "SherpaOnnxOnlineStreamReset") &&
+               lib.bind(isEndpoint, "SherpaOnnxOnlineStreamIsEndpoint") &&
+               lib.bind(inputFinished, "SherpaOnnxOnlineStreamInputFinished");
+    }
+};
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// ===== 识别器配置 (客户端以 key=value 行发送) =====
+
+struct RecognizerConfig {
+    std::map<std::string, std::string> values;
+
+    explicit RecognizerConfig(const std::string &text) {
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+            const std::string line = text.substr(pos, end - pos);
+            const size_t eq = line.find('=');
+            if (eq != std::string::npos) {
+                values[line.substr(0, eq)] = line.substr(eq + 1);
+            }
+            pos = end + 1;
+        }
+    }
+
+    const char *str(const char *key) const {
+        auto it = values.find(key);
+        return it != values.end() ? it->second.c_str() : "";
+    }
+
+    int32_t i32(const char *key, int32_t fallback) const {
+        auto it = values.find(key);
+        return it != values.end() ? std::atoi(it->second.c_str()) : fallback;
+    }
+
+    float f32(const char *key, float fallback) const {
+        auto it = values.find(key);
+        return it != values.end() ? std::strtof(it->second.c_str(), nullptr)
+                                  : fallback;
+    }
+
+    // 决定能否复用识别器的字段
+    // 端点规则在创建识别器时固定 (流不能单独设置)，同样计入
+    std::string modelKey() const {
+        std::string key;
+        for (const char *k : {"encoder", "decoder", "joiner", "tokens",
+                              "num_threads", "provider", "decoding_method",
+                              "sample_rate", "feature_dim", "enable_endpoint",
+                              "rule1", "rule2", "rule3"}) {
+            key += k;
+            key += '=';
+            key += str(k);
+            key += '\n';
+        }
+        return key;
+    }
+};
+
+// ===== 宿主 =====
+
+struct Model {
+    const SherpaOnlineRecognizer *recognizer = nullptr;
+    int users = 0;
+};
+
+class Host {
+public:
+    explicit Host(const SherpaApi *api) : api_(api) {}
+
+    // 取得 (必要时创建) 识别器，reused 表示已在进程内
+    const SherpaOnlineRecognizer *acquire(const RecognizerConfig &config,
+                                          bool &reused) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::string key = config.modelKey();
+        auto it = models_.find(key);
+        if (it != models_.end()) {
+            it->second.users++;
+            reused = true;
+            return it->second.recognizer;
+        }
+        // 换用其他模型时，先释放无人使用的旧识别器
+        for (auto old = models_.begin(); old != models_.end();) {
+            if (old->second.users == 0) {
+                api_->destroyRecognizer(old->second.recognizer);
+                old = models_.erase(old);
+            } else {
+                ++old;
+            }
+        }
+        reused = false;
+        const SherpaOnlineRecognizer *recognizer = create(config);
+        if (recognizer) {
+            models_[key] = Model{recognizer, 1};
+        }
+        return recognizer;
+    }
+
+    void release(const SherpaOnlineRecognizer *recognizer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &entry : models_) {
+            if (entry.second.recognizer == recognizer) {
+                entry.second.users--;
+                return;
+            }
+        }
+    }
+
+    const SherpaApi &api() const { return *api_; }
+
+    std::atomic<int> sessions{0};
+    std::atomic<int64_t> lastActivityNs{nowNs()};
+
+private:
+    const SherpaOnlineRecognizer *create(const RecognizerConfig &config) {
+        SherpaOnlineRecognizerConfig c{};
+        c.feat.sampleRate = config.i32("sample_rate", 16000);
+        c.feat.featureDim = config.i32("feature_dim", 80);
+        c.model.transducer = {config.str("encoder"), config.str("decoder"),
+                              config.str("joiner")};
+        c.model.paraformer = {"", ""};
+        c.model.zipformer2Ctc = {""};
+        c.model.tokens = config.str("tokens");
+        c.model.numThreads = config.i32("num_threads", 2);
+        c.model.provider = config.str("provider");
+        c.model.debug = 0;
+        c.model.modelType = "";
+        c.model.modelingUnit = "";
+        c.model.bpeVocab = "";
+        c.model.tokensBuf = nullptr;
+        c.model.tokensBufSize = 0;
+        c.model.nemoCtc = {""};
+        c.model.toneCtc = {""};
+        c.decodingMethod = config.str("decoding_method");
+        c.maxActivePaths = 4;
+        c.enableEndpoint = config.i32("enable_endpoint", 1);
+        c.rule1MinTrailingSilence = config.f32("rule1", 2.4f);
+        c.rule2MinTrailingSilence = config.f32("rule2", 1.2f);
+        c.rule3MinUtteranceLength = config.f32("rule3", 20.0f);
+        c.hotwordsFile = "";
+        c.hotwordsScore = 1.5f;
+        c.ctcFstDecoderConfig = {"", 3000};
+        c.ruleFsts = "";
+        c.ruleFars = "";
+        c.blankPenalty = 0.0f;
+        c.hotwordsBuf = nullptr;
+        c.hotwordsBufSize = 0;
+        c.hr = {"", "", ""};
+        return api_->createRecognizer(&c);
+    }
+
+    const SherpaApi *api_;
+    std::mutex mutex_;
+    std::map<std::string, Model> models_;
+};
+
+// ===== 会话 =====
+
+class Session {
+public:
+    Session(Host &host, int fd) : host_(host), api_(host.api()), fd_(fd) {}
+
+    ~Session() {
+        if (stream_) {
+            api_.destroyStream(stream_);
+        }
+        if (recognizer_) {
+            host_.release(recognizer_);
+        }
+        if (ring_) {
+            munmap(ring_, ringBytes_);
+        }
+        close(fd_);
+    }
+
+    void run() {
+        if (!handshake()) {
+            return;
+        }
+        std::vector<char> payload;
+        for (;;) {
+            MsgHeader header{};
+            if (!nextalk::host::readAll(fd_, &header, sizeof(header)) ||
+                header.size > nextalk::host::kMaxPayload) {
+                return;
+            }
+            payload.resize(header.size);
+            if (header.size > 0 &&
+                !nextalk::host::readAll(fd_, payload.data(), header.size)) {
+                return;
+            }
+            if (!handle(static_cast<MsgType>(header.type), header.arg,
+                        payload)) {
+                return;
+            }
+        }
+    }
+
+private:
+    // 握手: 接收版本号与音频环 memfd
+    bool handshake() {
+        MsgHeader header{};
+        iovec iov{&header, sizeof(header)};
+        char control[CMSG_SPACE(sizeof(int))] = {};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(fd_, &msg, MSG_CMSG_CLOEXEC) !=
+            static_cast<ssize_t>(sizeof(header))) {
+            return false;
+        }
+        int memfd = -1;
+        for (cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) {
+                std::memcpy(&memfd, CMSG_DATA(c), sizeof(int));
+            }
+        }
+        if (memfd < 0) {
+            return false;
+        }
+        bool ok = header.type == static_cast<uint32_t>(MsgType::Hello) &&
+                  header.arg == nextalk::host::kProtocolVersion;
+        struct stat st {};
+        if (ok && fstat(memfd, &st) == 0 &&
+            static_cast<size_t>(st.st_size) > sizeof(AudioRing)) {
+            void *map = mmap(nullptr, static_cast<size_t>(st.st_size),
+                             PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+            if (map != MAP_FAILED) {
+                ring_ = static_cast<AudioRing *>(map);
+                ringBytes_ = static_cast<size_t>(st.st_size);
+            }
+        }
+        close(memfd);
+        // 容量须为 2 的幂且与映射大小一致
+        ok = ok && ring_ && ring_->capacity > 0 &&
+             (ring_->capacity & (ring_->capacity - 1)) == 0 &&
+             AudioRing::bytesFor(ring_->capacity) <= ringBytes_;
+        if (!ok) {
+            sendError("handshake failed");
+        }
+        return ok;
+    }
+
+    bool handle(MsgType type, uint64_t arg, const std::vector<char> &payload) {
+        switch (type) {
+        case MsgType::Load:
+            return load(std::string(payload.begin(), payload.end()));
+        case MsgType::Audio:
+            if (!stream_ || !readAudio(arg)) {
+                return sendError("audio before load or ring underrun");
+            }
+            // 后面还有消息时先不解码，合并到最后一块再解码
+            if (!messagePending()) {
+                return decodeAndPublish();
+            }
+            return true;
+        case MsgType::Reset:
+            epoch_ = arg;
+            sentTokens_.clear();
+            sentText_.clear();
+            sentEndpoint_ = false;
+            if (stream_) {
+                api_.reset(recognizer_, stream_);
+            }
+            return true;
+        case MsgType::Finish:
+            if (stream_) {
+                api_.inputFinished(stream_);
+                if (!decodeAndPublish()) {
+                    return false;
+                }
+            }
+            return nextalk::host::sendMessage(fd_, MsgType::Finished, arg);
+        default:
+            return sendError("unexpected message");
+        }
+    }
+
+    bool load(const std::string &text) {
+        const RecognizerConfig config(text);
+        nextalk::host::LoadedPayload reply{NEXTALK_HOST_OK, 0, 0};
+        const int64_t start = nowNs();
+        if (stream_) {
+            api_.destroyStream(stream_);
+            stream_ = nullptr;
+        }
+        if (recognizer_) {
+            host_.release(recognizer_);
+            recognizer_ = nullptr;
+        }
+        bool reused = false;
+        recognizer_ = host_.acquire(config, reused);
+        if (recognizer_) {
+            stream_ = api_.createStream(recognizer_);
+        }
+        sampleRate_ = config.i32("sample_rate", 16000);
+        reply.reused = reused ? 1 : 0;
+        reply.loadNs = nowNs() - start;
+        if (!recognizer_ || !stream_) {
+            reply.status = NEXTALK_HOST_ERR_MODEL;
+        }
+        std::fprintf(stderr, "[nextalk-engine-host] load %s: %lldms (%s)\n",
+                     reply.status == NEXTALK_HOST_OK ? "ok" : "failed",
+                     static_cast<long long>(reply.loadNs / 1000000),
+                     reused ? "reused" : "cold");
+        return nextalk::host::sendMessage(fd_, MsgType::Loaded, 0, &reply,
+                                          sizeof(reply));
+    }
+
+    bool readAudio(uint64_t count) {
+        const uint64_t read = ring_->readPos.load(std::memory_order_relaxed);
+        const uint64_t write = ring_->writePos.load(std::memory_order_acquire);
+        if (write - read < count || count > ring_->capacity) {
+            return false;
+        }
+        const uint64_t mask = ring_->capacity - 1;
+        const uint64_t offset = read & mask;
+        const uint64_t first = std::min(count, ring_->capacity - offset);
+        samples_.resize(count);
+        std::memcpy(samples_.data(), ring_->data() + offset,
+                    first * sizeof(float));
+        std::memcpy(samples_.data() + first, ring_->data(),
+                    (count - first) * sizeof(float));
+        ring_->readPos.store(read + count, std::memory_order_release);
+        api_.acceptWaveform(stream_, sampleRate_, samples_.data(),
+                            static_cast<int32_t>(count));
+        decodedSamples_ += static_cast<int64_t>(count);
+        return true;
+    }
+
+    bool messagePending() const {
+        pollfd pfd{fd_, POLLIN, 0};
+        return poll(&pfd, 1, 0) > 0;
+    }
+
+    // 解码已送入的音频，结果与上次推送不同时推送完整假设
+    bool decodeAndPublish() {
+        const int64_t start = nowNs();
+        while (api_.isReady(recognizer_, stream_) == 1) {
+            api_.decode(recognizer_, stream_);
+        }
+        decodeNs_ += nowNs() - start;
+
+        const bool endpoint = api_.isEndpoint(recognizer_, stream_) == 1;
+        const SherpaOnlineResult *r = api_.result(recognizer_, stream_);
+        const int32_t count = r && r->tokensArr ? r->count : 0;
+        const char *text = r && r->text ? r->text : "";
+
+        bool changed = endpoint != sentEndpoint_ || text != sentText_ ||
+                       static_cast<size_t>(count) != sentTokens_.size();
+        for (int32_t i = 0; !changed && i < count; ++i) {
+            changed = sentTokens_[static_cast<size_t>(i)] != r->tokensArr[i];
+        }
+        bool ok = true;
+        if (changed) {
+            sentEndpoint_ = endpoint;
+            sentText_ = text;
+            sentTokens_.assign(r && count > 0 ? r->tokensArr : nullptr,
+                               r && count > 0 ? r->tokensArr + count : nullptr);
+
+            nextalk::host::ResultHead head{endpoint ? 1 : 0, count, decodeNs_,
+                                           decodedSamples_};
+            out_.assign(reinterpret_cast<const char *>(&head), sizeof(head));
+            for (int32_t i = 0; i < count; ++i) {
+                const float ts = r->timestamps ? r->timestamps[i] : 0.0f;
+                out_.append(reinterpret_cast<const char *>(&ts), sizeof(ts));
+            }
+            out_.append(text).push_back('\0');
+            for (const std::string &token : sentTokens_) {
+                out_.append(token).push_back('\0');
+            }
+            ok = nextalk::host::sendMessage(fd_, MsgType::Result, epoch_,
+                                            out_.data(),
+                                            static_cast<uint32_t>(out_.size()));
+        }
+        if (r) {
+            api_.destroyResult(r);
+        }
+        return ok;
+    }
+
+    bool sendError(const char *message) {
+        nextalk::host::sendMessage(fd_, MsgType::Error, 0, message,
+                                   static_cast<uint32_t>(std::strlen(message)));
+        return false;
+    }
+
+    Host &host_;
+    const SherpaApi &api_;
+    int fd_;
+    AudioRing *ring_ = nullptr;
+    size_t ringBytes_ = 0;
+
+    const SherpaOnlineRecognizer *recognizer_ = nullptr;
+    const SherpaOnlineStream *stream_ = nullptr;
+    int32_t sampleRate_ = 16000;
+    uint64_t epoch_ = 0;
+
+    int64_t decodeNs_ = 0;
+    int64_t decodedSamples_ = 0;
+    std::vector<float> samples_;
+
+    // 上次推送的结果
+    std::vector<std::string> sentTokens_;
+    std::string sentText_;
+    bool sentEndpoint_ = false;
+    std::string out_;
+};
+
+// 绑定监听套接字；同一路径上已有宿主时返回 -1
+// 以 <socket>.lock 上的 flock 判定唯一实例，残留的套接字文件直接替换
+int listenSocket(const std::string &path) {
+    const std::string lockPath = path + ".lock";
+    const int lockFd = open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (lockFd < 0 || flock(lockFd, LOCK_EX | LOCK_NB) != 0) {
+        return -1;
+    }
+    // lockFd 有意不关闭: 锁随进程存续
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    std::strcpy(addr.sun_path, path.c_str());
+    unlink(path.c_str());
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(fd, 4) != 0) {
+        close(fd);
+        return -1;
+    }
+    chmod(path.c_str(), 0600);
+    return fd;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::string socketPath;
+    int idleTimeoutSec = 1800;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        if (arg == "--socket") {
+            socketPath = argv[i + 1];
+        } else if (arg == "--idle-timeout") {
+            idleTimeoutSec = std::max(1, std::atoi(argv[i + 1]));
+        }
+    }
+    if (socketPath.empty()) {
+        std::fprintf(stderr,
+                     "usage: %s --socket <path> [--idle-timeout <sec>]\n",
+                     argv[0]);
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    auto *api = new SherpaApi();
+    if (!api->load()) {
+        std::fprintf(stderr,
+                     "[nextalk-engine-host] libsherpa-onnx-c-api 加载失败\n");
+        return 1;
+    }
+
+    const int listenFd = listenSocket(socketPath);
+    if (listenFd < 0) {
+        // 已有宿主在运行 (或路径不可用)，由客户端连接已有实例
+        return 0;
+    }
+    std::fprintf(stderr, "[nextalk-engine-host] listening on %s (idle %ds)\n",
+                 socketPath.c_str(), idleTimeoutSec);
+
+    Host host(api);
+    const int64_t idleNs = static_cast<int64_t>(idleTimeoutSec) * 1000000000LL;
+    for (;;) {
+        pollfd pfd{listenFd, POLLIN, 0};
+        const int ready = poll(&pfd, 1, 1000);
+        if (ready > 0) {
+            const int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                host.sessions.fetch_add(1);
+                std::thread([&host, fd] {
+                    pthread_setname_np(pthread_self(), "nextalk-session");
+                    {
+                        Session session(host, fd);
+                        session.run();
+                    }
+                    host.lastActivityNs.store(nowNs());
+                    host.sessions.fetch_sub(1);
+                }).detach();
+            }
+            continue;
+        }
+        if (host.sessions.load() == 0 &&
+            nowNs() - host.lastActivityNs.load() > idleNs) {
+            break;
+        }
+    }
+    std::fprintf(stderr, "[nextalk-engine-host] idle, exiting\n");
+    unlink(socketPath.c_str());
+    // 识别器随进程退出释放，不逐个销毁以免退出变慢
+    _exit(0);
+}
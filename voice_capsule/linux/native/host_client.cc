@@ -0,0 +1,443 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 识别宿主客户端
+ *
+ * 调用方线程只写音频环并发送控制消息；接收线程读取宿主推送的完整假设，
+ * 交给 ResultTracker 比较并发布增量，读取方式与本进程内的工作线程相同。
+ * reset 递增 epoch 并随 Reset 消息发给宿主，宿主在结果中带回 epoch，
+ * reset 之前的音频产生的结果由 ResultTracker 丢弃。
+ */
+
+#include "host_protocol.h"
+#include "nextalk_host.h"
+#include "result_tracker.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using nextalk::host::AudioRing;
+using nextalk::host::MsgHeader;
+using nextalk::host::MsgType;
+
+// 音频环容量 (样本)，16kHz 下约 65 秒，覆盖宿主加载模型期间的音频
+constexpr uint64_t kRingCapacity = 1u << 20;
+
+int connectSocket(const char *path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (std::strlen(path) >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    std::strcpy(addr.sun_path, path);
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 以脱离当前会话的孙进程启动宿主 (不成为本进程的子进程)
+// 调用方是多线程进程，fork 之后只调用 async-signal-safe 函数
+void spawnHost(const char *exe, const char *socketPath, int32_t idleSec) {
+    char idle[16];
+    std::snprintf(idle, sizeof(idle), "%d", idleSec);
+    const pid_t pid = fork();
+    if (pid < 0) {
+        return;
+    }
+    if (pid == 0) {
+        setsid();
+        if (fork() != 0) {
+            _exit(0);
+        }
+        const int devNull = open("/dev/null", O_RDWR);
+        if (devNull >= 0) {
+            dup2(devNull, STDIN_FILENO);
+        }
+        execl(exe, exe, "--socket", socketPath, "--idle-timeout", idle,
+              static_cast<char *>(nullptr));
+        _exit(127);
+    }
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+}
+
+} // namespace
+
+struct NextalkHostClient {
+    int sock = -1;
+    AudioRing *ring = nullptr;
+    std::thread receiver;
+    std::atomic<bool> alive{true};
+
+    nextalk::ResultTracker tracker;
+    std::atomic<int64_t> decodeNs{0};
+    std::atomic<int64_t> decodedSamples{0};
+
+    // 请求/应答状态 (mutex 保护)
+    std::mutex mutex;
+    std::condition_variable replyCv;
+    bool loadReplied = false;
+    nextalk::host::LoadedPayload loaded{};
+    uint64_t nextTicket = 1;
+    uint64_t finishedTicket = 0;
+    std::string lastError;
+    std::string errorOut; // nextalk_host_error 返回值 (调用方线程)
+
+    void receive() {
+        pthread_setname_np(pthread_self(), "nextalk-hostc");
+        std::vector<char> payload;
+        std::vector<const char *> tokens;
+        for (;;) {
+            MsgHeader header{};
+            if (!nextalk::host::readAll(sock, &header, sizeof(header)) ||
+                header.size > nextalk::host::kMaxPayload) {
+                break;
+            }
+            payload.resize(header.size);
+            if (header.size > 0 &&
+                !nextalk::host::readAll(sock, payload.data(), header.size)) {
+                break;
+            }
+            switch (static_cast<MsgType>(header.type)) {
+            case MsgType::Result:
+                onResult(header.arg, payload, tokens);
+                break;
+            case MsgType::Loaded: {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (payload.size() >= sizeof(loaded)) {
+                    std::memcpy(&loaded, payload.data(), sizeof(loaded));
+                } else {
+                    loaded = {NEXTALK_HOST_ERR_STATE, 0, 0};
+                }
+                loadReplied = true;
+                replyCv.notify_all();
+                break;
+            }
+            case MsgType::Finished: {
+                std::lock_guard<std::mutex> lock(mutex);
+                finishedTicket = std::max(finishedTicket, header.arg);
+                replyCv.notify_all();
+                break;
+            }
+            case MsgType::Error: {
+                std::lock_guard<std::mutex> lock(mutex);
+                lastError.assign(payload.data(), payload.size());
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        // 宿主退出或崩溃: 唤醒所有等待者
+        std::lock_guard<std::mutex> lock(mutex);
+        alive.store(false, std::memory_order_release);
+        if (lastError.empty()) {
+            lastError = "engine host disconnected";
+        }
+        replyCv.notify_all();
+    }
+
+    void onResult(uint64_t epoch, const std::vector<char> &payload,
+                  std::vector<const char *> &tokens) {
+        nextalk::host::ResultHead head{};
+        if (payload.size() < sizeof(head)) {
+            return;
+        }
+        std::memcpy(&head, payload.data(), sizeof(head));
+        const size_t tsBytes = static_cast<size_t>(head.count) * sizeof(float);
+        if (head.count < 0 || payload.size() < sizeof(head) + tsBytes) {
+            return;
+        }
+        std::vector<float> timestamps(static_cast<size_t>(head.count));
+        std::memcpy(timestamps.data(), payload.data() + sizeof(head), tsBytes);
+
+        // 文本与 token 均以 \0 结尾，依次切出
+        const char *p = payload.data() + sizeof(head) + tsBytes;
+        const char *end = payload.data() + payload.size();
+        auto next = [&p, end]() -> const char * {
+            const void *nul = std::memchr(p, '\0', static_cast<size_t>(end - p));
+            if (!nul) {
+                return nullptr;
+            }
+            const char *s = p;
+            p = static_cast<const char *>(nul) + 1;
+            return s;
+        };
+        const char *text = next();
+        if (!text) {
+            return;
+        }
+        tokens.clear();
+        for (int32_t i = 0; i < head.count; ++i) {
+            const char *token = next();
+            if (!token) {
+                return;
+            }
+            tokens.push_back(token);
+        }
+        decodeNs.store(head.decodeNs, std::memory_order_relaxed);
+        decodedSamples.store(head.decodedSamples, std::memory_order_relaxed);
+        tracker.offer(epoch, head.endpoint != 0, text, tokens.data(),
+                      timestamps.data(), head.count, head.decodedSamples);
+    }
+};
+
+NEXTALK_EXPORT NextalkHostClient *nextalk_host_connect(const char *socket_path,
+                                                       const char *host_exe,
+                                                       int32_t idle_timeout_sec,
+                                                       int32_t timeout_ms) {
+    if (!socket_path) {
+        return nullptr;
+    }
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(timeout_ms);
+    int fd = connectSocket(socket_path);
+    if (fd < 0 && host_exe) {
+        spawnHost(host_exe, socket_path, idle_timeout_sec);
+        // 等待宿主开始监听
+        while (fd < 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            fd = connectSocket(socket_path);
+        }
+    }
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    // 共享内存音频环
+    const size_t bytes = AudioRing::bytesFor(kRingCapacity);
+    const int memfd = memfd_create("nextalk-audio", MFD_CLOEXEC);
+    void *map = MAP_FAILED;
+    if (memfd >= 0 && ftruncate(memfd, static_cast<off_t>(bytes)) == 0) {
+        map = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    }
+    if (map == MAP_FAILED) {
+        if (memfd >= 0) {
+            close(memfd);
+        }
+        close(fd);
+        return nullptr;
+    }
+    auto *ring = new (map) AudioRing();
+    ring->writePos.store(0, std::memory_order_relaxed);
+    ring->readPos.store(0, std::memory_order_relaxed);
+    ring->capacity = kRingCapacity;
+
+    // 握手: 版本号 + memfd
+    MsgHeader header{static_cast<uint32_t>(MsgType::Hello), 0,
+                     nextalk::host::kProtocolVersion};
+    iovec iov{&header, sizeof(header)};
+    char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &memfd, sizeof(int));
+    const bool sent = sendmsg(fd, &msg, MSG_NOSIGNAL) ==
+                      static_cast<ssize_t>(sizeof(header));
+    close(memfd);
+    if (!sent) {
+        munmap(map, bytes);
+        close(fd);
+        return nullptr;
+    }
+
+    auto *client = new NextalkHostClient();
+    client->sock = fd;
+    client->ring = ring;
+    client->receiver = std::thread([client] { client->receive(); });
+    return client;
+}
+
+NEXTALK_EXPORT int32_t nextalk_host_load(NextalkHostClient *client,
+                                         const char *config,
+                                         int32_t timeout_ms) {
+    if (!client || !config) {
+        return NEXTALK_HOST_ERR_STATE;
+    }
+    {
+        std::lock_guard<std::mutex> lock(client->mutex);
+        client->loadReplied = false;
+    }
+    if (!nextalk::host::sendMessage(client->sock, MsgType::Load, 0, config,
+                                    static_cast<uint32_t>(std::strlen(config)))) {
+        return NEXTALK_HOST_ERR_STATE;
+    }
+    std::unique_lock<std::mutex> lock(client->mutex);
+    const bool replied = client->replyCv.wait_for(
+        lock, std::chrono::milliseconds(timeout_ms), [client] {
+            return client->loadReplied ||
+                   !client->alive.load(std::memory_order_acquire);
+        });
+    if (!replied || !client->loadReplied) {
+        return NEXTALK_HOST_ERR_STATE;
+    }
+    return client->loaded.status;
+}
+
+NEXTALK_EXPORT int64_t nextalk_host_load_ns(NextalkHostClient *client) {
+    if (!client) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(client->mutex);
+    return client->loaded.loadNs;
+}
+
+NEXTALK_EXPORT int32_t nextalk_host_load_reused(NextalkHostClient *client) {
+    if (!client) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(client->mutex);
+    return client->loaded.reused;
+}
+
+NEXTALK_EXPORT const char *nextalk_host_error(NextalkHostClient *client) {
+    if (!client) {
+        return "";
+    }
+    std::lock_guard<std::mutex> lock(client->mutex);
+    client->errorOut = client->lastError;
+    return client->errorOut.c_str();
+}
+
+NEXTALK_EXPORT int32_t nextalk_host_accept(NextalkHostClient *client,
+                                           const float *samples, int32_t n) {
+    if (!client || !samples || n < 0) {
+        return NEXTALK_HOST_ERR_STATE;
+    }
+    if (n == 0) {
+        return NEXTALK_HOST_OK;
+    }
+    if (!client->alive.load(std::memory_order_acquire)) {
+        return NEXTALK_HOST_ERR_STATE;
+    }
+    AudioRing *ring = client->ring;
+    const uint64_t write = ring->writePos.load(std::memory_order_relaxed);
+    const uint64_t read = ring->readPos.load(std::memory_order_acquire);
+    const auto count = static_cast<uint64_t>(n);
+    if (ring->capacity - (write - read) < count) {
+        return NEXTALK_HOST_ERR_STATE; // 宿主长时间未消费
+    }
+    const uint64_t mask = ring->capacity - 1;
+    const uint64_t offset = write & mask;
+    const uint64_t first = std::min(count, ring->capacity - offset);
+    std::memcpy(ring->data() + offset, samples, first * sizeof(float));
+    std::memcpy(ring->data(), samples + first, (count - first) * sizeof(float));
+    ring->writePos.store(write + count, std::memory_order_release);
+    return nextalk::host::sendMessage(client->sock, MsgType::Audio, count)
+               ? NEXTALK_HOST_OK
+               : NEXTALK_HOST_ERR_STATE;
+}
+
+NEXTALK_EXPORT void nextalk_host_reset(NextalkHostClient *client) {
+    if (!client) {
+        return;
+    }
+    const uint64_t epoch = client->tracker.reset();
+    nextalk::host::sendMessage(client->sock, MsgType::Reset, epoch);
+}
+
+NEXTALK_EXPORT int32_t nextalk_host_finish(NextalkHostClient *client,
+                                           int32_t timeout_ms) {
+    if (!client) {
+        return 0;
+    }
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(client->mutex);
+        ticket = client->nextTicket++;
+    }
+    if (!nextalk::host::sendMessage(client->sock, MsgType::Finish, ticket)) {
+        return 0;
+    }
+    std::unique_lock<std::mutex> lock(client->mutex);
+    const bool done = client->replyCv.wait_for(
+        lock, std::chrono::milliseconds(timeout_ms), [client, ticket] {
+            return client->finishedTicket >= ticket ||
+                   !client->alive.load(std::memory_order_acquire);
+        });
+    return done && client->finishedTicket >= ticket ? 1 : 0;
+}
+
+NEXTALK_EXPORT int32_t nextalk_host_drained(NextalkHostClient *client) {
+    if (!client) {
+        return 1;
+    }
+    // 宿主已断开时不会再有应答，视为完成
+    std::lock_guard<std::mutex> lock(client->mutex);
+    return client->finishedTicket + 1 >= client->nextTicket ||
+                   !client->alive.load(std::memory_order_acquire)
+               ? 1
+               : 0;
+}
+
+NEXTALK_EXPORT int64_t nextalk_host_generation(NextalkHostClient *client) {
+    return client ? client->tracker.generation() : 0;
+}
+
+NEXTALK_EXPORT int32_t nextalk_host_take_update(NextalkHostClient *client,
+                                                NextalkAsrUpdate *out) {
+    if (!client || !out) {
+        return 0;
+    }
+    return client->tracker.take(out) ? 1 : 0;
+}
+
+NEXTALK_EXPORT int32_t nextalk_host_is_endpoint(NextalkHostClient *client) {
+    return client && client->tracker.endpoint() ? 1 : 0;
+}
+
+NEXTALK_EXPORT int64_t nextalk_host_decode_ns(NextalkHostClient *client) {
+    return client ? client->decodeNs.load(std::memory_order_relaxed) : 0;
+}
+
+NEXTALK_EXPORT int64_t nextalk_host_decoded_frames(NextalkHostClient *client) {
+    return client ? client->decodedSamples.load(std::memory_order_relaxed) : 0;
+}
+
+NEXTALK_EXPORT int32_t nextalk_host_alive(NextalkHostClient *client) {
+    return client && client->alive.load(std::memory_order_acquire) ? 1 : 0;
+}
+
+NEXTALK_EXPORT void nextalk_host_disconnect(NextalkHostClient *client) {
+    if (!client) {
+        return;
+    }
+    // 关闭写端后接收线程读到 EOF 退出
+    shutdown(client->sock, SHUT_RDWR);
+    if (client->receiver.joinable()) {
+        client->receiver.join();
+    }
+    close(client->sock);
+    munmap(client->ring, AudioRing::bytesFor(client->ring->capacity));
+    delete client;
+}
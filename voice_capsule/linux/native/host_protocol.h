@@ -0,0 +1,156 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 识别宿主进程 (nextalk_engine_host) 与客户端之间的协议
+ *
+ * 控制消息走 Unix 域套接字: 定长消息头 + 可变长负载。
+ * 音频走共享内存: 客户端创建 memfd 环形缓冲区，在握手时随 SCM_RIGHTS
+ * 交给宿主；客户端写入样本后只发送一条带样本数的 Audio 消息，
+ * 宿主按到达顺序从环中读出同样数量的样本。
+ */
+
+#ifndef _NEXTALK_NATIVE_HOST_PROTOCOL_H_
+#define _NEXTALK_NATIVE_HOST_PROTOCOL_H_
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace nextalk {
+namespace host {
+
+constexpr uint32_t kProtocolVersion = 1;
+
+// 单条消息负载上限 (识别结果与配置都远小于此)
+constexpr uint32_t kMaxPayload = 1u << 20;
+
+enum class MsgType : uint32_t {
+    // 客户端 -> 宿主
+    Hello = 1, // arg: 协议版本，附带音频环 memfd
+    Load,      // 负载: 识别器配置 (key=value 行)
+    Audio,     // arg: 本次写入音频环的样本数
+    Reset,     // arg: 新的 epoch
+    Finish,    // arg: 序号，宿主解码完此前的音频后回复 Finished
+    // 宿主 -> 客户端
+    Loaded,   // 负载: LoadedPayload
+    Result,   // arg: epoch，负载: ResultHead + 时间戳 + 文本 + token
+    Finished, // arg: 对应 Finish 的序号
+    Error,    // 负载: 错误信息
+};
+
+struct MsgHeader {
+    uint32_t type;
+    uint32_t size; // 负载字节数
+    uint64_t arg;
+};
+
+struct LoadedPayload {
+    int32_t status;  // NEXTALK_HOST_* 错误码
+    int32_t reused;  // 1 表示复用了宿主中已加载的模型
+    int64_t loadNs;  // 本次创建识别器与流的耗时
+};
+
+// Result 负载: ResultHead, float timestamps[count], 文本\0, count 个 token\0
+struct ResultHead {
+    int32_t endpoint;
+    int32_t count;
+    int64_t decodeNs;       // 本会话累计解码耗时
+    int64_t decodedSamples; // 本会话累计送入识别器的样本数
+};
+
+// 共享内存音频环 (单生产者: 客户端，单消费者: 宿主)
+// 位置为单调递增的样本序号，容量为 2 的幂
+struct AudioRing {
+    alignas(64) std::atomic<uint64_t> writePos;
+    alignas(64) std::atomic<uint64_t> readPos;
+    alignas(64) uint64_t capacity;
+
+    float *data() { return reinterpret_cast<float *>(this + 1); }
+
+    static size_t bytesFor(uint64_t capacity) {
+        return sizeof(AudioRing) + capacity * sizeof(float);
+    }
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "跨进程共享的原子变量必须无锁");
+
+// 完整写入，失败返回 false (对端关闭或出错)
+inline bool writeAll(int fd, const void *buf, size_t len) {
+    const char *p = static_cast<const char *>(buf);
+    while (len > 0) {
+        const ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 完整读取，对端关闭或出错返回 false
+inline bool readAll(int fd, void *buf, size_t len) {
+    char *p = static_cast<char *>(buf);
+    while (len > 0) {
+        const ssize_t n = recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 发送一条消息 (消息头与负载一次发出)
+inline bool sendMessage(int fd, MsgType type, uint64_t arg,
+                        const void *payload = nullptr, uint32_t size = 0) {
+    MsgHeader header{static_cast<uint32_t>(type), size, arg};
+    iovec iov[2] = {{&header, sizeof(header)},
+                    {const_cast<void *>(payload), size}};
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = size > 0 ? 2 : 1;
+    const size_t total = sizeof(header) + size;
+    ssize_t n;
+    do {
+        n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        return false;
+    }
+    if (static_cast<size_t>(n) == total) {
+        return true;
+    }
+    // 套接字缓冲区满时的剩余部分
+    const char *header8 = reinterpret_cast<const char *>(&header);
+    size_t sent = static_cast<size_t>(n);
+    if (sent < sizeof(header)) {
+        if (!writeAll(fd, header8 + sent, sizeof(header) - sent)) {
+            return false;
+        }
+        sent = sizeof(header);
+    }
+    return writeAll(fd, static_cast<const char *>(payload) +
+                            (sent - sizeof(header)),
+                    total - sent);
+}
+
+} // namespace host
+} // namespace nextalk
+
+#endif // _NEXTALK_NATIVE_HOST_PROTOCOL_H_
@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 音频电平计量内核 (AVX2 / NEON / 标量)
+ */
+
+#include "level_meter.h"
+
+#include "audio_convert.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NEXTALK_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define NEXTALK_NEON 1
+#endif
+
+namespace nextalk {
+
+namespace {
+
+// 从下标 i 开始的标量尾部 (x[i-1] 必须有效)
+void accumulateScalar(const float *x, size_t i, size_t n, BlockLevels &out) {
+    for (; i < n; ++i) {
+        const float d = x[i] - x[i - 1];
+        out.sumSquares += static_cast<double>(x[i]) * x[i];
+        out.diffSumSquares += static_cast<double>(d) * d;
+        out.peak = std::max(out.peak, std::fabs(x[i]));
+    }
+}
+
+#if defined(NEXTALK_X86)
+
+__attribute__((target("avx2,fma"))) size_t accumulateAvx2(const float *x, size_t n,
+                                                          BlockLevels &out) {
+    const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 sq = _mm256_setzero_ps();
+    __m256 diff = _mm256_setzero_ps();
+    __m256 peak = _mm256_setzero_ps();
+    size_t i = 1;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 v = _mm256_loadu_ps(x + i);
+        const __m256 d = _mm256_sub_ps(v, _mm256_loadu_ps(x + i - 1));
+        sq = _mm256_fmadd_ps(v, v, sq);
+        diff = _mm256_fmadd_ps(d, d, diff);
+        peak = _mm256_max_ps(peak, _mm256_and_ps(v, signMask));
+    }
+    alignas(32) float lanes[3][8];
+    _mm256_store_ps(lanes[0], sq);
+    _mm256_store_ps(lanes[1], diff);
+    _mm256_store_ps(lanes[2], peak);
+    for (int k = 0; k < 8; ++k) {
+        out.sumSquares += lanes[0][k];
+        out.diffSumSquares += lanes[1][k];
+        out.peak = std::max(out.peak, lanes[2][k]);
+    }
+    return i;
+}
+
+#elif defined(NEXTALK_NEON)
+
+size_t accumulateNeon(const float *x, size_t n, BlockLevels &out) {
+    float32x4_t sq = vdupq_n_f32(0.0f);
+    float32x4_t diff = vdupq_n_f32(0.0f);
+    float32x4_t peak = vdupq_n_f32(0.0f);
+    size_t i = 1;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t v = vld1q_f32(x + i);
+        const float32x4_t d = vsubq_f32(v, vld1q_f32(x + i - 1));
+        sq = vfmaq_f32(sq, v, v);
+        diff = vfmaq_f32(diff, d, d);
+        peak = vmaxq_f32(peak, vabsq_f32(v));
+    }
+    out.sumSquares += vaddvq_f32(sq);
+    out.diffSumSquares += vaddvq_f32(diff);
+    out.peak = std::max(out.peak, vmaxvq_f32(peak));
+    return i;
+}
+
+#endif
+
+} // namespace
+
+BlockLevels measureBlock(const float *data, size_t n, float &prev) {
+    BlockLevels out;
+    if (n == 0) {
+        return out;
+    }
+    // 首个样本与上一块衔接，其余样本的差分都在块内
+    const float d0 = data[0] - prev;
+    out.sumSquares = static_cast<double>(data[0]) * data[0];
+    out.diffSumSquares = static_cast<double>(d0) * d0;
+    out.peak = std::fabs(data[0]);
+
+    size_t i = 1;
+    switch (activeSimdLevel()) {
+#if defined(NEXTALK_X86)
+    case SimdLevel::Avx2:
+        i = accumulateAvx2(data, n, out);
+        break;
+#elif defined(NEXTALK_NEON)
+    case SimdLevel::Neon:
+        i = accumulateNeon(data, n, out);
+        break;
+#endif
+    default:
+        break;
+    }
+    accumulateScalar(data, i, n, out);
+    prev = data[n - 1];
+    return out;
+}
+
+double spectralCentroidHz(const BlockLevels &levels, int sampleRate) {
+    if (levels.sumSquares <= 0.0) {
+        return 0.0;
+    }
+    const double ratio = std::clamp(levels.diffSumSquares / levels.sumSquares, 0.0, 4.0);
+    return std::acos(1.0 - ratio / 2.0) * sampleRate / (2.0 * M_PI);
+}
+
+} // namespace nextalk
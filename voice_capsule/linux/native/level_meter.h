@@ -0,0 +1,34 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 音频电平计量 (RMS / 峰值 / 频谱质心估计)
+ *
+ * 在采集线程中对每个写入环形缓冲区的块计算，结果供胶囊动画跟随语音、
+ * 以及静音判断使用，UI isolate 不必再遍历样本。
+ */
+
+#ifndef _NEXTALK_NATIVE_LEVEL_METER_H_
+#define _NEXTALK_NATIVE_LEVEL_METER_H_
+
+#include <cstddef>
+
+namespace nextalk {
+
+// 单块统计量
+struct BlockLevels {
+    double sumSquares = 0.0;     // Σx²
+    double diffSumSquares = 0.0; // Σ(x[i] - x[i-1])²，高频能量
+    float peak = 0.0f;           // max|x|
+};
+
+// 计算 n 个样本的统计量，prev 为上一块的最后一个样本 (返回时更新)
+BlockLevels measureBlock(const float *data, size_t n, float &prev);
+
+// 由一阶差分能量与信号能量之比估计频谱质心 (Hz)
+// 对正弦信号 Σ(Δx)²/Σx² = 2(1 - cos ω)，据此反解出能量加权的等效频率
+double spectralCentroidHz(const BlockLevels &levels, int sampleRate);
+
+} // namespace nextalk
+
+#endif // _NEXTALK_NATIVE_LEVEL_METER_H_
@@ -0,0 +1,141 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 模型内存驻留: 归还空闲内存、页缓存预读提示与登录后预热
+ *
+ * 预热用普通 read() 顺序读完整个文件: readahead(2) 与 WILLNEED 只是提示，
+ * 单次读取量受块设备预读窗口限制，不能保证文件全部进入页缓存。
+ * I/O 优先级按线程生效，因此在单独的线程中读取，不影响调用线程。
+ */
+
+#include "nextalk_memory.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// linux/ioprio.h 中的取值 (glibc 未提供封装)
+constexpr int kIoprioWhoProcess = 1;
+constexpr int kIoprioClassIdle = 3;
+constexpr int kIoprioClassShift = 13;
+
+constexpr size_t kReadChunk = 1 << 20;
+
+// fd 对应文件在页缓存中的字节数，失败返回 -errno
+int64_t residentBytes(int fd, int64_t size) {
+    if (size <= 0) {
+        return 0;
+    }
+    void *map = mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        return -errno;
+    }
+    const int64_t page = sysconf(_SC_PAGESIZE);
+    std::vector<unsigned char> vec(static_cast<size_t>((size + page - 1) / page));
+    int64_t resident = 0;
+    if (mincore(map, static_cast<size_t>(size), vec.data()) == 0) {
+        for (size_t i = 0; i < vec.size(); ++i) {
+            if (vec[i] & 1) {
+                resident += i + 1 == vec.size() ? size - static_cast<int64_t>(i) * page : page;
+            }
+        }
+    } else {
+        resident = -errno;
+    }
+    munmap(map, static_cast<size_t>(size));
+    return resident;
+}
+
+} // namespace
+
+NEXTALK_EXPORT int32_t nextalk_memory_trim(void) {
+    return malloc_trim(0) ? 1 : 0;
+}
+
+NEXTALK_EXPORT int64_t nextalk_memory_prefetch(const char *path) {
+    if (!path) {
+        return -EINVAL;
+    }
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -errno;
+    }
+    struct stat st {};
+    int64_t result = 0;
+    if (fstat(fd, &st) != 0) {
+        result = -errno;
+    } else {
+        // 只是提示: 内核在后台发起读取，文件已在页缓存中时几乎没有开销
+        const int rc = posix_fadvise(fd, 0, st.st_size, POSIX_FADV_WILLNEED);
+        result = rc == 0 ? static_cast<int64_t>(st.st_size) : -rc;
+    }
+    close(fd);
+    return result;
+}
+
+NEXTALK_EXPORT int64_t nextalk_memory_resident(const char *path) {
+    if (!path) {
+        return -EINVAL;
+    }
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -errno;
+    }
+    struct stat st {};
+    const int64_t result = fstat(fd, &st) == 0 ? residentBytes(fd, st.st_size) : -errno;
+    close(fd);
+    return result;
+}
+
+NEXTALK_EXPORT int64_t nextalk_memory_prewarm(const char *const *paths,
+                                              int32_t count,
+                                              int64_t *resident_before) {
+    int64_t total = 0;
+    int64_t resident = 0;
+    if (paths && count > 0) {
+        std::thread reader([&] {
+            // 空闲 I/O 优先级: 只在磁盘没有其他请求时读取，不拖慢登录
+            syscall(SYS_ioprio_set, kIoprioWhoProcess, 0,
+                    kIoprioClassIdle << kIoprioClassShift);
+            std::vector<char> buffer(kReadChunk);
+            for (int32_t i = 0; i < count; ++i) {
+                if (!paths[i]) {
+                    continue;
+                }
+                const int fd = open(paths[i], O_RDONLY | O_CLOEXEC);
+                if (fd < 0) {
+                    continue;
+                }
+                struct stat st {};
+                if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+                    const int64_t size = st.st_size;
+                    const int64_t cached = residentBytes(fd, size);
+                    total += size;
+                    resident += cached > 0 ? cached : 0;
+                    if (cached < size) {
+                        posix_fadvise(fd, 0, size, POSIX_FADV_SEQUENTIAL);
+                        ssize_t n;
+                        do {
+                            n = read(fd, buffer.data(), buffer.size());
+                        } while (n > 0 || (n < 0 && errno == EINTR));
+                    }
+                }
+                close(fd);
+            }
+        });
+        reader.join();
+    }
+    if (resident_before) {
+        *resident_before = resident;
+    }
+    return total;
+}
@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Nextalk 流式识别工作线程 C API (供 Dart FFI 调用)
+ *
+ * sherpa-onnx 在线识别器与流仍由 Dart 侧按配置创建，创建后交给工作线程独占:
+ * 送入音频只是入队拷贝，解码在独立线程中进行，UI isolate 不再等待
+ * DecodeOnlineStream。识别结果按 token id 比较，仅在变化时发布，
+ * Dart 侧按发布序号判断是否需要读取，读取到的是相对上次读取的增量。
+ */
+
+#ifndef _NEXTALK_NATIVE_ASR_H_
+#define _NEXTALK_NATIVE_ASR_H_
+
+#include "nextalk_capture.h"
+
+// 错误码 (与 Dart 侧 NativeAsrWorker 对应)
+enum {
+    NEXTALK_ASR_OK = 0,
+    NEXTALK_ASR_ERR_LIBRARY = -1, // libsherpa-onnx-c-api 加载失败
+    NEXTALK_ASR_ERR_STATE = -2,   // 参数或状态错误
+};
+
+typedef struct NextalkAsrWorker NextalkAsrWorker;
+
+// 识别结果增量: 保留上次读取结果的前 kept 个 token，其后替换为 tokens
+typedef struct NextalkAsrUpdate {
+    int64_t generation;        // 对应的发布序号
+    int32_t kept;              // 与上次读取相同的前缀 token 数 (稳定前缀)
+    int32_t count;             // tokens/timestamps 的长度
+    const char *text;          // 完整文本
+    const char *const *tokens; // 第 kept 个之后的 token
+    const float *timestamps;   // 对应 token 的时间戳 (秒)
+    int64_t samples;           // 产生该结果时已送入识别器的累计样本数
+} NextalkAsrUpdate;
+
+// 创建工作线程，接管 recognizer/stream (SherpaOnnxOnlineRecognizer/Stream 指针)
+// 失败返回 NULL，此时调用方继续在本线程同步解码
+// 工作线程存续期间调用方不得再直接访问 recognizer/stream
+NEXTALK_EXPORT NextalkAsrWorker *nextalk_asr_worker_create(void *recognizer,
+                                                           void *stream,
+                                                           int32_t sample_rate);
+
+// 送入音频 (拷贝后立即返回)
+NEXTALK_EXPORT int32_t nextalk_asr_worker_accept(NextalkAsrWorker *worker,
+                                                 const float *samples,
+                                                 int32_t n);
+
+// 重置识别状态: 已发布的结果与端点标记立即清空，
+// 此前入队但尚未解码的音频产生的结果会被丢弃
+NEXTALK_EXPORT void nextalk_asr_worker_reset(NextalkAsrWorker *worker);
+
+// 标记输入结束并等待已入队音频全部解码，返回 1 表示在 timeout_ms 内完成
+// timeout_ms 为 0 时只入队不等待，之后以 nextalk_asr_worker_drained 轮询
+NEXTALK_EXPORT int32_t nextalk_asr_worker_finish(NextalkAsrWorker *worker,
+                                                 int32_t timeout_ms);
+
+// 已入队的命令是否全部执行完毕 (1 是，0 否)
+NEXTALK_EXPORT int32_t nextalk_asr_worker_drained(NextalkAsrWorker *worker);
+
+// 结果发布序号 (每次 token 序列变化或重置时递增)
+NEXTALK_EXPORT int64_t nextalk_asr_worker_generation(NextalkAsrWorker *worker);
+
+// 取自上次调用以来的结果增量，返回 1 表示有变化，0 表示无变化
+// out 中的指针在下一次调用本函数之前有效
+NEXTALK_EXPORT int32_t nextalk_asr_worker_take_update(NextalkAsrWorker *worker,
+                                                      NextalkAsrUpdate *out);
+
+// 最近一次解码后是否到达端点
+NEXTALK_EXPORT int32_t nextalk_asr_worker_is_endpoint(NextalkAsrWorker *worker);
+
+// 工作线程累计解码耗时 (纳秒) 与已解码帧数，用于统计
+NEXTALK_EXPORT int64_t nextalk_asr_worker_decode_ns(NextalkAsrWorker *worker);
+NEXTALK_EXPORT int64_t nextalk_asr_worker_decoded_frames(NextalkAsrWorker *worker);
+
+// 停止并销毁工作线程 (未解码的音频被丢弃)，recognizer/stream 交还调用方
+NEXTALK_EXPORT void nextalk_asr_worker_destroy(NextalkAsrWorker *worker);
+
+#endif // _NEXTALK_NATIVE_ASR_H_
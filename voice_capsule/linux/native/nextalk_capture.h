@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Nextalk 原生音频采集 C API (供 Dart FFI 调用)
+ *
+ * 采集在独立的实时优先级线程中进行，音频帧写入无锁 SPSC 环形缓冲区；
+ * Dart 侧非阻塞读取，并通过 NativeCallable.listener 接收唤醒通知，
+ * 不再在 UI isolate 上阻塞等待音频服务器。
+ */
+
+#ifndef _NEXTALK_NATIVE_CAPTURE_H_
+#define _NEXTALK_NATIVE_CAPTURE_H_
+
+#include <stdint.h>
+
+#define NEXTALK_EXPORT extern "C" __attribute__((visibility("default")))
+
+// 错误码 (与 Dart 侧 NativeCaptureError 对应)
+enum {
+    NEXTALK_CAPTURE_OK = 0,
+    NEXTALK_CAPTURE_ERR_LIBRARY = -1,     // 音频库加载失败
+    NEXTALK_CAPTURE_ERR_OPEN = -2,        // 打开设备失败
+    NEXTALK_CAPTURE_ERR_START = -3,       // 启动采集失败
+    NEXTALK_CAPTURE_ERR_READ = -4,        // 读取失败
+    NEXTALK_CAPTURE_ERR_DEVICE_LOST = -5, // 设备断开
+    NEXTALK_CAPTURE_ERR_STATE = -6,       // 状态错误 (未打开/重复打开)
+};
+
+// 唤醒通知回调: 参数为当前可读帧数，< 0 表示采集线程出错
+typedef void (*nextalk_notify_fn)(int64_t available);
+
+typedef struct NextalkCapture NextalkCapture;
+
+// 电平快照 (采集线程每写入一块更新一次，样本满幅为 1.0)
+typedef struct NextalkLevels {
+    double energy;     // 自 start 起累计的样本平方和
+    int64_t frames;    // 自 start 起累计计量的帧数
+    int64_t blocks;    // 已计量的块数 (变化即表示有新数据)
+    float rms;         // 最近一块的均方根
+    float peak;        // 最近一块的峰值绝对值
+    float centroid_hz; // 最近一块的频谱质心估计 (Hz)，多声道时为 0
+} NextalkLevels;
+
+// 创建采集实例
+// ring_frames: 环形缓冲区容量 (帧)，block_frames: 采集线程单次读取帧数
+NEXTALK_EXPORT NextalkCapture *nextalk_capture_create(int32_t sample_rate,
+                                                      int32_t channels,
+                                                      int32_t ring_frames,
+                                                      int32_t block_frames);
+
+// 以设备原生采样率/格式打开录音流 (须在 open 之前调用，仅单声道时生效)
+// 由本库完成格式转换、混音与多相重采样，不依赖音频服务器的重采样设置
+NEXTALK_EXPORT void nextalk_capture_set_device_native(NextalkCapture *capture,
+                                                      int32_t enabled);
+
+// 通过 libpulse 异步流打开录音流，device 为 NULL 或 "default" 使用系统默认
+// target_latency_ms: 请求的分片时长 (fragsize)，服务器可能调整
+NEXTALK_EXPORT int32_t nextalk_capture_open_pulse(NextalkCapture *capture,
+                                                  const char *device,
+                                                  int32_t target_latency_ms);
+
+// 通过 PortAudio 打开录音流，device_index 由 Dart 侧设备解析逻辑给出
+NEXTALK_EXPORT int32_t nextalk_capture_open_portaudio(
+    NextalkCapture *capture, int32_t device_index, double suggested_latency);
+
+// 启动/停止采集线程
+NEXTALK_EXPORT int32_t nextalk_capture_start(NextalkCapture *capture);
+NEXTALK_EXPORT void nextalk_capture_stop(NextalkCapture *capture);
+
+// 非阻塞读取，返回实际读取帧数 (可能为 0)，采集线程出错时返回错误码
+NEXTALK_EXPORT int32_t nextalk_capture_read(NextalkCapture *capture,
+                                            float *dst, int32_t max_frames);
+
+// 同 nextalk_capture_read，并通过 capture_time_ns 返回所读首帧的采集时刻
+// (nextalk_capture_clock_ns 时钟，已扣除音频服务器与设备延迟；未知时为 -1)
+NEXTALK_EXPORT int32_t nextalk_capture_read_timestamped(NextalkCapture *capture,
+                                                        float *dst,
+                                                        int32_t max_frames,
+                                                        int64_t *capture_time_ns);
+
+// 采集时间戳所用的单调时钟 (纳秒)
+NEXTALK_EXPORT int64_t nextalk_capture_clock_ns(void);
+
+// 当前可读帧数
+NEXTALK_EXPORT int32_t nextalk_capture_available(NextalkCapture *capture);
+
+// 读取最近一块的电平与累计能量 (两次调用的 energy/frames 之差即区间平均能量)
+NEXTALK_EXPORT int32_t nextalk_capture_levels(NextalkCapture *capture,
+                                             NextalkLevels *out);
+
+// 丢弃最旧的数据，只保留最近 keep_frames 帧 (预录模式)，返回丢弃的帧数
+NEXTALK_EXPORT int32_t nextalk_capture_trim(NextalkCapture *capture,
+                                            int32_t keep_frames);
+
+// 设置唤醒回调 (传 NULL 取消)
+NEXTALK_EXPORT void nextalk_capture_set_notify(NextalkCapture *capture,
+                                               nextalk_notify_fn fn);
+
+// 消费者即将等待: 下一次写入后触发一次唤醒回调
+NEXTALK_EXPORT void nextalk_capture_arm_notify(NextalkCapture *capture);
+
+// 同上，但只在可读帧数达到 min_frames 后才唤醒 (按块调度时避免逐 10ms 唤醒)
+NEXTALK_EXPORT void nextalk_capture_arm_notify_at(NextalkCapture *capture,
+                                                  int32_t min_frames);
+
+// 诊断信息
+NEXTALK_EXPORT int32_t nextalk_capture_last_error(NextalkCapture *capture);
+// 把最近的错误信息复制到 buf (截断并以 NUL 结尾)，返回完整长度 (不含 NUL)
+NEXTALK_EXPORT int32_t nextalk_capture_error_text(NextalkCapture *capture,
+                                                  char *buf, int32_t buf_len);
+NEXTALK_EXPORT int64_t nextalk_capture_overruns(NextalkCapture *capture);
+NEXTALK_EXPORT int32_t nextalk_capture_is_realtime(NextalkCapture *capture);
+
+// 音频服务器授予的缓冲延迟 (微秒)，未知时返回 -1
+NEXTALK_EXPORT int64_t nextalk_capture_granted_latency_us(NextalkCapture *capture);
+
+// 实测采集延迟 (微秒)，未知时返回 -1
+NEXTALK_EXPORT int64_t nextalk_capture_latency_us(NextalkCapture *capture);
+
+// 设备侧实际采样率，未知时返回 -1
+NEXTALK_EXPORT int32_t nextalk_capture_device_rate(NextalkCapture *capture);
+
+// 销毁实例 (会先停止采集线程并关闭设备)
+NEXTALK_EXPORT void nextalk_capture_destroy(NextalkCapture *capture);
+
+#endif // _NEXTALK_NATIVE_CAPTURE_H_
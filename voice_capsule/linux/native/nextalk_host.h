@@ -0,0 +1,70 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Nextalk 识别宿主客户端 C API (供 Dart FFI 调用)
+ *
+ * 流式识别器可以放在独立的常驻进程 nextalk_engine_host 中: 宿主按需启动，
+ * 空闲超时后自行退出，已加载的模型在应用重启之间保留，识别崩溃也不会
+ * 带走界面进程。客户端接口与 nextalk_asr.h 的工作线程一致:
+ * 送入音频只是写入共享内存环，结果由宿主推送，按 token 比较后发布增量。
+ */
+
+#ifndef _NEXTALK_NATIVE_HOST_H_
+#define _NEXTALK_NATIVE_HOST_H_
+
+#include "nextalk_asr.h"
+
+// 错误码 (与 Dart 侧 EngineHostWorker 对应)
+enum {
+    NEXTALK_HOST_OK = 0,
+    NEXTALK_HOST_ERR_CONNECT = -1, // 无法连接或启动宿主进程
+    NEXTALK_HOST_ERR_LIBRARY = -2, // 宿主中 libsherpa-onnx-c-api 加载失败
+    NEXTALK_HOST_ERR_MODEL = -3,   // 宿主创建识别器失败
+    NEXTALK_HOST_ERR_STATE = -4,   // 参数或状态错误 (含宿主已断开)
+};
+
+typedef struct NextalkHostClient NextalkHostClient;
+
+// 连接 socket_path 上的宿主，未运行时以 host_exe 启动 (host_exe 可为 NULL，
+// 此时只连接已有宿主)。idle_timeout_sec 为新启动宿主的空闲退出时间，
+// 在 timeout_ms 内连接不上返回 NULL
+NEXTALK_EXPORT NextalkHostClient *nextalk_host_connect(const char *socket_path,
+                                                       const char *host_exe,
+                                                       int32_t idle_timeout_sec,
+                                                       int32_t timeout_ms);
+
+// 在宿主中创建识别器与流 (config 为 key=value 行)，阻塞直到完成或超时
+// 宿主中已有相同模型的识别器时直接复用，端点规则沿用首次加载时的配置
+NEXTALK_EXPORT int32_t nextalk_host_load(NextalkHostClient *client,
+                                         const char *config,
+                                         int32_t timeout_ms);
+
+// 最近一次 load 的耗时 (纳秒) 与是否复用了已加载的模型
+NEXTALK_EXPORT int64_t nextalk_host_load_ns(NextalkHostClient *client);
+NEXTALK_EXPORT int32_t nextalk_host_load_reused(NextalkHostClient *client);
+
+// 最近一条宿主错误信息 (无错误时为空串)
+NEXTALK_EXPORT const char *nextalk_host_error(NextalkHostClient *client);
+
+// 以下与 nextalk_asr_worker_* 语义相同
+NEXTALK_EXPORT int32_t nextalk_host_accept(NextalkHostClient *client,
+                                           const float *samples, int32_t n);
+NEXTALK_EXPORT void nextalk_host_reset(NextalkHostClient *client);
+NEXTALK_EXPORT int32_t nextalk_host_finish(NextalkHostClient *client,
+                                           int32_t timeout_ms);
+NEXTALK_EXPORT int32_t nextalk_host_drained(NextalkHostClient *client);
+NEXTALK_EXPORT int64_t nextalk_host_generation(NextalkHostClient *client);
+NEXTALK_EXPORT int32_t nextalk_host_take_update(NextalkHostClient *client,
+                                                NextalkAsrUpdate *out);
+NEXTALK_EXPORT int32_t nextalk_host_is_endpoint(NextalkHostClient *client);
+NEXTALK_EXPORT int64_t nextalk_host_decode_ns(NextalkHostClient *client);
+NEXTALK_EXPORT int64_t nextalk_host_decoded_frames(NextalkHostClient *client);
+
+// 与宿主的连接是否仍然有效 (宿主退出或崩溃后为 0)
+NEXTALK_EXPORT int32_t nextalk_host_alive(NextalkHostClient *client);
+
+// 断开连接 (宿主中的模型保留到空闲超时)
+NEXTALK_EXPORT void nextalk_host_disconnect(NextalkHostClient *client);
+
+#endif // _NEXTALK_NATIVE_HOST_H_
@@ -0,0 +1,36 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Nextalk 模型内存驻留 C API (供 Dart FFI 调用)
+ *
+ * 空闲卸载识别模型后，onnxruntime 释放的内存多留在 glibc 的空闲链表中，
+ * RSS 并不下降，需要显式归还给系统。重新加载前提示内核预读模型文件，
+ * 让磁盘读取与识别器创建并行。登录后则以空闲 I/O 优先级把模型文件
+ * 整个读入页缓存，首次录音不必再从磁盘冷读。
+ */
+
+#ifndef _NEXTALK_NATIVE_MEMORY_H_
+#define _NEXTALK_NATIVE_MEMORY_H_
+
+#include "nextalk_capture.h"
+
+// 把 malloc 空闲内存归还给系统 (malloc_trim)，有内存被归还时返回 1
+NEXTALK_EXPORT int32_t nextalk_memory_trim(void);
+
+// 提示内核把 path 整个读入页缓存 (posix_fadvise WILLNEED，立即返回)
+// 返回文件大小 (字节)，失败返回 -errno
+NEXTALK_EXPORT int64_t nextalk_memory_prefetch(const char *path);
+
+// path 当前在页缓存中的字节数 (mincore)，失败返回 -errno
+NEXTALK_EXPORT int64_t nextalk_memory_resident(const char *path);
+
+// 在独立线程中以空闲 I/O 优先级 (IOPRIO_CLASS_IDLE) 把 paths 读入页缓存，
+// 阻塞到全部完成 (应在后台调用)。已全部缓存的文件直接跳过，打不开的文件忽略
+// resident_before 写入读取前已在页缓存中的字节数 (可为 NULL)
+// 返回可读文件的总字节数
+NEXTALK_EXPORT int64_t nextalk_memory_prewarm(const char *const *paths,
+                                              int32_t count,
+                                              int64_t *resident_before);
+
+#endif // _NEXTALK_NATIVE_MEMORY_H_
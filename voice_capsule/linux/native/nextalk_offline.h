@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Nextalk 离线识别后台解码 C API (供 Dart FFI 调用)
+ *
+ * sherpa-onnx 离线识别器 (SenseVoice) 由 Dart 侧创建并继续持有，
+ * 这里只在后台线程上为提交的音频创建离线流并解码，UI isolate 不等待
+ * DecodeOfflineStream。两类请求:
+ * - 中间解码 (partial): 尚未结束的语音段，同一时刻最多解码一段，
+ *   尚未开始的旧请求会被新请求替换
+ * - 语音段解码 (segment): 已结束的语音段，由线程池并发解码，
+ *   可多段合批一次解码，结果按提交顺序读取
+ */
+
+#ifndef _NEXTALK_NATIVE_OFFLINE_H_
+#define _NEXTALK_NATIVE_OFFLINE_H_
+
+#include "nextalk_capture.h"
+
+// 错误码 (与 Dart 侧 NativeOfflineDecoder 对应)
+enum {
+    NEXTALK_OFFLINE_OK = 0,
+    NEXTALK_OFFLINE_ERR_LIBRARY = -1, // libsherpa-onnx-c-api 加载失败
+    NEXTALK_OFFLINE_ERR_STATE = -2,   // 参数或状态错误
+};
+
+typedef struct NextalkOfflineDecoder NextalkOfflineDecoder;
+
+// 一次解码的结果
+typedef struct NextalkOfflineResult {
+    int64_t tag;               // 提交时的标签
+    int64_t decode_ns;         // 解码耗时 (纳秒)
+    int32_t samples;           // 解码的样本数
+    int32_t count;             // tokens/timestamps 的长度
+    const char *text;          // 识别文本
+    const char *lang;          // 语言标识 (可能为空串)
+    const char *emotion;       // 情感标识 (可能为空串)
+    const char *const *tokens; // token 列表
+    const float *timestamps;   // 对应 token 的时间戳 (秒)
+    int32_t batch;             // 同批解码的语音段数 (中间解码为 1)
+    int32_t token_bytes;       // token_data 的字节数
+    const char *token_data;    // '\0' 分隔的全部 token (与 tokens 同一块内存)
+    int32_t allocs;            // 解码器为本结果新分配堆内存的次数 (复用时为 0)
+} NextalkOfflineResult;
+
+// 创建后台解码线程与 segment_threads 个语音段解码线程 (1-16)
+// recognizer 为 SherpaOnnxOfflineRecognizer 指针
+// 失败返回 NULL，此时调用方在本线程同步解码
+NEXTALK_EXPORT NextalkOfflineDecoder *
+nextalk_offline_decoder_create(void *recognizer, int32_t sample_rate,
+                               int32_t segment_threads);
+
+// 提交一次中间解码 (拷贝音频后立即返回)
+// 尚未开始解码的上一次请求被替换，正在解码的请求不受影响
+NEXTALK_EXPORT int32_t nextalk_offline_decoder_submit_partial(
+    NextalkOfflineDecoder *decoder, int64_t tag, const float *samples,
+    int32_t n);
+
+// 丢弃尚未开始的中间解码请求与尚未读取的结果
+NEXTALK_EXPORT void
+nextalk_offline_decoder_cancel_partial(NextalkOfflineDecoder *decoder);
+
+// 是否有中间解码在排队或进行中
+NEXTALK_EXPORT int32_t
+nextalk_offline_decoder_partial_busy(NextalkOfflineDecoder *decoder);
+
+// 取最近完成的中间解码结果，返回 1 表示有新结果
+// out 中的指针在下一次调用本函数之前有效
+NEXTALK_EXPORT int32_t nextalk_offline_decoder_take_partial(
+    NextalkOfflineDecoder *decoder, NextalkOfflineResult *out);
+
+// 提交一个已结束的语音段 (拷贝音频后立即返回)，返回其序号 (从 0 递增)
+// 参数错误返回 NEXTALK_OFFLINE_ERR_STATE
+NEXTALK_EXPORT int64_t nextalk_offline_decoder_submit_segment(
+    NextalkOfflineDecoder *decoder, const float *samples, int32_t n);
+
+// 设置语音段合批: 每批最多 max_segments 段 (1-32，1 表示逐段解码)、
+// 总计最多 max_samples 个样本 (0 表示不限，单段超出时单独成批)；
+// 不足一批时最多等待 wait_ms 毫秒 (从队首语音段提交时算起)，
+// 调用 wait_segments 时不再等待
+NEXTALK_EXPORT void nextalk_offline_decoder_set_segment_batch(
+    NextalkOfflineDecoder *decoder, int32_t max_segments, int32_t max_samples,
+    int32_t wait_ms);
+
+// 按提交顺序取下一个已解码的语音段，返回 1 表示取到 (out->tag 为序号)
+// 前面的语音段尚未解码完时返回 0；out 中的指针在下一次调用本函数之前有效
+NEXTALK_EXPORT int32_t nextalk_offline_decoder_take_segment(
+    NextalkOfflineDecoder *decoder, NextalkOfflineResult *out);
+
+// 尚未被读取的语音段数 (排队、解码中或已解码未读取)
+NEXTALK_EXPORT int32_t
+nextalk_offline_decoder_pending_segments(NextalkOfflineDecoder *decoder);
+
+// 等待已提交的语音段全部解码完成，返回 1 表示在 timeout_ms 内完成
+NEXTALK_EXPORT int32_t nextalk_offline_decoder_wait_segments(
+    NextalkOfflineDecoder *decoder, int32_t timeout_ms);
+
+// 丢弃全部未读取的语音段 (正在解码的完成后直接丢弃)
+NEXTALK_EXPORT void
+nextalk_offline_decoder_cancel_segments(NextalkOfflineDecoder *decoder);
+
+// 停止并销毁后台线程 (等待进行中的解码结束)，recognizer 交还调用方
+NEXTALK_EXPORT void
+nextalk_offline_decoder_destroy(NextalkOfflineDecoder *decoder);
+
+#endif // _NEXTALK_NATIVE_OFFLINE_H_
@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Nextalk ONNX Runtime 优化模型缓存 C API (供 Dart FFI 调用)
+ *
+ * sherpa-onnx 每次创建识别器都要解析 ONNX 文件并做图优化。这里用同一个
+ * libonnxruntime 把模型优化后另存为 ORT 格式，之后把缓存文件交给 sherpa
+ * (onnxruntime 按文件内容识别 ORT 格式)，省去解析与大部分优化。
+ * 优化结果与 onnxruntime 版本和 CPU 指令集有关，缓存按二者区分。
+ */
+
+#ifndef _NEXTALK_NATIVE_ORT_H_
+#define _NEXTALK_NATIVE_ORT_H_
+
+#include "nextalk_capture.h"
+
+// 错误码 (与 Dart 侧 OrtModelCache 对应)
+enum {
+    NEXTALK_ORT_OK = 0,
+    NEXTALK_ORT_ERR_LIBRARY = -1, // libonnxruntime 加载失败
+    NEXTALK_ORT_ERR_MODEL = -2,   // 模型加载或优化失败
+    NEXTALK_ORT_ERR_IO = -3,      // 写入缓存文件失败
+};
+
+// onnxruntime 版本 (如 "1.17.1")，库不可用时为空串
+NEXTALK_EXPORT const char *nextalk_ort_version(void);
+
+// 影响优化结果与 int8/fp32 选择的 CPU 特性 (如 "x86_64+avx2+fma+avxvnni")
+NEXTALK_EXPORT const char *nextalk_ort_cpu_features(void);
+
+// onnxruntime 可用的执行提供者，逗号分隔 (如 "XnnpackExecutionProvider,CPUExecutionProvider")
+// 库不可用时为空串
+NEXTALK_EXPORT const char *nextalk_ort_providers(void);
+
+// 优化 src 并以 ORT 格式写入 dst (须以 .ort 结尾)，写入后重新加载校验
+// 先写临时文件再改名，dst 要么完整可用要么不存在；耗时与一次模型加载相当
+// 失败时 error 中写入 onnxruntime 的错误信息 (可为 NULL)
+NEXTALK_EXPORT int32_t nextalk_ort_optimize(const char *src, const char *dst,
+                                            char *error, int32_t error_len);
+
+#endif // _NEXTALK_NATIVE_ORT_H_
@@ -0,0 +1,682 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 离线识别后台解码
+ *
+ * 中间解码请求只保留最新一个: 语音段在增长，旧请求解码出来也会立即被
+ * 新请求的结果覆盖，排队只会拖慢首个可见结果。
+ * 已结束的语音段由线程池并发解码 (识别器的解码可并发调用，每段使用
+ * 独立的离线流)，完成的结果按序号暂存，读取方只能按提交顺序取走，
+ * 拼接出的文本与逐段同步解码一致。
+ * 语音段可合批解码: 工作线程一次取走多个排队的语音段，用一次
+ * DecodeMultipleOfflineStreams 调用完成，编码器按批计算更充分地利用
+ * 矩阵运算。合批受段数与总样本数限制，不足一批时最多等待 batchWaitMs。
+ * 结果拷贝为自有内存后立即释放 sherpa 的结果与流，读取方取到的指针由
+ * 解码器持有。
+ * sherpa 的离线流只能送入一次音频且没有重置接口，每段仍需新建；
+ * 这一侧的缓冲全部复用: 结果 (含 '\0' 分隔的 token)、语音段音频拷贝与
+ * 暂存结果的 map 节点读取后回收，稳态下每段不再有堆分配。
+ * libsherpa-onnx-c-api 已由 Dart 侧加载，这里按同名 dlopen 取得同一实例。
+ */
+
+#include "dynlib.h"
+#include "nextalk_offline.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// sherpa-onnx C API 中用到的部分 (对象均为不透明指针)
+struct SherpaOfflineRecognizer;
+struct SherpaOfflineStream;
+
+// 与 sherpa-onnx c-api.h 中 SherpaOnnxOfflineRecognizerResult 的前缀布局一致
+struct SherpaOfflineResult {
+    const char *text;
+    float *timestamps;
+    int32_t count;
+    const char *tokens;
+    const char *const *tokensArr;
+    const char *json;
+    const char *lang;
+    const char *emotion;
+};
+
+struct SherpaOfflineApi {
+    nextalk::DynLib lib{"libsherpa-onnx-c-api.so"};
+    const SherpaOfflineStream *(*createStream)(
+        const SherpaOfflineRecognizer *) = nullptr;
+    void (*destroyStream)(const SherpaOfflineStream *) = nullptr;
+    void (*acceptWaveform)(const SherpaOfflineStream *, int32_t, const float *,
+                           int32_t) = nullptr;
+    void (*decode)(const SherpaOfflineRecognizer *,
+                   const SherpaOfflineStream *) = nullptr;
+    void (*decodeMultiple)(const SherpaOfflineRecognizer *,
+                           const SherpaOfflineStream **, int32_t) = nullptr;
+    const SherpaOfflineResult *(*result)(const SherpaOfflineStream *) = nullptr;
+    void (*destroyResult)(const SherpaOfflineResult *) = nullptr;
+
+    bool load() {
+        return lib.bind(createStream, "SherpaOnnxCreateOfflineStream") &&
+               lib.bind(destroyStream, "SherpaOnnxDestroyOfflineStream") &&
+               lib.bind(acceptWaveform, "SherpaOnnxAcceptWaveformOffline") &&
+               lib.bind(decode, "SherpaOnnxDecodeOfflineStream") &&
+               lib.bind(decodeMultiple, "SherpaOnnxDecodeMultipleOfflineStreams") &&
+               lib.bind(result, "SherpaOnnxGetOfflineStreamResult") &&
+               lib.bind(destroyResult, "SherpaOnnxDestroyOfflineRecognizerResult");
+    }
+};
+
+// 进程内只加载一次 (与 Dart 侧共享同一个库实例)
+const SherpaOfflineApi *sherpaOfflineApi() {
+    static SherpaOfflineApi *api = [] {
+        auto *loaded = new SherpaOfflineApi();
+        if (!loaded->load()) {
+            delete loaded;
+            return static_cast<SherpaOfflineApi *>(nullptr);
+        }
+        return loaded;
+    }();
+    return api;
+}
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// 一次解码的结果 (自有内存，复用时保留已分配的容量)
+struct Decoded {
+    int64_t tag = 0;
+    int64_t decodeNs = 0;
+    int32_t samples = 0;
+    int32_t batch = 1;
+    int32_t count = 0;  // token 数
+    int32_t allocs = 0; // 得到本结果时新分配堆内存的次数
+    std::string text;
+    std::string lang;
+    std::string emotion;
+    std::string tokenData; // '\0' 分隔的 token
+    std::vector<float> timestamps;
+
+    void reset(int64_t newTag, int32_t n, int32_t batchSize) {
+        tag = newTag;
+        decodeNs = 0;
+        samples = n;
+        batch = batchSize;
+        count = 0;
+        allocs = 0;
+        text.clear();
+        lang.clear();
+        emotion.clear();
+        tokenData.clear();
+        timestamps.clear();
+    }
+};
+
+// 拷贝 [first, last) 到 dst，容量不足需要重新分配时计数
+template <typename Dst, typename T>
+void assignCounted(Dst &dst, const T *first, const T *last, int32_t &allocs) {
+    if (static_cast<size_t>(last - first) > dst.capacity()) {
+        ++allocs;
+    }
+    dst.assign(first, last);
+}
+
+void assignCounted(std::string &dst, const char *s, int32_t &allocs) {
+    if (!s) {
+        dst.clear();
+        return;
+    }
+    assignCounted(dst, s, s + std::strlen(s), allocs);
+}
+
+// 把已解码离线流的结果拷贝到 out
+void readResult(const SherpaOfflineApi &api, const SherpaOfflineStream *stream,
+                Decoded &out) {
+    const SherpaOfflineResult *r = api.result(stream);
+    if (!r) {
+        return;
+    }
+    assignCounted(out.text, r->text, out.allocs);
+    assignCounted(out.lang, r->lang, out.allocs);
+    assignCounted(out.emotion, r->emotion, out.allocs);
+
+    const int32_t count = r->tokensArr ? r->count : 0;
+    size_t bytes = 0;
+    for (int32_t i = 0; i < count; ++i) {
+        bytes += (r->tokensArr[i] ? std::strlen(r->tokensArr[i]) : 0) + 1;
+    }
+    if (bytes > out.tokenData.capacity()) {
+        ++out.allocs;
+        out.tokenData.reserve(bytes);
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        if (r->tokensArr[i]) {
+            out.tokenData.append(r->tokensArr[i]);
+        }
+        out.tokenData.push_back('\0');
+    }
+    out.count = count;
+    if (r->timestamps && count > 0) {
+        assignCounted(out.timestamps, r->timestamps, r->timestamps + count,
+                      out.allocs);
+    }
+    api.destroyResult(r);
+}
+
+// 为一段音频创建离线流并解码，结果写入 out
+void decodeSamples(const SherpaOfflineApi &api,
+                   const SherpaOfflineRecognizer *recognizer,
+                   int32_t sampleRate, int64_t tag, const float *samples,
+                   int32_t n, Decoded &out) {
+    out.reset(tag, n, 1);
+
+    const int64_t start = nowNs();
+    const SherpaOfflineStream *stream = api.createStream(recognizer);
+    if (!stream) {
+        return;
+    }
+    api.acceptWaveform(stream, sampleRate, samples, n);
+    api.decode(recognizer, stream);
+    readResult(api, stream, out);
+    api.destroyStream(stream);
+    out.decodeNs = nowNs() - start;
+}
+
+// 一个待解码的语音段
+struct SegmentJob {
+    int64_t seq = 0;
+    std::vector<float> samples;
+    std::chrono::steady_clock::time_point submitted;
+    int32_t allocs = 0; // 提交与暂存时新分配堆内存的次数
+};
+
+// 为每个语音段创建离线流，一次调用合批解码，结果写入 out[i]
+// 每段的 decodeNs 为整批耗时；streams 为调用方复用的临时数组
+void decodeBatch(const SherpaOfflineApi &api,
+                 const SherpaOfflineRecognizer *recognizer, int32_t sampleRate,
+                 const std::vector<SegmentJob> &jobs,
+                 const std::vector<Decoded *> &out,
+                 std::vector<const SherpaOfflineStream *> &streams) {
+    if (jobs.size() == 1) {
+        decodeSamples(api, recognizer, sampleRate, jobs[0].seq,
+                      jobs[0].samples.data(),
+                      static_cast<int32_t>(jobs[0].samples.size()), *out[0]);
+        return;
+    }
+
+    const int64_t start = nowNs();
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        out[i]->reset(jobs[i].seq, static_cast<int32_t>(jobs[i].samples.size()),
+                      static_cast<int32_t>(jobs.size()));
+    }
+    // 创建流失败时只解码已创建的部分，其余语音段结果为空
+    streams.clear();
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const SherpaOfflineStream *stream = api.createStream(recognizer);
+        if (!stream) {
+            break;
+        }
+        api.acceptWaveform(stream, sampleRate, jobs[i].samples.data(),
+                           out[i]->samples);
+        streams.push_back(stream);
+    }
+
+    if (!streams.empty()) {
+        api.decodeMultiple(recognizer, streams.data(),
+                           static_cast<int32_t>(streams.size()));
+    }
+    for (size_t i = 0; i < streams.size(); ++i) {
+        readResult(api, streams[i], *out[i]);
+        api.destroyStream(streams[i]);
+    }
+
+    const int64_t elapsed = nowNs() - start;
+    for (Decoded *d : out) {
+        d->decodeNs = elapsed;
+    }
+}
+
+// 填充读取方的输出结构，token 指针数组存放在 tokenPtrs 中
+void fillResult(const Decoded &d, std::vector<const char *> &tokenPtrs,
+                NextalkOfflineResult *out) {
+    tokenPtrs.clear();
+    const char *token = d.tokenData.data();
+    for (int32_t i = 0; i < d.count; ++i) {
+        tokenPtrs.push_back(token);
+        token += std::strlen(token) + 1;
+    }
+    out->tag = d.tag;
+    out->decode_ns = d.decodeNs;
+    out->samples = d.samples;
+    out->count = d.count;
+    out->text = d.text.c_str();
+    out->lang = d.lang.c_str();
+    out->emotion = d.emotion.c_str();
+    out->tokens = tokenPtrs.data();
+    out->timestamps = static_cast<int32_t>(d.timestamps.size()) == d.count
+                          ? d.timestamps.data()
+                          : nullptr;
+    out->batch = d.batch;
+    out->token_bytes = static_cast<int32_t>(d.tokenData.size());
+    out->token_data = d.tokenData.data();
+    out->allocs = d.allocs;
+}
+
+using DoneMap = std::map<int64_t, Decoded>;
+
+// 新建一个 map 节点 (一次堆分配)，之后在 segmentDone 与回收池之间复用
+DoneMap::node_type newDoneNode() {
+    DoneMap scratch;
+    scratch.emplace(0, Decoded{});
+    return scratch.extract(scratch.begin());
+}
+
+constexpr int32_t kMaxSegmentThreads = 16;
+constexpr int32_t kMaxSegmentBatch = 32;
+// 回收池上限: 语音段音频最长可达数百 KB，不无限保留
+constexpr size_t kMaxSpareSegments = 8;
+
+} // namespace
+
+struct NextalkOfflineDecoder {
+    NextalkOfflineDecoder(const SherpaOfflineApi &sherpa, void *rec,
+                          int32_t rate)
+        : api(sherpa),
+          recognizer(static_cast<const SherpaOfflineRecognizer *>(rec)),
+          sampleRate(rate) {}
+
+    const SherpaOfflineApi &api;
+    const SherpaOfflineRecognizer *recognizer;
+    int32_t sampleRate;
+
+    std::thread thread;
+    std::vector<std::thread> segmentThreads;
+
+    // 以下由 mutex 保护
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+    bool hasRequest = false; // 排队中的中间解码请求
+    int64_t requestTag = 0;
+    std::vector<float> request;
+    bool decoding = false;
+    bool hasResult = false; // 尚未读取的结果
+    Decoded result;
+
+    // 语音段线程池 (同样由 mutex 保护)
+    std::condition_variable segmentCv;     // 有新语音段
+    std::condition_variable segmentDoneCv; // 有语音段解码完成
+    std::deque<SegmentJob> segmentQueue;
+    DoneMap segmentDone; // 按序号暂存，等待按序读取
+    std::vector<DoneMap::node_type> spareNodes;   // 已读取结果的节点
+    std::vector<std::vector<float>> spareSamples; // 已解码语音段的音频缓冲
+    int64_t nextSegmentSeq = 0;             // 下一个提交的序号
+    int64_t nextDeliverSeq = 0;             // 下一个交给读取方的序号
+    int32_t segmentsDecoding = 0;
+    int32_t segmentWaiters = 0; // wait_segments 调用方数，有人等待时不再攒批
+    int32_t batchMaxSegments = 1;
+    int64_t batchMaxSamples = 0; // 0 表示不限
+    int32_t batchWaitMs = 0;
+
+    // 读取方持有的输出缓冲 (仅读取方线程访问)
+    Decoded taken;
+    std::vector<const char *> takenTokens;
+    Decoded takenSegment;
+    std::vector<const char *> takenSegmentTokens;
+
+    // 回收节点与音频缓冲 (调用时持有 mutex)
+    void recycle(DoneMap::node_type node) {
+        if (spareNodes.size() < kMaxSpareSegments) {
+            spareNodes.push_back(std::move(node));
+        }
+    }
+
+    void recycle(std::vector<float> samples) {
+        if (spareSamples.size() < kMaxSpareSegments) {
+            spareSamples.push_back(std::move(samples));
+        }
+    }
+
+    void run() {
+        pthread_setname_np(pthread_self(), "nextalk-offline");
+        std::vector<float> samples;
+        Decoded decoded;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            cv.wait(lock, [this] { return stopping || hasRequest; });
+            if (stopping) {
+                return;
+            }
+            const int64_t tag = requestTag;
+            samples.swap(request);
+            hasRequest = false;
+            decoding = true;
+            lock.unlock();
+
+            decodeSamples(api, recognizer, sampleRate, tag, samples.data(),
+                          static_cast<int32_t>(samples.size()), decoded);
+
+            lock.lock();
+            decoding = false;
+            std::swap(result, decoded);
+            hasResult = true;
+        }
+    }
+
+    // 排队的语音段是否已够一批 (调用时持有 mutex)
+    bool batchFull() const {
+        if (static_cast<int32_t>(segmentQueue.size()) >= batchMaxSegments) {
+            return true;
+        }
+        if (batchMaxSamples <= 0) {
+            return false;
+        }
+        int64_t total = 0;
+        for (const auto &job : segmentQueue) {
+            total += static_cast<int64_t>(job.samples.size());
+        }
+        return total >= batchMaxSamples;
+    }
+
+    // 从队首取出一批语音段，至少一段 (调用时持有 mutex)
+    void popBatch(std::vector<SegmentJob> &batch) {
+        batch.clear();
+        int64_t total = 0;
+        while (!segmentQueue.empty() &&
+               static_cast<int32_t>(batch.size()) < batchMaxSegments) {
+            const auto n =
+                static_cast<int64_t>(segmentQueue.front().samples.size());
+            if (!batch.empty() && batchMaxSamples > 0 &&
+                total + n > batchMaxSamples) {
+                break;
+            }
+            total += n;
+            batch.push_back(std::move(segmentQueue.front()));
+            segmentQueue.pop_front();
+        }
+    }
+
+    void runSegments() {
+        pthread_setname_np(pthread_self(), "nextalk-seg");
+        std::vector<SegmentJob> batch;
+        std::vector<DoneMap::node_type> nodes;
+        std::vector<Decoded *> outputs;
+        std::vector<const SherpaOfflineStream *> streams;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            segmentCv.wait(lock,
+                           [this] { return stopping || !segmentQueue.empty(); });
+            if (stopping) {
+                return;
+            }
+            // 不足一批时等待后续语音段，最多等到队首提交后 batchWaitMs
+            if (batchMaxSegments > 1 && batchWaitMs > 0) {
+                const auto deadline = segmentQueue.front().submitted +
+                                      std::chrono::milliseconds(batchWaitMs);
+                segmentCv.wait_until(lock, deadline, [this] {
+                    return stopping || segmentQueue.empty() ||
+                           segmentWaiters > 0 || batchFull();
+                });
+                if (stopping) {
+                    return;
+                }
+                if (segmentQueue.empty()) {
+                    continue; // 已被其他线程取走
+                }
+            }
+            popBatch(batch);
+            // 每段的结果直接写入 map 节点，优先复用已读取结果的节点
+            nodes.clear();
+            outputs.clear();
+            for (auto &job : batch) {
+                if (!spareNodes.empty()) {
+                    nodes.push_back(std::move(spareNodes.back()));
+                    spareNodes.pop_back();
+                } else {
+                    nodes.push_back(newDoneNode());
+                    ++job.allocs;
+                }
+                outputs.push_back(&nodes.back().mapped());
+            }
+            segmentsDecoding += static_cast<int32_t>(batch.size());
+            lock.unlock();
+
+            decodeBatch(api, recognizer, sampleRate, batch, outputs, streams);
+
+            lock.lock();
+            segmentsDecoding -= static_cast<int32_t>(batch.size());
+            for (size_t i = 0; i < batch.size(); ++i) {
+                nodes[i].mapped().allocs += batch[i].allocs;
+                nodes[i].key() = batch[i].seq;
+                recycle(std::move(batch[i].samples));
+                // 解码期间被取消的语音段直接丢弃
+                if (batch[i].seq >= nextDeliverSeq) {
+                    segmentDone.insert(std::move(nodes[i]));
+                } else {
+                    recycle(std::move(nodes[i]));
+                }
+            }
+            segmentDoneCv.notify_all();
+        }
+    }
+
+    void join() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            segmentQueue.clear();
+        }
+        cv.notify_all();
+        segmentCv.notify_all();
+        segmentDoneCv.notify_all();
+        if (thread.joinable()) {
+            thread.join();
+        }
+        for (auto &t : segmentThreads) {
+            if (t.joinable()) {
+                t.join();
+            }
+        }
+    }
+};
+
+NEXTALK_EXPORT NextalkOfflineDecoder *
+nextalk_offline_decoder_create(void *recognizer, int32_t sample_rate,
+                               int32_t segment_threads) {
+    if (!recognizer || sample_rate <= 0) {
+        return nullptr;
+    }
+    const SherpaOfflineApi *api = sherpaOfflineApi();
+    if (!api) {
+        return nullptr;
+    }
+    auto *decoder = new NextalkOfflineDecoder(*api, recognizer, sample_rate);
+    decoder->thread = std::thread([decoder] { decoder->run(); });
+    const int32_t threads = std::clamp(segment_threads, 1, kMaxSegmentThreads);
+    for (int32_t i = 0; i < threads; ++i) {
+        decoder->segmentThreads.emplace_back(
+            [decoder] { decoder->runSegments(); });
+    }
+    return decoder;
+}
+
+NEXTALK_EXPORT int32_t nextalk_offline_decoder_submit_partial(
+    NextalkOfflineDecoder *decoder, int64_t tag, const float *samples,
+    int32_t n) {
+    if (!decoder || !samples || n <= 0) {
+        return NEXTALK_OFFLINE_ERR_STATE;
+    }
+    {
+        std::lock_guard<std::mutex> lock(decoder->mutex);
+        decoder->request.assign(samples, samples + n);
+        decoder->requestTag = tag;
+        decoder->hasRequest = true;
+    }
+    decoder->cv.notify_one();
+    return NEXTALK_OFFLINE_OK;
+}
+
+NEXTALK_EXPORT void
+nextalk_offline_decoder_cancel_partial(NextalkOfflineDecoder *decoder) {
+    if (!decoder) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(decoder->mutex);
+    decoder->hasRequest = false;
+    decoder->hasResult = false;
+}
+
+NEXTALK_EXPORT int32_t
+nextalk_offline_decoder_partial_busy(NextalkOfflineDecoder *decoder) {
+    if (!decoder) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(decoder->mutex);
+    return decoder->hasRequest || decoder->decoding ? 1 : 0;
+}
+
+NEXTALK_EXPORT int32_t nextalk_offline_decoder_take_partial(
+    NextalkOfflineDecoder *decoder, NextalkOfflineResult *out) {
+    if (!decoder || !out) {
+        return 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(decoder->mutex);
+        if (!decoder->hasResult) {
+            return 0;
+        }
+        std::swap(decoder->taken, decoder->result);
+        decoder->hasResult = false;
+    }
+    fillResult(decoder->taken, decoder->takenTokens, out);
+    return 1;
+}
+
+NEXTALK_EXPORT int64_t nextalk_offline_decoder_submit_segment(
+    NextalkOfflineDecoder *decoder, const float *samples, int32_t n) {
+    if (!decoder || !samples || n <= 0) {
+        return NEXTALK_OFFLINE_ERR_STATE;
+    }
+    int64_t seq;
+    {
+        std::lock_guard<std::mutex> lock(decoder->mutex);
+        seq = decoder->nextSegmentSeq++;
+        SegmentJob job;
+        job.seq = seq;
+        job.submitted = std::chrono::steady_clock::now();
+        if (!decoder->spareSamples.empty()) {
+            job.samples = std::move(decoder->spareSamples.back());
+            decoder->spareSamples.pop_back();
+        }
+        assignCounted(job.samples, samples, samples + n, job.allocs);
+        decoder->segmentQueue.push_back(std::move(job));
+    }
+    decoder->segmentCv.notify_one();
+    return seq;
+}
+
+NEXTALK_EXPORT void nextalk_offline_decoder_set_segment_batch(
+    NextalkOfflineDecoder *decoder, int32_t max_segments, int32_t max_samples,
+    int32_t wait_ms) {
+    if (!decoder) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(decoder->mutex);
+        decoder->batchMaxSegments =
+            std::clamp(max_segments, 1, kMaxSegmentBatch);
+        decoder->batchMaxSamples = std::max(max_samples, 0);
+        decoder->batchWaitMs = std::max(wait_ms, 0);
+    }
+    decoder->segmentCv.notify_all();
+}
+
+NEXTALK_EXPORT int32_t nextalk_offline_decoder_take_segment(
+    NextalkOfflineDecoder *decoder, NextalkOfflineResult *out) {
+    if (!decoder || !out) {
+        return 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(decoder->mutex);
+        auto it = decoder->segmentDone.find(decoder->nextDeliverSeq);
+        if (it == decoder->segmentDone.end()) {
+            return 0;
+        }
+        // 取出节点后与读取方缓冲交换，旧缓冲随节点回收复用
+        auto node = decoder->segmentDone.extract(it);
+        std::swap(decoder->takenSegment, node.mapped());
+        decoder->recycle(std::move(node));
+        ++decoder->nextDeliverSeq;
+    }
+    fillResult(decoder->takenSegment, decoder->takenSegmentTokens, out);
+    return 1;
+}
+
+NEXTALK_EXPORT int32_t
+nextalk_offline_decoder_pending_segments(NextalkOfflineDecoder *decoder) {
+    if (!decoder) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(decoder->mutex);
+    return static_cast<int32_t>(decoder->nextSegmentSeq -
+                                decoder->nextDeliverSeq);
+}
+
+NEXTALK_EXPORT int32_t nextalk_offline_decoder_wait_segments(
+    NextalkOfflineDecoder *decoder, int32_t timeout_ms) {
+    if (!decoder) {
+        return 0;
+    }
+    std::unique_lock<std::mutex> lock(decoder->mutex);
+    // 有人等待时攒批的线程立即开始解码
+    ++decoder->segmentWaiters;
+    decoder->segmentCv.notify_all();
+    const bool done = decoder->segmentDoneCv.wait_for(
+        lock, std::chrono::milliseconds(timeout_ms), [decoder] {
+            return decoder->stopping || (decoder->segmentQueue.empty() &&
+                                         decoder->segmentsDecoding == 0);
+        });
+    --decoder->segmentWaiters;
+    return done ? 1 : 0;
+}
+
+NEXTALK_EXPORT void
+nextalk_offline_decoder_cancel_segments(NextalkOfflineDecoder *decoder) {
+    if (!decoder) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(decoder->mutex);
+    for (auto &job : decoder->segmentQueue) {
+        decoder->recycle(std::move(job.samples));
+    }
+    decoder->segmentQueue.clear();
+    while (!decoder->segmentDone.empty()) {
+        decoder->recycle(
+            decoder->segmentDone.extract(decoder->segmentDone.begin()));
+    }
+    decoder->nextDeliverSeq = decoder->nextSegmentSeq;
+}
+
+NEXTALK_EXPORT void
+nextalk_offline_decoder_destroy(NextalkOfflineDecoder *decoder) {
+    if (!decoder) {
+        return;
+    }
+    decoder->join();
+    delete decoder;
+}
@@ -0,0 +1,248 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * ONNX Runtime 优化模型缓存
+ *
+ * 创建会话时设置 SetOptimizedModelFilePath，onnxruntime 在完成图优化后
+ * 把结果写入该文件，扩展名为 .ort 时写为 ORT 格式 (保留模型元数据，
+ * sherpa 依赖其中的 vocab_size 等字段)。写入后在同一进程中重新加载一次，
+ * 能加载的缓存才改名为正式文件，sherpa 遇到损坏的模型会直接终止进程。
+ * 优化级别为 ORT_ENABLE_ALL，结果可能含与 CPU 指令集相关的算子布局，
+ * 因此缓存键包含 CPU 特性。
+ * libonnxruntime 已随 sherpa-onnx 加载，这里按同名 dlopen 取得同一实例。
+ */
+
+#include "dynlib.h"
+#include "nextalk_ort.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#elif defined(__aarch64__)
+#include <sys/auxv.h>
+#endif
+
+namespace {
+
+// onnxruntime C API 中用到的部分 (对象均为不透明指针)
+struct OrtStatus;
+struct OrtEnv;
+struct OrtSession;
+struct OrtSessionOptions;
+
+constexpr int kOrtLoggingLevelError = 3;
+constexpr int kOrtEnableAll = 99;
+
+// 只请求第 3 版 API: 用到的函数都在其中，表的前缀布局此后不再变化
+constexpr uint32_t kOrtApiVersion = 3;
+
+// 与 onnxruntime_c_api.h 中 OrtApi 的前缀布局一致 (按声明顺序编号)
+struct OrtApi {
+    OrtStatus *(*CreateStatus)(int code, const char *msg);           // 0
+    int (*GetErrorCode)(const OrtStatus *status);                    // 1
+    const char *(*GetErrorMessage)(const OrtStatus *status);         // 2
+    OrtStatus *(*CreateEnv)(int level, const char *logid, OrtEnv **out); // 3
+    void *unused4[3];
+    OrtStatus *(*CreateSession)(const OrtEnv *env, const char *path,
+                                const OrtSessionOptions *options,
+                                OrtSession **out); // 7
+    void *unused8[2];
+    OrtStatus *(*CreateSessionOptions)(OrtSessionOptions **out); // 10
+    OrtStatus *(*SetOptimizedModelFilePath)(OrtSessionOptions *options,
+                                            const char *path); // 11
+    void *unused12[11];
+    OrtStatus *(*SetSessionGraphOptimizationLevel)(OrtSessionOptions *options,
+                                                   int level); // 23
+    OrtStatus *(*SetIntraOpNumThreads)(OrtSessionOptions *options,
+                                       int threads); // 24
+    void *unused25[67];
+    void (*ReleaseEnv)(OrtEnv *env);         // 92
+    void (*ReleaseStatus)(OrtStatus *status); // 93
+    void *unused94;
+    void (*ReleaseSession)(OrtSession *session); // 95
+    void *unused96[4];
+    void (*ReleaseSessionOptions)(OrtSessionOptions *options); // 100
+    void *unused101[24];
+    OrtStatus *(*GetAvailableProviders)(char ***out, int *length); // 125
+    OrtStatus *(*ReleaseAvailableProviders)(char **ptr, int length); // 126
+};
+
+struct OrtApiBase {
+    const OrtApi *(*GetApi)(uint32_t version);
+    const char *(*GetVersionString)();
+};
+
+struct OrtLib {
+    nextalk::DynLib lib{"libonnxruntime.so", "libonnxruntime.so.1"};
+    const OrtApi *api = nullptr;
+    std::string version;
+
+    OrtLib() {
+        const OrtApiBase *(*getApiBase)() = nullptr;
+        if (!lib.bind(getApiBase, "OrtGetApiBase")) {
+            return;
+        }
+        const OrtApiBase *base = getApiBase();
+        if (!base) {
+            return;
+        }
+        api = base->GetApi(kOrtApiVersion);
+        const char *v = base->GetVersionString();
+        version = v ? v : "";
+    }
+};
+
+OrtLib &ortLib() {
+    static OrtLib lib;
+    return lib;
+}
+
+std::string detectCpuFeatures() {
+#if defined(__x86_64__)
+    std::string features = "x86_64";
+    __builtin_cpu_init();
+    // 影响 onnxruntime CPU 内核选择的指令集
+    if (__builtin_cpu_supports("avx2")) features += "+avx2";
+    if (__builtin_cpu_supports("fma")) features += "+fma";
+    if (__builtin_cpu_supports("avx512f")) features += "+avx512f";
+    if (__builtin_cpu_supports("avx512bw")) features += "+avx512bw";
+    if (__builtin_cpu_supports("avx512vnni")) features += "+avx512vnni";
+    // int8 点积与矩阵指令 (旧版 GCC 的 __builtin_cpu_supports 不认识，直接查 cpuid)
+    // AVX 系指令需要操作系统保存 YMM 状态，AVX2 不可用时一并忽略
+    unsigned eax, ebx, ecx, edx;
+    if (__builtin_cpu_supports("avx2") && __get_cpuid_count(7, 1, &eax, &ebx, &ecx, &edx) &&
+        (eax & (1U << 4))) {
+        features += "+avxvnni";
+    }
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (edx & (1U << 25))) {
+        features += "+amxint8";
+    }
+    return features;
+#elif defined(__aarch64__)
+    std::string features = "aarch64";
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    if (hwcap & (1UL << 20)) features += "+asimddp"; // HWCAP_ASIMDDP
+    if (hwcap & (1UL << 22)) features += "+sve";     // HWCAP_SVE
+    const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+    if (hwcap2 & (1UL << 13)) features += "+i8mm";   // HWCAP2_I8MM
+    return features;
+#else
+    return "generic";
+#endif
+}
+
+// 消费 status: 成功返回 true，失败时把错误信息写入 error
+bool ok(const OrtApi *api, OrtStatus *status, char *error, int32_t errorLen) {
+    if (!status) {
+        return true;
+    }
+    if (error && errorLen > 0) {
+        const char *msg = api->GetErrorMessage(status);
+        std::snprintf(error, static_cast<size_t>(errorLen), "%s",
+                      msg ? msg : "");
+    }
+    api->ReleaseStatus(status);
+    return false;
+}
+
+// 以 path 创建一次会话 (optimizedPath 非空时同时写出优化结果)
+bool loadOnce(const OrtApi *api, OrtEnv *env, const char *path,
+              const char *optimizedPath, char *error, int32_t errorLen) {
+    OrtSessionOptions *options = nullptr;
+    if (!ok(api, api->CreateSessionOptions(&options), error, errorLen)) {
+        return false;
+    }
+    OrtSession *session = nullptr;
+    const bool loaded =
+        ok(api, api->SetIntraOpNumThreads(options, 1), error, errorLen) &&
+        ok(api, api->SetSessionGraphOptimizationLevel(options, kOrtEnableAll),
+           error, errorLen) &&
+        (!optimizedPath ||
+         ok(api, api->SetOptimizedModelFilePath(options, optimizedPath), error,
+            errorLen)) &&
+        ok(api, api->CreateSession(env, path, options, &session), error,
+           errorLen);
+    if (session) {
+        api->ReleaseSession(session);
+    }
+    api->ReleaseSessionOptions(options);
+    return loaded;
+}
+
+} // namespace
+
+NEXTALK_EXPORT const char *nextalk_ort_version(void) {
+    return ortLib().version.c_str();
+}
+
+NEXTALK_EXPORT const char *nextalk_ort_cpu_features(void) {
+    static const std::string features = detectCpuFeatures();
+    return features.c_str();
+}
+
+NEXTALK_EXPORT const char *nextalk_ort_providers(void) {
+    static const std::string providers = [] {
+        std::string list;
+        const OrtApi *api = ortLib().api;
+        char **names = nullptr;
+        int count = 0;
+        if (!api || !ok(api, api->GetAvailableProviders(&names, &count), nullptr, 0)) {
+            return list;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (!list.empty()) {
+                list += ',';
+            }
+            list += names[i];
+        }
+        ok(api, api->ReleaseAvailableProviders(names, count), nullptr, 0);
+        return list;
+    }();
+    return providers.c_str();
+}
+
+NEXTALK_EXPORT int32_t nextalk_ort_optimize(const char *src, const char *dst,
+                                            char *error, int32_t error_len) {
+    if (error && error_len > 0) {
+        error[0] = '\0';
+    }
+    const OrtApi *api = ortLib().api;
+    if (!api) {
+        return NEXTALK_ORT_ERR_LIBRARY;
+    }
+    if (!src || !dst) {
+        return NEXTALK_ORT_ERR_MODEL;
+    }
+
+    OrtEnv *env = nullptr;
+    if (!ok(api, api->CreateEnv(kOrtLoggingLevelError, "nextalk-ort-cache", &env),
+            error, error_len)) {
+        return NEXTALK_ORT_ERR_LIBRARY;
+    }
+
+    // 扩展名决定写出格式，临时文件同样以 .ort 结尾
+    const std::string tmp = std::string(dst) + ".part.ort";
+    std::remove(tmp.c_str());
+    int32_t rc = NEXTALK_ORT_OK;
+    if (!loadOnce(api, env, src, tmp.c_str(), error, error_len)) {
+        rc = NEXTALK_ORT_ERR_MODEL;
+    } else if (!loadOnce(api, env, tmp.c_str(), nullptr, error, error_len)) {
+        rc = NEXTALK_ORT_ERR_MODEL;
+    } else if (std::rename(tmp.c_str(), dst) != 0) {
+        if (error && error_len > 0) {
+            std::snprintf(error, static_cast<size_t>(error_len), "rename: %s",
+                          std::strerror(errno));
+        }
+        rc = NEXTALK_ORT_ERR_IO;
+    }
+    if (rc != NEXTALK_ORT_OK) {
+        std::remove(tmp.c_str());
+    }
+    api->ReleaseEnv(env);
+    return rc;
+}
@@ -0,0 +1,249 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * PortAudio 采集后端 (libpulse 不可用时的回退)
+ *
+ * 设备索引由 Dart 侧 AudioCapture._resolveDeviceIndex 解析后传入。
+ * 与 Dart 侧 DynamicLibrary.open 加载的是同一个 libportaudio 实例，
+ * Pa_Initialize/Pa_Terminate 为引用计数，两侧各自配对调用即可。
+ * 启用 deviceNative 时以设备默认采样率打开 (ALSA 设备多为 44.1/48kHz)，
+ * 由 FormatConverter 重采样，避免 PortAudio/ALSA plug 层的低质量转换。
+ */
+
+#include "audio_convert.h"
+#include "capture_backend.h"
+#include "dynlib.h"
+#include "nextalk_capture.h"
+
+#include <portaudio.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace nextalk {
+
+namespace {
+
+struct PortAudioApi {
+    DynLib lib{"libportaudio.so.2", "libportaudio.so", "libportaudio.so.0"};
+    decltype(&Pa_Initialize) initialize = nullptr;
+    decltype(&Pa_Terminate) terminate = nullptr;
+    decltype(&Pa_OpenStream) openStream = nullptr;
+    decltype(&Pa_CloseStream) closeStream = nullptr;
+    decltype(&Pa_StartStream) startStream = nullptr;
+    decltype(&Pa_StopStream) stopStream = nullptr;
+    decltype(&Pa_ReadStream) readStream = nullptr;
+    decltype(&Pa_GetErrorText) errorText = nullptr;
+    decltype(&Pa_GetStreamInfo) streamInfo = nullptr;
+    decltype(&Pa_GetDeviceInfo) deviceInfo = nullptr;
+
+    bool load() {
+        return lib.bind(initialize, "Pa_Initialize") &&
+               lib.bind(terminate, "Pa_Terminate") &&
+               lib.bind(openStream, "Pa_OpenStream") &&
+               lib.bind(closeStream, "Pa_CloseStream") &&
+               lib.bind(startStream, "Pa_StartStream") &&
+               lib.bind(stopStream, "Pa_StopStream") &&
+               lib.bind(readStream, "Pa_ReadStream") &&
+               lib.bind(errorText, "Pa_GetErrorText") &&
+               lib.bind(streamInfo, "Pa_GetStreamInfo") &&
+               lib.bind(deviceInfo, "Pa_GetDeviceInfo");
+    }
+};
+
+class PortAudioBackend : public CaptureBackend {
+public:
+    // converter 为空表示设备直接以输出格式打开
+    PortAudioBackend(std::unique_ptr<PortAudioApi> api, PaStream *stream,
+                     int32_t sampleRate, std::unique_ptr<FormatConverter> converter)
+        : api_(std::move(api)), stream_(stream), sampleRate_(sampleRate),
+          converter_(std::move(converter)) {
+        const int64_t granted = grantedLatencyUsec();
+        inputLatencyNs_ = granted > 0 ? granted * 1000 : 0;
+    }
+
+    ~PortAudioBackend() override {
+        if (started_) {
+            api_->stopStream(stream_);
+        }
+        api_->closeStream(stream_);
+        api_->terminate();
+    }
+
+    int32_t start() override {
+        if (started_) {
+            return NEXTALK_CAPTURE_OK;
+        }
+        if (converter_) {
+            converter_->reset();
+        }
+        const PaError err = api_->startStream(stream_);
+        if (err != paNoError) {
+            errorText_ = std::string("Pa_StartStream 失败: ") + api_->errorText(err);
+            return NEXTALK_CAPTURE_ERR_START;
+        }
+        started_ = true;
+        return NEXTALK_CAPTURE_OK;
+    }
+
+    void stop() override {
+        if (started_) {
+            api_->stopStream(stream_);
+            started_ = false;
+        }
+    }
+
+    int32_t read(float *dst, int32_t frames, int64_t &captureTimeNs) override {
+        if (converter_) {
+            return readConverted(dst, frames, captureTimeNs);
+        }
+        const PaError err = api_->readStream(stream_, dst, frames);
+        // paInputOverflowed 时数据仍然有效 (与 Dart 侧处理一致)
+        if (err == paNoError || err == paInputOverflowed) {
+            // 阻塞读取返回时末帧刚经过输入延迟到达，由此倒推首帧采集时刻
+            captureTimeNs = monotonicNowNs() - inputLatencyNs_ -
+                            static_cast<int64_t>(frames) * 1000000000LL / sampleRate_;
+            return frames;
+        }
+        return readError(err);
+    }
+
+    // PortAudio 只提供打开时协商的输入延迟，授予值即实测值
+    int64_t grantedLatencyUsec() override {
+        const PaStreamInfo *info = api_->streamInfo(stream_);
+        return info ? static_cast<int64_t>(info->inputLatency * 1e6) : -1;
+    }
+
+    int64_t latencyUsec() override { return grantedLatencyUsec(); }
+
+    int32_t deviceSampleRate() const override {
+        return converter_ ? converter_->input().sampleRate : sampleRate_;
+    }
+
+private:
+    // 按设备采样率读取，转换后输出不超过 frames 帧
+    int32_t readConverted(float *dst, int32_t frames, int64_t &captureTimeNs) {
+        const DeviceFormat &in = converter_->input();
+        const int32_t deviceFrames = converter_->inputFramesFor(frames);
+        deviceBlock_.resize(static_cast<size_t>(deviceFrames) * in.channels);
+
+        const PaError err = api_->readStream(stream_, deviceBlock_.data(), deviceFrames);
+        if (err != paNoError && err != paInputOverflowed) {
+            return readError(err);
+        }
+        captureTimeNs = monotonicNowNs() - inputLatencyNs_ -
+                        static_cast<int64_t>(deviceFrames) * 1000000000LL / in.sampleRate -
+                        converter_->delayNs();
+        const size_t produced = converter_->process(deviceBlock_.data(), deviceFrames, converted_);
+        const size_t n = std::min(produced, static_cast<size_t>(frames));
+        std::copy(converted_.begin(), converted_.begin() + static_cast<std::ptrdiff_t>(n), dst);
+        return static_cast<int32_t>(n);
+    }
+
+    int32_t readError(PaError err) {
+        errorText_ = std::string("Pa_ReadStream 失败: ") + api_->errorText(err);
+        if (err == paDeviceUnavailable) {
+            return NEXTALK_CAPTURE_ERR_DEVICE_LOST;
+        }
+        return NEXTALK_CAPTURE_ERR_READ;
+    }
+
+    std::unique_ptr<PortAudioApi> api_;
+    PaStream *stream_ = nullptr;
+    int32_t sampleRate_;
+    std::unique_ptr<FormatConverter> converter_;
+    std::vector<float> deviceBlock_;
+    std::vector<float> converted_;
+    int64_t inputLatencyNs_ = 0;
+    bool started_ = false;
+};
+
+PaStream *openStream(PortAudioApi &api, int32_t deviceIndex, int32_t channels,
+                     double sampleRate, double suggestedLatency, int32_t blockFrames,
+                     PaError &err) {
+    PaStreamParameters params;
+    params.device = deviceIndex;
+    params.channelCount = channels;
+    params.sampleFormat = paFloat32;
+    params.suggestedLatency = suggestedLatency;
+    params.hostApiSpecificStreamInfo = nullptr;
+
+    PaStream *stream = nullptr;
+    err = api.openStream(&stream, &params, nullptr, sampleRate,
+                         static_cast<unsigned long>(blockFrames), paClipOff, nullptr,
+                         nullptr);
+    return err == paNoError ? stream : nullptr;
+}
+
+// 设备原生格式: 默认采样率，最多取前两个声道混音
+std::unique_ptr<FormatConverter> nativeConverter(PortAudioApi &api,
+                                                 const StreamFormat &format,
+                                                 int32_t deviceIndex) {
+    const PaDeviceInfo *info = api.deviceInfo(deviceIndex);
+    if (!info || info->maxInputChannels <= 0 || info->defaultSampleRate <= 0) {
+        return nullptr;
+    }
+    DeviceFormat in;
+    in.sampleFormat = SampleFormat::Float32;
+    in.sampleRate = static_cast<int32_t>(std::lround(info->defaultSampleRate));
+    in.channels = std::min(info->maxInputChannels, 2);
+
+    auto converter = std::make_unique<FormatConverter>();
+    if (!converter->configure(in, format.sampleRate) || converter->passthrough()) {
+        return nullptr;
+    }
+    return converter;
+}
+
+} // namespace
+
+std::unique_ptr<CaptureBackend> createPortAudioBackend(
+    const StreamFormat &format, int32_t deviceIndex, double suggestedLatency,
+    int32_t &error, std::string &errorText) {
+    auto api = std::make_unique<PortAudioApi>();
+    if (!api->load()) {
+        error = NEXTALK_CAPTURE_ERR_LIBRARY;
+        errorText = "无法加载 libportaudio";
+        return nullptr;
+    }
+
+    PaError err = api->initialize();
+    if (err != paNoError) {
+        error = NEXTALK_CAPTURE_ERR_LIBRARY;
+        errorText = std::string("Pa_Initialize 失败: ") + api->errorText(err);
+        return nullptr;
+    }
+
+    std::unique_ptr<FormatConverter> converter;
+    PaStream *stream = nullptr;
+    if (format.deviceNative && format.channels == 1) {
+        converter = nativeConverter(*api, format, deviceIndex);
+    }
+    if (converter) {
+        const DeviceFormat &in = converter->input();
+        stream = openStream(*api, deviceIndex, in.channels, in.sampleRate, suggestedLatency,
+                            converter->inputFramesFor(format.blockFrames), err);
+        if (!stream) {
+            // 设备拒绝原生参数时回退到由 PortAudio/ALSA 转换
+            converter.reset();
+        }
+    }
+    if (!stream) {
+        stream = openStream(*api, deviceIndex, format.channels, format.sampleRate,
+                            suggestedLatency, format.blockFrames, err);
+    }
+    if (!stream) {
+        error = NEXTALK_CAPTURE_ERR_OPEN;
+        errorText = std::string("Pa_OpenStream 失败: ") + api->errorText(err);
+        api->terminate();
+        return nullptr;
+    }
+
+    error = NEXTALK_CAPTURE_OK;
+    return std::make_unique<PortAudioBackend>(std::move(api), stream, format.sampleRate,
+                                              std::move(converter));
+}
+
+} // namespace nextalk
@@ -0,0 +1,481 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * libpulse 异步采集后端 (pa_stream + pa_threaded_mainloop)
+ *
+ * 与 pa_simple 默认缓冲属性不同，这里按目标延迟显式请求 fragsize/maxlength，
+ * 避免服务器选择数百毫秒的分片；数据在 mainloop 线程的读回调中直接推送给
+ * CaptureSink，不需要额外的阻塞读取线程。
+ * 设备名与 Dart 侧 PulseAudioCapture 相同 (如 alsa_input.xxx)。
+ * 启用 deviceNative 时按源的原生采样规格打开，由 FormatConverter 在本进程
+ * 内转换，服务器无需为本流重采样 (其质量取决于 resample-method 设置)。
+ */
+
+#include "audio_convert.h"
+#include "capture_backend.h"
+#include "dynlib.h"
+#include "nextalk_capture.h"
+
+#include <pulse/pulseaudio.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace nextalk {
+
+namespace {
+
+// maxlength 相对 fragsize 的倍数: 允许服务器在客户端短暂调度延迟时多缓冲几片
+constexpr uint32_t kMaxLengthFragments = 4;
+
+struct PulseApi {
+    DynLib lib{"libpulse.so.0", "libpulse.so"};
+    decltype(&pa_threaded_mainloop_new) mainloopNew = nullptr;
+    decltype(&pa_threaded_mainloop_free) mainloopFree = nullptr;
+    decltype(&pa_threaded_mainloop_start) mainloopStart = nullptr;
+    decltype(&pa_threaded_mainloop_stop) mainloopStop = nullptr;
+    decltype(&pa_threaded_mainloop_lock) mainloopLock = nullptr;
+    decltype(&pa_threaded_mainloop_unlock) mainloopUnlock = nullptr;
+    decltype(&pa_threaded_mainloop_wait) mainloopWait = nullptr;
+    decltype(&pa_threaded_mainloop_signal) mainloopSignal = nullptr;
+    decltype(&pa_threaded_mainloop_get_api) mainloopGetApi = nullptr;
+    decltype(&pa_context_new) contextNew = nullptr;
+    decltype(&pa_context_set_state_callback) contextSetStateCallback = nullptr;
+    decltype(&pa_context_connect) contextConnect = nullptr;
+    decltype(&pa_context_get_state) contextGetState = nullptr;
+    decltype(&pa_context_errno) contextErrno = nullptr;
+    decltype(&pa_context_disconnect) contextDisconnect = nullptr;
+    decltype(&pa_context_unref) contextUnref = nullptr;
+    decltype(&pa_stream_new) streamNew = nullptr;
+    decltype(&pa_stream_set_state_callback) streamSetStateCallback = nullptr;
+    decltype(&pa_stream_set_read_callback) streamSetReadCallback = nullptr;
+    decltype(&pa_stream_connect_record) streamConnectRecord = nullptr;
+    decltype(&pa_stream_get_state) streamGetState = nullptr;
+    decltype(&pa_stream_peek) streamPeek = nullptr;
+    decltype(&pa_stream_drop) streamDrop = nullptr;
+    decltype(&pa_stream_cork) streamCork = nullptr;
+    decltype(&pa_stream_flush) streamFlush = nullptr;
+    decltype(&pa_stream_get_latency) streamGetLatency = nullptr;
+    decltype(&pa_stream_get_buffer_attr) streamGetBufferAttr = nullptr;
+    decltype(&pa_stream_disconnect) streamDisconnect = nullptr;
+    decltype(&pa_stream_unref) streamUnref = nullptr;
+    decltype(&pa_operation_unref) operationUnref = nullptr;
+    decltype(&pa_operation_get_state) operationGetState = nullptr;
+    decltype(&pa_context_get_source_info_by_name) contextGetSourceInfo = nullptr;
+    decltype(&pa_strerror) strerror = nullptr;
+
+    bool load() {
+        return lib.bind(mainloopNew, "pa_threaded_mainloop_new") &&
+               lib.bind(mainloopFree, "pa_threaded_mainloop_free") &&
+               lib.bind(mainloopStart, "pa_threaded_mainloop_start") &&
+               lib.bind(mainloopStop, "pa_threaded_mainloop_stop") &&
+               lib.bind(mainloopLock, "pa_threaded_mainloop_lock") &&
+               lib.bind(mainloopUnlock, "pa_threaded_mainloop_unlock") &&
+               lib.bind(mainloopWait, "pa_threaded_mainloop_wait") &&
+               lib.bind(mainloopSignal, "pa_threaded_mainloop_signal") &&
+               lib.bind(mainloopGetApi, "pa_threaded_mainloop_get_api") &&
+               lib.bind(contextNew, "pa_context_new") &&
+               lib.bind(contextSetStateCallback, "pa_context_set_state_callback") &&
+               lib.bind(contextConnect, "pa_context_connect") &&
+               lib.bind(contextGetState, "pa_context_get_state") &&
+               lib.bind(contextErrno, "pa_context_errno") &&
+               lib.bind(contextDisconnect, "pa_context_disconnect") &&
+               lib.bind(contextUnref, "pa_context_unref") &&
+               lib.bind(streamNew, "pa_stream_new") &&
+               lib.bind(streamSetStateCallback, "pa_stream_set_state_callback") &&
+               lib.bind(streamSetReadCallback, "pa_stream_set_read_callback") &&
+               lib.bind(streamConnectRecord, "pa_stream_connect_record") &&
+               lib.bind(streamGetState, "pa_stream_get_state") &&
+               lib.bind(streamPeek, "pa_stream_peek") &&
+               lib.bind(streamDrop, "pa_stream_drop") &&
+               lib.bind(streamCork, "pa_stream_cork") &&
+               lib.bind(streamFlush, "pa_stream_flush") &&
+               lib.bind(streamGetLatency, "pa_stream_get_latency") &&
+               lib.bind(streamGetBufferAttr, "pa_stream_get_buffer_attr") &&
+               lib.bind(streamDisconnect, "pa_stream_disconnect") &&
+               lib.bind(streamUnref, "pa_stream_unref") &&
+               lib.bind(operationUnref, "pa_operation_unref") &&
+               lib.bind(operationGetState, "pa_operation_get_state") &&
+               lib.bind(contextGetSourceInfo, "pa_context_get_source_info_by_name") &&
+               lib.bind(strerror, "pa_strerror");
+    }
+};
+
+// 在持有 mainloop 锁的作用域内执行
+class MainloopLock {
+public:
+    MainloopLock(const PulseApi &api, pa_threaded_mainloop *mainloop)
+        : api_(api), mainloop_(mainloop) {
+        api_.mainloopLock(mainloop_);
+    }
+    ~MainloopLock() { api_.mainloopUnlock(mainloop_); }
+
+    MainloopLock(const MainloopLock &) = delete;
+    MainloopLock &operator=(const MainloopLock &) = delete;
+
+private:
+    const PulseApi &api_;
+    pa_threaded_mainloop *mainloop_;
+};
+
+class PulseStreamBackend;
+
+// 源信息查询结果 (在 mainloop 线程中填写)
+struct SourceQuery {
+    PulseStreamBackend *self = nullptr;
+    pa_sample_spec spec{};
+    bool found = false;
+};
+
+class PulseStreamBackend : public CaptureBackend {
+public:
+    PulseStreamBackend(std::unique_ptr<PulseApi> api, const StreamFormat &format,
+                       CaptureSink *sink)
+        : api_(std::move(api)), format_(format), sink_(sink) {}
+
+    ~PulseStreamBackend() override { close(); }
+
+    // 连接服务器并创建录音流 (初始为 corked 状态)
+    int32_t open(const char *device, int32_t targetLatencyMs) {
+        mainloop_ = api_->mainloopNew();
+        if (!mainloop_) {
+            errorText_ = "pa_threaded_mainloop_new 失败";
+            return NEXTALK_CAPTURE_ERR_OPEN;
+        }
+        context_ = api_->contextNew(api_->mainloopGetApi(mainloop_), "Nextalk");
+        if (!context_) {
+            errorText_ = "pa_context_new 失败";
+            return NEXTALK_CAPTURE_ERR_OPEN;
+        }
+        api_->contextSetStateCallback(context_, &PulseStreamBackend::onContextState, this);
+
+        MainloopLock lock(*api_, mainloop_);
+        if (api_->contextConnect(context_, nullptr, PA_CONTEXT_NOFLAGS, nullptr) < 0 ||
+            api_->mainloopStart(mainloop_) < 0) {
+            return fail("pa_context_connect 失败");
+        }
+        mainloopRunning_ = true;
+
+        for (;;) {
+            const pa_context_state_t state = api_->contextGetState(context_);
+            if (state == PA_CONTEXT_READY) {
+                break;
+            }
+            if (state == PA_CONTEXT_FAILED || state == PA_CONTEXT_TERMINATED) {
+                return fail("连接 PulseAudio 失败");
+            }
+            api_->mainloopWait(mainloop_);
+        }
+
+        if (device && std::strcmp(device, "default") == 0) {
+            device = nullptr;
+        }
+
+        pa_sample_spec spec;
+        spec.format = PA_SAMPLE_FLOAT32NE;
+        spec.rate = static_cast<uint32_t>(format_.sampleRate);
+        spec.channels = static_cast<uint8_t>(format_.channels);
+        frameBytes_ = static_cast<size_t>(format_.channels) * sizeof(float);
+        if (format_.deviceNative && format_.channels == 1) {
+            useNativeSpec(device, spec);
+        }
+
+        stream_ = api_->streamNew(context_, "Voice Input", &spec, nullptr);
+        if (!stream_) {
+            return fail("pa_stream_new 失败");
+        }
+        api_->streamSetStateCallback(stream_, &PulseStreamBackend::onStreamState, this);
+        api_->streamSetReadCallback(stream_, &PulseStreamBackend::onRead, this);
+
+        // 按目标延迟请求分片大小，服务器会尽量满足 (ADJUST_LATENCY)
+        const uint32_t fragFrames = static_cast<uint32_t>(
+            std::max<int64_t>(1, static_cast<int64_t>(spec.rate) * targetLatencyMs / 1000));
+        pa_buffer_attr attr;
+        attr.fragsize = fragFrames * static_cast<uint32_t>(frameBytes_);
+        attr.maxlength = attr.fragsize * kMaxLengthFragments;
+        attr.tlength = static_cast<uint32_t>(-1);
+        attr.prebuf = static_cast<uint32_t>(-1);
+        attr.minreq = static_cast<uint32_t>(-1);
+
+        const auto flags = static_cast<pa_stream_flags_t>(
+            PA_STREAM_START_CORKED | PA_STREAM_ADJUST_LATENCY |
+            PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_AUTO_TIMING_UPDATE);
+        if (api_->streamConnectRecord(stream_, device, &attr, flags) < 0) {
+            return fail("pa_stream_connect_record 失败");
+        }
+
+        for (;;) {
+            const pa_stream_state_t state = api_->streamGetState(stream_);
+            if (state == PA_STREAM_READY) {
+                break;
+            }
+            if (state == PA_STREAM_FAILED || state == PA_STREAM_TERMINATED) {
+                return fail("打开录音流失败");
+            }
+            api_->mainloopWait(mainloop_);
+        }
+        return NEXTALK_CAPTURE_OK;
+    }
+
+    bool pushesData() const override { return true; }
+
+    int32_t start() override {
+        MainloopLock lock(*api_, mainloop_);
+        if (api_->streamGetState(stream_) != PA_STREAM_READY) {
+            errorText_ = "录音流已断开";
+            return NEXTALK_CAPTURE_ERR_DEVICE_LOST;
+        }
+        if (converter_) {
+            converter_->reset();
+        }
+        // corked 期间服务器可能仍有残留数据，启动时丢弃
+        unrefOperation(api_->streamFlush(stream_, nullptr, nullptr));
+        unrefOperation(api_->streamCork(stream_, 0, nullptr, nullptr));
+        return NEXTALK_CAPTURE_OK;
+    }
+
+    void stop() override {
+        MainloopLock lock(*api_, mainloop_);
+        if (api_->streamGetState(stream_) == PA_STREAM_READY) {
+            unrefOperation(api_->streamCork(stream_, 1, nullptr, nullptr));
+        }
+    }
+
+    int64_t grantedLatencyUsec() override {
+        MainloopLock lock(*api_, mainloop_);
+        const pa_buffer_attr *attr = api_->streamGetBufferAttr(stream_);
+        if (!attr) {
+            return -1;
+        }
+        // 录音流的分片大小即服务器每次投递的数据量
+        const int64_t bytesPerSecond =
+            static_cast<int64_t>(deviceSampleRate()) * static_cast<int64_t>(frameBytes_);
+        return static_cast<int64_t>(attr->fragsize) * 1000000 / bytesPerSecond;
+    }
+
+    int64_t latencyUsec() override {
+        MainloopLock lock(*api_, mainloop_);
+        pa_usec_t usec = 0;
+        int negative = 0;
+        if (api_->streamGetLatency(stream_, &usec, &negative) < 0) {
+            return -1;
+        }
+        // 录音流为负时表示数据尚未被读走前的时间差，按 0 处理
+        return negative ? 0 : static_cast<int64_t>(usec);
+    }
+
+    int32_t deviceSampleRate() const override {
+        return converter_ ? converter_->input().sampleRate : format_.sampleRate;
+    }
+
+private:
+    // 查询源的原生采样规格 (已持有 mainloop 锁)，本库支持的格式直接采用，
+    // 其他格式 (如 S24) 仍由服务器转换为 float，但保留原生采样率与声道
+    void useNativeSpec(const char *device, pa_sample_spec &spec) {
+        SourceQuery query;
+        query.self = this;
+        pa_operation *op = api_->contextGetSourceInfo(
+            context_, device ? device : "@DEFAULT_SOURCE@", &PulseStreamBackend::onSourceInfo,
+            &query);
+        if (!op) {
+            return;
+        }
+        while (api_->operationGetState(op) == PA_OPERATION_RUNNING) {
+            api_->mainloopWait(mainloop_);
+        }
+        api_->operationUnref(op);
+        if (!query.found) {
+            return;
+        }
+
+        DeviceFormat in;
+        pa_sample_spec native = query.spec;
+        switch (native.format) {
+        case PA_SAMPLE_S16NE:
+            in.sampleFormat = SampleFormat::Int16;
+            break;
+        case PA_SAMPLE_S32NE:
+            in.sampleFormat = SampleFormat::Int32;
+            break;
+        default:
+            native.format = PA_SAMPLE_FLOAT32NE;
+            in.sampleFormat = SampleFormat::Float32;
+            break;
+        }
+        in.sampleRate = static_cast<int32_t>(native.rate);
+        in.channels = native.channels;
+
+        auto converter = std::make_unique<FormatConverter>();
+        if (!converter->configure(in, format_.sampleRate) || converter->passthrough()) {
+            return; // 比例不受支持或无需转换时沿用服务器转换
+        }
+        converter_ = std::move(converter);
+        spec = native;
+        frameBytes_ = in.bytesPerFrame();
+    }
+
+    int32_t fail(const char *what) {
+        const int err = api_->contextErrno(context_);
+        errorText_ = std::string(what) + ": " + api_->strerror(err);
+        return NEXTALK_CAPTURE_ERR_OPEN;
+    }
+
+    void unrefOperation(pa_operation *op) {
+        if (op) {
+            api_->operationUnref(op);
+        }
+    }
+
+    void close() {
+        if (mainloop_ && mainloopRunning_) {
+            MainloopLock lock(*api_, mainloop_);
+            closing_ = true;
+            if (stream_) {
+                api_->streamSetReadCallback(stream_, nullptr, nullptr);
+                api_->streamSetStateCallback(stream_, nullptr, nullptr);
+                api_->streamDisconnect(stream_);
+            }
+            if (context_) {
+                api_->contextSetStateCallback(context_, nullptr, nullptr);
+                api_->contextDisconnect(context_);
+            }
+        }
+        // pa_threaded_mainloop_stop 不能在持锁时调用
+        if (mainloop_ && mainloopRunning_) {
+            api_->mainloopStop(mainloop_);
+            mainloopRunning_ = false;
+        }
+        if (stream_) {
+            api_->streamUnref(stream_);
+            stream_ = nullptr;
+        }
+        if (context_) {
+            api_->contextUnref(context_);
+            context_ = nullptr;
+        }
+        if (mainloop_) {
+            api_->mainloopFree(mainloop_);
+            mainloop_ = nullptr;
+        }
+    }
+
+    // 以下回调均在 mainloop 线程中执行 (已持有 mainloop 锁)
+
+    static void onContextState(pa_context *context, void *userdata) {
+        auto *self = static_cast<PulseStreamBackend *>(userdata);
+        const pa_context_state_t state = self->api_->contextGetState(context);
+        if (state == PA_CONTEXT_FAILED || state == PA_CONTEXT_TERMINATED) {
+            self->reportLost("PulseAudio 连接断开");
+        }
+        self->api_->mainloopSignal(self->mainloop_, 0);
+    }
+
+    static void onStreamState(pa_stream *stream, void *userdata) {
+        auto *self = static_cast<PulseStreamBackend *>(userdata);
+        const pa_stream_state_t state = self->api_->streamGetState(stream);
+        if (state == PA_STREAM_FAILED || state == PA_STREAM_TERMINATED) {
+            self->reportLost("录音设备断开");
+        }
+        self->api_->mainloopSignal(self->mainloop_, 0);
+    }
+
+    static void onSourceInfo(pa_context *, const pa_source_info *info, int eol,
+                             void *userdata) {
+        auto *query = static_cast<SourceQuery *>(userdata);
+        if (eol == 0 && info) {
+            query->spec = info->sample_spec;
+            query->found = true;
+        }
+        query->self->api_->mainloopSignal(query->self->mainloop_, 0);
+    }
+
+    static void onRead(pa_stream *stream, size_t, void *userdata) {
+        auto *self = static_cast<PulseStreamBackend *>(userdata);
+
+        const void *data = nullptr;
+        size_t bytes = 0;
+        while (self->api_->streamPeek(stream, &data, &bytes) == 0 && bytes > 0) {
+            const int32_t frames = static_cast<int32_t>(bytes / self->frameBytes_);
+            const int64_t captureTimeNs = self->fragmentCaptureTimeNs();
+            if (!data) {
+                // 数据空洞 (如设备挂起后恢复)，以静音补齐保持时间轴连续
+                // (全零字节在 float/int16/int32 下均为静音)
+                self->silence_.assign(bytes, 0);
+                data = self->silence_.data();
+            }
+            self->deliver(data, frames, captureTimeNs);
+            self->api_->streamDrop(stream);
+        }
+    }
+
+    void deliver(const void *data, int32_t frames, int64_t captureTimeNs) {
+        if (!converter_) {
+            sink_->onFrames(static_cast<const float *>(data), frames, captureTimeNs);
+            return;
+        }
+        const size_t produced = converter_->process(data, frames, converted_);
+        if (produced > 0) {
+            sink_->onFrames(converted_.data(), static_cast<int32_t>(produced),
+                            captureTimeNs - converter_->delayNs());
+        }
+    }
+
+    // 当前分片首帧的采集时刻 (已持有 mainloop 锁)
+    // 录音流的延迟 = 源端延迟 + 尚未被读走的数据时长，恰为读指针处数据的"年龄"
+    int64_t fragmentCaptureTimeNs() {
+        const int64_t now = monotonicNowNs();
+        pa_usec_t usec = 0;
+        int negative = 0;
+        if (api_->streamGetLatency(stream_, &usec, &negative) < 0 || negative) {
+            return now;
+        }
+        return now - static_cast<int64_t>(usec) * 1000;
+    }
+
+    void reportLost(const char *what) {
+        if (closing_) {
+            return;
+        }
+        errorText_ = std::string(what) + ": " + api_->strerror(api_->contextErrno(context_));
+        sink_->onError(NEXTALK_CAPTURE_ERR_DEVICE_LOST, errorText_);
+    }
+
+    std::unique_ptr<PulseApi> api_;
+    StreamFormat format_;
+    CaptureSink *sink_ = nullptr;
+
+    pa_threaded_mainloop *mainloop_ = nullptr;
+    pa_context *context_ = nullptr;
+    pa_stream *stream_ = nullptr;
+    bool mainloopRunning_ = false;
+    bool closing_ = false;
+    size_t frameBytes_ = sizeof(float);
+    std::unique_ptr<FormatConverter> converter_;
+    std::vector<float> converted_;
+    std::vector<uint8_t> silence_;
+};
+
+} // namespace
+
+std::unique_ptr<CaptureBackend> createPulseStreamBackend(
+    const StreamFormat &format, const char *device, int32_t targetLatencyMs,
+    CaptureSink *sink, int32_t &error, std::string &errorText) {
+    auto api = std::make_unique<PulseApi>();
+    if (!api->load()) {
+        error = NEXTALK_CAPTURE_ERR_LIBRARY;
+        errorText = "无法加载 libpulse";
+        return nullptr;
+    }
+
+    auto backend = std::make_unique<PulseStreamBackend>(std::move(api), format, sink);
+    error = backend->open(device, targetLatencyMs);
+    if (error != NEXTALK_CAPTURE_OK) {
+        errorText = backend->errorText();
+        return nullptr;
+    }
+    return backend;
+}
+
+} // namespace nextalk
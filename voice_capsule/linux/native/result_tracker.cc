@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "result_tracker.h"
+
+#include <algorithm>
+
+namespace nextalk {
+
+int32_t ResultTracker::intern(const char *token) {
+    auto it = ids_.find(token);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    const auto id = static_cast<int32_t>(vocab_.size());
+    vocab_.emplace_back(token);
+    ids_.emplace(vocab_.back(), id);
+    return id;
+}
+
+bool ResultTracker::offer(uint64_t epoch, bool endpoint, const char *text,
+                          const char *const *tokens, const float *timestamps,
+                          int32_t count, int64_t samples) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // reset 之后才解码完的旧音频: 结果作废
+    if (epoch != epoch_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    endpoint_.store(endpoint, std::memory_order_release);
+
+    scratch_.clear();
+    for (int32_t i = 0; i < count; ++i) {
+        scratch_.push_back(intern(tokens[i] ? tokens[i] : ""));
+    }
+    if (scratch_ == published_) {
+        return false;
+    }
+
+    published_.swap(scratch_);
+    if (timestamps) {
+        publishedTimestamps_.assign(timestamps, timestamps + count);
+    } else {
+        publishedTimestamps_.assign(static_cast<size_t>(count), 0.0f);
+    }
+    publishedText_ = text ? text : "";
+    publishedSamples_ = samples;
+    generation_.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+uint64_t ResultTracker::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    published_.clear();
+    publishedTimestamps_.clear();
+    publishedText_.clear();
+    read_.clear();
+    endpoint_.store(false, std::memory_order_release);
+    // 空结果也算一次发布，读取方据此清空
+    generation_.fetch_add(1, std::memory_order_release);
+    return epoch_.fetch_add(1, std::memory_order_acq_rel) + 1;
+}
+
+bool ResultTracker::take(NextalkAsrUpdate *out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int64_t generation = generation_.load(std::memory_order_acquire);
+    if (generation == readGeneration_) {
+        return false;
+    }
+
+    const size_t limit = std::min(read_.size(), published_.size());
+    size_t kept = 0;
+    while (kept < limit && read_[kept] == published_[kept]) {
+        ++kept;
+    }
+
+    outText_ = publishedText_;
+    outTokens_.clear();
+    outTimestamps_.clear();
+    for (size_t i = kept; i < published_.size(); ++i) {
+        outTokens_.push_back(vocab_[static_cast<size_t>(published_[i])].c_str());
+        outTimestamps_.push_back(publishedTimestamps_[i]);
+    }
+    read_ = published_;
+    readGeneration_ = generation;
+
+    out->generation = generation;
+    out->kept = static_cast<int32_t>(kept);
+    out->count = static_cast<int32_t>(outTokens_.size());
+    out->text = outText_.c_str();
+    out->tokens = outTokens_.data();
+    out->timestamps = outTimestamps_.data();
+    out->samples = publishedSamples_;
+    return true;
+}
+
+} // namespace nextalk
@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 流式识别结果跟踪 (按 token id 比较，只发布变化)
+ *
+ * 工作线程每次解码后送入完整假设；token 字符串被映射为 id，与上次发布的
+ * id 序列相同时不发布，读取方不必跨 FFI 拷贝、解析任何内容。
+ * 读取方取到的是相对其上一次读取的增量: 保留前 kept 个 token，
+ * 其后替换为新的 token (通常只是末尾追加或修正一两个)。
+ */
+
+#ifndef _NEXTALK_NATIVE_RESULT_TRACKER_H_
+#define _NEXTALK_NATIVE_RESULT_TRACKER_H_
+
+#include "nextalk_asr.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nextalk {
+
+class ResultTracker {
+public:
+    // 当前 epoch，解码命令入队时记录
+    uint64_t epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+    // 发布序号 (每次结果变化或重置时递增)
+    int64_t generation() const {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    bool endpoint() const { return endpoint_.load(std::memory_order_acquire); }
+
+    // 工作线程: 送入 epoch 时入队的音频解码后的完整假设
+    // samples 为解码到的累计样本数，随结果发布给读取方
+    // epoch 已过期 (期间发生过 reset) 时丢弃；token 序列未变化时不发布
+    // 返回是否发布了新结果
+    bool offer(uint64_t epoch, bool endpoint, const char *text,
+               const char *const *tokens, const float *timestamps,
+               int32_t count, int64_t samples);
+
+    // 清空已发布的结果与读取进度，递增 epoch 并返回新值
+    uint64_t reset();
+
+    // 读取方: 取自上次读取以来的增量，无变化返回 false
+    // out 中的指针在下一次 take 之前有效
+    bool take(NextalkAsrUpdate *out);
+
+private:
+    int32_t intern(const char *token);
+
+    std::mutex mutex_;
+    std::atomic<uint64_t> epoch_{0};
+    std::atomic<int64_t> generation_{0};
+    std::atomic<bool> endpoint_{false};
+
+    // token 词表: deque 追加时不移动已有元素，读取方可直接引用其 c_str()
+    std::unordered_map<std::string, int32_t> ids_;
+    std::deque<std::string> vocab_;
+
+    // 已发布的假设
+    std::vector<int32_t> published_;
+    std::vector<float> publishedTimestamps_;
+    std::string publishedText_;
+    int64_t publishedSamples_ = 0;
+
+    // 读取方上次取到的假设与输出缓冲 (仅读取方线程访问，reset 除外)
+    std::vector<int32_t> read_;
+    int64_t readGeneration_ = 0;
+    std::string outText_;
+    std::vector<const char *> outTokens_;
+    std::vector<float> outTimestamps_;
+
+    // 工作线程临时缓冲
+    std::vector<int32_t> scratch_;
+};
+
+} // namespace nextalk
+
+#endif // _NEXTALK_NATIVE_RESULT_TRACKER_H_
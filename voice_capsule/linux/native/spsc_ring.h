@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Nextalk Project
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * 单生产者/单消费者无锁环形缓冲区
+ * - 生产者: 原生采集线程
+ * - 消费者: Dart 主 isolate (通过 FFI 非阻塞读取)
+ */
+
+#ifndef _NEXTALK_NATIVE_SPSC_RING_H_
+#define _NEXTALK_NATIVE_SPSC_RING_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace nextalk {
+
+// 避免读写索引位于同一缓存行导致伪共享
+constexpr size_t kCacheLineSize = 64;
+
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SpscRing 仅支持可平凡复制的类型");
+
+public:
+    // 容量向上取整为 2 的幂，便于用掩码取模
+    explicit SpscRing(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        data_.reset(new T[capacity]());
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    size_t capacity() const { return capacity_; }
+
+    // 当前可读元素数量 (任一线程调用均安全，结果为快照)
+    size_t size() const {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    // 生产者写入，空间不足时只写入能容纳的部分，返回实际写入数量
+    size_t write(const T *src, size_t count) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t space = capacity_ - (head - tail);
+        const size_t n = std::min(count, space);
+        copyIn(head, src, n);
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // 消费者读取，返回实际读取数量 (不阻塞)
+    size_t read(T *dst, size_t count) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t n = std::min(count, head - tail);
+        copyOut(tail, dst, n);
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // 消费者丢弃最旧的数据，返回实际丢弃数量
+    size_t skip(size_t count) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t n = std::min(count, head - tail);
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // 消费者清空缓冲区
+    void clear() { skip(size()); }
+
+private:
+    void copyIn(size_t pos, const T *src, size_t n) {
+        const size_t offset = pos & mask_;
+        const size_t first = std::min(n, capacity_ - offset);
+        std::memcpy(data_.get() + offset, src, first * sizeof(T));
+        std::memcpy(data_.get(), src + first, (n - first) * sizeof(T));
+    }
+
+    void copyOut(size_t pos, T *dst, size_t n) const {
+        const size_t offset = pos & mask_;
+        const size_t first = std::min(n, capacity_ - offset);
+        std::memcpy(dst, data_.get() + offset, first * sizeof(T));
+        std::memcpy(dst + first, data_.get(), (n - first) * sizeof(T));
+    }
+
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    std::unique_ptr<T[]> data_;
+
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0}; // 生产者写位置
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0}; // 消费者读位置
+};
+
+} // namespace nextalk
+
+#endif // _NEXTALK_NATIVE_SPSC_RING_H_
@@ -3,6 +3,7 @@ import 'package:ffi/ffi.dart';
 import 'package:flutter_test/flutter_test.dart';
 import 'package:voice_capsule/ffi/portaudio_ffi.dart';
 import 'package:voice_capsule/services/audio_capture.dart';
+import 'package:voice_capsule/services/native_audio_capture.dart';
 
 void main() {
   group('PortAudioBindings', () {
@@ -100,6 +101,55 @@ void main() {
 
       capture.dispose();
     });
+
+    test('未预热时 arm 返回 false，预录模式保持关闭', () {
+      final capture = AudioCapture();
+      expect(capture.arm(500), isFalse);
+      expect(capture.isArmed, isFalse);
+      capture.dispose();
+    });
+
+    test('prerollMs 为 0 时 arm 返回 false', () {
+      final capture = AudioCapture();
+      expect(capture.arm(0), isFalse);
+      capture.dispose();
+    });
+  });
+
+  group('AudioLevels', () {
+    test('静音时 dBFS 为下限', () {
+      const levels = AudioLevels(
+        rms: 0,
+        peak: 0,
+        centroidHz: 0,
+        energy: 0,
+        frames: 1600,
+        blocks: 10,
+      );
+      expect(levels.dbfs, equals(AudioLevels.silenceDbfs));
+    });
+
+    test('dbfsSince 按区间内的平均能量计算', () {
+      const earlier = AudioLevels(
+        rms: 0.1,
+        peak: 0.2,
+        centroidHz: 500,
+        energy: 0.0,
+        frames: 1600,
+        blocks: 10,
+      );
+      // 之后 1600 个样本的均方为 0.01 (-20 dBFS)
+      const later = AudioLevels(
+        rms: 0.1,
+        peak: 0.2,
+        centroidHz: 500,
+        energy: 16.0,
+        frames: 3200,
+        blocks: 20,
+      );
+      expect(later.dbfsSince(earlier), closeTo(-20.0, 1e-9));
+      expect(later.dbfs, closeTo(-20.0, 1e-9));
+    });
   });
 
   group('AudioCaptureError', () {
@@ -5,8 +5,10 @@ import 'package:ffi/ffi.dart';
 import 'package:flutter_test/flutter_test.dart';
 import 'package:voice_capsule/constants/settings_constants.dart';
 import 'package:voice_capsule/services/asr/asr_engine.dart';
+import 'package:voice_capsule/services/asr/two_pass_engine.dart';
 import 'package:voice_capsule/services/audio_capture.dart';
 import 'package:voice_capsule/services/audio_inference_pipeline.dart';
+import 'package:voice_capsule/services/chunk_scheduler.dart';
 import 'package:voice_capsule/services/model_manager.dart';
 
 /// Mock AudioCapture for testing
@@ -71,6 +73,45 @@ class MockAudioCapture extends AudioCapture {
   bool get isDisposed => _disposed;
 }
 
+/// Mock 原生采集线程模式 (事件驱动，read 非阻塞)
+class EventDrivenMockAudioCapture extends MockAudioCapture {
+  int waitForDataCalls = 0;
+  bool hasData = true;
+  final List<int> requestedSamples = [];
+
+  @override
+  bool get isEventDriven => true;
+
+  @override
+  Future<bool> waitForData(Duration timeout, {int minSamples = 1}) async {
+    waitForDataCalls++;
+    requestedSamples.add(minSamples);
+    await Future.delayed(const Duration(milliseconds: 10));
+    return hasData;
+  }
+
+  @override
+  int read(Pointer<Float> buffer, int samples) {
+    if (!hasData) return 0;
+    return super.read(buffer, samples);
+  }
+}
+
+/// Mock 带采集时间戳的音频采集 (数据在缓冲区中驻留 [bufferedAge])
+class TimestampedMockAudioCapture extends MockAudioCapture {
+  Duration bufferedAge = const Duration(milliseconds: 150);
+  DateTime? _captureTime;
+
+  @override
+  int read(Pointer<Float> buffer, int samples) {
+    _captureTime = DateTime.now().subtract(bufferedAge);
+    return super.read(buffer, samples);
+  }
+
+  @override
+  DateTime? get lastReadCaptureTime => _captureTime;
+}
+
 /// Mock ASREngine for testing (Story 2-7: ASR 引擎抽象层)
 class MockASREngine implements ASREngine {
   bool _initialized = false;
@@ -79,6 +120,7 @@ class MockASREngine implements ASREngine {
   bool _ready = false;
   bool _hasNewData = false; // 模拟有新数据需要解码
   String _resultText = '';
+  List<String> _resultTokens = const [];
   bool _disposed = false;
   int _acceptWaveformCalls = 0;
   int _decodeCalls = 0;
@@ -94,7 +136,10 @@ class MockASREngine implements ASREngine {
 
   void setInitError(ASRError error) => _initError = error;
   void setReady(bool ready) => _ready = ready;
-  void setResultText(String text) => _resultText = text;
+  void setResultText(String text, {List<String> tokens = const []}) {
+    _resultText = text;
+    _resultTokens = tokens;
+  }
 
   int get acceptWaveformCalls => _acceptWaveformCalls;
   int get decodeCalls => _decodeCalls;
@@ -158,7 +203,7 @@ class MockASREngine implements ASREngine {
   ASRResult getResult() {
     return ASRResult(
       text: _resultText,
-      tokens: [],
+      tokens: _resultTokens,
       timestamps: [],
     );
   }
@@ -179,6 +224,17 @@ class MockASREngine implements ASREngine {
   @override
   void inputFinished() {}
 
+  // 模拟后台解码: finishInput 等待 finishDelay 后才发布最终文本
+  Duration finishDelay = Duration.zero;
+  String? textAfterFinish;
+
+  @override
+  Future<void> finishInput() async {
+    inputFinished();
+    if (finishDelay > Duration.zero) await Future.delayed(finishDelay);
+    if (textAfterFinish != null) _resultText = textAfterFinish!;
+  }
+
   @override
   void reset() {
     // Story 2-6: reset 后可以重新触发端点
@@ -441,6 +497,27 @@ void main() {
       expect(repeatCount, equals(1));
     });
 
+    test('deltaStream 只携带变化的 token', () async {
+      mockAsrEngine.setReady(true);
+      mockAsrEngine.setResultText('你好', tokens: ['你', '好']);
+
+      final deltas = <ASRResultDelta>[];
+      pipeline.deltaStream.listen(deltas.add);
+
+      await pipeline.start();
+      await Future.delayed(const Duration(milliseconds: 250));
+      mockAsrEngine.setResultText('你好世界', tokens: ['你', '好', '世', '界']);
+      await Future.delayed(const Duration(milliseconds: 250));
+      await pipeline.stop();
+
+      expect(deltas.length, equals(2));
+      expect(deltas[0].keptTokens, equals(0));
+      expect(deltas[0].tokens, equals(['你', '好']));
+      expect(deltas[1].keptTokens, equals(2));
+      expect(deltas[1].tokens, equals(['世', '界']));
+      expect(deltas[1].text, equals('你好世界'));
+    });
+
     test('设备不可用时触发 deviceUnavailable 错误 (AC7)', () async {
       await pipeline.start();
 
@@ -495,6 +572,17 @@ void main() {
       expect(finalText, equals('最终结果'));
     });
 
+    test('stop() 异步等待引擎解码完成后取最终结果', () async {
+      mockAsrEngine.setResultText('部分');
+      mockAsrEngine.finishDelay = const Duration(milliseconds: 50);
+      mockAsrEngine.textAfterFinish = '部分结果完整';
+
+      await pipeline.start();
+      final finalText = await pipeline.stop();
+
+      expect(finalText, equals('部分结果完整'));
+    });
+
     test('未运行时 stop() 安全返回', () async {
       // 未启动直接调用 stop
       final result = await pipeline.stop();
@@ -698,6 +786,30 @@ void main() {
       );
     });
 
+    test('延迟从音频块的采集时刻开始计算', () async {
+      final timestamped = TimestampedMockAudioCapture();
+      final timedPipeline = AudioInferencePipeline(
+        audioCapture: timestamped,
+        asrEngine: mockAsrEngine,
+        modelManager: mockModelManager,
+      );
+      mockAsrEngine.setReady(true);
+      mockAsrEngine.setResultText('采集时间戳');
+
+      await timedPipeline.start();
+      await Future.delayed(const Duration(milliseconds: 150));
+      await timedPipeline.stop();
+
+      final stats = timedPipeline.latencyStats;
+      expect(stats.sampleCount, greaterThan(0));
+      expect(
+        stats.avgLatencyMs,
+        greaterThanOrEqualTo(150),
+        reason: '缓冲区驻留时间应计入端到端延迟',
+      );
+      await timedPipeline.dispose();
+    });
+
     test('LatencyStats.toString() 格式正确', () {
       final stats = LatencyStats(
         sampleCount: 10,
@@ -764,6 +876,31 @@ void main() {
       final config = VadConfig.continuous();
       expect(config.autoStopOnEndpoint, isFalse);
       expect(config.autoReset, isTrue);
+      expect(config.energyGate, isTrue);
+    });
+
+    test('VadConfig 默认不启用能量门限', () {
+      expect(VadConfig.defaultConfig().energyGate, isFalse);
+    });
+
+    test('VadConfig 默认不启用自适应静音阈值', () {
+      expect(VadConfig.defaultConfig().adaptiveSilence, isFalse);
+    });
+
+    test('VadConfig 默认使用规则端点', () {
+      expect(VadConfig.defaultConfig().endpointMode, equals(EndpointMode.rules));
+      expect(VadConfig.continuous().endpointMode, equals(EndpointMode.rules));
+    });
+
+    test('EndpointEvent 带提交延迟时 toString 包含 commit', () {
+      final event = EndpointEvent(
+        finalText: '测试',
+        isVadTriggered: true,
+        durationMs: 1000,
+        latencyStats: LatencyStats.empty(),
+        commitLatencyMs: 420.4,
+      );
+      expect(event.toString(), contains('commit: 420ms'));
     });
 
     test('VadConfig 自定义静音阈值', () {
@@ -800,6 +937,14 @@ void main() {
       expect(stream2.isBroadcast, isTrue);
     });
 
+    test('未拦下过音频时诊断报告不含能量门限统计', () async {
+      expect(pipeline.energyGateStatus, isNull);
+      await pipeline.start();
+      await pipeline.stop();
+      expect(pipeline.energyGateStatus, isNull);
+      expect(pipeline.endpointStatus, isNot(contains('gate:')));
+    });
+
     test('vadConfig 默认值正确', () {
       expect(pipeline.vadConfig.autoStopOnEndpoint, isTrue);
       expect(pipeline.vadConfig.autoReset, isFalse);
@@ -857,6 +1002,48 @@ void main() {
 
       await customPipeline.dispose();
     });
+
+    test('第二次录音的静音阈值变化时重建识别器', () async {
+      final customPipeline = AudioInferencePipeline(
+        audioCapture: mockAudioCapture,
+        asrEngine: mockAsrEngine,
+        modelManager: mockModelManager,
+        vadConfig: const VadConfig(silenceThresholdSec: 1.2),
+      );
+
+      await customPipeline.start();
+      await customPipeline.stop();
+      expect(mockAsrEngine.disposed, isFalse);
+
+      customPipeline.setVadConfig(const VadConfig(silenceThresholdSec: 0.8));
+      await customPipeline.start();
+
+      // 端点规则在创建识别器时固定，阈值变化必须重建后才生效
+      expect(mockAsrEngine.disposed, isTrue);
+      expect(mockAsrEngine.isInitialized, isTrue);
+      final config = mockAsrEngine.lastReceivedConfig as ZipformerConfig;
+      expect(config.rule2MinTrailingSilence, equals(0.8));
+
+      await customPipeline.dispose();
+    });
+
+    test('端点规则不变时复用已加载的识别器', () async {
+      final customPipeline = AudioInferencePipeline(
+        audioCapture: mockAudioCapture,
+        asrEngine: mockAsrEngine,
+        modelManager: mockModelManager,
+        vadConfig: const VadConfig(silenceThresholdSec: 1.2),
+      );
+
+      expect(await customPipeline.warmUp(), equals(ASRError.none));
+      await customPipeline.start();
+      await customPipeline.stop();
+      await customPipeline.start();
+
+      expect(mockAsrEngine.disposed, isFalse);
+
+      await customPipeline.dispose();
+    });
   });
 
   group('Story 2-6: VAD 端点检测逻辑 (Task 3)', () {
@@ -988,6 +1175,26 @@ void main() {
         expect(events.first.durationMs, greaterThan(100));
       }
     });
+
+    test('规则端点记录语音结束到提交的延迟', () async {
+      mockAsrEngine.setReady(true);
+      mockAsrEngine.setResultText('提交延迟');
+      mockAsrEngine.triggerEndpointAfterCalls = 3;
+
+      final events = <EndpointEvent>[];
+      pipeline.endpointStream.listen(events.add);
+
+      await pipeline.start();
+      await Future.delayed(const Duration(milliseconds: 500));
+
+      expect(events, isNotEmpty);
+      // 文本在首块即出现，端点在第 3 块触发
+      expect(events.first.commitLatencyMs, isNotNull);
+      expect(events.first.commitLatencyMs, greaterThan(0));
+      expect(pipeline.commitLatencyStats.sampleCount, equals(1));
+      expect(pipeline.commitLatencyStats.vadTriggeredCount, equals(0));
+      expect(pipeline.isHybridEndpointActive, isFalse);
+    });
   });
 
   group('Story 2-6: stop() 方法修改 (Task 4)', () {
@@ -1216,6 +1423,15 @@ void main() {
       expect(pipeline.currentEngineType, equals(ASREngineType.sensevoice));
     });
 
+    test('只有 Zipformer 流式引擎支持提前上屏', () async {
+      expect(pipeline.supportsEarlyCommit, isTrue);
+
+      // SenseVoice 的 token 只含最近一段，不能按 token 判定稳定前缀
+      newMockAsrEngine.setEngineType(ASREngineType.sensevoice);
+      await pipeline.switchEngine(newMockAsrEngine);
+      expect(pipeline.supportsEarlyCommit, isFalse);
+    });
+
     test('switchEngine 在运行状态下先停止再切换', () async {
       // 启动流水线
       final startError = await pipeline.start();
@@ -1277,4 +1493,159 @@ void main() {
       expect(pipeline.lastError, equals(PipelineError.none));
     });
   });
+
+  group('原生采集线程事件驱动循环', () {
+    late EventDrivenMockAudioCapture mockAudioCapture;
+    late MockASREngine mockAsrEngine;
+    late AudioInferencePipeline pipeline;
+
+    setUp(() {
+      mockAudioCapture = EventDrivenMockAudioCapture();
+      mockAsrEngine = MockASREngine();
+      pipeline = AudioInferencePipeline(
+        audioCapture: mockAudioCapture,
+        asrEngine: mockAsrEngine,
+        modelManager: MockModelManager(),
+      );
+    });
+
+    tearDown(() {
+      pipeline.dispose();
+    });
+
+    test('等待采集线程唤醒，而非固定 100ms 周期', () async {
+      await pipeline.start();
+      await Future.delayed(const Duration(milliseconds: 200));
+      await pipeline.stop();
+
+      // 10ms 唤醒间隔下 200ms 内应远多于 2 次
+      expect(mockAudioCapture.waitForDataCalls, greaterThan(5));
+      expect(mockAsrEngine.acceptWaveformCalls, greaterThan(5));
+    });
+
+    test('无新数据时不调用 acceptWaveform', () async {
+      mockAudioCapture.hasData = false;
+
+      await pipeline.start();
+      await Future.delayed(const Duration(milliseconds: 100));
+      await pipeline.stop();
+
+      expect(mockAudioCapture.waitForDataCalls, greaterThan(0));
+      expect(mockAsrEngine.acceptWaveformCalls, equals(0));
+    });
+
+    test('默认 (未加载设置) 使用固定 100ms 块', () async {
+      await pipeline.start();
+      await Future.delayed(const Duration(milliseconds: 50));
+      await pipeline.stop();
+
+      expect(pipeline.activeChunkPolicy.name, equals('fixed'));
+      expect(mockAudioCapture.requestedSamples.toSet(), equals({1600}));
+    });
+
+    test('自适应分块: 开头等待小块，之后放大', () async {
+      pipeline.dispose();
+      pipeline = AudioInferencePipeline(
+        audioCapture: mockAudioCapture,
+        asrEngine: mockAsrEngine,
+        modelManager: MockModelManager(),
+        chunkPolicy: ChunkPolicy.adaptive,
+      );
+
+      await pipeline.start();
+      await Future.delayed(const Duration(milliseconds: 400));
+      await pipeline.stop();
+
+      // Mock 每次读出 100ms，10 块后越过首秒开始加倍
+      expect(mockAudioCapture.requestedSamples.first, equals(320));
+      expect(mockAudioCapture.requestedSamples.last, equals(1600));
+    });
+  });
+
+  group('AudioInferencePipeline 空闲卸载', () {
+    late MockAudioCapture mockAudioCapture;
+    late MockASREngine mockAsrEngine;
+    late AudioInferencePipeline pipeline;
+    late List<String> events;
+
+    setUp(() {
+      mockAudioCapture = MockAudioCapture();
+      mockAsrEngine = MockASREngine();
+      events = [];
+      pipeline = AudioInferencePipeline(
+        audioCapture: mockAudioCapture,
+        asrEngine: mockAsrEngine,
+        modelManager: MockModelManager(),
+        idleUnloadAfter: const Duration(milliseconds: 50),
+        onResidencyEvent: events.add,
+      );
+    });
+
+    tearDown(() async {
+      await pipeline.dispose();
+    });
+
+    test('空闲超时后释放模型，下次 start 重新加载', () async {
+      await pipeline.start();
+      await pipeline.stop();
+      expect(pipeline.isModelUnloaded, isFalse);
+
+      await Future.delayed(const Duration(milliseconds: 150));
+      expect(mockAsrEngine.isDisposed, isTrue);
+      expect(mockAsrEngine.isInitialized, isFalse);
+      expect(pipeline.isModelUnloaded, isTrue);
+      expect(pipeline.idleUnloadCount, equals(1));
+      expect(pipeline.residencyStatus, startsWith('unloaded'));
+      expect(pipeline.lastUnloadFreedBytes, isNotNull);
+      expect(pipeline.residencyStatus, contains('last unload freed='));
+
+      expect(await pipeline.start(), equals(PipelineError.none));
+      expect(mockAsrEngine.isInitialized, isTrue);
+      expect(pipeline.isModelUnloaded, isFalse);
+      expect(pipeline.lastReloadTime, isNotNull);
+      expect(events.where((e) => e.startsWith('空闲')), hasLength(1));
+      expect(events.where((e) => e.startsWith('重新加载')), hasLength(1));
+      expect(events.where((e) => e.startsWith('首次录音')), hasLength(1));
+      expect(pipeline.firstStartLatency, isNotNull);
+    });
+
+    test('超时前再次录音不释放模型', () async {
+      await pipeline.start();
+      await pipeline.stop();
+      await pipeline.start();
+      await Future.delayed(const Duration(milliseconds: 150));
+
+      expect(pipeline.isRunning, isTrue);
+      expect(mockAsrEngine.isDisposed, isFalse);
+      expect(pipeline.idleUnloadCount, equals(0));
+      await pipeline.stop();
+    });
+
+    test('重新加载时预读所有会创建识别器的模型 (两遍识别含 SenseVoice)', () {
+      expect(AudioInferencePipeline.modelEnginesFor(MockASREngine()),
+          equals([EngineType.zipformer]));
+      final twoPass = TwoPassEngine(
+        secondPass: const SenseVoiceConfig(
+            modelDir: '/mock/sensevoice', vadModelPath: '/mock/vad.onnx'),
+      );
+      expect(AudioInferencePipeline.modelEnginesFor(twoPass),
+          equals([EngineType.zipformer, EngineType.sensevoice]));
+      twoPass.dispose();
+    });
+
+    test('未配置空闲卸载时模型常驻', () async {
+      final resident = AudioInferencePipeline(
+        audioCapture: MockAudioCapture(),
+        asrEngine: MockASREngine(),
+        modelManager: MockModelManager(),
+      );
+      await resident.start();
+      await resident.stop();
+      await Future.delayed(const Duration(milliseconds: 100));
+
+      expect(resident.isModelUnloaded, isFalse);
+      expect(resident.residencyStatus, contains('idle_unload=off'));
+      await resident.dispose();
+    });
+  });
 }
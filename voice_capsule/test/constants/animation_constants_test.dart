@@ -66,6 +66,23 @@ void main() {
     });
   });
 
+  group('AnimationConstants Voice Level Tests', () {
+    test('voice level range maps speech loudness', () {
+      expect(
+        AnimationConstants.voiceLevelFloorDb,
+        lessThan(AnimationConstants.voiceLevelCeilDb),
+      );
+      expect(AnimationConstants.voiceLevelCeilDb, lessThan(0.0));
+    });
+
+    test('voice level attacks faster than it releases', () {
+      expect(
+        AnimationConstants.voiceLevelAttack,
+        lessThan(AnimationConstants.voiceLevelRelease),
+      );
+    });
+  });
+
   group('AnimationConstants Pulse Tests', () {
     test('pulseDuration is 400ms', () {
       expect(
@@ -1,6 +1,7 @@
 import 'dart:io';
 import 'package:crypto/crypto.dart';
 import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/constants/settings_constants.dart';
 import 'package:voice_capsule/services/model_manager.dart';
 
 void main() {
@@ -265,6 +266,35 @@ void main() {
           contains('sherpa-onnx-streaming-zipformer-bilingual-zh-en'));
     });
   });
+
+  group('ModelPrewarmResult', () {
+    test('按预热前已缓存的字节区分冷/热', () {
+      const cold = ModelPrewarmResult(
+        files: ['/a.onnx', '/b.onnx'],
+        totalBytes: 200 * 1024 * 1024,
+        residentBefore: 50 * 1024 * 1024,
+        elapsed: Duration(milliseconds: 1800),
+      );
+      expect(cold.wasWarm, isFalse);
+      expect(cold.residentRatio, closeTo(0.25, 1e-9));
+      expect(cold.toString(), contains('200MB'));
+      expect(cold.toString(), contains('25%'));
+
+      const warm = ModelPrewarmResult(
+        files: ['/a.onnx'],
+        totalBytes: 1024,
+        residentBefore: 1024,
+        elapsed: Duration.zero,
+      );
+      expect(warm.wasWarm, isTrue);
+    });
+
+    test('模型目录不存在时没有可预热的文件', () {
+      final tempManager = _TestModelManager();
+      expect(tempManager.modelFilesForEngine(EngineType.zipformer), isEmpty);
+      expect(tempManager.prefetchModelFiles(EngineType.zipformer), equals(0));
+    });
+  });
 }
 
 /// 使用临时目录的测试用 ModelManager
@@ -280,6 +310,10 @@ class _TestModelManager extends ModelManager {
   @override
   String get modelPath =>
       '$_instanceTestDir/models/sherpa-onnx-streaming-zipformer-bilingual-zh-en';
+
+  @override
+  String getModelPathForEngine(EngineType engineType) =>
+      '$_instanceTestDir/models/${ModelConfigs.forEngine(engineType).dirName}';
 }
 
 /// 可配置 SHA256 期望值的测试用 ModelManager
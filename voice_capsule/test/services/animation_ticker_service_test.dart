@@ -0,0 +1,27 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/constants/animation_constants.dart';
+import 'package:voice_capsule/services/animation_ticker_service.dart';
+
+void main() {
+  group('AnimationTickerService 语音电平', () {
+    test('dBFS 映射到 [0, 1] 并截断', () {
+      expect(
+        AnimationTickerService.levelFromDbfs(AnimationConstants.voiceLevelFloorDb),
+        equals(0.0),
+      );
+      expect(
+        AnimationTickerService.levelFromDbfs(AnimationConstants.voiceLevelCeilDb),
+        equals(1.0),
+      );
+      expect(AnimationTickerService.levelFromDbfs(-100.0), equals(0.0));
+      expect(AnimationTickerService.levelFromDbfs(0.0), equals(1.0));
+    });
+
+    test('未运行时电平为 0，呼吸缩放回到基础值', () {
+      final service = AnimationTickerService.instance;
+      service.stop();
+      expect(service.voiceLevel, equals(0.0));
+      expect(service.breathingScale, greaterThanOrEqualTo(AnimationConstants.breathingBaseScale));
+    });
+  });
+}
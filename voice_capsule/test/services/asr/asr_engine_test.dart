@@ -1,3 +1,6 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
 import 'package:flutter_test/flutter_test.dart';
 import 'package:voice_capsule/services/asr/asr_engine.dart';
 import 'package:voice_capsule/services/asr/asr_engine_factory.dart';
@@ -139,6 +142,11 @@ void main() {
       expect(config.maxSpeechDuration, equals(10.0));
       expect(config.vadWindowSize, equals(512));
       expect(config.provider, equals('cpu'));
+      expect(config.partialIntervalMs, equals(500));
+      expect(config.partialMaxLoad, equals(0.5));
+      expect(config.segmentThreads, equals(0));
+      expect(config.segmentBatchSize, equals(4));
+      expect(config.segmentBatchWaitMs, equals(0));
     });
 
     test('应该正确创建自定义配置', () {
@@ -171,6 +179,30 @@ void main() {
       expect(config.provider, equals('cuda'));
     });
 
+    test('segmentThreads 为 0 时按核数与 numThreads 自动选择', () {
+      const config = SenseVoiceConfig(
+        modelDir: '/test/path',
+        vadModelPath: '/vad/path',
+      );
+
+      expect(config.resolvedSegmentThreads(1), equals(1));
+      expect(config.resolvedSegmentThreads(2), equals(1));
+      expect(config.resolvedSegmentThreads(4), equals(2));
+      expect(config.resolvedSegmentThreads(8), equals(4));
+      expect(config.resolvedSegmentThreads(64),
+          equals(SenseVoiceConfig.maxAutoSegmentThreads));
+    });
+
+    test('显式 segmentThreads 不受核数限制', () {
+      const config = SenseVoiceConfig(
+        modelDir: '/test/path',
+        vadModelPath: '/vad/path',
+        segmentThreads: 6,
+      );
+
+      expect(config.resolvedSegmentThreads(2), equals(6));
+    });
+
     test('toString() 应该返回有意义的字符串', () {
       const config = SenseVoiceConfig(
         modelDir: '/test/path',
@@ -255,6 +287,143 @@ void main() {
     });
   });
 
+  group('PackedTokens 类', () {
+    PackedTokens pack(List<String> tokens) {
+      final bytes = <int>[];
+      for (final t in tokens) {
+        bytes
+          ..addAll(utf8.encode(t))
+          ..add(0);
+      }
+      return PackedTokens(Uint8List.fromList(bytes), tokens.length);
+    }
+
+    test('首次读取时才拆分 token', () {
+      final packed = pack(['▁hello', '你', '好', '']);
+
+      expect(packed.count, equals(4));
+      expect(packed.isMaterialized, isFalse);
+      expect(packed.tokens, equals(['▁hello', '你', '好', '']));
+      expect(packed.isMaterialized, isTrue);
+      expect(identical(packed.tokens, packed.tokens), isTrue);
+    });
+
+    test('packed 结果的 tokenCount 与 withText 不触发拆分', () {
+      final packed = pack(['你', '好']);
+      final result = ASRResult.packed(
+        text: '你好',
+        lang: 'zh',
+        tokens: packed,
+        timestamps: Float32List.fromList([0.1, 0.2]),
+      );
+
+      final copy = result.withText('前文你好');
+      expect(result.tokenCount, equals(2));
+      expect(copy.tokenCount, equals(2));
+      expect(copy.text, equals('前文你好'));
+      expect(copy.lang, equals('zh'));
+      expect(packed.isMaterialized, isFalse);
+
+      expect(copy.tokens, equals(['你', '好']));
+      expect(copy.timestamps, hasLength(2));
+    });
+
+    test('增量按字节比较前缀，不拆分上一次结果', () {
+      final previous = ASRResult.packed(
+        text: '今天天气',
+        tokens: pack(['今', '天', '天', '气']),
+      );
+      final nextTokens = pack(['今', '天', '田', '七', '好']);
+      final next = ASRResult.packed(text: '今天田七好', tokens: nextTokens);
+
+      final delta = ASRResultDelta.between(previous, next);
+      expect(delta.keptTokens, equals(2));
+      expect(delta.tokens, equals(['田', '七', '好']));
+      expect(nextTokens.isMaterialized, isFalse);
+
+      final rebuilt = delta.applyTo(
+          const ASRResult(text: '今天天气', tokens: ['今', '天', '天', '气']));
+      expect(rebuilt.tokens, equals(['今', '天', '田', '七', '好']));
+    });
+
+    test('相同字节前缀不跨越 token 边界', () {
+      // 第二个 token 的字节 "c" 是 "cd" 的前缀，但 token 并不相同
+      final a = pack(['▁ab', 'c']);
+      final b = pack(['▁ab', 'cd']);
+      expect(a.commonPrefix(b), equals(1));
+      expect(pack(['▁a']).commonPrefix(pack(['▁ab'])), equals(0));
+      expect(b.tokensFrom(1), equals(['cd']));
+    });
+
+    test('空数据得到空 token 列表', () {
+      final packed = PackedTokens(Uint8List(0), 0);
+      expect(packed.tokens, isEmpty);
+      expect(const ASRResult(text: 'a', tokens: ['a']).tokenCount, equals(1));
+    });
+  });
+
+  group('ASRResultDelta 类', () {
+    const previous = ASRResult(
+      text: '今天天气',
+      tokens: ['今', '天', '天', '气'],
+      timestamps: [0.1, 0.2, 0.3, 0.4],
+    );
+
+    test('末尾追加时保留全部旧 token', () {
+      const next = ASRResult(
+        text: '今天天气很好',
+        tokens: ['今', '天', '天', '气', '很', '好'],
+        timestamps: [0.1, 0.2, 0.3, 0.4, 0.5, 0.6],
+      );
+      final delta = ASRResultDelta.between(previous, next);
+
+      expect(delta.keptTokens, equals(4));
+      expect(delta.tokens, equals(['很', '好']));
+      expect(delta.timestamps, equals([0.5, 0.6]));
+      expect(delta.isAppendOnly(previous), isTrue);
+    });
+
+    test('修正中间 token 时从分歧处替换', () {
+      const next = ASRResult(
+        text: '今天田七',
+        tokens: ['今', '天', '田', '七'],
+        timestamps: [0.1, 0.2, 0.3, 0.4],
+      );
+      final delta = ASRResultDelta.between(previous, next);
+
+      expect(delta.keptTokens, equals(2));
+      expect(delta.tokens, equals(['田', '七']));
+      expect(delta.isAppendOnly(previous), isFalse);
+    });
+
+    test('applyTo 重建完整结果', () {
+      const next = ASRResult(
+        text: '今天田七好',
+        tokens: ['今', '天', '田', '七', '好'],
+        timestamps: [0.1, 0.2, 0.3, 0.4, 0.5],
+      );
+      final rebuilt = ASRResultDelta.between(previous, next).applyTo(previous);
+
+      expect(rebuilt.text, equals(next.text));
+      expect(rebuilt.tokens, equals(next.tokens));
+      expect(rebuilt.timestamps, equals(next.timestamps));
+    });
+
+    test('applyTo 保留语言与情感标签', () {
+      const next = ASRResult(
+        text: '今天天气很好',
+        lang: 'zh',
+        emotion: 'HAPPY',
+        tokens: ['今', '天', '天', '气', '很', '好'],
+      );
+      final rebuilt = ASRResultDelta.between(previous, next).applyTo(previous);
+
+      expect(rebuilt, equals(next));
+      expect(rebuilt.lang, equals('zh'));
+      expect(rebuilt.emotion, equals('HAPPY'));
+    });
+  });
+
   group('ASREngineFactory 类', () {
     test('create() 应该创建 ZipformerEngine', () {
       final engine = ASREngineFactory.create(ASREngineType.zipformer);
@@ -272,6 +441,17 @@ void main() {
       expect(engine, isA<ZipformerEngine>());
     });
 
+    test('ZipformerEngine 默认使用工作线程解码，初始化前未启用', () {
+      final engine = ZipformerEngine();
+      expect(engine.useInferenceWorker, isTrue);
+      expect(engine.usesInferenceWorker, isFalse);
+      expect(engine.workerDecodeTime, isNull);
+      // 未初始化时接口保持安全的空操作
+      expect(engine.isReady(), isFalse);
+      expect(engine.getResult().isEmpty, isTrue);
+      engine.dispose();
+    });
+
     test('create() 应该创建 SenseVoiceEngine', () {
       final engine = ASREngineFactory.create(ASREngineType.sensevoice);
 
@@ -0,0 +1,189 @@
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/ffi/native_host_bindings.dart';
+import 'package:voice_capsule/ffi/sherpa_ffi.dart';
+import 'package:voice_capsule/services/asr/asr_engine.dart';
+import 'package:voice_capsule/services/asr/engine_host_worker.dart';
+import 'package:voice_capsule/services/asr/zipformer_engine.dart';
+import 'package:voice_capsule/utils/wav_reader.dart';
+
+/// 识别宿主往返集成测试
+///
+/// 启动真实的 nextalk_engine_host，连接、送入测试音频并取回结果，
+/// 再杀死宿主验证重新连接。宿主、原生库或模型不可用时跳过。
+void main() {
+  late String modelDir;
+  String? hostExe;
+  String? skipReason;
+  Float32List? samples;
+
+  setUpAll(() {
+    modelDir = Platform.environment['SHERPA_MODEL_DIR'] ??
+        '${Platform.environment['HOME']}/.local/share/nextalk/models/sherpa-onnx-streaming-zipformer-bilingual-zh-en';
+    hostExe = _findHostExecutable();
+    if (hostExe == null) {
+      skipReason = '识别宿主不存在 (可用 NEXTALK_ENGINE_HOST 指定)';
+      return;
+    }
+    try {
+      NativeHostBindings();
+    } catch (e) {
+      skipReason = 'libnextalk_native 不可用: $e';
+      return;
+    }
+    if (!isSherpaLibraryAvailable()) {
+      skipReason = 'Sherpa 动态库不可用';
+      return;
+    }
+    if (!Directory(modelDir).existsSync()) {
+      skipReason = '模型不存在: $modelDir';
+      return;
+    }
+    samples = _loadTestClip(modelDir);
+    if (samples == null) {
+      skipReason = '模型目录中没有可用的 test_wavs';
+    }
+  });
+
+  late Directory socketDir;
+  late EngineHostOptions options;
+
+  setUp(() {
+    // 每个用例独立的套接字，避免连接到其他测试或应用正在使用的宿主
+    socketDir = Directory.systemTemp.createTempSync('nextalk-host-test-');
+    options = EngineHostOptions(
+      socketPath: '${socketDir.path}/engine-host.sock',
+      hostExecutable: hostExe ?? '/nonexistent/nextalk_engine_host',
+      idleTimeout: const Duration(seconds: 30),
+    );
+  });
+
+  tearDown(() async {
+    await _killHost(options.socketPath);
+    socketDir.deleteSync(recursive: true);
+  });
+
+  group('识别宿主往返', () {
+    test('送入音频取回结果，宿主退出后重新连接', () async {
+      if (skipReason != null) {
+        markTestSkipped(skipReason!);
+        return;
+      }
+      final engine = ZipformerEngine(engineHost: options);
+      final config = ZipformerConfig(modelDir: modelDir);
+      try {
+        expect(await engine.initialize(config), ASRError.none);
+        expect(engine.usesEngineHost, isTrue);
+        expect(engine.reusedHostModel, isFalse);
+
+        expect(await _recognize(engine, samples!), isNotEmpty);
+
+        // 模拟宿主崩溃
+        await _killHost(options.socketPath);
+        await _waitUntil(() => engine.hostDisconnected);
+
+        // 重新初始化时检测到宿主已断开，重新启动宿主并加载模型
+        expect(await engine.initialize(config), ASRError.none);
+        expect(engine.usesEngineHost, isTrue);
+        expect(engine.reusedHostModel, isFalse);
+        expect(await _recognize(engine, samples!), isNotEmpty);
+      } finally {
+        engine.dispose();
+      }
+    }, timeout: const Timeout(Duration(minutes: 2)));
+
+    test('端点规则不同的配置不复用宿主中的识别器', () async {
+      if (skipReason != null) {
+        markTestSkipped(skipReason!);
+        return;
+      }
+      Future<bool?> load(ZipformerConfig config) async {
+        final engine = ZipformerEngine(engineHost: options);
+        try {
+          expect(await engine.initialize(config), ASRError.none);
+          expect(engine.usesEngineHost, isTrue);
+          return engine.reusedHostModel;
+        } finally {
+          engine.dispose();
+        }
+      }
+
+      expect(await load(ZipformerConfig(modelDir: modelDir)), isFalse);
+      expect(await load(ZipformerConfig(modelDir: modelDir)), isTrue);
+      expect(
+        await load(ZipformerConfig(
+            modelDir: modelDir, rule2MinTrailingSilence: 0.6)),
+        isFalse,
+      );
+      expect(
+        await load(ZipformerConfig(modelDir: modelDir, enableEndpoint: false)),
+        isFalse,
+      );
+    }, timeout: const Timeout(Duration(minutes: 2)));
+  });
+}
+
+/// 宿主可执行文件: 环境变量 NEXTALK_ENGINE_HOST，否则取构建产物
+String? _findHostExecutable() {
+  final candidates = [
+    Platform.environment['NEXTALK_ENGINE_HOST'],
+    'build/linux/x64/release/bundle/lib/nextalk_engine_host',
+    'build/linux/x64/debug/bundle/lib/nextalk_engine_host',
+  ];
+  for (final path in candidates) {
+    if (path != null && path.isNotEmpty && File(path).existsSync()) {
+      return File(path).absolute.path;
+    }
+  }
+  return null;
+}
+
+Float32List? _loadTestClip(String modelDir) {
+  final dir = Directory('$modelDir/test_wavs');
+  if (!dir.existsSync()) return null;
+  final wavs = [
+    for (final entity in dir.listSync())
+      if (entity is File && entity.path.endsWith('.wav')) entity.path,
+  ]..sort();
+  for (final path in wavs) {
+    final samples = readWav16kMono(path);
+    if (samples != null) return samples;
+  }
+  return null;
+}
+
+/// 按 100ms 分块送入整段音频，结束输入后返回识别文本
+Future<String> _recognize(ZipformerEngine engine, Float32List samples) async {
+  const chunk = 1600;
+  final buffer = calloc<Float>(chunk);
+  try {
+    engine.reset();
+    for (var offset = 0; offset < samples.length; offset += chunk) {
+      final n = math.min(chunk, samples.length - offset);
+      buffer.asTypedList(n).setAll(0, samples.sublist(offset, offset + n));
+      engine.acceptWaveform(16000, buffer, n);
+    }
+    await engine.finishInput();
+    return engine.getResult().text;
+  } finally {
+    calloc.free(buffer);
+  }
+}
+
+Future<void> _killHost(String socketPath) async {
+  await Process.run('pkill', ['-KILL', '-f', socketPath]);
+}
+
+Future<void> _waitUntil(bool Function() condition,
+    {Duration timeout = const Duration(seconds: 5)}) async {
+  final deadline = DateTime.now().add(timeout);
+  while (!condition() && DateTime.now().isBefore(deadline)) {
+    await Future<void>.delayed(const Duration(milliseconds: 20));
+  }
+  expect(condition(), isTrue);
+}
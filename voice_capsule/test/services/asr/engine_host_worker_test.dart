@@ -0,0 +1,35 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/services/asr/engine_host_worker.dart';
+
+void main() {
+  group('EngineHostOptions', () {
+    test('默认位置: 套接字在 nextalk 运行时目录，宿主在 bundle 的 lib 目录', () {
+      final options = EngineHostOptions.standard();
+      expect(options.socketPath, endsWith('/nextalk/engine-host.sock'));
+      expect(options.hostExecutable, endsWith('/lib/nextalk_engine_host'));
+      expect(options.idleTimeout, equals(const Duration(minutes: 30)));
+    });
+
+    test('空闲超时可配置', () {
+      final options =
+          EngineHostOptions.standard(idleTimeout: const Duration(minutes: 5));
+      expect(options.idleTimeout.inSeconds, equals(300));
+    });
+  });
+
+  group('EngineHostWorker.tryConnect', () {
+    test('宿主可执行文件不存在时返回 null 并报告原因', () {
+      String? reason;
+      final worker = EngineHostWorker.tryConnect(
+        const EngineHostOptions(
+          socketPath: '/tmp/nextalk-test/engine-host.sock',
+          hostExecutable: '/nonexistent/nextalk_engine_host',
+        ),
+        'encoder=/nonexistent/encoder.onnx',
+        onError: (r) => reason = r,
+      );
+      expect(worker, isNull);
+      expect(reason, contains('/nonexistent/nextalk_engine_host'));
+    });
+  });
+}
@@ -0,0 +1,62 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/services/asr/partial_decode_scheduler.dart';
+
+void main() {
+  /// 16kHz 下 [ms] 毫秒的样本数
+  int samples(int ms) => ms * 16;
+
+  group('PartialDecodeScheduler 中间解码调度', () {
+    test('间隔为 0 时关闭', () {
+      final scheduler = PartialDecodeScheduler(intervalMs: 0, maxLoad: 0.5);
+      scheduler.advance(samples(2000));
+      expect(scheduler.enabled, isFalse);
+      expect(scheduler.shouldSubmit(samples(2000)), isFalse);
+    });
+
+    test('语音段过短时不提交', () {
+      final scheduler = PartialDecodeScheduler(intervalMs: 500, maxLoad: 0.5);
+      expect(scheduler.shouldSubmit(samples(200)), isFalse);
+      expect(scheduler.shouldSubmit(samples(400)), isTrue);
+    });
+
+    test('解码进行中不重复提交，完成后按间隔提交', () {
+      final scheduler = PartialDecodeScheduler(intervalMs: 500, maxLoad: 0.5);
+      scheduler.advance(samples(100));
+      expect(scheduler.shouldSubmit(samples(500)), isTrue);
+      scheduler.submitted();
+      expect(scheduler.inFlight, isTrue);
+      expect(scheduler.shouldSubmit(samples(500)), isFalse);
+
+      scheduler.advance(samples(100));
+      scheduler.completed(const Duration(milliseconds: 10));
+      scheduler.advance(samples(300));
+      expect(scheduler.shouldSubmit(samples(900)), isFalse);
+      scheduler.advance(samples(100));
+      expect(scheduler.elapsedMs, equals(600));
+      expect(scheduler.shouldSubmit(samples(1000)), isTrue);
+    });
+
+    test('解码耗时超出计算上限时拉长间隔', () {
+      final scheduler = PartialDecodeScheduler(intervalMs: 500, maxLoad: 0.5);
+      scheduler.submitted();
+      scheduler.completed(const Duration(milliseconds: 400));
+      // 400ms / 0.5 = 800ms 后才能再次提交
+      scheduler.advance(samples(700));
+      expect(scheduler.shouldSubmit(samples(2000)), isFalse);
+      scheduler.advance(samples(100));
+      expect(scheduler.shouldSubmit(samples(2000)), isTrue);
+    });
+
+    test('取消与重置', () {
+      final scheduler = PartialDecodeScheduler(intervalMs: 500, maxLoad: 0.5);
+      scheduler.advance(samples(1000));
+      scheduler.submitted();
+      scheduler.cancelled();
+      expect(scheduler.inFlight, isFalse);
+
+      scheduler.reset();
+      expect(scheduler.elapsedMs, equals(0));
+      expect(scheduler.shouldSubmit(samples(500)), isTrue);
+    });
+  });
+}
@@ -0,0 +1,94 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/services/asr/asr_engine.dart';
+import 'package:voice_capsule/services/asr/two_pass_engine.dart';
+
+void main() {
+  /// 第一遍结果: 每个 token 间隔 0.1 秒
+  ASRResult first(List<String> tokens) => ASRResult(
+        text: tokens.join().replaceAll('▁', ' ').trimLeft(),
+        tokens: tokens,
+        timestamps: [for (var i = 0; i < tokens.length; i++) i * 0.1],
+      );
+
+  group('TwoPassTranscript 分段替换', () {
+    test('尚无替换时原样返回第一遍结果', () {
+      final transcript = TwoPassTranscript();
+      final result = first(['今', '天']);
+      expect(transcript.close(result, 0), equals(0));
+      expect(identical(transcript.compose(result), result), isTrue);
+    });
+
+    test('端点之后没有新 token 时不切分', () {
+      final transcript = TwoPassTranscript();
+      final result = first(['今', '天']);
+      transcript.close(result, 0);
+      expect(transcript.close(result, 1.0), equals(-1));
+      expect(transcript.segmentCount, equals(1));
+    });
+
+    test('替换已切分的语音段，之后的部分保留第一遍实时结果', () {
+      final transcript = TwoPassTranscript();
+      transcript.close(first(['今', '田']), 0);
+      transcript.replace(
+        0,
+        const ASRResult(
+          text: '今天，',
+          lang: 'zh',
+          tokens: ['今', '天', '，'],
+          timestamps: [0.0, 0.1, 0.2],
+        ),
+      );
+
+      final live = first(['今', '田', '天', '气']);
+      final result = transcript.compose(live);
+      expect(result.text, equals('今天，天气'));
+      expect(result.tokens, equals(['今', '天', '，', '天', '气']));
+      expect(result.lang, equals('zh'));
+      expect(result.timestamps.length, equals(result.tokens.length));
+      expect(transcript.replacedCount, equals(1));
+    });
+
+    test('第二遍时间戳按语音段起点偏移', () {
+      final transcript = TwoPassTranscript();
+      transcript.close(first(['a']), 0);
+      transcript.close(first(['a', 'b']), 2.0);
+      transcript.replace(
+        1,
+        const ASRResult(text: 'B', tokens: ['B'], timestamps: [0.5]),
+      );
+      final result = transcript.compose(first(['a', 'b']));
+      expect(result.text, equals('aB'));
+      expect(result.timestamps, equals([0.0, 2.5]));
+    });
+
+    test('英文子词按词首标记还原空格', () {
+      final transcript = TwoPassTranscript();
+      transcript.close(first(['▁HE', 'LLO']), 0);
+      transcript.replace(
+        0,
+        const ASRResult(text: 'Hello.', tokens: ['▁Hello', '.']),
+      );
+      final result = transcript.compose(first(['▁HE', 'LLO', '▁WOR', 'LD']));
+      expect(result.text, equals('Hello. WORLD'));
+      // 第二遍缺少时间戳时整体不提供时间戳
+      expect(result.timestamps, isEmpty);
+    });
+
+    test('空的第二遍结果不替换', () {
+      final transcript = TwoPassTranscript();
+      final result = first(['嗯']);
+      transcript.close(result, 0);
+      transcript.replace(0, ASRResult.empty());
+      expect(transcript.replacedCount, equals(0));
+      expect(transcript.compose(result).text, equals('嗯'));
+    });
+
+    test('clear 后重新从第一个 token 切分', () {
+      final transcript = TwoPassTranscript();
+      transcript.close(first(['一', '二']), 0);
+      transcript.clear();
+      expect(transcript.segmentCount, equals(0));
+      expect(transcript.close(first(['三']), 0), equals(0));
+    });
+  });
+}
@@ -0,0 +1,73 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/constants/settings_constants.dart';
+import 'package:voice_capsule/services/chunk_scheduler.dart';
+
+void main() {
+  /// 按调度器给出的块长送入 [ms] 毫秒音频，返回每块的样本数
+  List<int> run(ChunkScheduler scheduler, int ms) {
+    final blocks = <int>[];
+    while (scheduler.elapsedMs < ms) {
+      final samples = scheduler.targetSamples;
+      blocks.add(samples);
+      scheduler.advance(samples);
+    }
+    return blocks;
+  }
+
+  group('ChunkScheduler 块长调度', () {
+    test('fixed 策略始终为 100ms', () {
+      final blocks = run(ChunkScheduler(ChunkPolicy.fixed), 3000);
+      expect(blocks.toSet(), equals({1600}));
+    });
+
+    test('adaptive 策略首秒 20ms，之后加倍到 100ms', () {
+      final scheduler = ChunkScheduler(ChunkPolicy.adaptive);
+      final blocks = run(scheduler, 3000);
+
+      // 首秒: 50 个 20ms 块
+      expect(blocks.take(50).toSet(), equals({320}));
+      // 之后每块加倍直到上限: 40ms, 80ms, 100ms
+      expect(blocks.sublist(50, 53), equals([640, 1280, 1600]));
+      expect(blocks.skip(53).toSet(), equals({1600}));
+      expect(scheduler.targetMs, equals(100));
+    });
+
+    test('reset 回到起始块长', () {
+      final scheduler = ChunkScheduler(ChunkPolicy.adaptive);
+      run(scheduler, 2000);
+      scheduler.reset();
+      expect(scheduler.targetMs, equals(20));
+      expect(scheduler.elapsedMs, equals(0));
+    });
+
+    test('读取不足时按实际样本数计时', () {
+      final scheduler = ChunkScheduler(ChunkPolicy.adaptive);
+      scheduler.advance(0);
+      expect(scheduler.elapsedMs, equals(0));
+      scheduler.advance(160);
+      expect(scheduler.elapsedMs, equals(10));
+    });
+  });
+
+  group('ChunkPolicy', () {
+    test('超出范围的块长被截断', () {
+      final scheduler = ChunkScheduler(
+        const ChunkPolicy(name: 'custom', initialMs: 5, steadyMs: 500),
+      );
+      expect(scheduler.targetMs, equals(ChunkPolicy.minChunkMs));
+      expect(scheduler.policy.steadyMs, equals(ChunkPolicy.maxChunkMs));
+    });
+
+    test('按名称查找内置策略', () {
+      expect(ChunkPolicy.byName('adaptive'), same(ChunkPolicy.adaptive));
+      expect(ChunkPolicy.byName('unknown'), isNull);
+    });
+
+    test('引擎默认策略', () {
+      expect(ChunkPolicy.forEngine(EngineType.zipformer).initialMs, equals(20));
+      final senseVoice = ChunkPolicy.forEngine(EngineType.sensevoice);
+      expect(senseVoice.initialMs, equals(32));
+      expect(senseVoice.steadyMs, equals(96));
+    });
+  });
+}
@@ -0,0 +1,60 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/constants/settings_constants.dart';
+import 'package:voice_capsule/services/cpu_profile.dart';
+
+void main() {
+  group('CpuProfile 模型版本选择', () {
+    test('没有 AVX2 的 x86 CPU 使用标准版本', () {
+      final cpu = CpuProfile('x86_64');
+      expect(cpu.arch, equals('x86_64'));
+      expect(cpu.preferredModelType, equals(ModelType.standard));
+      expect(cpu.modelTypeReason, contains('AVX2'));
+    });
+
+    test('有 AVX2 的 x86 CPU 使用 int8', () {
+      final cpu = CpuProfile('x86_64+avx2+fma');
+      expect(cpu.preferredModelType, equals(ModelType.int8));
+      expect(cpu.int8Extension, isNull);
+    });
+
+    test('int8 加速指令按加速程度报告', () {
+      final cpu =
+          CpuProfile('x86_64+avx2+fma+avx512f+avx512vnni+avxvnni+amxint8');
+      expect(cpu.preferredModelType, equals(ModelType.int8));
+      expect(cpu.int8Extension, equals('amxint8'));
+      expect(cpu.modelTypeReason, contains('amxint8'));
+      expect(CpuProfile('aarch64+asimddp+i8mm').int8Extension, equals('i8mm'));
+    });
+
+    test('未知 CPU 按默认规则使用 int8', () {
+      final cpu = CpuProfile('generic');
+      expect(cpu.preferredModelType, equals(ModelType.int8));
+      expect(cpu.modelTypeReason, equals('默认'));
+    });
+  });
+
+  group('CpuProfile 执行提供者选择', () {
+    test('arm64 上 onnxruntime 带有 XNNPACK 时使用 xnnpack', () {
+      final cpu = CpuProfile('aarch64+asimddp', providers: const [
+        CpuProfile.xnnpackProvider,
+        'CPUExecutionProvider',
+      ]);
+      expect(cpu.preferredProvider, equals('xnnpack'));
+    });
+
+    test('没有 XNNPACK 或在 x86 上使用 cpu', () {
+      expect(
+        CpuProfile('aarch64', providers: const ['CPUExecutionProvider'])
+            .preferredProvider,
+        equals('cpu'),
+      );
+      expect(
+        CpuProfile('x86_64+avx2', providers: const [
+          CpuProfile.xnnpackProvider,
+          'CPUExecutionProvider',
+        ]).preferredProvider,
+        equals('cpu'),
+      );
+    });
+  });
+}
@@ -0,0 +1,146 @@
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/services/energy_gate.dart';
+
+void main() {
+  // 100ms @ 16kHz
+  const block = 1600;
+
+  group('EnergyGate 判定', () {
+    test('启动时处于拖尾中，拖尾结束后拦下静音', () {
+      final gate = EnergyGate(
+        config: const EnergyGateConfig(hangoverMs: 300),
+      );
+      expect(gate.process(-70, block), isTrue);
+      expect(gate.process(-70, block), isTrue);
+      expect(gate.process(-70, block), isTrue);
+      expect(gate.process(-70, block), isFalse);
+      expect(gate.isOpen, isFalse);
+      expect(gate.stats.gatedMs, equals(100));
+      expect(gate.stats.totalMs, equals(400));
+    });
+
+    test('高于噪声底的块重新打开门限并重置拖尾', () {
+      final gate = EnergyGate(
+        config: const EnergyGateConfig(hangoverMs: 200),
+      );
+      for (var i = 0; i < 20; i++) {
+        gate.process(-70, block);
+      }
+      expect(gate.isOpen, isFalse);
+      expect(gate.process(-30, block), isTrue);
+      expect(gate.process(-70, block), isTrue);
+      expect(gate.process(-70, block), isTrue);
+      expect(gate.process(-70, block), isFalse);
+    });
+
+    test('噪声底快速下降、缓慢上升', () {
+      final gate = EnergyGate(
+        config: const EnergyGateConfig(initialFloorDbfs: -40),
+      );
+      for (var i = 0; i < 10; i++) {
+        gate.process(-70, block);
+      }
+      expect(gate.noiseFloorDbfs, lessThan(-69));
+
+      // 持续的风扇噪声: 噪声底逐步跟上，最终不再判为语音
+      for (var i = 0; i < 300; i++) {
+        gate.process(-62, block);
+      }
+      expect(gate.noiseFloorDbfs, closeTo(-62, 1));
+      expect(gate.process(-62, block), isFalse, reason: '持续噪声不应打开门限');
+    });
+
+    test('数字静音不拉低噪声底', () {
+      final gate = EnergyGate();
+      final floor = gate.noiseFloorDbfs;
+      gate.process(-100, block);
+      expect(gate.noiseFloorDbfs, equals(floor));
+    });
+
+    test('reset 清零统计并重新进入拖尾', () {
+      final gate = EnergyGate(
+        config: const EnergyGateConfig(hangoverMs: 100),
+      );
+      gate.process(-70, block);
+      gate.process(-70, block);
+      expect(gate.stats.gatedMs, greaterThan(0));
+      gate.reset();
+      expect(gate.stats.gatedMs, equals(0));
+      expect(gate.isOpen, isTrue);
+    });
+  });
+
+  group('EnergyGate 预录缓冲', () {
+    late Pointer<Float> buffer;
+
+    setUp(() {
+      buffer = calloc<Float>(block);
+    });
+
+    tearDown(() {
+      calloc.free(buffer);
+    });
+
+    void fill(double value) {
+      buffer.asTypedList(block).fillRange(0, block, value);
+    }
+
+    test('只保留最近 prerollMs 的音频，按时间顺序补送', () {
+      final gate = EnergyGate(
+        config: const EnergyGateConfig(hangoverMs: 0, prerollMs: 150),
+      );
+      for (final v in [0.1, 0.2, 0.3]) {
+        fill(v);
+        expect(gate.process(-70, block), isFalse);
+        gate.hold(buffer, block);
+      }
+
+      final drained = <double>[];
+      gate.drainHeld((data, samples) {
+        drained.addAll(data.asTypedList(samples));
+      });
+      expect(drained.length, equals(2400));
+      expect(drained.first, closeTo(0.2, 1e-6));
+      expect(drained[799], closeTo(0.2, 1e-6));
+      expect(drained[800], closeTo(0.3, 1e-6));
+      expect(drained.last, closeTo(0.3, 1e-6));
+
+      // 补送的音频不计入拦下时长
+      expect(gate.stats.gatedMs, equals(150));
+
+      var called = false;
+      gate.drainHeld((_, __) => called = true);
+      expect(called, isFalse, reason: '取出后缓冲应为空');
+      gate.dispose();
+    });
+  });
+
+  group('EnergyGate 统计', () {
+    test('按实测解码耗时估算节省', () {
+      final gate = EnergyGate(
+        config: const EnergyGateConfig(hangoverMs: 0),
+      );
+      gate.process(-20, block * 10);
+      gate.recordDecode(block * 10, const Duration(milliseconds: 50));
+      for (var i = 0; i < 100; i++) {
+        gate.process(-70, block);
+      }
+      final stats = gate.stats;
+      expect(stats.decodeMsPerAudioSec, closeTo(50, 1e-9));
+      expect(stats.gatedMs, equals(10000));
+      expect(stats.savedDecodeMs, closeTo(500, 1e-9));
+      expect(stats.toString(), contains('saved: 500ms'));
+    });
+
+    test('measureDbfs 计算平均电平', () {
+      final buffer = calloc<Float>(block);
+      expect(EnergyGate.measureDbfs(buffer, block), equals(-100.0));
+      buffer.asTypedList(block).fillRange(0, block, 0.1);
+      expect(EnergyGate.measureDbfs(buffer, block), closeTo(-20, 1e-3));
+      calloc.free(buffer);
+    });
+  });
+}
@@ -0,0 +1,157 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/services/hybrid_endpoint_detector.dart';
+
+void main() {
+  const chunk = 0.1;
+  final t0 = DateTime(2025, 1, 1);
+
+  DateTime at(int i) => t0.add(Duration(milliseconds: (i + 1) * 100));
+
+  /// 送入 [speechChunks] 个语音块后持续静音，返回触发端点时的静音块数 (未触发为 null)
+  int? silenceChunksUntilEndpoint(
+    HybridEndpointDetector detector, {
+    required int speechChunks,
+    bool hasText = true,
+    int maxSilenceChunks = 30,
+  }) {
+    var i = 0;
+    for (; i < speechChunks; i++) {
+      detector.update(
+        speech: true,
+        seconds: chunk,
+        chunkEnd: at(i),
+        hasText: hasText,
+        textChanged: hasText,
+      );
+    }
+    for (var s = 1; s <= maxSilenceChunks; s++, i++) {
+      if (detector.update(
+        speech: false,
+        seconds: chunk,
+        chunkEnd: at(i),
+        hasText: hasText,
+        textChanged: false,
+      )) {
+        return s;
+      }
+    }
+    return null;
+  }
+
+  group('HybridEndpointDetector 置信度加权', () {
+    test('长语音后只需短静音', () {
+      final detector = HybridEndpointDetector();
+      // 2 秒语音: 完全可信，所需静音 0.4s (含 VAD 去抖 0.1s)
+      expect(silenceChunksUntilEndpoint(detector, speechChunks: 20), equals(3));
+    });
+
+    test('短语音需要更长静音，上限为 maxSilenceSec', () {
+      final detector = HybridEndpointDetector();
+      // 0.5 秒语音: 置信度 1/3，所需静音约 0.93s
+      final chunks = silenceChunksUntilEndpoint(detector, speechChunks: 5)!;
+      expect(chunks, greaterThan(3));
+      expect(chunks * chunk + 0.1, lessThanOrEqualTo(1.2 + chunk));
+    });
+
+    test('所需静音随语音时长单调不增', () {
+      const config = HybridEndpointConfig();
+      final detector = HybridEndpointDetector(config: config);
+      expect(detector.requiredSilenceSec, equals(config.maxSilenceSec));
+      var previous = detector.requiredSilenceSec;
+      for (var i = 0; i < 20; i++) {
+        detector.update(
+          speech: true,
+          seconds: chunk,
+          chunkEnd: at(i),
+          hasText: true,
+          textChanged: false,
+        );
+        expect(detector.requiredSilenceSec, lessThanOrEqualTo(previous));
+        previous = detector.requiredSilenceSec;
+      }
+      expect(previous, closeTo(config.minSilenceSec, 1e-9));
+    });
+
+    test('没有识别文本时不触发，交给规则端点', () {
+      final detector = HybridEndpointDetector();
+      expect(
+        silenceChunksUntilEndpoint(detector, speechChunks: 20, hasText: false),
+        isNull,
+      );
+    });
+
+    test('过短的语音 (咳嗽等) 不触发', () {
+      final detector = HybridEndpointDetector();
+      expect(silenceChunksUntilEndpoint(detector, speechChunks: 2), isNull);
+    });
+
+    test('静音期间识别文本仍在变化时重新计时', () {
+      final detector = HybridEndpointDetector();
+      for (var i = 0; i < 20; i++) {
+        detector.update(
+          speech: true,
+          seconds: chunk,
+          chunkEnd: at(i),
+          hasText: true,
+          textChanged: true,
+        );
+      }
+      expect(
+        detector.update(
+            speech: false,
+            seconds: chunk,
+            chunkEnd: at(20),
+            hasText: true,
+            textChanged: false),
+        isFalse,
+      );
+      // 尾字在静音中才输出
+      expect(
+        detector.update(
+            speech: false,
+            seconds: chunk,
+            chunkEnd: at(21),
+            hasText: true,
+            textChanged: true),
+        isFalse,
+      );
+      expect(detector.silenceSec, closeTo(0.1, 1e-9));
+    });
+  });
+
+  group('HybridEndpointDetector 状态', () {
+    test('记录最后一个语音块的结束时刻，触发后等待新语音', () {
+      final detector = HybridEndpointDetector();
+      expect(detector.lastSpeechEnd, isNull);
+      expect(silenceChunksUntilEndpoint(detector, speechChunks: 20), equals(3));
+      expect(detector.lastSpeechEnd, equals(at(19)));
+      expect(detector.speechSec, equals(0));
+
+      // 触发后继续静音不会再次触发
+      for (var i = 0; i < 30; i++) {
+        expect(
+          detector.update(
+              speech: false,
+              seconds: chunk,
+              chunkEnd: at(30 + i),
+              hasText: true,
+              textChanged: false),
+          isFalse,
+        );
+      }
+    });
+
+    test('reset 清空语音结束时刻', () {
+      final detector = HybridEndpointDetector();
+      detector.update(
+          speech: true,
+          seconds: chunk,
+          chunkEnd: at(0),
+          hasText: true,
+          textChanged: true);
+      detector.reset();
+      expect(detector.lastSpeechEnd, isNull);
+      expect(detector.speechSec, equals(0));
+    });
+  });
+}
@@ -0,0 +1,64 @@
+import 'dart:io';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/services/ort_model_cache.dart';
+
+void main() {
+  group('OrtModelCache', () {
+    late Directory tempDir;
+    late File model;
+
+    setUp(() async {
+      tempDir = await Directory.systemTemp.createTemp('nextalk_ort_test_');
+      model = File('${tempDir.path}/model/encoder.int8.onnx')
+        ..createSync(recursive: true)
+        ..writeAsBytesSync([1, 2, 3]);
+      OrtModelCache.instance.enabled = true;
+    });
+
+    tearDown(() async {
+      if (tempDir.existsSync()) {
+        await tempDir.delete(recursive: true);
+      }
+    });
+
+    test('缓存未生成时返回原模型路径', () {
+      expect(OrtModelCache.instance.resolve(model.path, provider: 'cpu'),
+          equals(model.path));
+    });
+
+    test('关闭时不记录未命中', () {
+      OrtModelCache.instance.enabled = false;
+      final missed = OrtModelCache.instance.missed.length;
+      expect(OrtModelCache.instance.resolve(model.path, provider: 'cpu'),
+          equals(model.path));
+      expect(OrtModelCache.instance.missed.length, equals(missed));
+    });
+
+    test('非 cpu 提供者不使用缓存，也不记录未命中', () {
+      // 缓存副本含 CPU 专用的融合算子，其他提供者无法执行
+      expect(OrtModelCache.supportsProvider('cpu'), isTrue);
+      expect(OrtModelCache.supportsProvider('xnnpack'), isFalse);
+      final missed = OrtModelCache.instance.missed.length;
+      expect(OrtModelCache.instance.resolve(model.path, provider: 'xnnpack'),
+          equals(model.path));
+      expect(OrtModelCache.instance.missed.length, equals(missed));
+    });
+
+    test('缓存路径包含模型目录、大小与修改时间', () {
+      final cached = OrtModelCache.instance.cachePathFor(model.path);
+      // 原生库不可用时无法确定缓存键
+      if (cached == null) return;
+      expect(cached, startsWith(OrtModelCache.rootDirectory));
+      expect(cached, matches(RegExp(r'/model/encoder\.int8-3-\d+\.ort$')));
+    });
+
+    test('非 ONNX 文件不缓存', () {
+      final tokens = File('${tempDir.path}/model/tokens.txt')
+        ..writeAsStringSync('a 0');
+      expect(OrtModelCache.instance.cachePathFor(tokens.path), isNull);
+      expect(OrtModelCache.instance.resolve(tokens.path, provider: 'cpu'),
+          equals(tokens.path));
+    });
+  });
+}
@@ -0,0 +1,117 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/services/pause_statistics.dart';
+
+void main() {
+  const chunk = 0.1;
+
+  /// 模拟一句话: 语音与 [pauses] 中的停顿交替
+  void speak(PauseStatistics stats, List<double> pauses) {
+    stats.feed(true, chunk);
+    for (final pause in pauses) {
+      for (var t = 0.0; t < pause - 1e-9; t += chunk) {
+        stats.feed(false, chunk);
+      }
+      stats.feed(true, chunk);
+    }
+    stats.endUtterance();
+  }
+
+  group('PauseStatistics 句内停顿', () {
+    test('只记录之后继续说话的停顿', () {
+      final stats = PauseStatistics();
+      speak(stats, [0.3, 0.5]);
+      expect(stats.sampleWeight, equals(2));
+
+      // 尾部静音 (端点) 不计入
+      stats.feed(true, chunk);
+      stats.feed(false, chunk);
+      stats.feed(false, chunk);
+      stats.endUtterance();
+      stats.feed(true, chunk);
+      expect(stats.sampleWeight, equals(2));
+    });
+
+    test('过短 (音节间隙) 与过长 (两句之间) 的停顿被忽略', () {
+      final stats = PauseStatistics();
+      speak(stats, [0.1, 2.5]);
+      expect(stats.sampleWeight, equals(0));
+    });
+
+    test('无样本时使用默认阈值', () {
+      expect(PauseStatistics().recommendedThresholdSec(1.2), equals(1.2));
+    });
+  });
+
+  group('PauseStatistics 阈值推荐', () {
+    test('停顿短的用户阈值下降，但不低于下限', () {
+      final stats = PauseStatistics();
+      for (var i = 0; i < 100; i++) {
+        speak(stats, [0.2, 0.3]);
+      }
+      final threshold = stats.recommendedThresholdSec(1.2);
+      expect(threshold, lessThan(1.2));
+      expect(threshold, greaterThanOrEqualTo(PauseStatistics.minThresholdSec));
+    });
+
+    test('习惯长停顿的用户阈值上升，但不超过上限', () {
+      final stats = PauseStatistics();
+      for (var i = 0; i < 100; i++) {
+        speak(stats, [1.2, 1.6]);
+      }
+      final threshold = stats.recommendedThresholdSec(1.2);
+      expect(threshold, greaterThan(1.2));
+      expect(threshold, lessThanOrEqualTo(PauseStatistics.maxThresholdSec));
+    });
+
+    test('阈值不低于 90 分位停顿加余量 (避免截断)', () {
+      final stats = PauseStatistics();
+      for (var i = 0; i < 100; i++) {
+        speak(stats, [0.3, 0.3, 0.3, 0.3, 0.3, 0.3, 0.3, 0.3, 0.3, 0.8]);
+      }
+      final p90 = stats.quantileSec(PauseStatistics.quantile)!;
+      expect(stats.recommendedThresholdSec(1.2),
+          greaterThanOrEqualTo(p90 + PauseStatistics.marginSec - 1e-9));
+    });
+
+    test('样本不足时向默认值收缩', () {
+      final few = PauseStatistics();
+      speak(few, [0.2, 0.2, 0.2, 0.2, 0.2]);
+      final many = PauseStatistics();
+      for (var i = 0; i < 20; i++) {
+        speak(many, [0.2, 0.2, 0.2, 0.2, 0.2]);
+      }
+      expect(few.recommendedThresholdSec(1.2),
+          greaterThan(many.recommendedThresholdSec(1.2)));
+    });
+
+    test('每次录音开始时旧样本衰减', () {
+      final stats = PauseStatistics();
+      speak(stats, [0.3, 0.3]);
+      stats.beginSession();
+      expect(stats.sampleWeight, closeTo(2 * PauseStatistics.sessionDecay, 1e-9));
+    });
+  });
+
+  group('PauseStatistics 持久化', () {
+    test('JSON 往返保持分布', () {
+      final stats = PauseStatistics();
+      for (var i = 0; i < 30; i++) {
+        speak(stats, [0.4, 0.7]);
+      }
+      final restored = PauseStatistics.fromJson(stats.toJson());
+      expect(restored.sampleWeight, closeTo(stats.sampleWeight, 1e-6));
+      expect(restored.quantileSec(0.9), equals(stats.quantileSec(0.9)));
+      expect(restored.recommendedThresholdSec(1.2),
+          closeTo(stats.recommendedThresholdSec(1.2), 1e-6));
+    });
+
+    test('无效或不兼容的数据返回空统计', () {
+      expect(PauseStatistics.fromJson(null).sampleWeight, equals(0));
+      expect(PauseStatistics.fromJson('not json').sampleWeight, equals(0));
+      expect(
+        PauseStatistics.fromJson('{"bin_ms": 100, "bins": [1, 2]}').sampleWeight,
+        equals(0),
+      );
+    });
+  });
+}
@@ -185,10 +185,58 @@ void main() {
     test('zipformer 配置块包含 type 和 custom_url', () {
       final yaml = SettingsConstants.defaultSettingsYaml;
       // 使用正则表达式验证 zipformer 配置块结构 (注意: 有注释行在中间)
-      expect(yaml, matches(RegExp(r'zipformer:[\s\S]*type:\s*int8')));
+      expect(yaml, matches(RegExp(r'zipformer:[\s\S]*type:\s*auto')));
       expect(yaml, matches(RegExp(r'zipformer:[\s\S]*custom_url:')));
     });
 
+    test('旧模板默认的 zipformer.type: int8 迁移为与新模板一致的 auto', () {
+      const legacy = '''
+model:
+  zipformer:
+    # 模型版本: int8 | standard
+    # int8: 量化版本，速度快，内存占用小
+    # standard: 标准版本，精度高
+    type: int8
+
+    # 自定义模型下载地址 (留空使用默认地址)
+    custom_url: ""
+''';
+      final migrated = SettingsService.migrateLegacyModelType(legacy);
+      expect(migrated, contains('    type: auto\n'));
+      expect(migrated, isNot(contains('type: int8')));
+      expect(migrated, contains('    custom_url: ""'));
+      expect(migrated, contains('    # 模型版本: auto | int8 | standard\n'));
+    });
+
+    test('英文旧模板同样迁移', () {
+      const legacy = '''
+  zipformer:
+    # Model version: int8 | standard
+    # int8: Quantized version, faster, less memory
+    # standard: Standard version, higher accuracy
+    type: int8
+''';
+      expect(SettingsService.migrateLegacyModelType(legacy),
+          contains('    type: auto\n'));
+    });
+
+    test('用户修改过的模型版本不迁移', () {
+      const edited = '''
+  zipformer:
+    # 模型版本: int8 | standard
+    # int8: 量化版本，速度快，内存占用小
+    # standard: 标准版本，精度高
+    type: standard
+''';
+      expect(SettingsService.migrateLegacyModelType(edited), equals(edited));
+
+      // 新模板中明确写 int8 是用户的选择
+      final explicit = SettingsConstants.defaultSettingsYaml
+          .replaceFirst('type: auto', 'type: int8');
+      expect(
+          SettingsService.migrateLegacyModelType(explicit), equals(explicit));
+    });
+
     test('sensevoice 配置块包含 use_itn, language, custom_url', () {
       final yaml = SettingsConstants.defaultSettingsYaml;
       // 验证 sensevoice 配置块包含所有必需字段 (注意: 有注释行在中间)
@@ -290,5 +338,170 @@ void main() {
     test('setAudioInputDevice 方法存在', () {
       expect(SettingsService.instance.setAudioInputDevice, isA<Function>());
     });
+
+    test('audioTargetLatencyMs getter 存在', () {
+      expect(() => SettingsService.instance.audioTargetLatencyMs, returnsNormally);
+    });
+
+    test('audioTargetLatencyMs 默认值在有效范围内', () {
+      expect(
+        SettingsConstants.defaultAudioTargetLatencyMs,
+        inInclusiveRange(
+          SettingsConstants.minAudioTargetLatencyMs,
+          SettingsConstants.maxAudioTargetLatencyMs,
+        ),
+      );
+    });
+
+    test('默认以设备原生格式采集，模板包含 device_native_format', () {
+      expect(SettingsConstants.defaultAudioDeviceNativeFormat, isTrue);
+      expect(() => SettingsService.instance.audioDeviceNativeFormat, returnsNormally);
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'audio:[\s\S]*device_native_format:\s*true')),
+      );
+    });
+
+    test('预录模式默认关闭 (需用户主动开启)', () {
+      expect(SettingsConstants.defaultAudioPrerollMs, equals(0));
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'audio:[\s\S]*preroll_ms:\s*0')),
+      );
+    });
+
+    test('端点检测默认使用规则模式，模板包含 endpoint_mode', () {
+      expect(SettingsConstants.defaultEndpointMode, equals(EndpointMode.rules));
+      expect(() => SettingsService.instance.audioEndpointMode, returnsNormally);
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'audio:[\s\S]*endpoint_mode:\s*rules')),
+      );
+    });
+
+    test('默认启用自适应端点静音，模板包含 adaptive_silence', () {
+      expect(SettingsConstants.defaultAudioAdaptiveSilence, isTrue);
+      expect(() => SettingsService.instance.audioAdaptiveSilence, returnsNormally);
+      expect(() => SettingsService.instance.pauseStatistics, returnsNormally);
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'audio:[\s\S]*adaptive_silence:\s*true')),
+      );
+    });
+
+    test('SenseVoice 中间解码默认值，模板包含 partial_interval_ms', () {
+      expect(SettingsConstants.defaultSenseVoicePartialIntervalMs, equals(500));
+      expect(SettingsConstants.defaultSenseVoicePartialMaxLoad, equals(0.5));
+      expect(
+        () => SettingsService.instance.senseVoicePartialIntervalMs,
+        returnsNormally,
+      );
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'sensevoice:[\s\S]*partial_interval_ms:\s*500')),
+      );
+    });
+
+    test('两遍识别默认关闭，模板包含 two_pass', () {
+      expect(SettingsConstants.defaultTwoPassEnabled, isFalse);
+      expect(SettingsConstants.defaultTwoPassNumThreads, equals(1));
+      expect(SettingsConstants.defaultTwoPassMaxWaitMs, equals(800));
+      expect(() => SettingsService.instance.twoPassEnabled, returnsNormally);
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'zipformer:[\s\S]*two_pass:\s*enabled:\s*false')),
+      );
+    });
+
+    test('默认不空闲卸载模型，模板包含 idle_unload_min', () {
+      expect(SettingsConstants.defaultIdleUnloadMin, equals(0));
+      expect(() => SettingsService.instance.idleUnloadAfter, returnsNormally);
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'model:[\s\S]*idle_unload_min:\s*0')),
+      );
+    });
+
+    test('常驻识别宿主默认关闭，模板包含 engine_host', () {
+      expect(SettingsConstants.defaultEngineHostEnabled, isFalse);
+      expect(SettingsConstants.defaultEngineHostIdleTimeoutMin, equals(30));
+      expect(() => SettingsService.instance.engineHostEnabled, returnsNormally);
+      expect(
+        SettingsService.instance.engineHostIdleTimeoutMin,
+        inInclusiveRange(1, SettingsConstants.maxEngineHostIdleTimeoutMin),
+      );
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'zipformer:[\s\S]*engine_host:\s*enabled:\s*false')),
+      );
+    });
+
+    test('模型版本与执行提供者默认自动，模板包含 provider: auto', () {
+      expect(SettingsConstants.defaultProvider, equals('auto'));
+      expect(
+        SettingsService.instance.provider,
+        isIn(['cpu', 'xnnpack']),
+      );
+      expect(() => SettingsService.instance.modelType, returnsNormally);
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'model:[\s\S]*provider:\s*auto')),
+      );
+    });
+
+    test('推理线程数默认自动，模板两个引擎都包含 num_threads: 0', () {
+      for (final engine in EngineType.values) {
+        expect(
+          SettingsService.instance.numThreadsFor(engine),
+          inInclusiveRange(1, SettingsConstants.maxNumThreads),
+        );
+      }
+      expect(SettingsConstants.defaultNumThreads, equals(2));
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'zipformer:[\s\S]*num_threads:\s*0[\s\S]*two_pass:')),
+      );
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'sensevoice:[\s\S]*num_threads:\s*0')),
+      );
+    });
+
+    test('默认缓存优化模型，模板包含 ort_cache', () {
+      expect(SettingsConstants.defaultOrtModelCache, isTrue);
+      expect(() => SettingsService.instance.ortModelCache, returnsNormally);
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'model:[\s\S]*ort_cache:\s*true')),
+      );
+    });
+
+    test('默认启用提前上屏，模板包含 early_commit', () {
+      expect(SettingsConstants.defaultAudioEarlyCommit, isTrue);
+      expect(() => SettingsService.instance.audioEarlyCommit, returnsNormally);
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'audio:[\s\S]*early_commit:\s*true')),
+      );
+    });
+
+    test('分块策略未覆盖时使用引擎默认值，模板包含注释的 chunk_ms', () {
+      for (final engine in EngineType.values) {
+        final policy = SettingsService.instance.chunkPolicyFor(engine);
+        expect(policy.initialMs, greaterThanOrEqualTo(20));
+        expect(policy.steadyMs, lessThanOrEqualTo(100));
+      }
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'zipformer:[\s\S]*# first_chunk_ms: 20')),
+      );
+    });
+
+    test('默认配置模板包含 target_latency_ms', () {
+      expect(
+        SettingsConstants.defaultSettingsYaml,
+        matches(RegExp(r'audio:[\s\S]*target_latency_ms:\s*20')),
+      );
+    });
   });
 }
@@ -0,0 +1,119 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/services/asr/asr_engine.dart';
+import 'package:voice_capsule/services/stability_tracker.dart';
+
+void main() {
+  ASRResultDelta delta(
+    int kept,
+    List<String> tokens,
+    List<double> timestamps,
+    String text,
+  ) =>
+      ASRResultDelta(
+        keptTokens: kept,
+        tokens: tokens,
+        timestamps: timestamps,
+        text: text,
+      );
+
+  group('StabilityTracker 稳定前缀', () {
+    test('连续 3 次不变且落后最新 token 1 秒的 token 才输出', () {
+      final tracker = StabilityTracker();
+      final out = [
+        tracker.update(delta(0, ['你'], [0.0], '你')),
+        tracker.update(delta(1, ['好'], [0.3], '你好')),
+        tracker.update(delta(2, ['世'], [1.2], '你好世')),
+        tracker.update(delta(3, ['界'], [1.5], '你好世界')),
+      ];
+      expect(out, equals(['', '', '你', '好']));
+      expect(tracker.stableText, equals('你好'));
+    });
+
+    test('被修正的 token 重新计数', () {
+      final tracker = StabilityTracker();
+      tracker.update(delta(0, ['你'], [0.0], '你'));
+      tracker.update(delta(1, ['号'], [0.3], '你号'));
+      tracker.update(delta(1, ['好'], [0.3], '你好'));
+      // "你" 已满 3 次，"好" 刚被修正
+      expect(tracker.update(delta(2, ['世'], [1.4], '你好世')), equals('你'));
+      expect(tracker.update(delta(3, ['界'], [1.6], '你好世界')), equals('好'));
+    });
+
+    test('不在英文单词中间截断', () {
+      final tracker = StabilityTracker();
+      tracker.update(delta(0, ['▁HE'], [0.0], 'HE'));
+      tracker.update(delta(1, ['LLO'], [0.6], 'HELLO'));
+      // "▁HE" 已稳定但 "LLO" 未稳定，不输出半个单词
+      expect(
+        tracker.update(delta(2, ['▁WORLD'], [1.2], 'HELLO WORLD')),
+        isEmpty,
+      );
+      expect(
+        tracker.update(delta(3, ['▁AGAIN'], [1.8], 'HELLO WORLD AGAIN')),
+        equals('HELLO'),
+      );
+    });
+
+    test('没有时间戳时不提前输出', () {
+      final tracker = StabilityTracker();
+      for (var i = 0; i < 6; i++) {
+        expect(
+          tracker.update(delta(i, ['字'], const [], '字' * (i + 1))),
+          isEmpty,
+        );
+      }
+    });
+
+    test('已输出部分被修正时暂停输出', () {
+      final tracker = StabilityTracker();
+      tracker.update(delta(0, ['你'], [0.0], '你'));
+      tracker.update(delta(1, ['好'], [0.3], '你好'));
+      tracker.update(delta(2, ['世'], [1.2], '你好世'));
+      expect(tracker.stableText, equals('你'));
+
+      expect(
+        tracker.update(delta(0, ['泥', '好'], [0.0, 1.5], '泥好')),
+        isEmpty,
+      );
+      // "泥" 满足稳定条件，但与已输出的 "你" 不连续
+      for (var i = 0; i < 3; i++) {
+        expect(tracker.update(delta(2, const [], const [], '泥好')), isEmpty);
+      }
+      expect(tracker.stableText, equals('你'));
+    });
+
+    test('reset 清空状态', () {
+      final tracker = StabilityTracker();
+      tracker.update(delta(0, ['你'], [0.0], '你'));
+      tracker.update(delta(1, ['好'], [0.3], '你好'));
+      tracker.update(delta(2, ['世'], [1.2], '你好世'));
+      tracker.reset();
+      expect(tracker.stableText, isEmpty);
+      expect(tracker.result.tokens, isEmpty);
+    });
+  });
+
+  group('StabilityTracker.remainder', () {
+    test('去掉已提交的前缀', () {
+      expect(StabilityTracker.remainder('你好', '你好世界'), equals('世界'));
+      expect(StabilityTracker.remainder('', '你好'), equals('你好'));
+      expect(StabilityTracker.remainder('你好', '你好'), isEmpty);
+    });
+
+    test('最终结果修正已提交部分时按位置提交其后的内容', () {
+      // 已上屏的 "北京" 无法撤回，但其后说出的 "吃饭" 仍需提交
+      expect(StabilityTracker.diverges('我想去北京', '我想去背景吃饭'), isTrue);
+      expect(StabilityTracker.remainder('我想去北京', '我想去背景吃饭'), equals('吃饭'));
+    });
+
+    test('最终结果短于已提交文本时不再提交', () {
+      expect(StabilityTracker.diverges('你好世界', '你好'), isTrue);
+      expect(StabilityTracker.remainder('你好世界', '你好'), isEmpty);
+    });
+
+    test('最终结果延续已提交文本时不视为分歧', () {
+      expect(StabilityTracker.diverges('', '你好'), isFalse);
+      expect(StabilityTracker.diverges('你好', '你好世界'), isFalse);
+    });
+  });
+}
@@ -0,0 +1,88 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:voice_capsule/constants/settings_constants.dart';
+import 'package:voice_capsule/services/thread_calibration.dart';
+
+void main() {
+  /// 5 秒音频在 [threads] 个线程下耗时 [wallMs] / CPU [cpuMs]
+  ThreadTiming timing(int threads, int wallMs, int cpuMs) => ThreadTiming(
+        threads: threads,
+        wall: Duration(milliseconds: wallMs),
+        cpu: Duration(milliseconds: cpuMs),
+        audioSec: 5.0,
+      );
+
+  group('ThreadCalibration.pick', () {
+    test('无测量结果时使用默认线程数', () {
+      expect(ThreadCalibration.pick([]),
+          equals(SettingsConstants.defaultNumThreads));
+    });
+
+    test('多线程明显更快且 CPU 开销相近时取更多线程', () {
+      final n = ThreadCalibration.pick([
+        timing(1, 1000, 1000),
+        timing(2, 550, 1050),
+        timing(4, 300, 1150),
+      ]);
+      expect(n, equals(4));
+    });
+
+    test('延迟差距在容差内时取线程更少者', () {
+      final n = ThreadCalibration.pick([
+        timing(1, 1000, 1000),
+        timing(2, 520, 1040),
+        timing(3, 500, 1100),
+        timing(4, 490, 1200),
+      ]);
+      expect(n, equals(2));
+    });
+
+    test('CPU 开销过大的线程数不参与比较', () {
+      // 4 线程更快，但 CPU 开销超过最省结果的 maxCpuGrowth 倍
+      final n = ThreadCalibration.pick([
+        timing(1, 1000, 1000),
+        timing(2, 600, 1200),
+        timing(4, 350, 1800),
+      ]);
+      expect(n, equals(2));
+    });
+
+    test('候选线程数不超过 CPU 核数与上限', () {
+      expect(ThreadCalibration.candidates(1), equals([1]));
+      expect(ThreadCalibration.candidates(4), equals([1, 2, 3, 4]));
+      expect(ThreadCalibration.candidates(64).length,
+          equals(ThreadCalibration.maxThreads));
+    });
+  });
+
+  group('ThreadCalibration 持久化', () {
+    test('JSON 往返保留各引擎结果', () {
+      final calibration = const ThreadCalibration(cores: 8)
+          .withResult(EngineType.zipformer, 3, cores: 8)
+          .withResult(EngineType.sensevoice, 2, cores: 8);
+      final restored = ThreadCalibration.fromJson(calibration.toJson());
+      expect(restored.cores, equals(8));
+      expect(restored.threadsFor(EngineType.zipformer, cores: 8), equals(3));
+      expect(restored.threadsFor(EngineType.sensevoice, cores: 8), equals(2));
+    });
+
+    test('CPU 核数变化后校准值作废', () {
+      final calibration = const ThreadCalibration(cores: 8)
+          .withResult(EngineType.zipformer, 3, cores: 8);
+      expect(calibration.threadsFor(EngineType.zipformer, cores: 4), isNull);
+
+      // 新核数下重新校准时丢弃其他引擎的旧值
+      final updated =
+          calibration.withResult(EngineType.sensevoice, 2, cores: 4);
+      expect(updated.cores, equals(4));
+      expect(updated.threadsFor(EngineType.zipformer, cores: 4), isNull);
+      expect(updated.threadsFor(EngineType.sensevoice, cores: 4), equals(2));
+    });
+
+    test('无记录或格式错误时为空结果', () {
+      for (final json in [null, '', 'not json', '{"cores": "x"}']) {
+        final calibration = ThreadCalibration.fromJson(json);
+        expect(calibration.threadsFor(EngineType.zipformer), isNull);
+      }
+    });
+  });
+}
@@ -33,6 +33,17 @@ void main() {
       expect(service.initializationFailed, isA<bool>());
     });
 
+    test('setMicMonitoring updates privacy indicator state', () async {
+      final service = TrayService.instance;
+      expect(service.isMicMonitoring, isFalse);
+
+      await service.setMicMonitoring(500);
+      expect(service.isMicMonitoring, isTrue);
+
+      await service.setMicMonitoring(null);
+      expect(service.isMicMonitoring, isFalse);
+    });
+
     test('onBeforeExit callback should be settable', () {
       final service = TrayService.instance;
 